@@ -68,6 +68,7 @@ struct Configuration {
     DocumentationInfo documentation;
 
     bool useMultithreadedInitialization = false;
+    bool useMultithreadedSceneUpdate = false;
 
     struct LoadingScreen {
         bool isShowingMessages = true;
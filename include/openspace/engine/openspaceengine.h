@@ -134,6 +134,7 @@ public:
     NetworkEngine& networkEngine();
     ParallelPeer& parallelPeer();
     RenderEngine& renderEngine();
+    SyncEngine& syncEngine();
     TimeManager& timeManager();
     WindowWrapper& windowWrapper();
     ghoul::fontrendering::FontManager& fontManager();
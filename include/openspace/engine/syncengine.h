@@ -25,10 +25,14 @@
 #ifndef __OPENSPACE_CORE___SYNCENGINE___H__
 #define __OPENSPACE_CORE___SYNCENGINE___H__
 
-#include <openspace/util/syncbuffer.h>
+#include <openspace/properties/propertyowner.h>
 
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/util/syncbuffer.h>
 #include <ghoul/misc/boolean.h>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace openspace {
@@ -38,11 +42,24 @@ class Syncable;
 /**
  * Manages a collection of <code>Syncable</code>s and ensures they are synchronized
  * over SGCT nodes. Encoding/Decoding order is handles internally.
+ *
+ * By default, only the values that have changed since the previous frame are
+ * transmitted. To guard against diverging state, a full frame is transmitted at a
+ * regular interval regardless. The number of bytes that each Syncable contributes to
+ * a frame is recorded on the master as well as on the slaves.
  */
-class SyncEngine {
+class SyncEngine : public properties::PropertyOwner {
 public:
     BooleanType(IsMaster);
 
+    struct SyncableInfo {
+        Syncable* syncable;
+        /// The name of the Syncable that is used when presenting the statistics
+        std::string name;
+        /// The number of bytes that this Syncable used in the last frame
+        size_t nBytes;
+    };
+
     /**
      * Creates a new SyncEngine which a buffer size of \p syncBufferSize
      * \pre syncBufferSize must be bigger than 0
@@ -72,16 +89,20 @@ public:
     void postSynchronization(IsMaster isMaster);
 
     /**
-     * Add a Syncable to be synchronized over the SGCT cluster.
+     * Add a Syncable to be synchronized over the SGCT cluster. The \p name is only used
+     * to identify the Syncable in the statistics.
      * \pre syncable must not be nullptr
      */
-    void addSyncable(Syncable* syncable);
+    void addSyncable(Syncable* syncable, std::string name = "");
 
     /**
-     * Add multiple Syncables to be synchronized over the SGCT cluster
+     * Add multiple Syncables to be synchronized over the SGCT cluster. If there is more
+     * than one Syncable, their statistics are identified by \p name followed by their
+     * index in \p syncables.
      * \pre syncables must not contain any nullptr
      */
-    void addSyncables(const std::vector<Syncable*>& syncables);
+    void addSyncables(const std::vector<Syncable*>& syncables,
+        const std::string& name = "");
 
     /**
      * Remove a Syncable from being synchronized over the SGCT cluster
@@ -93,11 +114,30 @@ public:
     */
     void removeSyncables(const std::vector<Syncable*>& syncables);
 
+    /**
+     * Returns all registered Syncables in the order in which they are encoded, together
+     * with the number of bytes that each of them used in the last frame
+     */
+    const std::vector<SyncableInfo>& syncables() const;
+
+    /// Returns the number of uncompressed bytes that were used for the last frame
+    size_t payloadSize() const;
+
+    /// Returns the number of bytes that were transmitted for the last frame
+    size_t transmittedSize() const;
+
 private:
     /**
      * Vector of Syncables. The vectors ensures consistent encode/decode order
      */
-    std::vector<Syncable*> _syncables;
+    std::vector<SyncableInfo> _syncables;
+
+    properties::BoolProperty _onlySyncChanges;
+    properties::BoolProperty _compressFrames;
+    properties::IntProperty _fullFrameInterval;
+
+    /// The number of frames that have been encoded since the last full frame
+    int _nFramesSinceFullFrame = 0;
 
     /**
      * Databuffer used in encoding/decoding
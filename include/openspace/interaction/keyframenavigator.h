@@ -30,7 +30,10 @@
 #include <ghoul/glm.h>
 #include <glm/gtx/quaternion.hpp>
 
-namespace openspace { class Camera; }
+namespace openspace {
+    class Camera;
+    class Scene;
+} // namespace openspace
 
 namespace openspace::interaction {
 
@@ -45,6 +48,16 @@ public:
     };
 
     void updateCamera(Camera& camera);
+
+    /**
+     * Computes the world space position that the camera will have at the application
+     * time \p timestamp if it keeps following the keyframes. Neither the camera nor the
+     * timeline are modified, which makes it possible to look ahead along the path.
+     * \return <code>false</code> if the camera will not be controlled by the keyframes
+     *         at \p timestamp
+     */
+    bool cameraPositionAt(double timestamp, const Scene& scene,
+        glm::dvec3& position) const;
     Timeline<CameraPose>& timeline();
 
     void addKeyframe(double timestamp, KeyframeNavigator::CameraPose pose);
@@ -54,6 +67,16 @@ public:
     const std::vector<datamessagestructures::CameraKeyframe>& keyframes() const;
 
 private:
+    /**
+     * Interpolates the camera state between the keyframes surrounding the application
+     * time \p timestamp. This is shared between updating the camera and looking ahead
+     * along the path so that both follow exactly the same trajectory.
+     * \return <code>false</code> if the camera is not controlled by the keyframes at
+     *         \p timestamp
+     */
+    bool interpolatePose(double timestamp, const Scene& scene, glm::dvec3& position,
+        glm::dquat& rotation, float& scale) const;
+
     Timeline<CameraPose> _cameraPoseTimeline;
 };
 
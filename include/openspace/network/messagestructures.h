@@ -26,22 +26,54 @@
 #define __OPENSPACE_CORE___MESSAGESTRUCTURES___H__
 
 #include <ghoul/glm.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
+/**
+ * The structures in this file describe the wire format of the data messages that are
+ * exchanged between ParallelPeers. Each structure is serialized with a fixed layout: all
+ * fields have an explicit size and a fixed offset and there is no padding. Fields with a
+ * variable length are always placed at the end of a message. This makes it possible to
+ * serialize directly into a preallocated buffer and to deserialize directly from the
+ * received bytes without any intermediate copies.
+ *
+ * Any change to these layouts requires an increase of the protocol version in the
+ * ParallelConnection.
+ */
 namespace openspace::datamessagestructures {
 
 enum class Type : uint32_t {
     CameraData = 0,
     TimeData,
-    ScriptData
+    ScriptData,
+    /// A sequence of other data messages, see #appendToBatch
+    Batch
 };
 
-struct CameraKeyframe {
-    CameraKeyframe() {}
-    CameraKeyframe(const std::vector<char> &buffer) {
-        deserialize(buffer);
+namespace detail {
+    template <typename T>
+    void write(char* buffer, size_t& offset, const T& value) {
+        memcpy(buffer + offset, &value, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    template <typename T>
+    void read(const char* buffer, size_t& offset, T& value) {
+        memcpy(&value, buffer + offset, sizeof(T));
+        offset += sizeof(T);
     }
+} // namespace detail
+
+struct CameraKeyframe {
+    static constexpr const Type MessageType = Type::CameraData;
+
+    // timestamp + position + rotation + scale + followNodeRotation + focusNodeLength
+    static constexpr const size_t FixedSize = sizeof(double) + sizeof(glm::dvec3) +
+        sizeof(glm::dquat) + sizeof(float) + sizeof(uint8_t) + sizeof(uint16_t);
 
     glm::dvec3 _position;
     glm::dquat _rotation;
@@ -51,100 +83,75 @@ struct CameraKeyframe {
 
     double _timestamp;
 
-    void serialize(std::vector<char> &buffer) {
-        // Add position
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_position),
-            reinterpret_cast<char*>(&_position) + sizeof(_position)
-        );
-
-        // Add orientation
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_rotation),
-            reinterpret_cast<char*>(&_rotation) + sizeof(_rotation)
-        );
-
-        // Follow focus node rotation?
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_followNodeRotation),
-            reinterpret_cast<char*>(&_followNodeRotation) + sizeof(_followNodeRotation)
-        );
-
-        int nodeNameLength = static_cast<int>(_focusNode.size());
-
-        // Add focus node
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&nodeNameLength),
-            reinterpret_cast<char*>(&nodeNameLength) + sizeof(nodeNameLength)
-        );
-        buffer.insert(
-            buffer.end(),
-            _focusNode.data(),
-            _focusNode.data() + nodeNameLength
-        );
-
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_scale),
-            reinterpret_cast<char*>(&_scale) + sizeof(_scale)
-        );
-
-        // Add timestamp
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_timestamp),
-            reinterpret_cast<char*>(&_timestamp) + sizeof(_timestamp)
-        );
-    };
-
-    void deserialize(const std::vector<char> &buffer) {
-        int offset = 0;
-        int size = 0;
-
-        // Position
-        size = sizeof(_position);
-        memcpy(&_position, buffer.data() + offset, size);
-        offset += size;
-
-        // Orientation
-        size = sizeof(_rotation);
-        memcpy(&_rotation, buffer.data() + offset, size);
-        offset += size;
-
-        // Follow focus node rotation?
-        size = sizeof(_followNodeRotation);
-        memcpy(&_followNodeRotation, buffer.data() + offset, size);
-        offset += size;
-
-        // Focus node
-        int nodeNameLength;
-        size = sizeof(int);
-        memcpy(&nodeNameLength, buffer.data() + offset, size);
-        offset += size;
-        size = nodeNameLength;
-        _focusNode = std::string(buffer.data() + offset, buffer.data() + offset + size);
-        offset += size;
-
-        // Scale
-        size = sizeof(_scale);
-        memcpy(&_scale, buffer.data() + offset, size);
-        offset += size;
-
-        // Timestamp
-        size = sizeof(_timestamp);
-        memcpy(&_timestamp, buffer.data() + offset, size);
-    };
+    /**
+     * Returns the number of characters of the focus node that are transmitted. Names
+     * that do not fit into the 16 bit length field are truncated
+     */
+    uint16_t focusNodeLength() const {
+        return static_cast<uint16_t>(std::min<size_t>(
+            _focusNode.size(),
+            std::numeric_limits<uint16_t>::max()
+        ));
+    }
+
+    size_t serializedSize() const {
+        return FixedSize + focusNodeLength();
+    }
+
+    /**
+     * Writes this keyframe into \p buffer, which must have room for at least
+     * #serializedSize bytes
+     */
+    void serialize(char* buffer) const {
+        const uint16_t focusNodeLength = this->focusNodeLength();
+        size_t offset = 0;
+        detail::write(buffer, offset, _timestamp);
+        detail::write(buffer, offset, _position);
+        detail::write(buffer, offset, _rotation);
+        detail::write(buffer, offset, _scale);
+        detail::write(buffer, offset, static_cast<uint8_t>(_followNodeRotation));
+        detail::write(buffer, offset, focusNodeLength);
+        memcpy(buffer + offset, _focusNode.data(), focusNodeLength);
+    }
+
+    void serialize(std::vector<char>& buffer) const {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + serializedSize());
+        serialize(buffer.data() + offset);
+    }
+
+    /**
+     * Reads this keyframe from the \p size bytes in \p buffer. Returns \c false if the
+     * buffer is too small to contain a keyframe.
+     */
+    bool deserialize(const char* buffer, size_t size) {
+        if (size < FixedSize) {
+            return false;
+        }
+        size_t offset = 0;
+        uint8_t followNodeRotation;
+        uint16_t focusNodeLength;
+        detail::read(buffer, offset, _timestamp);
+        detail::read(buffer, offset, _position);
+        detail::read(buffer, offset, _rotation);
+        detail::read(buffer, offset, _scale);
+        detail::read(buffer, offset, followNodeRotation);
+        detail::read(buffer, offset, focusNodeLength);
+        if (size < FixedSize + focusNodeLength) {
+            return false;
+        }
+        _followNodeRotation = (followNodeRotation != 0);
+        // assign reuses the capacity of the string if this keyframe is reused
+        _focusNode.assign(buffer + offset, focusNodeLength);
+        return true;
+    }
 };
 
 struct TimeKeyframe {
-    TimeKeyframe() {}
-    TimeKeyframe(const std::vector<char> &buffer) {
-        deserialize(buffer);
-    }
+    static constexpr const Type MessageType = Type::TimeData;
+
+    // timestamp + time + dt + paused + requiresTimeJump
+    static constexpr const size_t FixedSize = 3 * sizeof(double) + 2 * sizeof(uint8_t);
 
     double _time;
     double _dt;
@@ -152,91 +159,110 @@ struct TimeKeyframe {
     bool _requiresTimeJump;
     double _timestamp;
 
-    void serialize(std::vector<char> &buffer){
-        // Add current time
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_time),
-            reinterpret_cast<char*>(&_time) + sizeof(_time)
-        );
-
-        // Add delta time
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_dt),
-            reinterpret_cast<char*>(&_dt) + sizeof(_dt)
-        );
-
-        // Add whether time is paused or not
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_paused),
-            reinterpret_cast<char*>(&_paused) + sizeof(_paused)
-        );
-
-        // Add whether a time jump is necessary (recompute paths etc)
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_requiresTimeJump),
-            reinterpret_cast<char*>(&_requiresTimeJump) + sizeof(_requiresTimeJump)
-        );
-
-        // Add timestamp
-        buffer.insert(
-            buffer.end(),
-            reinterpret_cast<char*>(&_timestamp),
-            reinterpret_cast<char*>(&_timestamp) + sizeof(_timestamp)
-        );
-    };
-
-    void deserialize(const std::vector<char> &buffer){
-        int offset = 0;
-        int size = 0;
-
-        // Current time
-        size = sizeof(_time);
-        memcpy(&_time, buffer.data() + offset, size);
-        offset += size;
-
-        // Delta time
-        size = sizeof(_dt);
-        memcpy(&_dt, buffer.data() + offset, size);
-        offset += size;
-
-        // Is time paused?
-        size = sizeof(_paused);
-        memcpy(&_paused, buffer.data() + offset, size);
-        offset += sizeof(_paused);
-
-        // Is a time jump required?
-        size = sizeof(_requiresTimeJump);
-        memcpy(&_requiresTimeJump, buffer.data() + offset, size);
-        offset += size;
-
-        // Timestamp
-        size = sizeof(_timestamp);
-        memcpy(&_timestamp, buffer.data() + offset, size);
-        // offset += size;
-    };
+    size_t serializedSize() const {
+        return FixedSize;
+    }
+
+    void serialize(char* buffer) const {
+        size_t offset = 0;
+        detail::write(buffer, offset, _timestamp);
+        detail::write(buffer, offset, _time);
+        detail::write(buffer, offset, _dt);
+        detail::write(buffer, offset, static_cast<uint8_t>(_paused));
+        detail::write(buffer, offset, static_cast<uint8_t>(_requiresTimeJump));
+    }
+
+    void serialize(std::vector<char>& buffer) const {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + serializedSize());
+        serialize(buffer.data() + offset);
+    }
+
+    bool deserialize(const char* buffer, size_t size) {
+        if (size < FixedSize) {
+            return false;
+        }
+        size_t offset = 0;
+        uint8_t paused;
+        uint8_t requiresTimeJump;
+        detail::read(buffer, offset, _timestamp);
+        detail::read(buffer, offset, _time);
+        detail::read(buffer, offset, _dt);
+        detail::read(buffer, offset, paused);
+        detail::read(buffer, offset, requiresTimeJump);
+        _paused = (paused != 0);
+        _requiresTimeJump = (requiresTimeJump != 0);
+        return true;
+    }
 };
 
 struct ScriptMessage {
-    ScriptMessage() {}
-    ScriptMessage(const std::vector<char> &buffer) {
-        deserialize(buffer);
-    }
+    static constexpr const Type MessageType = Type::ScriptData;
 
     std::string _script;
 
-    void serialize(std::vector<char> &buffer){
+    size_t serializedSize() const {
+        return _script.size();
+    }
+
+    void serialize(char* buffer) const {
+        memcpy(buffer, _script.data(), _script.size());
+    }
+
+    void serialize(std::vector<char>& buffer) const {
         buffer.insert(buffer.end(), _script.begin(), _script.end());
-    };
+    }
 
-    void deserialize(const std::vector<char> &buffer){
-        _script.assign(buffer.begin(), buffer.end());
-    };
+    bool deserialize(const char* buffer, size_t size) {
+        _script.assign(buffer, size);
+        return true;
+    }
 };
 
-} // namespace openspace::messagestructures
+/**
+ * Appends the \p message to the \p batch. A batch is a sequence of entries that each
+ * consist of <code>[uint32 type][uint32 size][size bytes]</code>. The \p batch is only
+ * ever grown, so reusing it between network ticks avoids any further allocations.
+ */
+template <typename T>
+void appendToBatch(std::vector<char>& batch, const T& message) {
+    const uint32_t type = static_cast<uint32_t>(T::MessageType);
+    const uint32_t size = static_cast<uint32_t>(message.serializedSize());
+
+    size_t offset = batch.size();
+    batch.resize(offset + 2 * sizeof(uint32_t) + size);
+    detail::write(batch.data(), offset, type);
+    detail::write(batch.data(), offset, size);
+    message.serialize(batch.data() + offset);
+}
+
+/**
+ * Calls the \p callback with the type, data pointer, and size of each message that is
+ * contained in the batch of \p size bytes in \p buffer. The data pointer points into
+ * \p buffer, so the messages can be deserialized in place. Returns \c false if the
+ * batch is malformed, in which case the callback has been called for all messages
+ * before the malformed one.
+ */
+template <typename Func>
+bool forEachInBatch(const char* buffer, size_t size, Func callback) {
+    size_t offset = 0;
+    while (offset < size) {
+        if (size - offset < 2 * sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t type;
+        uint32_t messageSize;
+        detail::read(buffer, offset, type);
+        detail::read(buffer, offset, messageSize);
+        if (size - offset < messageSize) {
+            return false;
+        }
+        callback(static_cast<Type>(type), buffer + offset, messageSize);
+        offset += messageSize;
+    }
+    return true;
+}
+
+} // namespace openspace::datamessagestructures
 
 #endif // __OPENSPACE_CORE___MESSAGESTRUCTURES___H__
@@ -34,6 +34,12 @@ namespace openspace {
 
 class ParallelConnection  {
 public:
+    /// Version 5 introduced the fixed layout data messages and batches
+    static constexpr const uint32_t ProtocolVersion = 5;
+
+    /// Each message starts with 'OS' + protocolVersion + messageType + messageSize
+    static constexpr const size_t HeaderSize = 2 * sizeof(char) + 3 * sizeof(uint32_t);
+
     enum class Status : uint32_t {
         Disconnected = 0,
         Connecting,
@@ -78,12 +84,22 @@ public:
     bool isConnectedOrConnecting() const;
     void sendDataMessage(const ParallelConnection::DataMessage& dataMessage);
     bool sendMessage(const ParallelConnection::Message& message);
+
+    /**
+     * Sends a message of type \p type with the \p size bytes pointed to by \p data as
+     * its content. The content is handed to the socket directly without being copied
+     * into an intermediate Message first.
+     */
+    bool sendMessage(MessageType type, const char* data, size_t size);
+
     void disconnect();
     ghoul::io::TcpSocket* socket();
 
     ParallelConnection::Message receiveMessage();
 
 private:
+    bool sendHeader(MessageType type, size_t contentSize);
+
     std::unique_ptr<ghoul::io::TcpSocket> _socket;
 };
 
@@ -74,19 +74,24 @@ public:
     ghoul::Event<>& connectionEvent();
 
 private:
-    void queueInMessage(const ParallelConnection::Message& message);
+    void queueInMessage(ParallelConnection::Message message);
 
     void sendAuthentication();
     void handleCommunication();
 
     void handleMessage(const ParallelConnection::Message&);
     void dataMessageReceived(const std::vector<char>& message);
+    void handleDataMessage(datamessagestructures::Type type, const char* data,
+        size_t size);
     void connectionStatusMessageReceived(const std::vector<char>& message);
     void nConnectionsMessageReceived(const std::vector<char>& message);
 
     void sendCameraKeyframe();
     void sendTimeKeyframe();
 
+    /// Sends all data messages that have been batched during this network tick
+    void sendBatch();
+
     void setStatus(ParallelConnection::Status status);
     void setHostName(const std::string& hostName);
     void setNConnections(size_t nConnections);
@@ -123,6 +128,16 @@ private:
     std::deque<double> _latencyDiffs;
     double _initialTimeDiff;
 
+    /**
+     * All data messages that are sent during one network tick are collected in this
+     * buffer and sent as a single batch. The buffer is reused between ticks
+     */
+    std::vector<char> _sendBuffer;
+    size_t _nBatchedMessages = 0;
+
+    /// Reused for each received camera keyframe to avoid reallocating the node name
+    datamessagestructures::CameraKeyframe _receivedCameraKeyframe;
+
     std::unique_ptr<std::thread> _receiveThread = nullptr;
     std::shared_ptr<ghoul::Event<>> _connectionEvent;
 
@@ -27,85 +27,153 @@
 
 #include <openspace/network/parallelconnection.h>
 
-#include <openspace/util/concurrentqueue.h>
-#include <ghoul/io/socket/tcpsocketserver.h>
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace openspace {
 
+/**
+ * The ParallelServer relays the messages of a host ParallelPeer to all connected client
+ * peers. All sockets are non-blocking and are serviced by a single I/O thread, which
+ * waits on them using epoll on Linux and poll on all other platforms. Messages are
+ * handled directly on the I/O thread as soon as they have been received completely.
+ *
+ * Outgoing messages are appended to a ring buffer for each peer and are written as
+ * soon as the socket of that peer is writable, so a slow peer never delays any of the
+ * other peers. If a peer falls so far behind that its ring buffer is full, it is
+ * disconnected, as it would otherwise only present increasingly outdated keyframes.
+ */
 class ParallelServer {
 public:
+    /**
+     * Creates a server whose peers can each have at most \p outgoingBufferSize bytes
+     * of unsent data before they are disconnected
+     */
+    ParallelServer(size_t outgoingBufferSize = DefaultOutgoingBufferSize);
+    ~ParallelServer();
+
+    /**
+     * Starts listening for peers on \p port of all addresses that \p address resolves
+     * to, which can be both IPv4 and IPv6 addresses. If \p address is empty, the server
+     * listens on all IPv4 and IPv6 interfaces of this machine
+     */
     void start(int port, const std::string& password,
-        const std::string& changeHostPassword);
+        const std::string& changeHostPassword, const std::string& address = "");
 
     void setDefaultHostAddress(std::string defaultHostAddress);
 
     std::string defaultHostAddress() const;
 
+    /**
+     * Stops listening for new connections, disconnects all connected peers, and waits
+     * for the I/O thread to finish
+     */
     void stop();
 
     size_t nConnections() const;
 
+    static constexpr const size_t DefaultOutgoingBufferSize = 4 * 1024 * 1024;
+
+    /// A fixed capacity FIFO of the bytes that still have to be sent to a peer
+    class RingBuffer {
+    public:
+        RingBuffer(size_t capacity);
+
+        /// Appends all \p size bytes or, if they do not fit, nothing
+        bool push(const char* data, size_t size);
+
+        /// Returns the largest contiguous block of bytes at the front of the buffer
+        std::pair<const char*, size_t> front() const;
+
+        /// Removes \p size bytes from the front of the buffer
+        void pop(size_t size);
+
+        size_t size() const;
+        size_t capacity() const;
+        bool empty() const;
+
+    private:
+        std::vector<char> _data;
+        size_t _begin = 0;
+        size_t _size = 0;
+    };
+
 private:
     struct Peer {
-        //Peer(size_t id_, std::string name_, ParallelConnection parallelConnection_,
-            //ParallelConnection::Status status_, std::thread )
-
         size_t id;
         std::string name;
-        ParallelConnection parallelConnection;
+        std::string address;
         ParallelConnection::Status status;
-        std::thread thread;
-    };
 
-    struct PeerMessage {
-        size_t peerId;
-        ParallelConnection::Message message;
+        /// The platform specific socket handle
+        intptr_t socket;
+
+        /// The received bytes that do not yet form a complete message
+        std::vector<char> inBuffer;
+        size_t nReceivedBytes = 0;
+
+        RingBuffer outBuffer;
+        /// Whether the I/O loop is currently waiting for the socket to be writable
+        bool isWaitingForWrite = false;
+        /// Set when the peer should be disconnected at the end of the current iteration
+        bool isDisconnecting = false;
     };
 
-    bool isConnected(std::shared_ptr<Peer> peer) const;
+    bool isConnected(const Peer& peer) const;
 
-    void sendMessage(std::shared_ptr<Peer> peer,
-        ParallelConnection::MessageType messageType,
-        const std::vector<char>& message);
+    void sendMessage(Peer& peer, ParallelConnection::MessageType messageType,
+        const char* data, size_t size);
 
     void sendMessageToAll(ParallelConnection::MessageType messageType,
-        const std::vector<char>& message);
+        const char* data, size_t size);
 
     void sendMessageToClients(ParallelConnection::MessageType messageType,
-        const std::vector<char>& message);
+        const char* data, size_t size);
 
-    void disconnect(std::shared_ptr<Peer> peer);
-    void setName(std::shared_ptr<Peer> peer, std::string name);
-    void assignHost(std::shared_ptr<Peer> newHost);
-    void setToClient(std::shared_ptr<Peer> peer);
+    void disconnect(Peer& peer);
+    void setName(Peer& peer, std::string name);
+    void assignHost(Peer& newHost);
+    void setToClient(Peer& peer);
     void setNConnections(size_t nConnections);
-    void sendConnectionStatus(std::shared_ptr<Peer> peer);
+    void sendConnectionStatus(Peer& peer);
 
-    void handleAuthentication(std::shared_ptr<Peer> peer, std::vector<char> message);
-    void handleData(std::shared_ptr<Peer> peer, std::vector<char> data);
-    void handleHostshipRequest(std::shared_ptr<Peer> peer, std::vector<char> message);
-    void handleHostshipResignation(std::shared_ptr<Peer> peer, std::vector<char> data);
-    void handleDisconnection(std::shared_ptr<Peer> peer);
+    void handleAuthentication(Peer& peer, const char* data, size_t size);
+    void handleData(Peer& peer, const char* data, size_t size);
+    void handleHostshipRequest(Peer& peer, const char* data, size_t size);
+    void handleHostshipResignation(Peer& peer);
 
-    void handleNewPeers();
     void eventLoop();
-    std::shared_ptr<Peer> peer(size_t id);
-    void handlePeer(size_t id);
-    void handlePeerMessage(PeerMessage peerMessage);
+    /// Accepts all pending connections on all listening sockets
+    void acceptPeers();
+    void acceptPeers(intptr_t listenSocket);
+    void readFromPeer(Peer& peer);
+    void writeToPeer(Peer& peer);
+    void handlePeerMessage(Peer& peer, ParallelConnection::MessageType messageType,
+        const char* data, size_t size);
+    void removeDisconnectedPeers();
+    Peer* peer(size_t id);
 
-    std::unordered_map<size_t, std::shared_ptr<Peer>> _peers;
-    mutable std::mutex _peerListMutex;
+    /// Registers or updates the events of \p socket that the I/O loop waits for
+    void watchSocket(intptr_t socket, size_t id, bool isNew, bool waitForWrite);
+
+    std::unordered_map<size_t, std::unique_ptr<Peer>> _peers;
 
-    std::thread _serverThread;
     std::thread _eventLoopThread;
-    ghoul::io::TcpSocketServer _socketServer;
+    std::vector<intptr_t> _listenSockets;
+    /// The epoll instance on Linux, unused on all other platforms
+    int _pollHandle = -1;
+    const size_t _outgoingBufferSize;
+
     size_t _passwordHash;
     size_t _changeHostPasswordHash;
     size_t _nextConnectionId = 1;
     std::atomic_bool _shouldStop = false;
+    bool _isRunning = false;
 
     std::atomic_size_t _nConnections = 0;
     std::atomic_size_t _hostPeerId = 0;
@@ -113,8 +181,6 @@ private:
     mutable std::mutex _hostInfoMutex;
     std::string _hostName;
     std::string _defaultHostAddress;
-
-    ConcurrentQueue<PeerMessage> _incomingMessages;
 };
 
 } // namespace openspace
@@ -0,0 +1,67 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___GPUTIMER___H__
+#define __OPENSPACE_CORE___GPUTIMER___H__
+
+#include <ghoul/opengl/ghoul_gl.h>
+
+namespace openspace::performance {
+
+/**
+ * Measures the time that the GPU spends on the commands that are issued between #begin
+ * and #end without stalling the pipeline. The timer alternates between two
+ * <code>GL_TIME_ELAPSED</code> queries, and the result of a query is only read once
+ * the GPU reports it as available, which is usually one or two frames later. If the
+ * query that is next in line is still pending when #begin is called, that measurement
+ * is skipped. As elapsed time queries cannot be nested, only one timer can be running
+ * at any given time.
+ */
+class GpuTimer {
+public:
+    /// Starts a measurement and reads back the results that have become available
+    void begin();
+
+    /// Ends the measurement that was started by the last call to #begin
+    void end();
+
+    /// Returns the most recent result that has been read back, in nanoseconds
+    long long latestResult() const;
+
+    /// Deletes the query objects. Has to be called while the OpenGL context is current
+    void deinitialize();
+
+private:
+    void collectResults();
+
+    GLuint _queries[2] = { 0, 0 };
+    bool _isPending[2] = { false, false };
+    int _current = 0;
+    bool _isRunning = false;
+    long long _latestResult = 0;
+};
+
+} // namespace openspace::performance
+
+#endif // __OPENSPACE_CORE___GPUTIMER___H__
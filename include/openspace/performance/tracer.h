@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TRACER___H__
+#define __OPENSPACE_CORE___TRACER___H__
+
+#include <openspace/scripting/lualibrary.h>
+#include <cstdint>
+#include <string>
+
+namespace openspace::performance {
+
+/**
+ * A low-overhead hierarchical tracer that records named, timed zones per thread and can
+ * export them as a Chrome trace (JSON) that can be opened in
+ * <code>chrome://tracing</code> or Perfetto. Each thread that records a zone gets its
+ * own fixed-size ring buffer, so recording a zone never takes a lock and never
+ * allocates after the first zone on a thread; if a thread records more zones than fit
+ * in its buffer, the oldest ones are overwritten. When a thread exits, its buffer is
+ * reused by the next thread that records a zone, which discards the zones of the exited
+ * thread. Zones that are opened within another zone on the same thread are shown as its
+ * children, as the nesting follows directly from the begin and end times.
+ *
+ * All names that are passed to the tracer, both zone names and thread names, have to
+ * outlive the tracer, which in practice means that they have to be string literals.
+ * Tracing is disabled by default, in which case a zone costs a single atomic load.
+ */
+class Tracer {
+public:
+    /// Records the time between its construction and destruction as a zone
+    class Zone {
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* _name;
+        int64_t _begin = 0;
+    };
+
+    /// The number of zones that are kept for each thread
+    static constexpr const uint64_t BufferSize = 16384;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Sets the name under which the calling thread shows up in the exported trace.
+     * Calling this repeatedly with the same name is cheap, so thread pool tasks can call
+     * it at the beginning of each task.
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * Writes all zones that are currently stored in the threads' buffers to the file at
+     * \p filename in the Chrome trace event format. Zones that are still being recorded
+     * while the trace is written are skipped. Returns <code>false</code> if the file
+     * could not be written.
+     */
+    static bool writeChromeTrace(const std::string& filename);
+
+    /// Removes all recorded zones
+    static void clear();
+
+    static scripting::LuaLibrary luaLibrary();
+};
+
+#define __MERGE_TraceZone(a,b)  a##b
+#define __LABEL_TraceZone(a) __MERGE_TraceZone(unique_trace_zone_, a)
+
+/// Declare a new variable that traces the current block under the literal \p name
+#define TraceZone(name) \
+    openspace::performance::Tracer::Zone __LABEL_TraceZone(__LINE__)(name)
+
+} // namespace openspace::performance
+
+#endif // __OPENSPACE_CORE___TRACER___H__
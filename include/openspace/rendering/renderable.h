@@ -77,6 +77,11 @@ public:
 
     virtual void render(const RenderData& data, RendererTasks& rendererTask);
     virtual void update(const UpdateData& data);
+
+    // Returns whether #update may be called on a worker thread, concurrently with the
+    // updates of other scene graph nodes. As most renderables use OpenGL in their update,
+    // this is opt-in; renderables that only do CPU work on their own state can enable it
+    virtual bool supportsParallelUpdate() const;
     virtual SurfacePositionHandle calculateSurfacePositionHandle(
                                                 const glm::dvec3& targetModelSpace) const;
 
@@ -52,6 +52,12 @@ public:
     virtual double scaleValue(const Time& time) const = 0;
     virtual void update(const Time& time);
 
+    // Returns whether #update may be called concurrently with the updates of other
+    // scene graph nodes. Scales that use non-reentrant libraries without
+    // synchronization or that read the state of other scene graph nodes have to
+    // return false
+    virtual bool supportsParallelUpdate() const;
+
     static documentation::Documentation Documentation();
 
 protected:
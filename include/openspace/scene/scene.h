@@ -45,6 +45,7 @@ namespace documentation { struct Documentation; }
 namespace scripting { struct LuaLibrary; }
 
 class SceneInitializer;
+class ThreadPool;
 
 // Notifications:
 // SceneGraphFinishedLoading
@@ -62,8 +63,22 @@ public:
             const std::string& comp = "");
     };
 
-    // constructors & destructor
-    Scene(std::unique_ptr<SceneInitializer> initializer);
+    // The nodes of a level only depend on nodes of earlier levels. The transforms of
+    // the serial nodes are updated on the calling thread after the parallel nodes
+    struct UpdateLevel {
+        std::vector<SceneGraphNode*> parallelNodes;
+        std::vector<SceneGraphNode*> serialNodes;
+    };
+
+    /**
+     * Creates an empty scene. If \p nUpdateThreads is bigger than 0, the scene graph
+     * nodes are updated in parallel on a ThreadPool with that many threads, grouped into
+     * levels of nodes that do not depend on each other. The levels are processed in
+     * order, so the parent and the dependencies of a node are always updated before the
+     * node itself.
+     */
+    Scene(std::unique_ptr<SceneInitializer> initializer,
+        unsigned int nUpdateThreads = 0);
     ~Scene();
 
     /**
@@ -93,7 +108,11 @@ public:
     Camera* camera() const;
 
     /**
-     * Updates all SceneGraphNodes relative positions
+     * Updates all SceneGraphNodes relative positions. Without update threads, each node
+     * updates its transform and then its renderable before the next node is visited.
+     * With update threads, the transforms of all nodes are updated first and the
+     * renderables afterwards, so a renderable always sees the transforms of the current
+     * frame, independent of its position in the scene graph.
      */
     void update(const UpdateData& data);
 
@@ -140,6 +159,11 @@ public:
      */
     const std::vector<SceneGraphNode*>& allSceneGraphNodes() const;
 
+    /**
+     * Returns the levels into which the nodes are grouped for the parallel update.
+     */
+    const std::vector<UpdateLevel>& updateLevels() const;
+
     /**
      * Write information about the license information for the scenegraph nodes that are
      * contained in this scene
@@ -227,6 +251,14 @@ private:
 
     void sortTopologically();
 
+    /**
+     * Groups the topologically sorted nodes into the levels that are used for the
+     * parallel update and separates the nodes that have to be updated serially.
+     */
+    void groupNodesIntoUpdateLevels();
+
+    void updateNodesInParallel(const UpdateData& data);
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
     std::vector<SceneGraphNode*> _circularNodes;
@@ -235,6 +267,13 @@ private:
     SceneGraphNode _rootDummy;
     std::unique_ptr<SceneInitializer> _initializer;
 
+    // The calling thread takes part in the update in addition to the pool's threads
+    std::unique_ptr<ThreadPool> _updatePool;
+    unsigned int _nUpdateThreads = 0;
+    std::vector<UpdateLevel> _updateLevels;
+    std::vector<SceneGraphNode*> _parallelRenderableNodes;
+    std::vector<SceneGraphNode*> _serialRenderableNodes;
+
     std::vector<SceneLicense> _licenses;
 
     std::mutex _programUpdateLock;
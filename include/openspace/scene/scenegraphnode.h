@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___SCENEGRAPHNODE___H__
 #define __OPENSPACE_CORE___SCENEGRAPHNODE___H__
 
+#include <openspace/performance/gputimer.h>
 #include <openspace/properties/propertyowner.h>
 
 #include <ghoul/glm.h>
@@ -61,6 +62,8 @@ public:
 
     BooleanType(UpdateScene);
 
+    // The update times are measured on the CPU. The render time is the time the GPU
+    // spent on the node and it lags behind the current frame by one or two frames
     struct PerformanceRecord {
         long long renderTime;  // time in ns
         long long updateTimeRenderable;  // time in ns
@@ -89,6 +92,22 @@ public:
     void traversePreOrder(const std::function<void(SceneGraphNode*)>& fn);
     void traversePostOrder(const std::function<void(SceneGraphNode*)>& fn);
     void update(const UpdateData& data);
+
+    /**
+     * Updates the translation, rotation, and scale of this node and caches the resulting
+     * world transformation. The world transformation of the parent has to be up to date.
+     */
+    void updateTransforms(const UpdateData& data);
+
+    /// Updates the renderable with the world transformation cached by #updateTransforms
+    void updateRenderable(const UpdateData& data);
+
+    /// Returns whether #updateTransforms may run concurrently with other nodes' updates
+    bool supportsParallelTransformUpdate() const;
+
+    /// Returns whether #updateRenderable may run concurrently with other nodes' updates
+    bool supportsParallelRenderableUpdate() const;
+
     void render(const RenderData& data, RendererTasks& tasks);
     void updateCamera(Camera* camera) const;
 
@@ -156,6 +175,7 @@ private:
     bool _guiHintHidden = false;
 
     PerformanceRecord _performanceRecord = { 0, 0, 0, 0, 0 };
+    performance::GpuTimer _renderTimer;
 
     std::unique_ptr<Renderable> _renderable;
 
@@ -175,6 +195,7 @@ private:
 
     glm::dmat4 _modelTransformCached;
     glm::dmat4 _inverseModelTransformCached;
+    bool _hasCachedTransforms = false;
 };
 
 } // namespace openspace
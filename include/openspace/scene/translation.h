@@ -31,6 +31,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -54,6 +55,26 @@ public:
 
     virtual glm::dvec3 position(const Time& time) const = 0;
 
+    // Returns the positions at each of the \p times in J2000 seconds. The result is the
+    // same as calling #position for each time, but uses the #batchSampler if there is one
+    std::vector<glm::dvec3> positions(const std::vector<double>& times) const;
+
+    using BatchSampler =
+        std::function<std::vector<glm::dvec3>(const std::vector<double>& times)>;
+
+    // Returns a function that computes the positions for many times at once, sharing the
+    // work that is common to all samples. The function only depends on the state of this
+    // Translation at the time of this call and may be evaluated on any thread, even while
+    // this Translation is changed or destroyed. An empty function, the default, means
+    // that the positions can only be computed through #position
+    virtual BatchSampler batchSampler() const;
+
+    // Returns whether #update may be called concurrently with the updates of other
+    // scene graph nodes. Translations that use non-reentrant libraries without
+    // synchronization or that read the state of other scene graph nodes have to
+    // return false
+    virtual bool supportsParallelUpdate() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
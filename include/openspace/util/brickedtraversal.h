@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___BRICKEDTRAVERSAL___H__
+#define __OPENSPACE_CORE___BRICKEDTRAVERSAL___H__
+
+#include <openspace/util/parallelfor.h>
+#include <ghoul/glm.h>
+#include <functional>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Calls \p function for every cell of a grid with the provided \p dimensions, using one
+ * thread per element in \p threadStates. The grid is split into bricks of at most
+ * \p brickSize cells along each axis, which are handed out to the threads one at a time.
+ * Within a brick, the cells are visited with the x coordinate varying fastest, so
+ * consecutive calls access neighboring cells.
+ *
+ * The \p function is called as <code>function(ThreadState& state, const glm::uvec3&
+ * cell)</code>, where \p state is the element of \p threadStates that belongs to the
+ * calling thread. This is where per-thread resources, such as interpolators that are not
+ * thread-safe, or partial results, such as extrema, are kept. The calling thread is used
+ * as the first of the threads.
+ *
+ * The bricks are distributed with parallelForEach, which also describes how progress
+ * is reported and how exceptions are handled.
+ */
+template <typename ThreadState, typename Function>
+void traverseBricksParallel(const glm::uvec3& dimensions,
+    std::vector<ThreadState>& threadStates, Function function,
+    const std::function<void(float)>& progressCallback = nullptr,
+    unsigned int brickSize = 16);
+
+} // namespace openspace
+
+#include "brickedtraversal.inl"
+
+#endif // __OPENSPACE_CORE___BRICKEDTRAVERSAL___H__
@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+
+namespace openspace {
+
+template <typename ThreadState, typename Function>
+void traverseBricksParallel(const glm::uvec3& dimensions,
+                            std::vector<ThreadState>& threadStates, Function function,
+                            const std::function<void(float)>& progressCallback,
+                            unsigned int brickSize)
+{
+    if (dimensions.x == 0 || dimensions.y == 0 || dimensions.z == 0) {
+        return;
+    }
+    brickSize = std::max(brickSize, 1u);
+
+    const glm::uvec3 nBricks = (dimensions + glm::uvec3(brickSize - 1)) / brickSize;
+    const size_t totalBricks = static_cast<size_t>(nBricks.x) * nBricks.y * nBricks.z;
+
+    auto traverseBrick = [&](ThreadState& state, size_t brick) {
+        // Bricks are handed out in the same x-fastest order as the cells
+        const glm::uvec3 brickCoords = glm::uvec3(
+            brick % nBricks.x,
+            (brick / nBricks.x) % nBricks.y,
+            brick / (static_cast<size_t>(nBricks.x) * nBricks.y)
+        );
+        const glm::uvec3 begin = brickCoords * brickSize;
+        const glm::uvec3 end = glm::min(begin + brickSize, dimensions);
+
+        glm::uvec3 cell;
+        for (cell.z = begin.z; cell.z < end.z; ++cell.z) {
+            for (cell.y = begin.y; cell.y < end.y; ++cell.y) {
+                for (cell.x = begin.x; cell.x < end.x; ++cell.x) {
+                    function(state, static_cast<const glm::uvec3&>(cell));
+                }
+            }
+        }
+    };
+    parallelForEach(totalBricks, threadStates, traverseBrick, progressCallback);
+}
+
+} // namespace openspace
@@ -30,7 +30,7 @@ T ConcurrentQueue<T>::pop() {
     while (_queue.empty()) {
         _cond.wait(mlock);
     }
-    auto item = _queue.front();
+    T item = std::move(_queue.front());
     _queue.pop();
     return item;
 }
@@ -41,7 +41,7 @@ void ConcurrentQueue<T>::pop(T& item) {
     while (_queue.empty()) {
         _cond.wait(mlock);
     }
-    item = _queue.front();
+    item = std::move(_queue.front());
     _queue.pop();
 }
 
@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PARALLELFOR___H__
+#define __OPENSPACE_CORE___PARALLELFOR___H__
+
+#include <functional>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Calls \p function for every index in [0, \p nItems), using one thread per element in
+ * \p threadStates. The indices are handed out to the threads one at a time, so the items
+ * should be coarse enough for this to not be a bottleneck, such as tracing a field line
+ * or sampling a brick of a volume.
+ *
+ * The \p function is called as <code>function(ThreadState& state, size_t index)</code>,
+ * where \p state is the element of \p threadStates that belongs to the calling thread.
+ * This is where per-thread resources, such as interpolators that are not thread-safe,
+ * scratch buffers or partial results, are kept. The order in which the items are
+ * processed is not deterministic, so results should be written to a slot that is
+ * determined by the \p index. The calling thread is used as the first of the threads.
+ *
+ * The \p progressCallback, if provided, is only called from the calling thread, with
+ * the fraction of the items that have been completed. An exception thrown from
+ * \p function stops the remaining work and is rethrown on the calling thread.
+ */
+template <typename ThreadState, typename Function>
+void parallelForEach(size_t nItems, std::vector<ThreadState>& threadStates,
+    Function function, const std::function<void(float)>& progressCallback = nullptr);
+
+/**
+ * Returns the number of threads that should be used for a parallel loop, which is the
+ * number of hardware threads, but at least one.
+ */
+unsigned int defaultParallelThreadCount();
+
+} // namespace openspace
+
+#include "parallelfor.inl"
+
+#endif // __OPENSPACE_CORE___PARALLELFOR___H__
@@ -0,0 +1,97 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace openspace {
+
+template <typename ThreadState, typename Function>
+void parallelForEach(size_t nItems, std::vector<ThreadState>& threadStates,
+                     Function function,
+                     const std::function<void(float)>& progressCallback)
+{
+    if (threadStates.empty() || nItems == 0) {
+        return;
+    }
+
+    std::atomic<size_t> nextItem = 0;
+    std::atomic<size_t> nFinishedItems = 0;
+    std::exception_ptr exception;
+    std::atomic_bool hasFailed = false;
+
+    auto work = [&](ThreadState& state, bool reportProgress) {
+        try {
+            while (!hasFailed) {
+                const size_t item = nextItem++;
+                if (item >= nItems) {
+                    return;
+                }
+
+                function(state, item);
+
+                const size_t nFinished = ++nFinishedItems;
+                if (reportProgress && progressCallback) {
+                    progressCallback(
+                        static_cast<float>(nFinished) / static_cast<float>(nItems)
+                    );
+                }
+            }
+        }
+        catch (...) {
+            // Only the first exception is kept; the other threads stop at their next
+            // item and the exception is rethrown on the calling thread
+            if (!hasFailed.exchange(true)) {
+                exception = std::current_exception();
+            }
+        }
+    };
+
+    // No need for more threads than there are items
+    const size_t nThreads = std::min(threadStates.size(), nItems);
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (size_t i = 1; i < nThreads; ++i) {
+        threads.emplace_back(work, std::ref(threadStates[i]), false);
+    }
+    work(threadStates[0], true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    if (progressCallback) {
+        progressCallback(1.f);
+    }
+}
+
+inline unsigned int defaultParallelThreadCount() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+} // namespace openspace
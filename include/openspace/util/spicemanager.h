@@ -31,7 +31,10 @@
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/exception.h>
 #include <array>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <set>
@@ -40,6 +43,14 @@ namespace openspace {
 
 namespace scripting { struct LuaLibrary; }
 
+/**
+ * The SpiceManager is the only place that calls into the CSPICE library. As CSPICE is not
+ * reentrant, all calls are serialized, which makes it safe to use the SpiceManager from
+ * any thread. The results of the most frequent queries, positions, position transform
+ * matrices, and fields of view, are memoized per query and time until kernels are loaded
+ * or unloaded, so that repeated queries within a frame or across frames with the same
+ * time are cheap.
+ */
 class SpiceManager : public ghoul::Singleton<SpiceManager> {
     friend class ghoul::Singleton<SpiceManager>;
 
@@ -478,6 +489,20 @@ public:
     std::string dateFromEphemerisTime(double ephemerisTime,
         const std::string& formatString = "YYYY MON DDTHR:MN:SC.### ::RND") const;
 
+    /**
+     * Converts the position given by a \p range, \p rightAscension, and \p declination
+     * into rectangular coordinates.
+     *
+     * \param range The distance of the position from the origin
+     * \param rightAscension The right ascension of the position in radians
+     * \param declination The declination of the position in radians
+     * \return The rectangular coordinates of the position
+     *
+     * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/radrec_c.html
+     */
+    glm::dvec3 rectangularFromRaDec(double range, double rightAscension,
+        double declination) const;
+
     /**
      * Returns the \p position of a \p target body relative to an \p observer in a
      * specific \p referenceFrame, optionally corrected for \p lightTime (planetary
@@ -541,6 +566,33 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the positions of a \p target body relative to an \p observer for each of
+     * the \p ephemerisTimes. The result is the same as calling #targetPosition for each
+     * time, but the bodies are only looked up once and the serialization is only done
+     * once for all times, which makes this the preferred way to sample a trajectory. The
+     * results bypass the memoization, as sampled times are rarely queried again.
+     *
+     * \param target The target body name or the target body's NAIF ID
+     * \param observer The observing body name or the observing body's NAIF ID
+     * \param referenceFrame The reference frame of the output position vectors
+     * \param aberrationCorrection The aberration correction used for the position
+     *        calculation
+     * \param ephemerisTimes The times at which the positions are to be queried
+     * \return The positions of the \p target relative to the \p observer in the
+     *         specified \p referenceFrame, in the same order as the \p ephemerisTimes
+     *
+     * \throw SpiceException If the position for any of the times cannot be computed,
+     *        with the same conditions as #targetPosition
+     * \pre \p target must not be empty.
+     * \pre \p observer must not be empty.
+     * \pre \p referenceFrame must not be empty.
+     */
+    std::vector<glm::dvec3> targetPositions(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection,
+        const std::vector<double>& ephemerisTimes) const;
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
@@ -987,6 +1039,26 @@ private:
      */
     void findSpkCoverage(const std::string& path);
 
+    /// Returns whether the body with the NAIF \p id has SPK coverage at time \p et
+    bool hasSpkCoverage(int id, double et) const;
+
+    /**
+     * Implements #targetPosition without the memoization. If exceptions are disabled,
+     * \p isValid is set to <code>false</code> if the returned position is only a
+     * placeholder for a query that failed, and to <code>true</code> otherwise.
+     */
+    glm::dvec3 computeTargetPosition(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double& lightTime, bool& isValid) const;
+
+    /**
+     * Implements #positionTransformMatrix without the memoization. \p isValid is set in
+     * the same way as for #computeTargetPosition.
+     */
+    glm::dmat3 computePositionTransformMatrix(const std::string& sourceFrame,
+        const std::string& destinationFrame, double ephemerisTime, bool& isValid) const;
+
     /**
      * If a position is requested for an uncovered time in the SPK kernels, this function
      * will return an estimated position. If the coverage has not yet started, the first
@@ -1003,6 +1075,8 @@ private:
      * \param lightTime If the \p aberrationCorrection is different from
      *        AbberationCorrection::Type::None, this variable will contain the light time
      *        between the observer and the target.
+     * \param isValid Is set to <code>false</code> if exceptions are disabled and no
+     *        position could be estimated, and to <code>true</code> otherwise
      * \return The position of the \p target relative to the \p origin
      *
      * \throw SpiceException If the \p target or \p origin are not valid NAIF
@@ -1016,7 +1090,7 @@ private:
     glm::dvec3 getEstimatedPosition(const std::string& target,
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime,
-        double& lightTime) const;
+        double& lightTime, bool& isValid) const;
 
     /**
      * If a transform matrix is requested for an uncovered time in the CK kernels, this
@@ -1028,6 +1102,8 @@ private:
      * \param fromFrame The transform matrix will be retrieved in relation to this frame
      * \param toFrame The reference frame into which the resulting matrix will transformed
      * \param time The time for which an estimated transform matrix is requested
+     * \param isValid Is set to <code>false</code> if exceptions are disabled and no
+     *        transform matrix could be estimated, and to <code>true</code> otherwise
      * \return The estimated transform matrix of the frame
      *
      * \throw SpiceException If there is no coverage available for the specified
@@ -1037,7 +1113,7 @@ private:
      * \pre \p toFrame must not be empty
      */
     glm::dmat3 getEstimatedTransformMatrix(const std::string& fromFrame,
-        const std::string& toFrame, double time) const;
+        const std::string& toFrame, double time, bool& isValid) const;
 
     /// A list of all loaded kernels
     std::vector<KernelInformation> _loadedKernels;
@@ -1050,11 +1126,20 @@ private:
     // Vector of pairs: Body, Frame
     std::vector<std::pair<std::string, std::string>> _frameByBody;
 
-    /// Stores whether the SpiceManager throws exceptions (Yes) or fails silently (No)
-    UseException _useExceptions = UseException::Yes;
+    /// Stores whether the SpiceManager throws exceptions (Yes) or fails silently (No).
+    /// It is atomic as it is read without holding the _mutex, see #exceptionHandling
+    std::atomic<UseException> _useExceptions = { UseException::Yes };
 
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
+
+    /// The memoized query results, which are invalidated when the kernels change
+    struct QueryCache;
+    std::unique_ptr<QueryCache> _cache;
+
+    /// Serializes all calls into CSPICE and all accesses to the members above. It is
+    /// recursive as the public functions are implemented in terms of each other
+    mutable std::recursive_mutex _mutex;
 };
 
 } // namespace openspace
@@ -25,7 +25,9 @@
 #ifndef __OPENSPACE_CORE___SYNCBUFFER___H__
 #define __OPENSPACE_CORE___SYNCBUFFER___H__
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace sgct {
@@ -35,12 +37,66 @@ namespace sgct {
 
 namespace openspace {
 
+/**
+ * The SyncBuffer collects the data that is encoded by all Syncables on the master node
+ * and distributes it as a single frame to the slave nodes. Each frame is prefixed with a
+ * small header that describes how its payload was produced, so that the slaves do not
+ * need to be configured identically to the master:
+ *
+ * <code>[uint8 flags][uint32 payload size, only if compressed][payload]</code>
+ *
+ * If the frame is compressed, the payload is an LZ4 block that decompresses to the
+ * given size. If the frame only contains changes, each Syncable that supports it has
+ * prefixed its value with a flag stating whether the value was transmitted at all.
+ */
 class SyncBuffer {
 public:
+    /**
+     * Creates a new SyncBuffer with an initial capacity of \p n bytes. The buffer grows
+     * if more data than that is encoded in a single frame
+     */
     SyncBuffer(size_t n);
 
     ~SyncBuffer();
 
+    /**
+     * Determines whether the next frames that are written will only contain the values
+     * that have changed since the previous frame. This setting is only used on the
+     * master, the slaves take the value from the header of each received frame
+     */
+    void setOnlyEncodeChanges(bool onlyChanges);
+
+    /**
+     * Returns \c true if the frame that is currently being encoded or decoded only
+     * contains the values that have changed since the last frame
+     */
+    bool onlyEncodeChanges() const;
+
+    /**
+     * Determines whether the frames written by the master are compressed using LZ4
+     * before they are transmitted. Small frames, and frames that do not compress, are
+     * always transmitted uncompressed
+     */
+    void setCompressionEnabled(bool enabled);
+
+    /**
+     * Returns the number of bytes that have been encoded into the current frame on the
+     * master or that have been decoded from the current frame on the slaves
+     */
+    size_t currentOffset() const;
+
+    /// Returns the size of the uncompressed payload of the last frame
+    size_t payloadSize() const;
+
+    /// Returns the number of bytes, including the header, of the last transmitted frame
+    size_t transmittedSize() const;
+
+    /**
+     * Returns the number of times the internal buffer had to grow since the SyncBuffer
+     * was created. A value that keeps increasing means the initial size is too small
+     */
+    int nReallocations() const;
+
     void encode(const std::string& s);
 
     template <typename T>
@@ -56,15 +112,52 @@ public:
     template <typename T>
     void decode(T& value);
 
+    /// Packs the encoded values into a frame and transmits it to the slave nodes
     void write();
 
-    void read();
+    /**
+     * Receives the frame that was transmitted by the master and unpacks it, so that the
+     * values can be decoded.
+     * \return <code>false</code> if no frame has been received or if the frame is
+     *         malformed, in which case nothing must be decoded
+     */
+    bool read();
+
+    /**
+     * Packs the values that have been encoded since the last frame into a new frame,
+     * which is afterwards available through frame(). This is the part of write() that
+     * does not transmit any data.
+     */
+    void packFrame();
+
+    /**
+     * Unpacks the received \p frame so that its values can be decoded. This is the part
+     * of read() that does not receive any data.
+     * \return <code>false</code> if the \p frame is empty or malformed, in which case the
+     *         payload is empty
+     */
+    bool unpackFrame(std::vector<char> frame);
+
+    /// Returns the last frame that has been packed or unpacked
+    const std::vector<char>& frame() const;
 
 private:
+    /// Makes sure that \p size more bytes can be encoded into the data stream
+    void ensureCapacity(size_t size);
+
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
     std::vector<char> _dataStream;
+
+    /// The frame, including the header, that is transmitted or has been received
+    std::vector<char> _frame;
+
+    bool _onlyEncodeChanges = false;
+    bool _compressionEnabled = false;
+    size_t _payloadSize = 0;
+    int _nReallocations = 0;
+
     std::unique_ptr<sgct::SharedVector<char>> _synchronizationBuffer;
 };
 
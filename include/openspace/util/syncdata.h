@@ -27,6 +27,7 @@
 
 #include <openspace/util/syncable.h>
 
+#include <array>
 #include <mutex>
 
 namespace openspace {
@@ -42,6 +43,10 @@ namespace openspace {
  *
  * ((T&) t).method();
  *
+ * If the SyncBuffer is set to only encode changes, the value is only transmitted in the
+ * frames in which it differs from the previously transmitted value. Values are compared
+ * with <code>operator==</code> if T provides one; otherwise the bytes that would be
+ * encoded are compared with the bytes that were encoded last.
  */
 template<class T>
 class SyncData : public Syncable {
@@ -70,8 +75,18 @@ protected:
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
 
+    /// Returns \c true if \c data differs from the value that was encoded last
+    bool hasChangedSinceLastEncode() const;
+
     T data;
     T doubleBufferedData;
+
+    /// The value that was last encoded, used to detect whether \c data has changed
+    T _lastEncodedData;
+    /// The encoded bytes of the last value, used if T cannot be compared with ==
+    std::array<char, sizeof(T)> _lastEncodedBytes;
+    bool _hasEncodedData = false;
+
     std::mutex _mutex;
 };
 
@@ -24,8 +24,22 @@
 
 #include <openspace/util/syncbuffer.h>
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
 namespace openspace {
 
+namespace detail {
+    template <typename T, typename = void>
+    struct HasEqualityOperator : std::false_type {};
+
+    template <typename T>
+    struct HasEqualityOperator<
+        T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>
+    > : std::true_type {};
+} // namespace detail
+
 template<class T>
 SyncData<T>::SyncData(const T& val) : data(val) {};
 
@@ -51,14 +65,51 @@ SyncData<T>::operator const T&() const {
 template<class T>
 void SyncData<T>::encode(SyncBuffer* syncBuffer) {
     _mutex.lock();
-    syncBuffer->encode(data);
+    if (syncBuffer->onlyEncodeChanges()) {
+        const bool hasChanged = hasChangedSinceLastEncode();
+        syncBuffer->encode(hasChanged);
+        if (hasChanged) {
+            syncBuffer->encode(data);
+        }
+    }
+    else {
+        syncBuffer->encode(data);
+    }
+    if constexpr (detail::HasEqualityOperator<T>::value) {
+        _lastEncodedData = data;
+    }
+    else {
+        // Copying the bytes instead of the value keeps the padding that was encoded
+        memcpy(_lastEncodedBytes.data(), &data, sizeof(T));
+    }
+    _hasEncodedData = true;
     _mutex.unlock();
 }
 
+template<class T>
+bool SyncData<T>::hasChangedSinceLastEncode() const {
+    if (!_hasEncodedData) {
+        return true;
+    }
+    if constexpr (detail::HasEqualityOperator<T>::value) {
+        return !(data == _lastEncodedData);
+    }
+    else {
+        // SyncBuffer::encode copies the bytes of the value
+        return memcmp(&data, _lastEncodedBytes.data(), sizeof(T)) != 0;
+    }
+}
+
 template<class T>
 void SyncData<T>::decode(SyncBuffer* syncBuffer) {
     _mutex.lock();
-    syncBuffer->decode(doubleBufferedData);
+    // If only changes are transmitted, an unchanged value keeps the last decoded value
+    const bool hasChanged = syncBuffer->onlyEncodeChanges() ?
+        syncBuffer->decode<bool>() :
+        true;
+    if (hasChanged) {
+        syncBuffer->decode(doubleBufferedData);
+    }
     _mutex.unlock();
 }
 
@@ -60,6 +60,8 @@
 #include <openspace/util/factorymanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
+#include <algorithm>
+#include <thread>
 
 namespace openspace {
 
@@ -137,12 +139,26 @@ void BaseModule::internalInitialize(const ghoul::Dictionary&) {
     auto fGeometry = FactoryManager::ref().factory<modelgeometry::ModelGeometry>();
     ghoul_assert(fGeometry, "Model geometry factory was not created");
     fGeometry->registerClass<modelgeometry::MultiModelGeometry>("MultiModelGeometry");
+
+    // Leave half of the cores for the render loop and the scene update
+    _trailSamplingPool = std::make_unique<ThreadPool>(
+        std::max(std::thread::hardware_concurrency() / 2, 1u)
+    );
+}
+
+void BaseModule::internalDeinitialize() {
+    _trailSamplingPool = nullptr;
 }
 
 void BaseModule::internalDeinitializeGL() {
     ProgramObjectManager.releaseAll(ghoul::opengl::ProgramObjectManager::Warnings::Yes);
 }
 
+ThreadPool& BaseModule::trailSamplingPool() {
+    ghoul_assert(_trailSamplingPool, "BaseModule has not been initialized");
+    return *_trailSamplingPool;
+}
+
 std::vector<documentation::Documentation> BaseModule::documentations() const {
     return {
         DashboardItemAngle::Documentation(),
@@ -27,7 +27,9 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <openspace/util/threadpool.h>
 #include <ghoul/opengl/programobjectmanager.h>
+#include <memory>
 
 namespace openspace {
 
@@ -43,9 +45,16 @@ public:
 
     static ghoul::opengl::ProgramObjectManager ProgramObjectManager;
 
+    /// Returns the thread pool on which the trails compute their positions
+    ThreadPool& trailSamplingPool();
+
 protected:
     void internalInitialize(const ghoul::Dictionary&) override;
+    void internalDeinitialize() override;
     void internalDeinitializeGL() override;
+
+private:
+    std::unique_ptr<ThreadPool> _trailSamplingPool;
 };
 
 } // namespace openspace
@@ -27,12 +27,15 @@
 #include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/performance/tracer.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/opengl/programobject.h>
+#include <chrono>
 
 namespace {
     constexpr const char* ProgramName = "EphemerisProgram";
@@ -425,4 +428,44 @@ void RenderableTrail::render(const RenderData& data, RendererTasks&) {
     _programObject->deactivate();
 }
 
+void RenderableTrail::requestSamples(std::vector<double> times) {
+    Translation::BatchSampler sampler = _translation->batchSampler();
+    if (!sampler) {
+        // Without a sampler, the Translation can only be evaluated on this thread
+        std::promise<std::vector<glm::dvec3>> promise;
+        _samples = promise.get_future();
+        promise.set_value(_translation->positions(times));
+        return;
+    }
+
+    // The task only holds on to the sampler and the times, so it can finish safely even
+    // if this trail has been destroyed in the meantime
+    using Task = std::packaged_task<std::vector<glm::dvec3>()>;
+    auto task = std::make_shared<Task>(
+        [sampler = std::move(sampler), times = std::move(times)]() {
+            TraceZone("RenderableTrail::sample");
+            return sampler(times);
+        }
+    );
+    _samples = task->get_future();
+    OsEng.moduleEngine().module<BaseModule>()->trailSamplingPool().enqueue(
+        [task]() { (*task)(); }
+    );
+}
+
+bool RenderableTrail::collectSamples(std::vector<glm::dvec3>& positions) {
+    if (!_samples.valid() ||
+        _samples.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return false;
+    }
+
+    positions = _samples.get();
+    return true;
+}
+
+bool RenderableTrail::hasPendingSamples() const {
+    return _samples.valid();
+}
+
 } // namespace openspace
@@ -35,6 +35,8 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <future>
+#include <vector>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -68,6 +70,8 @@ class Translation;
  * The positions for each point along the trail is provided through a Translation object,
  * the type of which is specified in the dictionary that is passed to the constructor. A
  * typical implementation of Translation used for the trail would be a SpiceTranslation.
+ * Large numbers of points are sampled through #requestSamples, which computes them on a
+ * worker thread if the Translation provides a Translation::BatchSampler.
  */
 class RenderableTrail : public Renderable {
 public:
@@ -142,6 +146,30 @@ protected:
     /// part of the trail
     RenderInformation _floatingRenderInformation;
 
+    /**
+     * Starts computing the positions of the #_translation at the provided \p times. If
+     * the Translation provides a Translation::BatchSampler, the positions are computed
+     * on a worker thread, otherwise they are computed before this function returns.
+     * Either way, the result is retrieved with #collectSamples. The result of a previous
+     * request that has not been collected yet is discarded.
+     *
+     * \param times The times in J2000 seconds at which the positions are computed
+     */
+    void requestSamples(std::vector<double> times);
+
+    /**
+     * Moves the positions of the last #requestSamples into \p positions if they are
+     * ready. This function does not block.
+     *
+     * \param positions The positions in the same order as the requested times
+     * \return \c true if the positions were ready, \c false otherwise
+     * \throw ghoul::RuntimeError If the Translation failed to compute the positions
+     */
+    bool collectSamples(std::vector<glm::dvec3>& positions);
+
+    /// Returns \c true if requested positions have not been collected yet
+    bool hasPendingSamples() const;
+
 private:
     /// Specifies the base color of the line before fading
     properties::Vec3Property _lineColor;
@@ -161,6 +189,9 @@ private:
 
     UniformCache(opacity, modelView, projection, color, useLineFade, lineFade,
         vertexSorting, idOffset, nVertices, stride, pointSize, renderPhase) _uniformCache;
+
+    /// The positions that are computed on a worker thread or were computed directly
+    std::future<std::vector<glm::dvec3>> _samples;
 };
 
 } // namespace openspace
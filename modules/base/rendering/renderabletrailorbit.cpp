@@ -322,11 +322,12 @@ void RenderableTrailOrbit::update(const UpdateData& data) {
 RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
                                                                    const UpdateData& data)
 {
-    if (_needsFullSweep) {
-        fullSweep(data.time.j2000Seconds());
-        return { false, true, UpdateReport::All } ;
+    if (_needsFullSweep && !hasPendingSamples()) {
+        requestFullSweep(data.time.j2000Seconds());
+    }
+    if (hasPendingSamples()) {
+        return finishFullSweep();
     }
-
 
     constexpr const double Epsilon = 1e-7;
     // When time stands still (at the iron hill), we don't need to perform any work
@@ -362,16 +363,25 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
         // If we would need to generate more new points than there are total points in the
         // array, it is faster to regenerate the entire array
         if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
+            requestFullSweep(data.time.j2000Seconds());
+            return finishFullSweep();
+        }
+
+        // Compute all new permanent points at once
+        std::vector<double> times(nNewPoints);
+        double t = _lastPointTime;
+        for (int i = 0; i < nNewPoints; ++i) {
+            t += secondsPerPoint;
+            times[i] = t;
         }
+        const std::vector<glm::dvec3> positions = _translation->positions(times);
 
         for (int i = 0; i < nNewPoints; ++i) {
             _lastPointTime += secondsPerPoint;
 
             // Get the new permanent point and write it into the (previously) floating
             // location
-            const glm::vec3 p = _translation->position(_lastPointTime);
+            const glm::vec3 p = positions[i];
             _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
 
             // Move the current pointer back one step to be used as the new floating
@@ -397,16 +407,25 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
         // If we would need to generate more new points than there are total points in the
         // array, it is faster to regenerate the entire array
         if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
+            requestFullSweep(data.time.j2000Seconds());
+            return finishFullSweep();
         }
 
+        // Compute all new permanent points at once
+        std::vector<double> times(nNewPoints);
+        double t = _firstPointTime;
+        for (int i = 0; i < nNewPoints; ++i) {
+            t -= secondsPerPoint;
+            times[i] = t;
+        }
+        const std::vector<glm::dvec3> positions = _translation->positions(times);
+
         for (int i = 0; i < nNewPoints; ++i) {
             _firstPointTime -= secondsPerPoint;
 
             // Get the new permanent point and write it into the (previously) floating
             // location
-            const glm::vec3 p = _translation->position(_firstPointTime);
+            const glm::vec3 p = positions[i];
             _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
 
             // if we are on the upper bounds of the array, we start at 0
@@ -428,36 +447,59 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
     }
 }
 
-void RenderableTrailOrbit::fullSweep(double time) {
+void RenderableTrailOrbit::requestFullSweep(double time) {
+    _sweepTime = time;
+    _sweepSecondsPerPoint = _period / (_resolution - 1);
+
+    // The first position is a floating current one, so it is not sampled here
+    std::vector<double> times(_resolution - 1);
+    for (int i = 0; i < _resolution - 1; ++i) {
+        times[i] = time - i * _sweepSecondsPerPoint;
+    }
+    requestSamples(std::move(times));
+
+    _needsFullSweep = false;
+}
+
+RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::finishFullSweep() {
+    std::vector<glm::dvec3> positions;
+    if (!collectSamples(positions)) {
+        // The previous trail is kept until the new positions are ready, but its floating
+        // point keeps following the object
+        return { !_vertexArray.empty(), false, 0 };
+    }
+
+    // The resolution might have changed since the sweep was requested, in which case
+    // _needsFullSweep is set and the next update requests another sweep
+    const int resolution = static_cast<int>(positions.size()) + 1;
+
     // Reserve the space for the vertices
     _vertexArray.clear();
-    _vertexArray.resize(_resolution);
+    _vertexArray.resize(resolution);
 
     // The index buffer stays constant until we change the size of the array
-    if (_indexBufferDirty) {
-        // Create the index buffer and fill it with two ranges for [0, _resolution)
+    if (_indexArray.size() != static_cast<size_t>(resolution) * 2) {
+        // Create the index buffer and fill it with two ranges for [0, resolution)
         _indexArray.clear();
-        _indexArray.resize(_resolution * 2);
-        std::iota(_indexArray.begin(), _indexArray.begin() + _resolution, 0);
-        std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
+        _indexArray.resize(resolution * 2);
+        std::iota(_indexArray.begin(), _indexArray.begin() + resolution, 0);
+        std::iota(_indexArray.begin() + resolution, _indexArray.end(), 0);
+        _indexBufferDirty = true;
     }
 
-    _lastPointTime = time;
-
-    const double secondsPerPoint = _period / (_resolution - 1);
     // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; ++i) {
-        const glm::vec3 p = _translation->position(time);
+    for (int i = 1; i < resolution; ++i) {
+        const glm::vec3 p = positions[i - 1];
         _vertexArray[i] = { p.x, p.y, p.z };
-
-        time -= secondsPerPoint;
     }
 
     _primaryRenderInformation.first = 0;
-    _primaryRenderInformation.count = _resolution;
+    _primaryRenderInformation.count = resolution;
 
-    _firstPointTime = time + secondsPerPoint;
-    _needsFullSweep = false;
+    _lastPointTime = _sweepTime;
+    _firstPointTime = _sweepTime - (resolution - 2) * _sweepSecondsPerPoint;
+
+    return { false, true, UpdateReport::All };
 }
 
 } // namespace openspace
@@ -43,6 +43,8 @@ namespace documentation { struct Documentation; }
  * are rendered. Each of these fixed points are fixed time steps apart, where as the most
  * current point is floating and updated every frame. The _period determines the length of
  * the trail (the distance between the newest and oldest point being _period days).
+ * If all points have to be recomputed, for example after a time jump, the previous trail
+ * is shown until the new points have been computed in the background.
  */
 class RenderableTrailOrbit : public RenderableTrail {
 public:
@@ -55,13 +57,7 @@ public:
 
     static documentation::Documentation Documentation();
 
-private:
-    /**
-     * Performs a full sweep of the orbit and fills the entire vertex buffer object.
-     * \param time The current time up to which the full sweep should be performed
-     */
-    void fullSweep(double time);
-
+protected:
     /// This structure is returned from the #updateTrails method and gives information
     /// about which parts of the vertex array to update
     struct UpdateReport {
@@ -84,6 +80,22 @@ private:
      */
     UpdateReport updateTrails(const UpdateData& data);
 
+    /**
+     * Requests the positions for a full sweep of the orbit, which are computed on a
+     * worker thread if the Translation supports it.
+     * \param time The current time up to which the full sweep should be performed
+     */
+    void requestFullSweep(double time);
+
+    /**
+     * Fills the entire vertex buffer object with the positions of the last full sweep
+     * once they are ready. Until then, the permanent points of the previous trail are
+     * left unchanged and only its floating point follows the object.
+     * \return The UpdateReport describing whether the full sweep has been applied
+     */
+    UpdateReport finishFullSweep();
+
+private:
     /// The orbital period of the RenderableTrail in days
     properties::DoubleProperty _period;
     /// The number of points that should be sampled between _period and now
@@ -102,6 +114,11 @@ private:
     double _lastPointTime = 0.0;
     /// The time stamp of when the last valid trail was generated.
     double _previousTime = 0.0;
+
+    /// The time up to which the requested full sweep is performed
+    double _sweepTime = 0.0;
+    /// The time between two fixed points of the requested full sweep
+    double _sweepSecondsPerPoint = 0.0;
 };
 
 } // namespace openspace
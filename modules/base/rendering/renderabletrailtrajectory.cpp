@@ -208,23 +208,39 @@ void RenderableTrailTrajectory::deinitializeGL() {
 }
 
 void RenderableTrailTrajectory::update(const UpdateData& data) {
-    if (_needsFullSweep) {
+    if (_needsFullSweep && !hasPendingSamples()) {
         // Convert the start and end time from string representations to J2000 seconds
-        _start = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
-        _end = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
+        _sweepStart = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
+        _sweepEnd = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
 
         const double totalSampleInterval = _sampleInterval / _timeStampSubsamplingFactor;
         // How many values do we need to compute given the distance between the start and
         // end date and the desired sample interval
-        const int nValues = static_cast<int>((_end - _start) / totalSampleInterval);
+        const int nValues = static_cast<int>(
+            (_sweepEnd - _sweepStart) / totalSampleInterval
+        );
+
+        std::vector<double> times(nValues);
+        for (int i = 0; i < nValues; ++i) {
+            times[i] = _sweepStart + i * totalSampleInterval;
+        }
+        requestSamples(std::move(times));
+        _needsFullSweep = false;
+    }
+
+    // The previous trail is rendered until the new positions have arrived
+    std::vector<glm::dvec3> positions;
+    if (collectSamples(positions)) {
+        _start = _sweepStart;
+        _end = _sweepEnd;
 
         // Make space for the vertices
         _vertexArray.clear();
-        _vertexArray.resize(nValues);
+        _vertexArray.resize(positions.size());
 
         // ... fill all of the values
-        for (int i = 0; i < nValues; ++i) {
-            const glm::vec3 p = _translation->position(_start + i * totalSampleInterval);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const glm::vec3 p = positions[i];
             _vertexArray[i] = { p.x, p.y, p.z };
         }
 
@@ -246,7 +262,13 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
         _indexArray.clear();
 
         _subsamplingIsDirty = true;
-        _needsFullSweep = false;
+    }
+
+    if (_vertexArray.empty()) {
+        // Nothing has been sampled yet
+        _primaryRenderInformation.count = 0;
+        _floatingRenderInformation.count = 0;
+        return;
     }
 
     // This has to be done every update step;
@@ -46,7 +46,7 @@ namespace documentation { struct Documentation; }
  * rendered from the past to the current simulation time, not showing any part of the
  * trail in the future. If _renderFullTrail is false, the current position of the object
  * has to be updated constantly to make the trail connect to the object that has the
- * trail.
+ * trail. While the trail is resampled in the background, the previous trail is rendered.
  */
 class RenderableTrailTrajectory : public RenderableTrail {
 public:
@@ -84,6 +84,11 @@ private:
     double _start = 0.0;
     /// The conversion of the _endTime into the internal time format
     double _end = 0.0;
+
+    /// The start time of the requested, but not yet applied, full sweep
+    double _sweepStart = 0.0;
+    /// The end time of the requested, but not yet applied, full sweep
+    double _sweepEnd = 0.0;
 };
 
 } // namespace openspace
@@ -550,6 +550,12 @@ glm::dmat3 FixedRotation::matrix(const Time&) const {
     }
 }
 
+bool FixedRotation::supportsParallelUpdate() const {
+    // The axes can be defined by the world positions of other scene graph nodes, which
+    // might be updated concurrently
+    return false;
+}
+
 glm::vec3 FixedRotation::xAxis() const {
     switch (_xAxis.type) {
         case Axis::Type::Unspecified:
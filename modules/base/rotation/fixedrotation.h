@@ -49,6 +49,7 @@ public:
     static documentation::Documentation Documentation();
 
     glm::dmat3 matrix(const Time& time) const override;
+    bool supportsParallelUpdate() const override;
 
 private:
     glm::vec3 xAxis() const;
@@ -28,9 +28,11 @@
 #include <modules/digitaluniverse/rendering/renderabledumeshes.h>
 #include <modules/digitaluniverse/rendering/renderableplanescloud.h>
 #include <modules/digitaluniverse/rendering/renderablepoints.h>
+#include <modules/digitaluniverse/tasks/convertspecktask.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -50,6 +52,10 @@ void DigitalUniverseModule::internalInitialize(const ghoul::Dictionary&) {
     fRenderable->registerClass<RenderableBillboardsCloud>("RenderableBillboardsCloud");
     fRenderable->registerClass<RenderablePlanesCloud>("RenderablePlanesCloud");
     fRenderable->registerClass<RenderableDUMeshes>("RenderableDUMeshes");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<ConvertSpeckTask>("ConvertSpeckTask");
 }
 
 void DigitalUniverseModule::internalDeinitializeGL() {
@@ -61,7 +67,8 @@ std::vector<documentation::Documentation> DigitalUniverseModule::documentations(
         RenderablePoints::Documentation(),
         RenderableBillboardsCloud::Documentation(),
         RenderablePlanesCloud::Documentation(),
-        RenderableDUMeshes::Documentation()
+        RenderableDUMeshes::Documentation(),
+        ConvertSpeckTask::documentation()
     };
 }
 
@@ -25,13 +25,13 @@
 #include <modules/digitaluniverse/rendering/renderablebillboardscloud.h>
 
 #include <modules/digitaluniverse/digitaluniversemodule.h>
+#include <modules/digitaluniverse/speckfile.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/rendering/renderengine.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
@@ -44,10 +44,9 @@
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/string_cast.hpp>
+#include <algorithm>
 #include <array>
-#include <fstream>
 #include <stdint.h>
-#include <locale>
 #include <string>
 
 namespace {
@@ -66,7 +65,6 @@ namespace {
     constexpr const char* GigaparsecUnit    = "Gpc";
     constexpr const char* GigalightyearUnit = "Gly";
 
-    constexpr int8_t CurrentCacheVersion = 1;
     constexpr double PARSEC = 0.308567756E17;
 
     const openspace::properties::Property::PropertyInfo SpriteTextureInfo = {
@@ -510,7 +508,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
             }
         }
         _colorOption.onChange([&] {
-            _dataIsDirty = true;
+            _colorVariableIsDirty = true;
             _colorOptionString = _optionConversionMap[_colorOption.value()];
         });
         addProperty(_colorOption);
@@ -714,6 +712,12 @@ void RenderableBillboardsCloud::initializeGL() {
     _uniformCache.enabledRectSizeControl = _program->uniformLocation(
         "enabledRectSizeControl"
     );
+    _uniformCache.transformationMatrix = _program->uniformLocation(
+        "transformationMatrix"
+    );
+    _uniformCache.unit = _program->uniformLocation("unit");
+    _uniformCache.colorMapTexture = _program->uniformLocation("colorMapTexture");
+    _uniformCache.colorRange = _program->uniformLocation("colorRange");
 
     if (_hasPolygon) {
         createPolygonTexture();
@@ -737,6 +741,8 @@ void RenderableBillboardsCloud::deinitializeGL() {
     _vbo = 0;
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
+    glDeleteTextures(1, &_colorMapTexture);
+    _colorMapTexture = 0;
 
     DigitalUniverseModule::ProgramObjectManager.releaseProgramObject(
         ProgramObjectName,
@@ -847,7 +853,22 @@ void RenderableBillboardsCloud::renderBillboards(const RenderData& data,
         _program->setUniform(_uniformCache.hasPolygon, _hasPolygon);
     }
 
+    _program->setUniform(_uniformCache.transformationMatrix, _transformationMatrix);
+    _program->setUniform(_uniformCache.unit, static_cast<float>(_unit));
+
     _program->setUniform(_uniformCache.hasColormap, _hasColorMapFile);
+    ghoul::opengl::TextureUnit colorMapTextureUnit;
+    if (_hasColorMapFile) {
+        colorMapTextureUnit.activate();
+        glBindTexture(GL_TEXTURE_1D, _colorMapTexture);
+        _program->setUniform(_uniformCache.colorMapTexture, colorMapTextureUnit);
+
+        const size_t option = static_cast<size_t>(_colorOption.value());
+        const glm::vec2 colorRange = option < _colorRangeData.size() ?
+            _colorRangeData[option] :
+            glm::vec2(0.f);
+        _program->setUniform(_uniformCache.colorRange, colorRange);
+    }
 
     glBindVertexArray(_vao);
     const GLsizei nAstronomicalObjects = static_cast<GLsizei>(_fullData.size() /
@@ -1015,73 +1036,15 @@ void RenderableBillboardsCloud::render(const RenderData& data, RendererTasks&) {
 
 void RenderableBillboardsCloud::update(const UpdateData&) {
     if (_dataIsDirty && _hasSpeckFile) {
-        LDEBUG("Regenerating data");
-
-        createDataSlice();
-
-        int size = static_cast<int>(_slicedData.size());
-
-        if (_vao == 0) {
-            glGenVertexArrays(1, &_vao);
-            LDEBUG(fmt::format("Generating Vertex Array id '{}'", _vao));
-        }
-        if (_vbo == 0) {
-            glGenBuffers(1, &_vbo);
-            LDEBUG(fmt::format("Generating Vertex Buffer Object id '{}'", _vbo));
-        }
-
-        glBindVertexArray(_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            size * sizeof(float),
-            &_slicedData[0],
-            GL_STATIC_DRAW
-        );
-        GLint positionAttrib = _program->attributeLocation("in_position");
-
-        if (_hasColorMapFile) {
-            /*const size_t nAstronomicalObjects = _fullData.size() /
-            _nValuesPerAstronomicalObject;
-            const size_t nValues = _slicedData.size() / nAstronomicalObjects;
-            GLsizei stride = static_cast<GLsizei>(sizeof(float) * nValues);*/
-
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                sizeof(float) * 8,
-                nullptr
-            );
-
-            GLint colorMapAttrib = _program->attributeLocation("in_colormap");
-            glEnableVertexAttribArray(colorMapAttrib);
-            glVertexAttribPointer(
-                colorMapAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                sizeof(float) * 8,
-                reinterpret_cast<void*>(sizeof(float) * 4)
-            );
-        }
-        else {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                0,
-                nullptr
-            );
-        }
-
-        glBindVertexArray(0);
-
+        LDEBUG("Uploading data");
+        uploadData();
         _dataIsDirty = false;
+        _colorVariableIsDirty = true;
+    }
+
+    if (_colorVariableIsDirty && _hasSpeckFile && _hasColorMapFile) {
+        selectColorVariable();
+        _colorVariableIsDirty = false;
     }
 
     if (_hasSpriteTexture && _spriteTextureIsDirty) {
@@ -1126,7 +1089,7 @@ bool RenderableBillboardsCloud::loadData() {
         if (!_hasSpeckFile) {
             success = true;
         }
-        success &= readColorMapFile();
+        success &= loadColorMapData();
     }
 
     success &= loadLabelData();
@@ -1135,486 +1098,149 @@ bool RenderableBillboardsCloud::loadData() {
 }
 
 bool RenderableBillboardsCloud::loadSpeckData() {
-    bool success = true;
-    if (_hasSpeckFile) {
-        const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
-            ghoul::filesystem::File(_speckFile),
-            "RenderableDUMeshes|" + identifier(),
-            ghoul::filesystem::CacheManager::Persistent::Yes
-        );
-
-        const bool hasCachedFile = FileSys.fileExists(cachedFile);
-        if (hasCachedFile) {
-            LINFO(fmt::format(
-                "Cached file '{}' used for Speck file '{}'",
-                cachedFile, _speckFile
-            ));
-
-            success = loadCachedFile(cachedFile);
-            if (success) {
-                return true;
-            }
-            else {
-                FileSys.cacheManager()->removeCacheFile(_speckFile);
-                // Intentional fall-through to the 'else' to generate the cache
-                // file for the next run
-            }
-        }
-        else {
-            LINFO(fmt::format("Cache for Speck file '{}' not found", _speckFile));
-        }
-        LINFO(fmt::format("Loading Speck file '{}'", _speckFile));
-
-        success = readSpeckFile();
-        if (!success) {
-            return false;
-        }
-
-        success &= saveCachedFile(cachedFile);
+    if (!_hasSpeckFile) {
+        return true;
     }
-    return success;
-}
-
-bool RenderableBillboardsCloud::loadLabelData() {
-    bool success = true;
-    if (!_labelFile.empty()) {
-        // I disabled the cache as it didn't work on Mac --- abock
-        const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
-            ghoul::filesystem::File(_labelFile),
-            ghoul::filesystem::CacheManager::Persistent::Yes
-        );
-        if (!_hasSpeckFile && !_hasColorMapFile) {
-            success = true;
-        }
-        const bool hasCachedFile = FileSys.fileExists(cachedFile);
-        if (hasCachedFile) {
-            LINFO(fmt::format(
-                "Cached file '{}' used for Label file '{}'",
-                cachedFile, _labelFile
-            ));
 
-            success &= loadCachedFile(cachedFile);
-            if (!success) {
-                FileSys.cacheManager()->removeCacheFile(_labelFile);
-                // Intentional fall-through to the 'else' to generate the cache
-                // file for the next run
-            }
-        }
-        else {
-            LINFO(fmt::format("Cache for Label file '{}' not found", _labelFile));
-            LINFO(fmt::format("Loading Label file '{}'", _labelFile));
-
-            success &= readLabelFile();
-            if (!success) {
-                return false;
-            }
-        }
-    }
-
-    return success;
-}
-
-bool RenderableBillboardsCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
+    speck::Dataset dataset;
+    if (!speck::loadFile(_speckFile, dataset)) {
         return false;
     }
-
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject });
-
-            // We want the number, but the index is 0 based
-            _nValuesPerAstronomicalObject += 1;
-        }
+    _nValuesPerAstronomicalObject = dataset.valuesPerEntry;
+    _fullData = std::move(dataset.entries);
+    for (const speck::Dataset::Variable& variable : dataset.variables) {
+        _variableDataPositionMap.insert({ variable.name, variable.index });
     }
-
-    _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-        }
-
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
-
     return true;
 }
 
-bool RenderableBillboardsCloud::readColorMapFile() {
-    std::string _file = _colorMapFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Color Map file '{}'", _file));
+bool RenderableBillboardsCloud::loadColorMapData() {
+    speck::Dataset dataset;
+    if (!speck::loadFile(_colorMapFile, dataset)) {
         return false;
     }
-
-    std::size_t numberOfColors = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        // std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        // Initial number of colors
-        std::locale loc;
-        if (std::isdigit(line[0], loc)) {
-            std::string::size_type sz;
-            numberOfColors = std::stoi(line, &sz);
-            break;
-        }
-        else if (file.eof()) {
-            return false;
-        }
-    }
-
-    for (size_t i = 0; i < numberOfColors; ++i) {
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        glm::vec4 color;
-        for (int j = 0; j < 4; ++j) {
-            str >> color[j];
-        }
-
-        _colorMapData.push_back(color);
-    }
-
+    _colorMapData = std::move(dataset.colorMap);
     return true;
 }
 
-bool RenderableBillboardsCloud::readLabelFile() {
-    std::string _file = _labelFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _file));
-        return false;
+bool RenderableBillboardsCloud::loadLabelData() {
+    if (_labelFile.empty()) {
+        return true;
     }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
+    speck::Dataset dataset;
+    if (!speck::loadFile(_labelFile, dataset)) {
+        return false;
     }
-
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (auto j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            if (dummy == "#") {
-                break;
-            }
-
-            label += " " + dummy;
-            dummy.clear();
-        }
-
-        glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
+    for (size_t i = 0; i < dataset.labelTexts.size(); ++i) {
+        const glm::vec3 transformedPos = glm::vec3(
+            _transformationMatrix * glm::dvec4(dataset.labelPositions[i], 1.0)
         );
-        _labelData.push_back(std::make_pair(transformedPos, label));
-    } while (!file.eof());
-
+        _labelData.emplace_back(transformedPos, std::move(dataset.labelTexts[i]));
+    }
     return true;
 }
 
-bool RenderableBillboardsCloud::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
-
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(
-            reinterpret_cast<char*>(&_nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
-
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
-
-        if (_hasColorMapFile) {
-            int32_t nItems = 0;
-            fileStream.read(reinterpret_cast<char*>(&nItems), sizeof(int32_t));
-
-            for (int i = 0; i < nItems; ++i) {
-                int32_t keySize = 0;
-                fileStream.read(reinterpret_cast<char*>(&keySize), sizeof(int32_t));
-                std::string key;
-                for (int c = 0; c < keySize; ++c) {
-                    char t;
-                    fileStream.read(&t, sizeof(char));
-                    key.append(1, t);
-                }
-                int32_t value = 0;
-                fileStream.read(reinterpret_cast<char*>(&value), sizeof(int32_t));
-
-                _variableDataPositionMap.insert({ key, value });
-            }
-        }
-
-        bool success = fileStream.good();
-        return success;
+void RenderableBillboardsCloud::uploadData() {
+    if (_vao == 0) {
+        glGenVertexArrays(1, &_vao);
+        LDEBUG(fmt::format("Generating Vertex Array id '{}'", _vao));
     }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
+    if (_vbo == 0) {
+        glGenBuffers(1, &_vbo);
+        LDEBUG(fmt::format("Generating Vertex Buffer Object id '{}'", _vbo));
     }
-}
-
-bool RenderableBillboardsCloud::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
 
-        int32_t nValues = static_cast<int32_t>(_fullData.size());
-        if (nValues == 0) {
-            LERROR("Error writing cache: No values were loaded");
-            return false;
-        }
-        fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-        int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-            _nValuesPerAstronomicalObject
-            );
-        fileStream.write(
-            reinterpret_cast<const char*>(&nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
-
-        size_t nBytes = nValues * sizeof(_fullData[0]);
-        fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-        if (_hasColorMapFile) {
-            int32_t nItems = static_cast<int32_t>(_variableDataPositionMap.size());
-            fileStream.write(reinterpret_cast<const char*>(&nItems), sizeof(int32_t));
-
-            for (auto pair : _variableDataPositionMap) {
-                int32_t keySize = static_cast<int32_t>(pair.first.size());
-                fileStream.write(
-                    reinterpret_cast<const char*>(&keySize),
-                    sizeof(int32_t)
-                );
-                for (size_t c = 0; c < pair.first.size(); ++c) {
-                    char keyChar = static_cast<int32_t>(pair.first[c]);
-                    fileStream.write(&keyChar, sizeof(char));
-                }
-                int32_t value = static_cast<int32_t>(pair.second);
-                fileStream.write(reinterpret_cast<const char*>(&value), sizeof(int32_t));
-            }
-        }
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
-    }
-}
+    // All columns of the dataset are uploaded once. The transformation, the unit and
+    // the color map lookup are applied in the shaders, so neither changing the color
+    // variable nor the color range requires touching this buffer again
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _fullData.size() * sizeof(float),
+        _fullData.data(),
+        GL_STATIC_DRAW
+    );
 
-void RenderableBillboardsCloud::createDataSlice() {
-    _slicedData.clear();
-    if (_hasColorMapFile) {
-        _slicedData.reserve(8 * (_fullData.size() / _nValuesPerAstronomicalObject));
-    }
-    else {
-        _slicedData.reserve(4 * (_fullData.size() / _nValuesPerAstronomicalObject));
-    }
+    GLint positionAttrib = _program->attributeLocation("in_position");
+    glEnableVertexAttribArray(positionAttrib);
+    glVertexAttribPointer(
+        positionAttrib,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        static_cast<GLsizei>(sizeof(float) * _nValuesPerAstronomicalObject),
+        nullptr
+    );
+    glBindVertexArray(0);
 
-    // Generate the color bins for the colomap
-    int colorMapInUse = 0;
-    std::vector<float> colorBins;
     if (_hasColorMapFile) {
-        colorMapInUse = _variableDataPositionMap[_colorOptionString];
-        glm::vec2 currentColorRange = _colorRangeData[_colorOption.value()];
-        float colorMapBinSize = (currentColorRange.y - currentColorRange.x) /
-            static_cast<float>(_colorMapData.size());
-        float bin = colorMapBinSize;
-        for (size_t i = 0; i < _colorMapData.size(); ++i) {
-            colorBins.push_back(bin);
-            bin += colorMapBinSize;
+        if (_colorMapTexture == 0) {
+            glGenTextures(1, &_colorMapTexture);
         }
+        glBindTexture(GL_TEXTURE_1D, _colorMapTexture);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexImage1D(
+            GL_TEXTURE_1D,
+            0,
+            GL_RGBA32F,
+            static_cast<GLsizei>(_colorMapData.size()),
+            0,
+            GL_RGBA,
+            GL_FLOAT,
+            _colorMapData.data()
+        );
+        glBindTexture(GL_TEXTURE_1D, 0);
     }
 
-    float biggestCoord = -1.0f;
+    float biggestCoord = -1.f;
     for (size_t i = 0; i < _fullData.size(); i += _nValuesPerAstronomicalObject) {
-        glm::dvec4 transformedPos = _transformationMatrix * glm::dvec4(
+        const glm::dvec4 transformedPos = _transformationMatrix * glm::dvec4(
             _fullData[i + 0],
             _fullData[i + 1],
             _fullData[i + 2],
             1.0
         );
-        glm::vec4 position(glm::vec3(transformedPos), static_cast<float>(_unit));
-
-        if (_hasColorMapFile) {
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(position[j]);
-                biggestCoord = biggestCoord < position[j] ? position[j] : biggestCoord;
-            }
-            // Finds from which bin to get the color.
-            // Note: the first color in the colormap file
-            // is the outliers color.
-            glm::vec4 itemColor;
-            float variableColor = _fullData[i + 3 + colorMapInUse];
-            int c = static_cast<int>(colorBins.size() - 1);
-            while (variableColor < colorBins[c]) {
-                --c;
-                if (c == 0)
-                    break;
-            }
-
-            int colorIndex =
-                c == static_cast<int>(colorBins.size() - 1) ?
-                0 :
-                c + 1;
+        const glm::vec3 position = glm::vec3(transformedPos);
+        biggestCoord = std::max(
+            { biggestCoord, position.x, position.y, position.z }
+        );
+    }
+    _fadeInDistance.setMaxValue(glm::vec2(10.f * biggestCoord));
+}
 
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(_colorMapData[colorIndex][j]);
-            }
-        }
-        else {
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(position[j]);
-            }
-        }
+void RenderableBillboardsCloud::selectColorVariable() {
+    // Selecting a different color variable only points the color attribute at another
+    // column of the already uploaded buffer. Unknown variables fall back to the first
+    // data column, which follows the x, y, z position
+    int column = 3;
+    auto it = _variableDataPositionMap.find(_colorOptionString);
+    if (it != _variableDataPositionMap.end()) {
+        column = it->second;
+    }
+    else if (!_colorOptionString.empty()) {
+        LERROR(fmt::format(
+            "Color variable '{}' does not exist in '{}'",
+            _colorOptionString, _speckFile
+        ));
     }
-    _fadeInDistance.setMaxValue(glm::vec2(10.0f * biggestCoord));
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GLint colorValueAttrib = _program->attributeLocation("in_colorValue");
+    glEnableVertexAttribArray(colorValueAttrib);
+    glVertexAttribPointer(
+        colorValueAttrib,
+        1,
+        GL_FLOAT,
+        GL_FALSE,
+        static_cast<GLsizei>(sizeof(float) * _nValuesPerAstronomicalObject),
+        reinterpret_cast<void*>(sizeof(float) * column)
+    );
+    glBindVertexArray(0);
 }
 
 void RenderableBillboardsCloud::createPolygonTexture() {
@@ -2137,7 +1763,7 @@ void RenderableBillboardsCloud::renderPolygonGeometry(GLuint vao) {
 //                // Note: the first color in the colormap file
 //                // is the outliers color.
 //                glm::vec4 itemColor;
-//                float variableColor = _fullData[i + 3 + colorMapInUse];
+//                float variableColor = _fullData[i + colorMapInUse];
 //                int c = static_cast<int>(colorBins.size() - 1);
 //                while (variableColor < colorBins[c]) {
 //                    --c;
@@ -2201,7 +1827,7 @@ void RenderableBillboardsCloud::renderPolygonGeometry(GLuint vao) {
 //            // Finds from which bin to get the color.
 //            // Note: the first color in the colormap file
 //            // is the outliers color.
-//            const float variableColor = _fullData[i + 3 + colorMapInUse];
+//            const float variableColor = _fullData[i + colorMapInUse];
 //            int c = static_cast<int>(colorBins.size() - 1);
 //            while (variableColor < colorBins[c]) {
 //                --c;
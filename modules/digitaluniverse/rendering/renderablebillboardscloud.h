@@ -77,7 +77,8 @@ private:
         GigalightYears = 6
     };
 
-    void createDataSlice();
+    void uploadData();
+    void selectColorVariable();
     void createPolygonTexture();
     void renderToTexture(GLuint textureToRenderTo, GLuint textureWidth,
         GLuint textureHeight);
@@ -90,15 +91,12 @@ private:
 
     bool loadData();
     bool loadSpeckData();
+    bool loadColorMapData();
     bool loadLabelData();
-    bool readSpeckFile();
-    bool readColorMapFile();
-    bool readLabelFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
 
     bool _hasSpeckFile = false;
     bool _dataIsDirty = true;
+    bool _colorVariableIsDirty = true;
     bool _textColorIsDirty = true;
     bool _hasSpriteTexture = false;
     bool _spriteTextureIsDirty = true;
@@ -144,7 +142,8 @@ private:
         renderOption, minBillboardSize, maxBillboardSize, correctionSizeEndDistance,
         correctionSizeFactor, color, sides, alphaValue, scaleFactor, up, right,
         fadeInValue, screenSize, spriteTexture, polygonTexture, hasPolygon,
-        hasColormap, enabledRectSizeControl
+        hasColormap, enabledRectSizeControl, transformationMatrix, unit, colorMapTexture,
+        colorRange
     ) _uniformCache;
     std::shared_ptr<ghoul::fontrendering::Font> _font;
 
@@ -155,7 +154,6 @@ private:
 
     Unit _unit = Parsec;
 
-    std::vector<float> _slicedData;
     std::vector<float> _fullData;
     std::vector<glm::vec4> _colorMapData;
     std::vector<std::pair<glm::vec3, std::string>> _labelData;
@@ -169,6 +167,7 @@ private:
 
     GLuint _vao = 0;
     GLuint _vbo = 0;
+    GLuint _colorMapTexture = 0;
 
     // For polygons
     GLuint _polygonVao = 0;
@@ -25,6 +25,7 @@
 #include <modules/digitaluniverse/rendering/renderabledumeshes.h>
 
 #include <modules/digitaluniverse/digitaluniversemodule.h>
+#include <modules/digitaluniverse/speckfile.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
@@ -42,7 +43,6 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <array>
-#include <fstream>
 #include <stdint.h>
 
 namespace {
@@ -60,7 +60,6 @@ namespace {
     constexpr const char* GigaparsecUnit    = "Gpc";
     constexpr const char* GigalightyearUnit = "Gly";
 
-    constexpr const int8_t CurrentCacheVersion = 1;
     constexpr const double PARSEC = 0.308567756E17;
 
     const openspace::properties::Property::PropertyInfo TransparencyInfo = {
@@ -632,352 +631,40 @@ void RenderableDUMeshes::update(const UpdateData&) {
 bool RenderableDUMeshes::loadData() {
     bool success = false;
     if (_hasSpeckFile) {
-        // I disabled the cache as it didn't work on Mac --- abock
-        // std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        //     _speckFile,
-        //     ghoul::filesystem::CacheManager::Persistent::Yes
-        // );
-
-        // bool hasCachedFile = FileSys.fileExists(cachedFile);
-        // if (hasCachedFile) {
-        //     LINFO(
-        //         "Cached file '" << cachedFile <<
-        //         "' used for Speck file '" << _speckFile << "'"
-        //     );
-
-        //     success = loadCachedFile(cachedFile);
-        //     if (!success) {
-        //         FileSys.cacheManager()->removeCacheFile(_speckFile);
-        //         // Intentional fall-through to the 'else' to generate the cache
-        //         // file for the next run
-        //     }
-        // }
-        // else
-        // {
-        //     LINFO("Cache for Speck file '" << _speckFile << "' not found");
-            LINFO(fmt::format("Loading Speck file '{}'", _speckFile));
-
-            success = readSpeckFile();
-            if (!success) {
-                return false;
-            }
-
-            // LINFO("Saving cache");
-            //success &= saveCachedFile(cachedFile);
-        // }
-    }
-
-    std::string labelFile = _labelFile;
-    if (!labelFile.empty()) {
-        // I disabled the cache as it didn't work on Mac --- abock
-        // std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        //     labelFile,
-        //     ghoul::filesystem::CacheManager::Persistent::Yes
-        // );
-        // bool hasCachedFile = FileSys.fileExists(cachedFile);
-        // if (hasCachedFile) {
-        //     LINFO(
-        //         "Cached file '" << cachedFile << "' used for Label file '" <<
-        //         labelFile << "'"
-        //     );
-
-        //     success &= loadCachedFile(cachedFile);
-        //     if (!success) {
-        //         FileSys.cacheManager()->removeCacheFile(labelFile);
-        //         // Intentional fall-through to the 'else' to generate the cache
-        //         // file for the next run
-        //     }
-        // }
-        // else {
-        //     LINFO("Cache for Label file '" << labelFile << "' not found");
-            LINFO(fmt::format("Loading Label file '{}'", labelFile));
-
-            success &= readLabelFile();
-            if (!success) {
-                return false;
-            }
-
-        // }
-    }
-
-    return success;
-}
-
-bool RenderableDUMeshes::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
-        return false;
-    }
-
-    int meshIndex = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (file.eof()) {
-            break;
-        }
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 4) != "mesh") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
+        speck::Dataset dataset;
+        if (!speck::loadFile(_speckFile, dataset)) {
+            return false;
         }
 
-        if (line.substr(0, 4) == "mesh") {
-            // mesh lines are structured as follows:
-            // mesh -t texnum -c colorindex -s style {
-            // where textnum is the index of the texture;
-            // colorindex is the index of the color for the mesh
-            // and style is solid, wire or point (for now we support only wire)
-            std::stringstream str(line);
-
+        int meshIndex = 0;
+        for (speck::Dataset::Mesh& m : dataset.meshes) {
             RenderingMesh mesh;
             mesh.meshIndex = meshIndex;
-
-            std::string dummy;
-            str >> dummy; // mesh command
-            dummy.clear();
-            str >> dummy; // texture index command?
-            do {
-                if (dummy == "-t") {
-                    dummy.clear();
-                    str >> mesh.textureIndex; // texture index
-                }
-                else if (dummy == "-c") {
-                    dummy.clear();
-                    str >> mesh.colorIndex; // color index command
-                }
-                else if (dummy == "-s") {
-                    dummy.clear();
-                    str >> dummy; // style value command
-                    if (dummy == "solid") {
-                        mesh.style = Solid;
-                    }
-                    else if (dummy == "wire") {
-                        mesh.style = Wire;
-                    }
-                    else if (dummy == "point") {
-                        mesh.style = Point;
-                    }
-                    else {
-                        mesh.style = INVALID;
-                        break;
-                    }
-                }
-                dummy.clear();
-                str >> dummy;
-            } while (dummy != "{");
-
-            std::getline(file, line);
-            std::stringstream dim(line);
-            dim >> mesh.numU; // numU
-            dim >> mesh.numV; // numV
-
-            // We can now read the vertices data:
-            for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
-                std::getline(file, line);
-                if (line.substr(0, 1) != "}") {
-                    std::stringstream lineData(line);
-                    for (int i = 0; i < 7; ++i) {
-                        GLfloat value;
-                        lineData >> value;
-                        bool errorReading = lineData.rdstate() & std::ifstream::failbit;
-                        if (!errorReading) {
-                            mesh.vertices.push_back(value);
-                        }
-                        else {
-                            break;
-                        }
-                    }
-                }
-                else {
-                    break;
-                }
-            }
-
-            std::getline(file, line);
-            if (line.substr(0, 1) == "}") {
-                _renderingMeshesMap.insert({ meshIndex++, mesh });
-            }
-            else {
-                return false;
-            }
+            mesh.colorIndex = m.colorIndex;
+            mesh.textureIndex = m.textureIndex;
+            mesh.numU = m.numU;
+            mesh.numV = m.numV;
+            mesh.style = static_cast<MeshType>(m.style);
+            mesh.vertices = std::move(m.vertices);
+            _renderingMeshesMap.insert({ meshIndex++, std::move(mesh) });
         }
+        success = true;
     }
 
-    return true;
-}
-
-bool RenderableDUMeshes::readLabelFile() {
-    std::ifstream file(_labelFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _labelFile));
-        return false;
-    }
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
-    }
-
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (int j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
-        glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
-        );
-        _labelData.push_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
-
-    return true;
-}
-
-bool RenderableDUMeshes::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
+    if (!_labelFile.empty()) {
+        speck::Dataset dataset;
+        if (!speck::loadFile(_labelFile, dataset)) {
             return false;
         }
-
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(
-            reinterpret_cast<char*>(&_nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
-
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
-    }
-}
-
-bool RenderableDUMeshes::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
-
-        const int32_t nValues = static_cast<int32_t>(_fullData.size());
-        if (nValues == 0) {
-            LERROR("Error writing cache: No values were loaded");
-            return false;
+        for (size_t i = 0; i < dataset.labelTexts.size(); ++i) {
+            const glm::vec3 transformedPos = glm::vec3(
+                _transformationMatrix * glm::dvec4(dataset.labelPositions[i], 1.0)
+            );
+            _labelData.emplace_back(transformedPos, std::move(dataset.labelTexts[i]));
         }
-        fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-        const int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-            _nValuesPerAstronomicalObject
-        );
-        fileStream.write(
-            reinterpret_cast<const char*>(&nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
-
-        const size_t nBytes = nValues * sizeof(_fullData[0]);
-        fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-        const bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
     }
+
+    return success;
 }
 
 void RenderableDUMeshes::createMeshes() {
@@ -108,10 +108,6 @@ private:
         const glm::vec3& orthoRight, const glm::vec3& orthoUp);
 
     bool loadData();
-    bool readSpeckFile();
-    bool readLabelFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
 
     bool _hasSpeckFile = false;
     bool _dataIsDirty = true;
@@ -143,9 +139,7 @@ private:
 
     Unit _unit = Parsec;
 
-    std::vector<float> _fullData;
     std::vector<std::pair<glm::vec3, std::string>> _labelData;
-    int _nValuesPerAstronomicalObject = 0;
 
     glm::dmat4 _transformationMatrix;
 
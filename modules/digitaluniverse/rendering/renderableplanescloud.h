@@ -99,10 +99,6 @@ private:
 
     bool loadData();
     bool loadTextures();
-    bool readSpeckFile();
-    bool readLabelFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
 
     bool _hasSpeckFile = false;
     bool _dataIsDirty = true;
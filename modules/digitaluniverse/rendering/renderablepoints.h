@@ -77,10 +77,6 @@ private:
     void createDataSlice();
 
     bool loadData();
-    bool readSpeckFile();
-    bool readColorMapFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
 
     bool _dataIsDirty = true;
     bool _hasSpriteTexture = false;
@@ -26,12 +26,34 @@
 
 #include "PowerScaling/powerScaling_vs.hglsl"
 
-in vec4 in_position;
-in vec4 in_colormap;
+in vec3 in_position;
+in float in_colorValue;
+
+uniform dmat4 transformationMatrix;
+uniform float unit;
+uniform bool hasColorMap;
+uniform sampler1D colorMapTexture;
+uniform vec2 colorRange;
 
 out vec4 colorMap;
 
 void main() {
-    colorMap = in_colormap;
-    gl_Position = vec4(in_position);
-}
\ No newline at end of file
+    if (hasColorMap) {
+        // The color range is split into one bin per color map entry. The first entry
+        // of the color map is used for outliers above the range
+        int nColors = textureSize(colorMapTexture, 0);
+        float binSize = (colorRange.y - colorRange.x) / float(nColors);
+
+        int colorIndex = 0;
+        if (in_colorValue < binSize * float(nColors)) {
+            colorIndex = min(max(int(floor(in_colorValue / binSize)), 1), nColors - 1);
+        }
+        colorMap = texelFetch(colorMapTexture, colorIndex, 0);
+    }
+    else {
+        colorMap = vec4(0.0);
+    }
+
+    dvec4 position = transformationMatrix * dvec4(in_position, 1.0);
+    gl_Position = vec4(vec3(position.xyz), unit);
+}
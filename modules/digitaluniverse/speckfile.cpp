@@ -0,0 +1,753 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/digitaluniverse/speckfile.h>
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* _loggerCat = "SpeckFile";
+
+    constexpr const char Magic[8] = { 'O', 'S', 'S', 'P', 'E', 'C', 'K', '\0' };
+    // Increase this version number whenever the layout of any section changes
+    constexpr const uint32_t CurrentVersion = 1;
+
+    enum class Section : uint32_t {
+        Variables = 1,
+        Textures = 2,
+        Entries = 3,
+        Labels = 4,
+        ColorMap = 5,
+        Meshes = 6
+    };
+
+    // Each section starts with its type and the size of its payload, which is padded to
+    // a multiple of 8 bytes. Readers skip sections whose type they do not know
+    struct SectionHeader {
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t size;
+    };
+    static_assert(sizeof(SectionHeader) == 16, "Wrong size of SectionHeader");
+
+    bool startsWith(const std::string& line, const char* keyword) {
+        return line.compare(0, strlen(keyword), keyword) == 0;
+    }
+
+    // Guard against wrong line endings (copying files from Windows to Mac) that cause
+    // lines to have a final \r
+    bool nextLine(std::istream& file, std::string& line) {
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    // Parses up to nValues floating point values from the line and writes them to
+    // result, which has to have room for nValues. Missing values are set to 0. Returns
+    // the number of values that were read
+    int parseValues(const std::string& line, int nValues, float* result) {
+        const char* p = line.c_str();
+        int i = 0;
+        for (; i < nValues; ++i) {
+            char* end = nullptr;
+            const float v = std::strtof(p, &end);
+            if (end == p) {
+                break;
+            }
+            result[i] = v;
+            p = end;
+        }
+        std::fill(result + i, result + nValues, 0.f);
+        return i;
+    }
+
+    // mesh lines are structured as follows:
+    // mesh -t texnum -c colorindex -s style {
+    // where textnum is the index of the texture; colorindex is the index of the color for
+    // the mesh and style is solid, wire or point. The next line contains numU and numV
+    // followed by numU * numV vertex lines and a closing }
+    bool readMesh(std::istream& file, const std::string& header,
+                  openspace::speck::Dataset::Mesh& mesh)
+    {
+        using Style = openspace::speck::Dataset::Mesh::Style;
+
+        std::stringstream str(header);
+        std::string token;
+        str >> token; // mesh command
+        while (str >> token && token != "{") {
+            if (token == "-t") {
+                str >> mesh.textureIndex;
+            }
+            else if (token == "-c") {
+                str >> mesh.colorIndex;
+            }
+            else if (token == "-s") {
+                str >> token;
+                if (token == "solid") {
+                    mesh.style = Style::Solid;
+                }
+                else if (token == "wire") {
+                    mesh.style = Style::Wire;
+                }
+                else if (token == "point") {
+                    mesh.style = Style::Point;
+                }
+                else {
+                    mesh.style = Style::Invalid;
+                }
+            }
+        }
+
+        std::string line;
+        if (!nextLine(file, line)) {
+            return false;
+        }
+        std::stringstream dim(line);
+        dim >> mesh.numU >> mesh.numV;
+
+        // Each vertex line contains the position and optionally texture coordinates
+        constexpr const int MaxValuesPerVertex = 7;
+        float values[MaxValuesPerVertex];
+        for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
+            if (!nextLine(file, line)) {
+                return false;
+            }
+            if (startsWith(line, "}")) {
+                return true;
+            }
+            const int n = parseValues(line, MaxValuesPerVertex, values);
+            mesh.vertices.insert(mesh.vertices.end(), values, values + n);
+        }
+
+        return nextLine(file, line) && startsWith(line, "}");
+    }
+
+    bool readSpeckFile(const std::string& path, openspace::speck::Dataset& dataset) {
+        std::ifstream file(path);
+        if (!file.good()) {
+            LERROR(fmt::format("Failed to open Speck file '{}'", path));
+            return false;
+        }
+
+        // The number of data values, which does not include x, y, z
+        int nValues = 0;
+
+        // The beginning of the speck file has a header that either contains comments
+        // (signaled by a preceding '#') or information about the structure of the file
+        // (signaled by the keywords 'datavar', 'texturevar', 'texture', and 'mesh')
+        std::string line;
+        bool isHeader = true;
+        while (nextLine(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            if (isHeader) {
+                std::stringstream str(line);
+                std::string command;
+                str >> command;
+
+                if (command == "datavar") {
+                    // datavar lines are structured as follows:
+                    // datavar # description
+                    // where # is the index of the data variable; so if we repeatedly
+                    // overwrite nValues with the latest index, we will end up with the
+                    // total number of values
+                    int index = 0;
+                    std::string name;
+                    str >> index >> name;
+                    // +3 because of the x, y and z at the beginning of each line
+                    dataset.variables.push_back({ index + 3, name });
+
+                    // Orientations are stored as two 3d vectors u and v
+                    const bool isOrientation = (name == "orientation" || name == "ori");
+                    nValues = index + (isOrientation ? 6 : 1);
+                }
+                else if (command == "polyorivar") {
+                    str >> dataset.orientationVariableIndex;
+                    dataset.orientationVariableIndex += 3;
+                }
+                else if (command == "texturevar") {
+                    str >> dataset.textureVariableIndex;
+                    dataset.textureVariableIndex += 3;
+                }
+                else if (command == "texture") {
+                    // texture [-option] index filename
+                    std::string token;
+                    str >> token;
+                    if (!token.empty() && token[0] == '-') {
+                        str >> token;
+                    }
+                    openspace::speck::Dataset::Texture texture;
+                    texture.index = std::atoi(token.c_str());
+                    str >> texture.file;
+                    dataset.textures.push_back(std::move(texture));
+                }
+                else if (command == "mesh") {
+                    openspace::speck::Dataset::Mesh mesh;
+                    if (!readMesh(file, line, mesh)) {
+                        LERROR(fmt::format("Error reading mesh in file '{}'", path));
+                        return false;
+                    }
+                    dataset.meshes.push_back(std::move(mesh));
+                }
+                else if (command == "maxcomment") {
+                    // Not used
+                }
+                else {
+                    // We read a line that doesn't belong to the header, so it is the
+                    // first entry
+                    isHeader = false;
+                    dataset.valuesPerEntry = nValues + 3;
+                }
+            }
+
+            if (!isHeader) {
+                const size_t offset = dataset.entries.size();
+                dataset.entries.resize(offset + dataset.valuesPerEntry);
+                parseValues(line, dataset.valuesPerEntry, &dataset.entries[offset]);
+            }
+        }
+
+        if (isHeader) {
+            // The file does not contain any entries
+            dataset.valuesPerEntry = nValues + 3;
+        }
+        return true;
+    }
+
+    bool readLabelFile(const std::string& path, openspace::speck::Dataset& dataset) {
+        std::ifstream file(path);
+        if (!file.good()) {
+            LERROR(fmt::format("Failed to open Label file '{}'", path));
+            return false;
+        }
+
+        // Label lines are structured as follows:
+        // x y z text label # comment
+        std::string line;
+        while (nextLine(file, line)) {
+            // TODO: handle cases of labels with different colors (textcolor)
+            if (line.empty() || line[0] == '#' || startsWith(line, "textcolor")) {
+                continue;
+            }
+
+            std::stringstream str(line);
+
+            glm::vec3 position;
+            str >> position.x >> position.y >> position.z;
+
+            std::string token;
+            str >> token; // text keyword
+
+            std::string label;
+            while (str >> token && token != "#") {
+                if (!label.empty()) {
+                    label += ' ';
+                }
+                label += token;
+            }
+
+            dataset.labelPositions.push_back(position);
+            dataset.labelTexts.push_back(std::move(label));
+        }
+
+        return true;
+    }
+
+    bool readColorMapFile(const std::string& path, openspace::speck::Dataset& dataset) {
+        std::ifstream file(path);
+        if (!file.good()) {
+            LERROR(fmt::format("Failed to open Color Map file '{}'", path));
+            return false;
+        }
+
+        // The color map starts with the number of colors after an optional header of
+        // comments, followed by one RGBA color per line
+        size_t nColors = 0;
+        std::string line;
+        while (true) {
+            if (!nextLine(file, line)) {
+                LERROR(fmt::format("Missing number of colors in '{}'", path));
+                return false;
+            }
+            if (!line.empty() && std::isdigit(static_cast<unsigned char>(line[0]))) {
+                nColors = std::stoul(line);
+                break;
+            }
+        }
+
+        dataset.colorMap.reserve(nColors);
+        for (size_t i = 0; i < nColors && nextLine(file, line); ++i) {
+            glm::vec4 color;
+            parseValues(line, 4, &color.x);
+            dataset.colorMap.push_back(color);
+        }
+
+        return true;
+    }
+
+    class BinaryWriter {
+    public:
+        template <typename T>
+        void write(const T& value) {
+            write(&value, sizeof(T));
+        }
+
+        void write(const void* data, size_t size) {
+            if (size == 0) {
+                return;
+            }
+            const char* p = reinterpret_cast<const char*>(data);
+            _buffer.insert(_buffer.end(), p, p + size);
+        }
+
+        void write(const std::string& s) {
+            write(static_cast<uint32_t>(s.size()));
+            write(s.data(), s.size());
+        }
+
+        size_t beginSection(Section section) {
+            write(SectionHeader{ static_cast<uint32_t>(section), 0, 0 });
+            return _buffer.size();
+        }
+
+        void endSection(size_t begin) {
+            _buffer.resize((_buffer.size() + 7) & ~size_t(7), 0);
+            const uint64_t size = _buffer.size() - begin;
+            overwrite(begin - sizeof(uint64_t), size);
+        }
+
+        template <typename T>
+        void overwrite(size_t offset, const T& value) {
+            std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+        }
+
+        size_t size() const {
+            return _buffer.size();
+        }
+
+        const std::vector<char>& buffer() const {
+            return _buffer;
+        }
+
+    private:
+        std::vector<char> _buffer;
+    };
+
+    // Reads values from a memory range and fails once the range is exhausted
+    class BinaryReader {
+    public:
+        BinaryReader(const char* data, size_t size) : _p(data), _end(data + size) {}
+
+        template <typename T>
+        T read() {
+            T value = T();
+            read(&value, sizeof(T));
+            return value;
+        }
+
+        void read(void* destination, size_t size) {
+            if (!has(size)) {
+                _isValid = false;
+                return;
+            }
+            if (size > 0) {
+                std::memcpy(destination, _p, size);
+            }
+            _p += size;
+        }
+
+        std::string readString() {
+            const uint32_t size = read<uint32_t>();
+            if (!has(size)) {
+                _isValid = false;
+                return std::string();
+            }
+            std::string s(_p, size);
+            _p += size;
+            return s;
+        }
+
+        template <typename T>
+        void readArray(std::vector<T>& result, uint64_t count) {
+            if (count > static_cast<uint64_t>(_end - _p) / sizeof(T)) {
+                _isValid = false;
+                return;
+            }
+            result.resize(count);
+            read(result.data(), count * sizeof(T));
+        }
+
+        void skip(uint64_t size) {
+            if (!has(size)) {
+                _isValid = false;
+                return;
+            }
+            _p += size;
+        }
+
+        bool has(uint64_t size) const {
+            return _isValid && size <= static_cast<uint64_t>(_end - _p);
+        }
+
+        const char* position() const {
+            return _p;
+        }
+
+        bool isValid() const {
+            return _isValid;
+        }
+
+    private:
+        const char* _p;
+        const char* _end;
+        bool _isValid = true;
+    };
+
+    bool readSection(Section section, BinaryReader& reader,
+                     openspace::speck::Dataset& dataset)
+    {
+        using namespace openspace::speck;
+
+        switch (section) {
+            case Section::Variables: {
+                const uint32_t n = reader.read<uint32_t>();
+                for (uint32_t i = 0; i < n && reader.isValid(); ++i) {
+                    Dataset::Variable variable;
+                    variable.index = reader.read<int32_t>();
+                    variable.name = reader.readString();
+                    dataset.variables.push_back(std::move(variable));
+                }
+                break;
+            }
+            case Section::Textures: {
+                const uint32_t n = reader.read<uint32_t>();
+                for (uint32_t i = 0; i < n && reader.isValid(); ++i) {
+                    Dataset::Texture texture;
+                    texture.index = reader.read<int32_t>();
+                    texture.file = reader.readString();
+                    dataset.textures.push_back(std::move(texture));
+                }
+                break;
+            }
+            case Section::Entries: {
+                dataset.valuesPerEntry = reader.read<int32_t>();
+                dataset.textureVariableIndex = reader.read<int32_t>();
+                dataset.orientationVariableIndex = reader.read<int32_t>();
+                reader.read<uint32_t>(); // reserved
+                const uint64_t nValues = reader.read<uint64_t>();
+                reader.readArray(dataset.entries, nValues);
+                if (dataset.valuesPerEntry <= 0 ||
+                    dataset.entries.size() % dataset.valuesPerEntry != 0)
+                {
+                    return false;
+                }
+                break;
+            }
+            case Section::Labels: {
+                const uint64_t n = reader.read<uint64_t>();
+                reader.readArray(dataset.labelPositions, n);
+                std::vector<uint32_t> offsets;
+                reader.readArray(offsets, n + 1);
+                if (!reader.isValid() || !reader.has(offsets.back())) {
+                    return false;
+                }
+                const char* texts = reader.position();
+                dataset.labelTexts.reserve(n);
+                for (uint64_t i = 0; i < n; ++i) {
+                    if (offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets.back()) {
+                        return false;
+                    }
+                    dataset.labelTexts.emplace_back(
+                        texts + offsets[i],
+                        offsets[i + 1] - offsets[i]
+                    );
+                }
+                break;
+            }
+            case Section::ColorMap: {
+                const uint64_t n = reader.read<uint64_t>();
+                reader.readArray(dataset.colorMap, n);
+                break;
+            }
+            case Section::Meshes: {
+                const uint32_t n = reader.read<uint32_t>();
+                for (uint32_t i = 0; i < n && reader.isValid(); ++i) {
+                    Dataset::Mesh mesh;
+                    mesh.textureIndex = reader.read<int32_t>();
+                    mesh.colorIndex = reader.read<int32_t>();
+                    mesh.style = Dataset::Mesh::Style(reader.read<int32_t>());
+                    mesh.numU = reader.read<int32_t>();
+                    mesh.numV = reader.read<int32_t>();
+                    const uint32_t nVertexValues = reader.read<uint32_t>();
+                    reader.readArray(mesh.vertices, nVertexValues);
+                    dataset.meshes.push_back(std::move(mesh));
+                }
+                break;
+            }
+            default:
+                // Sections that were added in later versions
+                break;
+        }
+        return reader.isValid();
+    }
+
+    bool isBinaryFile(const openspace::MemoryMappedFile& file) {
+        return file.size() >= sizeof(Magic) &&
+               std::memcmp(file.data(), Magic, sizeof(Magic)) == 0;
+    }
+
+    bool loadBinary(const openspace::MemoryMappedFile& file, const std::string& path,
+                    openspace::speck::Dataset& dataset)
+    {
+        BinaryReader reader(file.data(), file.size());
+        char magic[sizeof(Magic)];
+        reader.read(magic, sizeof(Magic));
+        const uint32_t version = reader.read<uint32_t>();
+        const uint32_t nSections = reader.read<uint32_t>();
+        if (!reader.isValid() || std::memcmp(magic, Magic, sizeof(Magic)) != 0) {
+            LERROR(fmt::format("File '{}' is not a binary Speck file", path));
+            return false;
+        }
+        if (version != CurrentVersion) {
+            LINFO(fmt::format(
+                "File '{}' has version {} but version {} is required",
+                path, version, CurrentVersion
+            ));
+            return false;
+        }
+
+        for (uint32_t i = 0; i < nSections; ++i) {
+            const SectionHeader header = reader.read<SectionHeader>();
+            if (!reader.has(header.size)) {
+                LERROR(fmt::format("Binary Speck file '{}' is truncated", path));
+                return false;
+            }
+            BinaryReader sectionReader(reader.position(), header.size);
+            if (!readSection(Section(header.type), sectionReader, dataset)) {
+                LERROR(fmt::format("Binary Speck file '{}' is corrupt", path));
+                return false;
+            }
+            reader.skip(header.size);
+        }
+        return true;
+    }
+} // namespace
+
+namespace openspace::speck {
+
+int Dataset::index(const std::string& name) const {
+    auto it = std::find_if(
+        variables.begin(),
+        variables.end(),
+        [&name](const Variable& v) { return v.name == name; }
+    );
+    return it != variables.end() ? it->index : -1;
+}
+
+bool loadFile(const std::string& path, Dataset& dataset) {
+    if (!FileSys.fileExists(path)) {
+        LERROR(fmt::format("Failed to open file '{}'", path));
+        return false;
+    }
+
+    {
+        // Empty files cannot be mapped, but they are valid (empty) text files
+        MemoryMappedFile file(path);
+        if (file.isValid() && isBinaryFile(file)) {
+            return loadBinary(file, path, dataset);
+        }
+    }
+
+    const std::string cachedFile = FileSys.cacheManager()->cachedFilename(
+        ghoul::filesystem::File(path),
+        "Speck",
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+
+    if (FileSys.fileExists(cachedFile)) {
+        LINFO(fmt::format("Cached file '{}' used for file '{}'", cachedFile, path));
+        if (loadBinaryFile(cachedFile, dataset)) {
+            return true;
+        }
+        // Intentional fall-through to regenerate the cache file for the next run
+        dataset = Dataset();
+        FileSys.deleteFile(cachedFile);
+    }
+    else {
+        LINFO(fmt::format("Cache for file '{}' not found", path));
+    }
+
+    LINFO(fmt::format("Loading file '{}'", path));
+    if (!readTextFile(path, dataset)) {
+        return false;
+    }
+
+    if (!saveBinaryFile(dataset, cachedFile)) {
+        LWARNING(fmt::format("Error writing cache file for '{}'", path));
+    }
+    return true;
+}
+
+bool readTextFile(const std::string& path, Dataset& dataset) {
+    const std::string extension = ghoul::filesystem::File(path).fileExtension();
+    if (extension == "label") {
+        return readLabelFile(path, dataset);
+    }
+    else if (extension == "cmap") {
+        return readColorMapFile(path, dataset);
+    }
+    else {
+        return readSpeckFile(path, dataset);
+    }
+}
+
+bool loadBinaryFile(const std::string& path, Dataset& dataset) {
+    MemoryMappedFile file(path);
+    if (!file.isValid()) {
+        LERROR(fmt::format("Failed to open file '{}'", path));
+        return false;
+    }
+    return loadBinary(file, path, dataset);
+}
+
+bool saveBinaryFile(const Dataset& dataset, const std::string& path) {
+    BinaryWriter writer;
+    writer.write(Magic, sizeof(Magic));
+    writer.write(CurrentVersion);
+    uint32_t nSections = 0;
+    const size_t nSectionsOffset = writer.size();
+    writer.write(nSections);
+
+    if (!dataset.variables.empty()) {
+        const size_t s = writer.beginSection(Section::Variables);
+        writer.write(static_cast<uint32_t>(dataset.variables.size()));
+        for (const Dataset::Variable& v : dataset.variables) {
+            writer.write(static_cast<int32_t>(v.index));
+            writer.write(v.name);
+        }
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    if (!dataset.textures.empty()) {
+        const size_t s = writer.beginSection(Section::Textures);
+        writer.write(static_cast<uint32_t>(dataset.textures.size()));
+        for (const Dataset::Texture& t : dataset.textures) {
+            writer.write(static_cast<int32_t>(t.index));
+            writer.write(t.file);
+        }
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    if (dataset.valuesPerEntry > 0) {
+        const size_t s = writer.beginSection(Section::Entries);
+        writer.write(static_cast<int32_t>(dataset.valuesPerEntry));
+        writer.write(static_cast<int32_t>(dataset.textureVariableIndex));
+        writer.write(static_cast<int32_t>(dataset.orientationVariableIndex));
+        writer.write(uint32_t(0)); // reserved
+        writer.write(static_cast<uint64_t>(dataset.entries.size()));
+        writer.write(dataset.entries.data(), dataset.entries.size() * sizeof(float));
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    if (!dataset.labelTexts.empty()) {
+        // The positions and the texts are stored in separate blocks; the texts are
+        // concatenated and addressed by an offset table
+        const size_t s = writer.beginSection(Section::Labels);
+        writer.write(static_cast<uint64_t>(dataset.labelTexts.size()));
+        writer.write(
+            dataset.labelPositions.data(),
+            dataset.labelPositions.size() * sizeof(glm::vec3)
+        );
+        uint32_t offset = 0;
+        writer.write(offset);
+        for (const std::string& text : dataset.labelTexts) {
+            offset += static_cast<uint32_t>(text.size());
+            writer.write(offset);
+        }
+        for (const std::string& text : dataset.labelTexts) {
+            writer.write(text.data(), text.size());
+        }
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    if (!dataset.colorMap.empty()) {
+        const size_t s = writer.beginSection(Section::ColorMap);
+        writer.write(static_cast<uint64_t>(dataset.colorMap.size()));
+        writer.write(
+            dataset.colorMap.data(),
+            dataset.colorMap.size() * sizeof(glm::vec4)
+        );
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    if (!dataset.meshes.empty()) {
+        const size_t s = writer.beginSection(Section::Meshes);
+        writer.write(static_cast<uint32_t>(dataset.meshes.size()));
+        for (const Dataset::Mesh& m : dataset.meshes) {
+            writer.write(static_cast<int32_t>(m.textureIndex));
+            writer.write(static_cast<int32_t>(m.colorIndex));
+            writer.write(static_cast<int32_t>(m.style));
+            writer.write(static_cast<int32_t>(m.numU));
+            writer.write(static_cast<int32_t>(m.numV));
+            writer.write(static_cast<uint32_t>(m.vertices.size()));
+            writer.write(m.vertices.data(), m.vertices.size() * sizeof(float));
+        }
+        writer.endSection(s);
+        ++nSections;
+    }
+
+    writer.overwrite(nSectionsOffset, nSections);
+
+    std::ofstream file(path, std::ofstream::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Error opening file '{}' for writing", path));
+        return false;
+    }
+    file.write(writer.buffer().data(), writer.buffer().size());
+    return file.good();
+}
+
+} // namespace openspace::speck
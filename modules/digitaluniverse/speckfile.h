@@ -0,0 +1,125 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_DIGITALUNIVERSE___SPECKFILE___H__
+#define __OPENSPACE_MODULE_DIGITALUNIVERSE___SPECKFILE___H__
+
+#include <ghoul/glm.h>
+#include <string>
+#include <vector>
+
+namespace openspace::speck {
+
+/**
+ * The contents of a Digital Universe data file. A Speck file provides the data variables,
+ * textures, entries, and meshes, a Label file provides the labels, and a Color Map file
+ * provides the color map; all other members are left empty.
+ */
+struct Dataset {
+    struct Variable {
+        /// The index of this variable's column in an entry, including the x, y, z
+        int index;
+        std::string name;
+    };
+
+    struct Texture {
+        int index;
+        std::string file;
+    };
+
+    struct Mesh {
+        enum class Style : int {
+            Solid = 0,
+            Wire = 1,
+            Point = 2,
+            Invalid = 9
+        };
+
+        int textureIndex = 0;
+        int colorIndex = 0;
+        Style style = Style::Wire;
+        int numU = 0;
+        int numV = 0;
+        std::vector<float> vertices;
+    };
+
+    /// Returns the column of the variable with the \p name or -1 if it does not exist
+    int index(const std::string& name) const;
+
+    std::vector<Variable> variables;
+    std::vector<Texture> textures;
+    /// The column of the texture index of each entry or -1 if there is no texturevar
+    int textureVariableIndex = -1;
+    /// The column of the plane orientation of each entry or -1 if there is no polyorivar
+    int orientationVariableIndex = -1;
+
+    /// The number of values of each entry, including its x, y, z position
+    int valuesPerEntry = 0;
+    /// All entries, each being valuesPerEntry consecutive values
+    std::vector<float> entries;
+
+    std::vector<glm::vec3> labelPositions;
+    std::vector<std::string> labelTexts;
+
+    std::vector<glm::vec4> colorMap;
+
+    std::vector<Mesh> meshes;
+};
+
+/**
+ * Reads the Speck (<code>.speck</code>), Label (<code>.label</code>), or Color Map
+ * (<code>.cmap</code>) file at \p path into the \p dataset. If \p path instead is a
+ * binary file written by #saveBinaryFile, it is memory mapped and each of its sections
+ * is copied into the \p dataset with a single block copy instead of being parsed. For
+ * text files, a binary copy is stored in the cache, which is used instead of the text
+ * file as long as the latter does not change. An empty file is loaded as an empty text
+ * file.
+ *
+ * \return <code>true</code> if the file was loaded successfully
+ */
+bool loadFile(const std::string& path, Dataset& dataset);
+
+/**
+ * Parses the text file at \p path, whose type is determined by its extension, into the
+ * \p dataset without using the cache.
+ */
+bool readTextFile(const std::string& path, Dataset& dataset);
+
+/**
+ * Loads the binary file at \p path that was written by #saveBinaryFile. The file is
+ * memory mapped and the sections are copied out of the mapping, so the \p dataset does
+ * not reference the file after this function returns.
+ */
+bool loadBinaryFile(const std::string& path, Dataset& dataset);
+
+/**
+ * Writes the \p dataset into a versioned binary file at \p path. The file consists of a
+ * header and a list of sections; each section stores one part of the dataset in a
+ * contiguous block so that it can be loaded without parsing.
+ */
+bool saveBinaryFile(const Dataset& dataset, const std::string& path);
+
+} // namespace openspace::speck
+
+#endif // __OPENSPACE_MODULE_DIGITALUNIVERSE___SPECKFILE___H__
@@ -0,0 +1,107 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/digitaluniverse/tasks/convertspecktask.h>
+
+#include <modules/digitaluniverse/speckfile.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    constexpr const char* _loggerCat = "ConvertSpeckTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+} // namespace
+
+namespace openspace {
+
+ConvertSpeckTask::ConvertSpeckTask(const ghoul::Dictionary& dictionary) {
+    documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ConvertSpeckTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+}
+
+std::string ConvertSpeckTask::description() {
+    return fmt::format(
+        "Convert the Digital Universe file {} into the binary file {}",
+        _inputPath, _outputPath
+    );
+}
+
+void ConvertSpeckTask::perform(const Task::ProgressCallback& progressCallback) {
+    speck::Dataset dataset;
+    if (!speck::readTextFile(_inputPath, dataset)) {
+        LERROR(fmt::format("Could not read file '{}'", _inputPath));
+        return;
+    }
+    progressCallback(0.5f);
+
+    if (!speck::saveBinaryFile(dataset, _outputPath)) {
+        LERROR(fmt::format("Could not write file '{}'", _outputPath));
+        return;
+    }
+    progressCallback(1.f);
+}
+
+documentation::Documentation ConvertSpeckTask::documentation() {
+    using namespace documentation;
+    return {
+        "ConvertSpeckTask",
+        "digitaluniverse_convert_speck_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ConvertSpeckTask"),
+                Optional::No,
+                "The type of this task"
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A speck, label, or cmap file"),
+                Optional::No,
+                "The Digital Universe file that is converted. The type of the file is "
+                "determined by its extension"
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The binary file that is written. It can be used in place of the input "
+                "file by the RenderablePoints, RenderableBillboardsCloud, "
+                "RenderablePlanesCloud, and RenderableDUMeshes"
+            }
+        }
+    };
+}
+
+} // namespace openspace
@@ -25,6 +25,7 @@
 #include <modules/fieldlinessequence/rendering/renderablefieldlinessequence.h>
 
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
 #include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
@@ -38,7 +39,6 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
 #include <fstream>
-#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableFieldlinesSequence";
@@ -69,6 +69,10 @@ namespace {
     constexpr const char* KeyJsonScalingFactor = "ScaleToMeters";
     // [BOOLEAN] If value False => Load in initializing step and store in RAM
     constexpr const char* KeyOslfsLoadAtRuntime = "LoadAtRuntime";
+    // [INT] Number of states to keep decoded ahead of the active one when LoadAtRuntime
+    constexpr const char* KeyOslfsPrefetchAhead = "PrefetchStatesAhead";
+    // [INT] Number of states to keep decoded behind the active one when LoadAtRuntime
+    constexpr const char* KeyOslfsPrefetchBehind = "PrefetchStatesBehind";
 
     // ---------------------------- OPTIONAL MODFILE KEYS  ---------------------------- //
     // [STRING ARRAY] Values should be paths to .txt files
@@ -359,6 +363,16 @@ void RenderableFieldlinesSequence::initializeGL() {
     glGenBuffers(1, &_vertexColorBuffer);
     glGenBuffers(1, &_vertexMaskingBuffer);
 
+    // The prefetcher is created and destroyed together with the GL resources that the
+    // decoded states are uploaded into
+    if (_loadingStatesDynamically) {
+        _prefetcher = std::make_unique<FieldlinesStatePrefetcher>(
+            _sourceFiles,
+            _nStatesToPrefetchAhead,
+            _nStatesToPrefetchBehind
+        );
+    }
+
     // Needed for additive blending
     setRenderBin(Renderable::RenderBin::Overlay);
 }
@@ -618,6 +632,15 @@ void RenderableFieldlinesSequence::extractOsflsInfoFromDictionary() {
             _identifier, KeyOslfsLoadAtRuntime
         ));
     }
+
+    double nAhead;
+    if (_dictionary->getValue(KeyOslfsPrefetchAhead, nAhead)) {
+        _nStatesToPrefetchAhead = std::max(static_cast<int>(nAhead), 0);
+    }
+    double nBehind;
+    if (_dictionary->getValue(KeyOslfsPrefetchBehind, nBehind)) {
+        _nStatesToPrefetchBehind = std::max(static_cast<int>(nBehind), 0);
+    }
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
@@ -1029,15 +1052,9 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done!
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Joins the thread that is decoding states
+    _prefetcher = nullptr;
+    _streamedState = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1045,7 +1062,8 @@ bool RenderableFieldlinesSequence::isReady() const {
 }
 
 void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&) {
-    if (_activeTriggerTimeIndex != -1) {
+    // When streaming, nothing has been uploaded until the first state has been decoded
+    if (_activeTriggerTimeIndex != -1 && (!_loadingStatesDynamically || _streamedState)) {
         _shaderProgram->activate();
 
         // Calculate Model View MatrixProjection
@@ -1114,11 +1132,12 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
         }
 
         glBindVertexArray(_vertexArrayObject);
+        const FieldlinesState& state = activeState();
         glMultiDrawArrays(
             GL_LINE_STRIP, //_drawingOutputType,
-            _states[_activeStateIndex].lineStart().data(),
-            _states[_activeStateIndex].lineCount().data(),
-            static_cast<GLsizei>(_states[_activeStateIndex].lineStart().size())
+            state.lineStart().data(),
+            state.lineCount().data(),
+            static_cast<GLsizei>(state.lineStart().size())
         );
 
         glBindVertexArray(0);
@@ -1167,33 +1186,42 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         _needsUpdate              = false;
     }
 
-    if (_mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk    = true;
-            _mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)] {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
+    if (_prefetcher) {
+        if (currentTime != _previousTime) {
+            _playbackDirection = (currentTime > _previousTime) ? 1 : -1;
         }
-    }
 
-    if (_needsUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+        // Outside of the sequence, keep the end that time is approaching decoded
+        int centerIndex = _activeTriggerTimeIndex;
+        if (centerIndex == -1) {
+            centerIndex = (currentTime < _startTimes[0]) ?
+                0 :
+                static_cast<int>(_nStates) - 1;
+        }
+        _prefetcher->setActiveState(centerIndex, _playbackDirection);
+
+        if (_mustLoadNewStateFromDisk) {
+            std::shared_ptr<const FieldlinesState> state =
+                _prefetcher->state(_activeTriggerTimeIndex);
+            if (state) {
+                _streamedState = std::move(state);
+                _mustLoadNewStateFromDisk = false;
+                _needsUpdate = true;
+            }
         }
+    }
+    _previousTime = currentTime;
 
+    if (_needsUpdate) {
         updateVertexPositionBuffer();
 
-        if (_states[_activeStateIndex].nExtraQuantities() > 0) {
+        if (activeState().nExtraQuantities() > 0) {
             _shouldUpdateColorBuffer = true;
             _shouldUpdateMaskingBuffer = true;
         }
 
         // Everything is set and ready for rendering!
         _needsUpdate = false;
-        _newStateIsReady = false;
     }
 
     if (_shouldUpdateColorBuffer) {
@@ -1224,13 +1252,11 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe!
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+const FieldlinesState& RenderableFieldlinesSequence::activeState() const {
+    if (_loadingStatesDynamically && _streamedState) {
+        return *_streamedState;
     }
-    _isLoadingStateFromDisk = false;
+    return _states[_activeStateIndex];
 }
 
 // Unbind buffers and arrays
@@ -1243,7 +1269,7 @@ void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
 
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
+    const std::vector<glm::vec3>& vertPos = activeState().vertexPositions();
 
     glBufferData(
         GL_ARRAY_BUFFER,
@@ -1263,7 +1289,7 @@ void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
+    const std::vector<float>& quantities = activeState().extraQuantity(
         _pColorQuantity,
         isSuccessful
     );
@@ -1288,7 +1314,7 @@ void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
     glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
+    const std::vector<float>& maskings = activeState().extraQuantity(
         _pMaskingQuantity,
         isSuccessful
     );
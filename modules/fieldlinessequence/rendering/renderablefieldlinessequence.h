@@ -35,12 +35,13 @@
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
 
 namespace { enum class SourceFileType; }
 
 namespace openspace {
 
+class FieldlinesStatePrefetcher;
+
 class RenderableFieldlinesSequence : public Renderable {
 public:
     RenderableFieldlinesSequence(const ghoul::Dictionary& dictionary);
@@ -65,9 +66,6 @@ private:
     std::string _identifier;                               // Name of the Node!
 
     // ------------------------------------- FLAGS -------------------------------------//
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
@@ -77,9 +75,6 @@ private:
     // Used for 'in-RAM-states' : True if new 'in-RAM-state'  must be loaded.
     // False => the previous frame's state should still be shown
     bool _needsUpdate = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -95,6 +90,17 @@ private:
     int _activeTriggerTimeIndex = -1;
     // Number of states in the sequence
     size_t _nStates = 0;
+    // Used for 'runtime-states'. Number of states to keep decoded ahead of the active
+    // state in the playback direction
+    int _nStatesToPrefetchAhead = 4;
+    // Used for 'runtime-states'. Number of states to keep decoded behind the active
+    // state, opposite to the playback direction
+    int _nStatesToPrefetchBehind = 2;
+    // Used for 'runtime-states'. 1 if time moved forward in the last frame that time
+    // changed, -1 if it moved backwards
+    int _playbackDirection = 1;
+    // Time of the previous update, used to determine the playback direction
+    double _previousTime = 0.0;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
     // domain limits.
     float _scalingFactor = 1.f;
@@ -114,8 +120,10 @@ private:
     // ----------------------------------- POINTERS ------------------------------------//
     // The Lua-Modfile-Dictionary used during initialization
     std::unique_ptr<ghoul::Dictionary> _dictionary;
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
+    // Used for 'runtime-states'. Decodes the states around the active state
+    std::unique_ptr<FieldlinesStatePrefetcher> _prefetcher;
+    // Used for 'runtime-states'. The state that is currently uploaded to the GPU
+    std::shared_ptr<const FieldlinesState> _streamedState;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -220,7 +228,7 @@ private:
     bool prepareForOsflsStreaming();
 
     // ------------------------- FUNCTIONS USED DURING RUNTIME ------------------------ //
-    void readNewState(const std::string& filePath);
+    const FieldlinesState& activeState() const;
     void updateActiveTriggerTimeIndex(double currentTime);
     void updateVertexPositionBuffer();
     void updateVertexColorBuffer();
@@ -24,10 +24,12 @@
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
 
+#include <openspace/util/memorymappedfile.h>
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
 #include <ext/json/json.hpp>
+#include <cstring>
 #include <fstream>
 
 namespace {
@@ -61,14 +63,30 @@ void FieldlinesState::scalePositions(float scale) {
 }
 
 bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
-    std::ifstream ifs(pathToOsflsFile, std::ifstream::binary);
-    if (!ifs.is_open()) {
+    // The file is mapped into memory and every array is copied out of it with a single
+    // memcpy, rather than going through a large number of small stream reads
+    const MemoryMappedFile file(pathToOsflsFile);
+    if (!file.isValid()) {
         LERROR("Couldn't open file: " + pathToOsflsFile);
         return false;
     }
 
-    int binFileVersion;
-    ifs.read(reinterpret_cast<char*>(&binFileVersion), sizeof(int));
+    const char* data = file.data();
+    const size_t size = file.size();
+    size_t offset = 0;
+    auto read = [&](void* destination, size_t nBytes) {
+        if (nBytes > size - offset) {
+            return false;
+        }
+        if (nBytes > 0) {
+            std::memcpy(destination, data + offset, nBytes);
+        }
+        offset += nBytes;
+        return true;
+    };
+
+    int binFileVersion = -1;
+    read(&binFileVersion, sizeof(int));
 
     switch (binFileVersion) {
         case 0:
@@ -80,19 +98,32 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     }
 
     // Define tmp variables to store meta data in
-    size_t nLines;
-    size_t nPoints;
-    size_t nExtras;
-    size_t byteSizeAllNames;
+    uint64_t nLines = 0;
+    uint64_t nPoints = 0;
+    uint64_t nExtras = 0;
+    uint64_t byteSizeAllNames = 0;
 
     // Read single value variables
-    ifs.read(reinterpret_cast<char*>(&_triggerTime), sizeof(double));
-    ifs.read(reinterpret_cast<char*>(&_model), sizeof(int32_t));
-    ifs.read(reinterpret_cast<char*>(&_isMorphable), sizeof(bool));
-    ifs.read(reinterpret_cast<char*>(&nLines), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&nPoints), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&nExtras), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&byteSizeAllNames), sizeof(uint64_t));
+    bool success = read(&_triggerTime, sizeof(double));
+    success &= read(&_model, sizeof(int32_t));
+    success &= read(&_isMorphable, sizeof(bool));
+    success &= read(&nLines, sizeof(uint64_t));
+    success &= read(&nPoints, sizeof(uint64_t));
+    success &= read(&nExtras, sizeof(uint64_t));
+    success &= read(&byteSizeAllNames, sizeof(uint64_t));
+
+    // Reject sizes that cannot possibly fit into the file before allocating anything.
+    // Every name of an extra quantity is terminated by '\0', so there can not be more
+    // extra quantities than name bytes, even if there are no points
+    const size_t remaining = size - offset;
+    if (!success || nLines > remaining / (sizeof(int32_t) + sizeof(uint32_t)) ||
+        nPoints > remaining / (3 * sizeof(float)) ||
+        (nPoints > 0 && nExtras > remaining / (sizeof(float) * nPoints)) ||
+        byteSizeAllNames > remaining || nExtras > byteSizeAllNames)
+    {
+        LERROR("Corrupt or truncated file: " + pathToOsflsFile);
+        return false;
+    }
 
     _lineStart.resize(nLines);
     _lineCount.resize(nLines);
@@ -101,31 +132,30 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     _extraQuantityNames.resize(nExtras);
 
     // Read vertex position data
-    ifs.read(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
-    ifs.read(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
-    ifs.read(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
-    );
+    success &= read(_lineStart.data(), sizeof(int32_t) * nLines);
+    success &= read(_lineCount.data(), sizeof(uint32_t) * nLines);
+    success &= read(_vertexPositions.data(), 3 * sizeof(float) * nPoints);
 
     // Read all extra quantities
     for (std::vector<float>& vec : _extraQuantities) {
         vec.resize(nPoints);
-        ifs.read(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+        success &= read(vec.data(), sizeof(float) * nPoints);
     }
 
     // Read all extra quantities' names. Stored as multiple c-strings
-    std::string allNamesInOne;
-    std::vector<char> buffer(byteSizeAllNames);
-    ifs.read(buffer.data(), byteSizeAllNames);
-    allNamesInOne.assign(buffer.data(), byteSizeAllNames);
+    std::string allNamesInOne(byteSizeAllNames, '\0');
+    success &= read(&allNamesInOne[0], byteSizeAllNames);
+    if (!success) {
+        LERROR("Corrupt or truncated file: " + pathToOsflsFile);
+        return false;
+    }
 
-    size_t offset = 0;
+    size_t nameOffset = 0;
     for (size_t i = 0; i < nExtras; ++i) {
-        auto endOfVarName = allNamesInOne.find('\0', offset);
-        endOfVarName -= offset;
-        const std::string varName = allNamesInOne.substr(offset, endOfVarName);
-        offset += varName.size() + 1;
+        auto endOfVarName = allNamesInOne.find('\0', nameOffset);
+        endOfVarName -= nameOffset;
+        const std::string varName = allNamesInOne.substr(nameOffset, endOfVarName);
+        nameOffset += varName.size() + 1;
         _extraQuantityNames[i] = varName;
     }
 
@@ -405,7 +435,6 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
     const size_t nOldPoints = _vertexPositions.size();
     _lineStart.push_back(static_cast<GLint>(nOldPoints));
     _lineCount.push_back(static_cast<GLsizei>(nNewPoints));
-    _vertexPositions.reserve(nOldPoints + nNewPoints);
     _vertexPositions.insert(
         _vertexPositions.end(),
         std::make_move_iterator(line.begin()),
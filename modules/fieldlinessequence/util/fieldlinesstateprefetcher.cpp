@@ -0,0 +1,178 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "FieldlinesStatePrefetcher";
+
+    std::shared_ptr<const openspace::FieldlinesState> loadOsfls(const std::string& file) {
+        auto state = std::make_shared<openspace::FieldlinesState>();
+        if (!state->loadStateFromOsfls(file)) {
+            return nullptr;
+        }
+        return state;
+    }
+} // namespace
+
+namespace openspace {
+
+FieldlinesStatePrefetcher::FieldlinesStatePrefetcher(std::vector<std::string> files,
+                                                     int nAhead, int nBehind,
+                                                     StateLoader loader)
+    : _files(std::move(files))
+    , _nAhead(std::max(nAhead, 0))
+    , _nBehind(std::max(nBehind, 0))
+    , _loader(loader ? std::move(loader) : loadOsfls)
+    , _ring(_nAhead + _nBehind + 1)
+{
+    _worker = std::thread([this]() { workerLoop(); });
+}
+
+FieldlinesStatePrefetcher::~FieldlinesStatePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void FieldlinesStatePrefetcher::setActiveState(int index, int direction) {
+    direction = direction < 0 ? -1 : 1;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (index == _activeIndex && direction == _direction) {
+            return;
+        }
+        _activeIndex = index;
+        _direction = direction;
+    }
+    _condition.notify_one();
+}
+
+std::shared_ptr<const FieldlinesState> FieldlinesStatePrefetcher::state(int index) const
+{
+    if (index < 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Slot& slot = _ring[index % _ring.size()];
+    return slot.index == index ? slot.state : nullptr;
+}
+
+bool FieldlinesStatePrefetcher::isInWindow(int index) const {
+    const int ahead = index - _activeIndex;
+    return _direction > 0 ?
+        (ahead >= -_nBehind && ahead <= _nAhead) :
+        (ahead >= -_nAhead && ahead <= _nBehind);
+}
+
+int FieldlinesStatePrefetcher::nextIndexToLoad() const {
+    if (_activeIndex < 0) {
+        return -1;
+    }
+
+    const int nFiles = static_cast<int>(_files.size());
+    auto isMissing = [&](int index) {
+        return index >= 0 && index < nFiles &&
+               _ring[index % _ring.size()].index != index;
+    };
+    // A slot that has the index but no state means that decoding failed
+    auto shouldRetry = [&](int index) {
+        if (index < 0 || index >= nFiles) {
+            return false;
+        }
+        const Slot& slot = _ring[index % _ring.size()];
+        return slot.index == index && !slot.state &&
+               slot.nFailedAttempts < MaxLoadAttempts;
+    };
+
+    // The active state first, then the upcoming states in the playback direction, and
+    // the states behind last
+    auto find = [&](auto needsLoading) {
+        for (int i = 0; i <= _nAhead; ++i) {
+            const int index = _activeIndex + i * _direction;
+            if (needsLoading(index)) {
+                return index;
+            }
+        }
+        for (int i = 1; i <= _nBehind; ++i) {
+            const int index = _activeIndex - i * _direction;
+            if (needsLoading(index)) {
+                return index;
+            }
+        }
+        return -1;
+    };
+
+    // Failed states are only retried once everything else in the window is decoded
+    const int index = find(isMissing);
+    return index != -1 ? index : find(shouldRetry);
+}
+
+void FieldlinesStatePrefetcher::workerLoop() {
+    while (true) {
+        int index = -1;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this, &index]() {
+                index = nextIndexToLoad();
+                return _shouldStop || index != -1;
+            });
+            if (_shouldStop) {
+                return;
+            }
+        }
+
+        std::shared_ptr<const FieldlinesState> state = _loader(_files[index]);
+        if (!state) {
+            LWARNING(fmt::format("Failed to load state from: {}", _files[index]));
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        // The active state might have moved far enough while decoding that this state
+        // is no longer needed, in which case it must not replace a state that is
+        if (isInWindow(index)) {
+            Slot& slot = _ring[index % _ring.size()];
+            if (slot.index != index) {
+                slot.index = index;
+                slot.nFailedAttempts = 0;
+            }
+            if (!state) {
+                ++slot.nFailedAttempts;
+            }
+            slot.state = std::move(state);
+        }
+    }
+}
+
+} // namespace openspace
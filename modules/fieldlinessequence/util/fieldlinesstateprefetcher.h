@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+class FieldlinesState;
+
+/**
+ * Keeps a bounded ring of decoded .osfls states around the active state of a sequence.
+ * The ring covers the active state, a number of states ahead of it in the playback
+ * direction, and a number of states behind it. A single persistent worker thread decodes
+ * the missing states, starting with the active state and continuing outwards in the
+ * playback direction, so that crossing into the next state finds it already decoded.
+ * A state that fails to decode is retried, after all other states in the ring have been
+ * decoded, up to #MaxLoadAttempts times while it stays in the ring.
+ */
+class FieldlinesStatePrefetcher {
+public:
+    /// The number of times that decoding a state is attempted before giving up on it
+    static constexpr const int MaxLoadAttempts = 3;
+
+    /// Decodes the state stored in a file, returning \c nullptr if that fails
+    using StateLoader =
+        std::function<std::shared_ptr<const FieldlinesState>(const std::string&)>;
+
+    /**
+     * Creates a prefetcher for the states stored in \p files. The states are decoded by
+     * the \p loader, which is called on the worker thread; by default the files are
+     * read as .osfls files.
+     */
+    FieldlinesStatePrefetcher(std::vector<std::string> files, int nAhead, int nBehind,
+        StateLoader loader = nullptr);
+    ~FieldlinesStatePrefetcher();
+
+    /**
+     * Centers the ring on the state with the index \p index. A positive \p direction
+     * means that time is moving forward through the sequence, a negative direction that
+     * it is moving backwards.
+     */
+    void setActiveState(int index, int direction);
+
+    /// Returns the state at \p index, or \c nullptr if it has not been decoded (yet)
+    std::shared_ptr<const FieldlinesState> state(int index) const;
+
+private:
+    struct Slot {
+        int index = -1;
+        std::shared_ptr<const FieldlinesState> state;
+        /// The number of times that decoding the state at index has failed
+        int nFailedAttempts = 0;
+    };
+
+    void workerLoop();
+    bool isInWindow(int index) const;
+    int nextIndexToLoad() const;
+
+    const std::vector<std::string> _files;
+    const int _nAhead;
+    const int _nBehind;
+    const StateLoader _loader;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    // A state with index i is stored in slot i % _ring.size(); since the window around
+    // the active state is exactly as large as the ring, no two states in it collide
+    std::vector<Slot> _ring;
+    int _activeIndex = -1;
+    int _direction = 1;
+    bool _shouldStop = false;
+
+    std::thread _worker;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
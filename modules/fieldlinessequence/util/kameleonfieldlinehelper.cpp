@@ -26,8 +26,10 @@
 
 #include <modules/fieldlinessequence/util/commons.h>
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/parallelfor.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <memory>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
@@ -61,8 +63,9 @@ namespace openspace::fls {
 
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
-    bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string& tracingVar, FieldlinesState& state);
+    bool addLinesToState(ccmc::Kameleon* kameleon, const std::string& cdfPath,
+        const std::vector<glm::vec3>& seeds, const std::string& tracingVar,
+        FieldlinesState& state);
     void addExtraQuantities(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
@@ -106,7 +109,7 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
     state.setModel(fls::stringToModel(kameleon->getModelName()));
     state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
 
-    if (addLinesToState(kameleon.get(), seedPoints, tracingVar, state)) {
+    if (addLinesToState(kameleon.get(), cdfPath, seedPoints, tracingVar, state)) {
         // The line points are in their RAW format (unscaled & maybe spherical)
         // Before we scale to meters (and maybe cartesian) we must extract
         // the extraQuantites, as the iterpolator needs the unaltered positions
@@ -135,9 +138,13 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
  * Vertices are not scaled to meters nor converted from spherical into cartesian
  * coordinates.
  * Note that extraQuantities will NOT be set!
+ * The lines are traced in parallel; all threads but the calling one open their own
+ * Kameleon object from cdfPath, as tracing reads and caches data in the Kameleon object.
  */
-bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string& tracingVar, FieldlinesState& state) {
+bool addLinesToState(ccmc::Kameleon* kameleon, const std::string& cdfPath,
+                     const std::vector<glm::vec3>& seedPoints,
+                     const std::string& tracingVar, FieldlinesState& state)
+{
 
     float innerBoundaryLimit;
 
@@ -162,18 +169,42 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
         return false;
     }
 
-    bool success = false;
     LINFO("Tracing field lines!");
-    // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
-    for (const glm::vec3& seed : seedPoints) {
+    // TRACE THE LINES FROM ALL SEED POINTS IN PARALLEL. EVERY LINE IS STORED IN THE SLOT
+    // OF ITS SEED POINT, SO THE LINES ARE ADDED TO THE STATE IN THE ORDER OF THE SEEDS
+    std::vector<std::vector<glm::vec3>> lines(seedPoints.size());
+    // A Kameleon object must not be used by more than one thread at a time, so each
+    // thread gets its own. The calling thread is the first thread and uses the object
+    // that was passed in; the others open theirs when they get their first seed point
+    struct ThreadState {
+        ccmc::Kameleon* kameleon = nullptr;
+        std::unique_ptr<ccmc::Kameleon> ownedKameleon;
+    };
+    std::vector<ThreadState> threadStates(defaultParallelThreadCount());
+    threadStates[0].kameleon = kameleon;
+    auto trace = [&](ThreadState& threadState, size_t i) {
+        if (!threadState.kameleon) {
+            threadState.ownedKameleon = kameleonHelper::createKameleonObject(cdfPath);
+            if (!threadState.ownedKameleon ||
+                !threadState.ownedKameleon->loadVariable(tracingVar))
+            {
+                throw ghoul::RuntimeError(
+                    fmt::format("Failed to open '{}' for tracing", cdfPath),
+                    _loggerCat
+                );
+            }
+            threadState.kameleon = threadState.ownedKameleon.get();
+        }
+
         //--------------------------------------------------------------------------//
         // We have to create a new tracer (or actually a new interpolator) for each //
         // new line, otherwise some issues occur                                    //
         //--------------------------------------------------------------------------//
-        std::unique_ptr<ccmc::Interpolator> interpolator =
-                std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-        ccmc::Tracer tracer(kameleon, interpolator.get());
+        ccmc::Kameleon* k = threadState.kameleon;
+        auto interpolator = std::make_unique<ccmc::KameleonInterpolator>(k->model);
+        ccmc::Tracer tracer(k, interpolator.get());
         tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
+        const glm::vec3& seed = seedPoints[i];
         ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
             tracingVar,
             seed.x,
@@ -182,17 +213,25 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
         );
         const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
 
-        const size_t nLinePoints = positions.size();
-
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
+        std::vector<glm::vec3>& vertices = lines[i];
+        vertices.reserve(positions.size());
         for (const ccmc::Point3f& p : positions) {
             vertices.emplace_back(p.component1, p.component2, p.component3);
         }
-        state.addLine(vertices);
-        success |= (nLinePoints > 0);
+    };
+    try {
+        parallelForEach(seedPoints.size(), threadStates, trace);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        return false;
     }
 
+    bool success = false;
+    for (std::vector<glm::vec3>& vertices : lines) {
+        success |= !vertices.empty();
+        state.addLine(vertices);
+    }
     return success;
 }
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
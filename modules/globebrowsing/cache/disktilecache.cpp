@@ -0,0 +1,564 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/cache/disktilecache.h>
+
+#include <modules/globebrowsing/tile/rawtile.h>
+#include <modules/globebrowsing/tile/tilemetadata.h>
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <lz4.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "DiskTileCache";
+
+    constexpr const char* IndexFile = "index.bin";
+    constexpr const char* TileExtension = "tile";
+    constexpr const uint32_t TileMagic = 0x5444534F; // 'OSDT'
+    constexpr const uint32_t IndexMagic = 0x4944534F; // 'OSDI'
+    constexpr const uint32_t CurrentVersion = 1;
+
+    constexpr const size_t ByteToMegaByte = 1024 * 1024;
+
+    struct TileFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t initDataHashKey;
+        uint64_t uncompressedSize;
+        uint64_t compressedSize;
+        uint32_t nMetaDataValues;
+        uint32_t padding;
+    };
+
+    struct IndexEntry {
+        uint32_t providerID;
+        int32_t level;
+        int32_t x;
+        int32_t y;
+        uint64_t size;
+    };
+
+    const openspace::properties::Property::PropertyInfo EnabledInfo = {
+        "Enabled",
+        "Enabled",
+        "If this value is enabled, tiles that are loaded from remote sources are "
+        "stored on disk and are read from there instead of being requested again."
+    };
+
+    const openspace::properties::Property::PropertyInfo CacheSizeInfo = {
+        "CacheSize",
+        "Disk cache size (MB)",
+        "The maximum amount of disk space (in MB) that is used by the cache. If the "
+        "cache grows beyond this size, the least recently used tiles are removed."
+    };
+
+    const openspace::properties::Property::PropertyInfo UsedSizeInfo = {
+        "UsedSize",
+        "Used disk space (MB)",
+        "This value denotes the amount of disk space (in MB) that the cache is "
+        "currently occupying."
+    };
+
+    const openspace::properties::Property::PropertyInfo HitsInfo = {
+        "Hits",
+        "Cache hits",
+        "The number of tiles that were read from the disk cache in this session."
+    };
+
+    const openspace::properties::Property::PropertyInfo MissesInfo = {
+        "Misses",
+        "Cache misses",
+        "The number of tiles that were requested from the disk cache in this session "
+        "but had to be read from their original source."
+    };
+
+    const openspace::properties::Property::PropertyInfo BytesReadInfo = {
+        "BytesRead",
+        "Data read (MB)",
+        "The amount of compressed data (in MB) that was read from the disk cache in "
+        "this session."
+    };
+
+    const openspace::properties::Property::PropertyInfo BytesWrittenInfo = {
+        "BytesWritten",
+        "Data written (MB)",
+        "The amount of compressed data (in MB) that was written to the disk cache in "
+        "this session."
+    };
+
+    const openspace::properties::Property::PropertyInfo ClearCacheInfo = {
+        "ClearCache",
+        "Clear disk cache",
+        "Removes all tiles that are currently stored in the disk cache."
+    };
+
+    int clampToInt(uint64_t value) {
+        return static_cast<int>(
+            std::min(value, static_cast<uint64_t>(std::numeric_limits<int>::max()))
+        );
+    }
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileCache::DiskTileCache(std::string cacheDirectory, size_t maximumSize)
+    : PropertyOwner({ "DiskTileCache" })
+    , _cacheDirectory(std::move(cacheDirectory))
+    , _index(std::numeric_limits<size_t>::max())
+    , _maximumSize(maximumSize)
+    , _enabled(EnabledInfo, true)
+    , _cacheSize(
+        CacheSizeInfo,
+        static_cast<int>(maximumSize / ByteToMegaByte),
+        128,
+        1024 * 1024,
+        1
+    )
+    , _usedSize(UsedSizeInfo, 0, 0, 1024 * 1024, 1)
+    , _hits(HitsInfo, 0, 0, std::numeric_limits<int>::max(), 1)
+    , _misses(MissesInfo, 0, 0, std::numeric_limits<int>::max(), 1)
+    , _bytesRead(BytesReadInfo, 0, 0, std::numeric_limits<int>::max(), 1)
+    , _bytesWritten(BytesWrittenInfo, 0, 0, std::numeric_limits<int>::max(), 1)
+    , _clearCache(ClearCacheInfo)
+{
+    if (!FileSys.directoryExists(_cacheDirectory)) {
+        FileSys.createDirectory(
+            _cacheDirectory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+    loadIndex();
+
+    addProperty(_enabled);
+
+    _cacheSize.onChange([this]() {
+        _maximumSize = static_cast<size_t>(_cacheSize) * ByteToMegaByte;
+        std::lock_guard<std::mutex> lock(_indexMutex);
+        evict(_maximumSize);
+    });
+    addProperty(_cacheSize);
+
+    _usedSize.setReadOnly(true);
+    addProperty(_usedSize);
+    _hits.setReadOnly(true);
+    addProperty(_hits);
+    _misses.setReadOnly(true);
+    addProperty(_misses);
+    _bytesRead.setReadOnly(true);
+    addProperty(_bytesRead);
+    _bytesWritten.setReadOnly(true);
+    addProperty(_bytesWritten);
+
+    _clearCache.onChange([this]() { clear(); });
+    addProperty(_clearCache);
+}
+
+DiskTileCache::~DiskTileCache() {
+    std::lock_guard<std::mutex> lock(_indexMutex);
+    saveIndex();
+}
+
+bool DiskTileCache::isEnabled() const {
+    return _enabled;
+}
+
+bool DiskTileCache::exist(const ProviderTileKey& key) const {
+    std::lock_guard<std::mutex> lock(_indexMutex);
+    return _index.exist(key);
+}
+
+std::shared_ptr<RawTile> DiskTileCache::read(const ProviderTileKey& key,
+                                             const TileTextureInitData& initData,
+                                             char* dataDestination,
+                                             char* pboMappedDataDestination)
+{
+    {
+        std::lock_guard<std::mutex> lock(_indexMutex);
+        if (!_index.touch(key)) {
+            _nMisses++;
+            return nullptr;
+        }
+        _nOpenReaders[key]++;
+    }
+
+    // Unregisters the reader after the file has been unmapped, which is guaranteed by
+    // the order of destruction, and performs a removal that was deferred while mapped
+    struct ReaderGuard {
+        ~ReaderGuard() { cache.closeReader(key); }
+        DiskTileCache& cache;
+        const ProviderTileKey& key;
+    } readerGuard = { *this, key };
+
+    // The file is only read outside of the lock. Evicting or overwriting the tile in the
+    // meantime is deferred until the file is unmapped, as a mapped file cannot be removed
+    // on all platforms
+    const MemoryMappedFile file(tilePath(key));
+    if (!file.isValid() || file.size() < sizeof(TileFileHeader)) {
+        _nMisses++;
+        return nullptr;
+    }
+
+    TileFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(TileFileHeader));
+
+    const size_t metaDataSize = header.nMetaDataValues * (2 * sizeof(float) + 1);
+    const bool isValid = header.magic == TileMagic &&
+        header.version == CurrentVersion &&
+        header.initDataHashKey == initData.hashKey() &&
+        header.uncompressedSize == initData.totalNumBytes() &&
+        file.size() == sizeof(TileFileHeader) + metaDataSize + header.compressedSize;
+    if (!isValid) {
+        _nMisses++;
+        return nullptr;
+    }
+
+    std::shared_ptr<RawTile> rawTile = std::make_shared<RawTile>();
+    const char* p = file.data() + sizeof(TileFileHeader);
+    if (header.nMetaDataValues > 0) {
+        std::shared_ptr<TileMetaData> metaData = std::make_shared<TileMetaData>();
+        const uint32_t n = header.nMetaDataValues;
+        metaData->maxValues.resize(n);
+        std::memcpy(metaData->maxValues.data(), p, n * sizeof(float));
+        p += n * sizeof(float);
+        metaData->minValues.resize(n);
+        std::memcpy(metaData->minValues.data(), p, n * sizeof(float));
+        p += n * sizeof(float);
+        metaData->hasMissingData.resize(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            metaData->hasMissingData[i] = (p[i] != 0);
+        }
+        p += n;
+        rawTile->tileMetaData = std::move(metaData);
+    }
+
+    char* destination = dataDestination ? dataDestination : pboMappedDataDestination;
+    ghoul_assert(destination, "Need to specify a data destination");
+    const int nDecompressed = LZ4_decompress_safe(
+        p,
+        destination,
+        static_cast<int>(header.compressedSize),
+        static_cast<int>(header.uncompressedSize)
+    );
+    if (nDecompressed != static_cast<int>(header.uncompressedSize)) {
+        LWARNING(fmt::format("Corrupt tile file '{}'", tilePath(key)));
+        _nMisses++;
+        return nullptr;
+    }
+    if (dataDestination && pboMappedDataDestination) {
+        std::memcpy(pboMappedDataDestination, dataDestination, header.uncompressedSize);
+    }
+
+    rawTile->imageData = dataDestination;
+    rawTile->error = RawTile::ReadError::None;
+    rawTile->tileIndex = key.tileIndex;
+    rawTile->textureInitData = std::make_shared<TileTextureInitData>(initData);
+
+    _nHits++;
+    _nBytesRead += file.size();
+    return rawTile;
+}
+
+void DiskTileCache::write(const ProviderTileKey& key, const RawTile& rawTile,
+                          const char* imageData)
+{
+    if (rawTile.error != RawTile::ReadError::None || !imageData) {
+        return;
+    }
+
+    const TileTextureInitData& initData = *rawTile.textureInitData;
+    const uint32_t nMetaDataValues = rawTile.tileMetaData ?
+        static_cast<uint32_t>(rawTile.tileMetaData->maxValues.size()) :
+        0;
+    const size_t metaDataSize = nMetaDataValues * (2 * sizeof(float) + 1);
+    const int uncompressedSize = static_cast<int>(initData.totalNumBytes());
+
+    std::vector<char> buffer(
+        sizeof(TileFileHeader) + metaDataSize + LZ4_compressBound(uncompressedSize)
+    );
+    char* p = buffer.data() + sizeof(TileFileHeader);
+    if (nMetaDataValues > 0) {
+        const TileMetaData& metaData = *rawTile.tileMetaData;
+        std::memcpy(p, metaData.maxValues.data(), nMetaDataValues * sizeof(float));
+        p += nMetaDataValues * sizeof(float);
+        std::memcpy(p, metaData.minValues.data(), nMetaDataValues * sizeof(float));
+        p += nMetaDataValues * sizeof(float);
+        for (uint32_t i = 0; i < nMetaDataValues; ++i) {
+            p[i] = metaData.hasMissingData[i] ? 1 : 0;
+        }
+        p += nMetaDataValues;
+    }
+
+    const int compressedSize = LZ4_compress_default(
+        imageData,
+        p,
+        uncompressedSize,
+        LZ4_compressBound(uncompressedSize)
+    );
+    if (compressedSize <= 0) {
+        return;
+    }
+
+    TileFileHeader header;
+    header.magic = TileMagic;
+    header.version = CurrentVersion;
+    header.initDataHashKey = initData.hashKey();
+    header.uncompressedSize = static_cast<uint64_t>(uncompressedSize);
+    header.compressedSize = static_cast<uint64_t>(compressedSize);
+    header.nMetaDataValues = nMetaDataValues;
+    header.padding = 0;
+    std::memcpy(buffer.data(), &header, sizeof(TileFileHeader));
+
+    const size_t fileSize = sizeof(TileFileHeader) + metaDataSize + compressedSize;
+
+    // Write to a temporary file first so that a concurrent reader never observes a
+    // partially written tile
+    const std::string path = tilePath(key);
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ofstream::binary);
+        if (!file.good()) {
+            LWARNING(fmt::format("Could not write tile file '{}'", temporaryPath));
+            return;
+        }
+        file.write(buffer.data(), fileSize);
+    }
+
+    std::lock_guard<std::mutex> lock(_indexMutex);
+    if (_nOpenReaders.find(key) != _nOpenReaders.end()) {
+        // The existing file is mapped by a reader and cannot be replaced right now
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+    std::remove(path.c_str());
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+
+    if (_index.exist(key)) {
+        _numBytesOnDisk -= _index.get(key);
+    }
+    _index.put(key, fileSize);
+    _numBytesOnDisk += fileSize;
+    _nBytesWritten += fileSize;
+
+    evict(_maximumSize);
+}
+
+void DiskTileCache::clear() {
+    LINFO("Clearing disk tile cache");
+    std::lock_guard<std::mutex> lock(_indexMutex);
+    evict(0);
+    LINFO("Disk tile cache cleared");
+}
+
+void DiskTileCache::update() {
+    size_t numBytesOnDisk;
+    {
+        std::lock_guard<std::mutex> lock(_indexMutex);
+        numBytesOnDisk = _numBytesOnDisk;
+    }
+
+    _usedSize = static_cast<int>(numBytesOnDisk / ByteToMegaByte);
+    _hits = clampToInt(_nHits);
+    _misses = clampToInt(_nMisses);
+    _bytesRead = clampToInt(_nBytesRead / ByteToMegaByte);
+    _bytesWritten = clampToInt(_nBytesWritten / ByteToMegaByte);
+}
+
+std::string DiskTileCache::tilePath(const ProviderTileKey& key) const {
+    return fmt::format(
+        "{}/{}_{}_{}_{}.{}",
+        _cacheDirectory,
+        key.providerID,
+        key.tileIndex.level,
+        key.tileIndex.x,
+        key.tileIndex.y,
+        TileExtension
+    );
+}
+
+void DiskTileCache::loadIndex() {
+    // The index file contains the tiles in the order from least to most recently used.
+    // It is removed after reading, so that an unclean shutdown causes a rescan of the
+    // directory instead of an index that is out of sync with the files on disk
+    const std::string indexPath = FileSys.pathByAppendingComponent(
+        _cacheDirectory,
+        IndexFile
+    );
+
+    std::ifstream indexFile(indexPath, std::ifstream::binary);
+    if (indexFile.good()) {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t nEntries = 0;
+        indexFile.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+        indexFile.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+        indexFile.read(reinterpret_cast<char*>(&nEntries), sizeof(uint64_t));
+
+        if (indexFile.good() && magic == IndexMagic && version == CurrentVersion) {
+            std::vector<IndexEntry> entries(nEntries);
+            indexFile.read(
+                reinterpret_cast<char*>(entries.data()),
+                nEntries * sizeof(IndexEntry)
+            );
+            if (indexFile.good()) {
+                for (const IndexEntry& e : entries) {
+                    const ProviderTileKey key = {
+                        TileIndex(e.x, e.y, e.level),
+                        e.providerID
+                    };
+                    if (FileSys.fileExists(tilePath(key))) {
+                        _index.put(key, static_cast<size_t>(e.size));
+                        _numBytesOnDisk += static_cast<size_t>(e.size);
+                    }
+                }
+            }
+        }
+        indexFile.close();
+        FileSys.deleteFile(indexPath);
+    }
+
+    // Pick up all tiles that are not part of the index in an unspecified order and
+    // remove leftovers from interrupted writes
+    ghoul::filesystem::Directory directory(_cacheDirectory);
+    const std::vector<std::string> files = directory.readFiles(
+        ghoul::filesystem::Directory::Recursive::No,
+        ghoul::filesystem::Directory::Sort::No
+    );
+    for (const std::string& f : files) {
+        const ghoul::filesystem::File file(f);
+        if (file.fileExtension() != TileExtension) {
+            if (file.fileExtension() == "tmp") {
+                FileSys.deleteFile(f);
+            }
+            continue;
+        }
+
+        unsigned int providerID = 0;
+        TileIndex tileIndex;
+        const int nMatched = sscanf(
+            file.baseName().c_str(),
+            "%u_%i_%i_%i",
+            &providerID,
+            &tileIndex.level,
+            &tileIndex.x,
+            &tileIndex.y
+        );
+        if (nMatched != 4) {
+            continue;
+        }
+
+        const ProviderTileKey key = { tileIndex, providerID };
+        if (!_index.exist(key)) {
+            std::ifstream tileFile(f, std::ifstream::binary | std::ifstream::ate);
+            const size_t size = static_cast<size_t>(tileFile.tellg());
+            _index.put(key, size);
+            _numBytesOnDisk += size;
+        }
+    }
+
+    LDEBUG(fmt::format(
+        "Loaded {} tiles ({} MB) from '{}'",
+        _index.size(), _numBytesOnDisk / ByteToMegaByte, _cacheDirectory
+    ));
+    evict(_maximumSize);
+}
+
+void DiskTileCache::saveIndex() {
+    std::vector<IndexEntry> entries;
+    entries.reserve(_index.size());
+    while (!_index.isEmpty()) {
+        const std::pair<ProviderTileKey, size_t> item = _index.popLRU();
+        entries.push_back({
+            item.first.providerID,
+            item.first.tileIndex.level,
+            item.first.tileIndex.x,
+            item.first.tileIndex.y,
+            static_cast<uint64_t>(item.second)
+        });
+    }
+
+    const std::string indexPath = FileSys.pathByAppendingComponent(
+        _cacheDirectory,
+        IndexFile
+    );
+    std::ofstream indexFile(indexPath, std::ofstream::binary);
+    if (!indexFile.good()) {
+        LWARNING(fmt::format("Could not write disk cache index '{}'", indexPath));
+        return;
+    }
+    const uint64_t nEntries = entries.size();
+    indexFile.write(reinterpret_cast<const char*>(&IndexMagic), sizeof(uint32_t));
+    indexFile.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(uint32_t));
+    indexFile.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    indexFile.write(
+        reinterpret_cast<const char*>(entries.data()),
+        entries.size() * sizeof(IndexEntry)
+    );
+}
+
+void DiskTileCache::evict(size_t budget) {
+    // Assumes that _indexMutex is locked
+    while (_numBytesOnDisk > budget && !_index.isEmpty()) {
+        const std::pair<ProviderTileKey, size_t> item = _index.popLRU();
+        if (_nOpenReaders.find(item.first) != _nOpenReaders.end()) {
+            // The last reader removes the file once it has been unmapped
+            _pendingRemovals.insert(item.first);
+        }
+        else {
+            std::remove(tilePath(item.first).c_str());
+        }
+        _numBytesOnDisk -= item.second;
+    }
+}
+
+void DiskTileCache::closeReader(const ProviderTileKey& key) {
+    std::lock_guard<std::mutex> lock(_indexMutex);
+    const auto it = _nOpenReaders.find(key);
+    ghoul_assert(it != _nOpenReaders.end(), "Reader was not registered");
+    if (--(it->second) > 0) {
+        return;
+    }
+    _nOpenReaders.erase(it);
+
+    // The tile might have been evicted and already written again in the meantime
+    if (_pendingRemovals.erase(key) > 0 && !_index.exist(key)) {
+        std::remove(tilePath(key).c_str());
+    }
+}
+
+} // namespace openspace::globebrowsing::cache
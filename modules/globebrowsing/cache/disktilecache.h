@@ -0,0 +1,132 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+
+#include <modules/globebrowsing/cache/lrucache.h>
+#include <modules/globebrowsing/cache/memoryawaretilecache.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/triggerproperty.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace openspace::globebrowsing {
+    struct RawTile;
+    class TileTextureInitData;
+} // namespace openspace::globebrowsing
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A persistent tile cache tier that sits beneath the MemoryAwareTileCache. Each tile is
+ * stored LZ4 compressed in its own file inside the cache directory and is read back
+ * through a memory mapping. The cache keeps its own least-recently-used order and
+ * evicts tiles once the total size on disk exceeds the configured budget. The order is
+ * persisted in an index file on destruction so that it survives application restarts.
+ *
+ * The <code>providerID</code> of the ProviderTileKey must be stable across sessions,
+ * see AsyncTileDataProvider for how it is derived. All public methods are thread-safe
+ * as they are called from the tile loading threads.
+ */
+class DiskTileCache : public properties::PropertyOwner {
+public:
+    /**
+     * \param cacheDirectory is the directory in which the tiles are stored. The
+     *        directory is created if it does not exist
+     * \param maximumSize is the initial budget of the cache in bytes
+     */
+    DiskTileCache(std::string cacheDirectory, size_t maximumSize);
+    ~DiskTileCache();
+
+    bool isEnabled() const;
+    bool exist(const ProviderTileKey& key) const;
+
+    /**
+     * Reads the tile identified by \p key into the provided destinations, which follow
+     * the same rules as for RawTileDataReader::readTileData. If the tile is not cached,
+     * or if it was stored with a different TileTextureInitData, <code>nullptr</code> is
+     * returned and the destinations are left untouched.
+     */
+    std::shared_ptr<RawTile> read(const ProviderTileKey& key,
+        const TileTextureInitData& initData, char* dataDestination,
+        char* pboMappedDataDestination);
+
+    /**
+     * Compresses and stores the tile data pointed to by \p imageData. Tiles that were
+     * read with an error are not stored.
+     */
+    void write(const ProviderTileKey& key, const RawTile& rawTile,
+        const char* imageData);
+
+    void clear();
+
+    /**
+     * Updates the statistics properties. Has to be called from the main thread.
+     */
+    void update();
+
+private:
+    std::string tilePath(const ProviderTileKey& key) const;
+    void loadIndex();
+    void saveIndex();
+    void evict(size_t budget);
+    void closeReader(const ProviderTileKey& key);
+
+    const std::string _cacheDirectory;
+
+    mutable std::mutex _indexMutex;
+    /// Maps from the tile to the number of bytes it is occupying on disk
+    LRUCache<ProviderTileKey, size_t, ProviderTileHasher> _index;
+    size_t _numBytesOnDisk = 0;
+    /// The number of readers that currently have the file of a tile mapped
+    std::unordered_map<ProviderTileKey, int, ProviderTileHasher> _nOpenReaders;
+    /// Evicted tiles whose files are removed once the last reader has unmapped them
+    std::unordered_set<ProviderTileKey, ProviderTileHasher> _pendingRemovals;
+    std::atomic<size_t> _maximumSize;
+
+    std::atomic<uint64_t> _nHits = { 0 };
+    std::atomic<uint64_t> _nMisses = { 0 };
+    std::atomic<uint64_t> _nBytesRead = { 0 };
+    std::atomic<uint64_t> _nBytesWritten = { 0 };
+
+    properties::BoolProperty _enabled;
+    properties::IntProperty _cacheSize;
+    properties::IntProperty _usedSize;
+    properties::IntProperty _hits;
+    properties::IntProperty _misses;
+    properties::IntProperty _bytesRead;
+    properties::IntProperty _bytesWritten;
+    properties::TriggerProperty _clearCache;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
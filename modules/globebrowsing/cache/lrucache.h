@@ -25,8 +25,10 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
-#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace openspace::globebrowsing::cache {
@@ -34,17 +36,28 @@ namespace openspace::globebrowsing::cache {
 /**
  * Templated class implementing a Least-Recently-Used Cache.
  * <code>KeyType</code> needs to be an enumerable type.
+ *
+ * The items are stored in a contiguous array of slots that are linked into a recency
+ * list through their indices, and are looked up through an open-addressing hash table
+ * using linear probing. Slots are reused when items are removed, so no memory is
+ * allocated unless the number of items grows beyond the number of slots that have been
+ * allocated before.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
 
     /**
      * \param size is the maximum size of the cache given in number of cached items.
      */
     LRUCache(size_t size);
+    ~LRUCache();
+
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+    LRUCache(LRUCache&& other) noexcept;
+    LRUCache& operator=(LRUCache&& other) noexcept;
 
     void put(KeyType key, ValueType value);
     std::vector<Item> putAndFetchPopped(KeyType key, ValueType value);
@@ -57,7 +70,13 @@ public:
      */
     bool touch(const KeyType& key);
     bool isEmpty() const;
-    ValueType get(const KeyType& key);
+
+    /**
+     * Returns a reference to the value of the key, which has to exist in the cache, and
+     * bumps it to the front of the queue. The reference is valid until the next call
+     * that adds or removes items from the cache.
+     */
+    ValueType& get(const KeyType& key);
 
     /**
      * Pops the front of the queue.
@@ -72,13 +91,48 @@ public:
     size_t maximumCacheSize() const;
 
 private:
-    void putWithoutCleaning(KeyType key, ValueType value);
-    void clean();
+    using Index = uint32_t;
+    static constexpr const Index Invalid = ~Index(0);
+
+    struct Slot {
+        typename std::aligned_storage<sizeof(Item), alignof(Item)>::type storage;
+        /// Towards the most recently used item or the next free slot
+        Index previous;
+        /// Towards the least recently used item
+        Index next;
+        /// Cached hash of the key, used when moving entries in the hash table
+        size_t hash;
+
+        Item& item();
+        const Item& item() const;
+    };
 
+    size_t hash(const KeyType& key) const;
+
+    /// Returns the bucket of the key or the empty bucket where it would be placed
+    size_t findBucket(const KeyType& key, size_t hash) const;
+
+    Index putWithoutCleaning(KeyType key, ValueType value);
+    Item removeSlot(Index slot);
+    void clean();
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    void linkFront(Index slot);
+    void unlink(Index slot);
+    Index allocateSlot();
+    void grow();
+    void rebuildBuckets(size_t nBuckets);
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _capacity = 0;
+    Index _firstFreeSlot = Invalid;
+
+    /// Contains the slot indices of the items or Invalid for empty buckets
+    std::vector<Index> _buckets;
+
+    Index _mostRecentlyUsed = Invalid;
+    Index _leastRecentlyUsed = Invalid;
+    size_t _size = 0;
 
     size_t _maximumCacheSize;
 };
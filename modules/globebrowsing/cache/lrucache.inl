@@ -23,18 +23,115 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/assert.h>
+#include <new>
 
 namespace openspace::globebrowsing::cache {
 
+namespace lrucache {
+    // The initial number of slots that are allocated for caches that are allowed to
+    // grow larger than this
+    constexpr const size_t InitialCapacity = 256;
+
+    // The hashers used for the caches, for example the ProviderTileHasher, produce keys
+    // with most of the variation in the higher bits. Mixing the bits ensures that the
+    // lower bits, which select the bucket, are well distributed
+    inline size_t mix(unsigned long long h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+} // namespace lrucache
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Item&
+LRUCache<KeyType, ValueType, HasherType>::Slot::item()
+{
+    return *reinterpret_cast<Item*>(&storage);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+const typename LRUCache<KeyType, ValueType, HasherType>::Item&
+LRUCache<KeyType, ValueType, HasherType>::Slot::item() const
+{
+    return *reinterpret_cast<const Item*>(&storage);
+}
+
 template<typename KeyType, typename ValueType, typename HasherType>
 LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
     : _maximumCacheSize(size)
-{}
+{
+    // One more than the maximum size is needed as an item is added before the cache
+    // is cleaned
+    const size_t capacity = size < lrucache::InitialCapacity ?
+        size + 1 :
+        lrucache::InitialCapacity;
+
+    _slots = std::make_unique<Slot[]>(capacity);
+    _capacity = capacity;
+    for (size_t i = 0; i < _capacity; ++i) {
+        _slots[i].previous = static_cast<Index>(i + 1);
+    }
+    _slots[_capacity - 1].previous = Invalid;
+    _firstFreeSlot = 0;
+
+    rebuildBuckets(_capacity * 2);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+LRUCache<KeyType, ValueType, HasherType>::~LRUCache() {
+    clear();
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+LRUCache<KeyType, ValueType, HasherType>::LRUCache(LRUCache&& other) noexcept
+    : _slots(std::move(other._slots))
+    , _capacity(other._capacity)
+    , _firstFreeSlot(other._firstFreeSlot)
+    , _buckets(std::move(other._buckets))
+    , _mostRecentlyUsed(other._mostRecentlyUsed)
+    , _leastRecentlyUsed(other._leastRecentlyUsed)
+    , _size(other._size)
+    , _maximumCacheSize(other._maximumCacheSize)
+{
+    other._capacity = 0;
+    other._firstFreeSlot = Invalid;
+    other._mostRecentlyUsed = Invalid;
+    other._leastRecentlyUsed = Invalid;
+    other._size = 0;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+LRUCache<KeyType, ValueType, HasherType>&
+LRUCache<KeyType, ValueType, HasherType>::operator=(LRUCache&& other) noexcept
+{
+    if (this != &other) {
+        clear();
+        _slots = std::move(other._slots);
+        _capacity = other._capacity;
+        _firstFreeSlot = other._firstFreeSlot;
+        _buckets = std::move(other._buckets);
+        _mostRecentlyUsed = other._mostRecentlyUsed;
+        _leastRecentlyUsed = other._leastRecentlyUsed;
+        _size = other._size;
+        _maximumCacheSize = other._maximumCacheSize;
+
+        other._capacity = 0;
+        other._firstFreeSlot = Invalid;
+        other._mostRecentlyUsed = Invalid;
+        other._leastRecentlyUsed = Invalid;
+        other._size = 0;
+    }
+    return *this;
+}
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
-    _itemMap.clear();
+    while (_mostRecentlyUsed != Invalid) {
+        removeSlot(_mostRecentlyUsed);
+    }
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -53,67 +150,56 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    if (_size == 0) {
+        return false;
+    }
+    return _buckets[findBucket(key, hash(key))] != Invalid;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) { // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
-        // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
-
-        return true;
-    } else {
+    if (_size == 0) {
+        return false;
+    }
+    const Index slot = _buckets[findBucket(key, hash(key))];
+    if (slot == Invalid) {
         return false;
     }
+    // Bump to front
+    unlink(slot);
+    linkFront(slot);
+    return true;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return (_size == 0);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
-    //ghoul_assert(exist(key), "Key " << key << " must exist");
-    const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    return it->second->second;
+ValueType& LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
+    const Index slot = _buckets[findBucket(key, hash(key))];
+    ghoul_assert(slot != Invalid, "Key must exist");
+    unlink(slot);
+    linkFront(slot);
+    return _slots[slot].item().second;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
-
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+    ghoul_assert(_size > 0, "Cannot pop LRU cache. Ensure cache is not empty.");
+    return removeSlot(_mostRecentlyUsed);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
-
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+    ghoul_assert(_size > 0, "Cannot pop LRU cache. Ensure cache is not empty.");
+    return removeSlot(_leastRecentlyUsed);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 size_t LRUCache<KeyType, ValueType, HasherType>::size() const {
-    return _itemMap.size();
+    return _size;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -122,25 +208,102 @@ size_t LRUCache<KeyType, ValueType, HasherType>::maximumCacheSize() const {
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
-                                                                  ValueType value)
+size_t LRUCache<KeyType, ValueType, HasherType>::hash(const KeyType& key) const {
+    return lrucache::mix(static_cast<unsigned long long>(HasherType()(key)));
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::findBucket(const KeyType& key,
+                                                            size_t hash) const
 {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    // The table is never more than half full, so there is always an empty bucket
+    const size_t mask = _buckets.size() - 1;
+    size_t bucket = hash & mask;
+    while (_buckets[bucket] != Invalid) {
+        const Slot& s = _slots[_buckets[bucket]];
+        if (s.hash == hash && s.item().first == key) {
+            return bucket;
+        }
+        bucket = (bucket + 1) & mask;
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+    return bucket;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Index
+LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
+                                                             ValueType value)
+{
+    if (_buckets.empty()) {
+        // Only happens if this cache has been moved from
+        grow();
+    }
+
+    const size_t h = hash(key);
+    size_t bucket = findBucket(key, h);
+    Index slot = _buckets[bucket];
+    if (slot != Invalid) {
+        _slots[slot].item().second = std::move(value);
+        unlink(slot);
+        linkFront(slot);
+        return slot;
+    }
+
+    if (_firstFreeSlot == Invalid) {
+        grow();
+        bucket = findBucket(key, h);
+    }
+    slot = allocateSlot();
+    new (&_slots[slot].storage) Item(std::move(key), std::move(value));
+    _slots[slot].hash = h;
+    _buckets[bucket] = slot;
+    linkFront(slot);
+    ++_size;
+    return slot;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+LRUCache<KeyType, ValueType, HasherType>::removeSlot(Index slot)
+{
+    Slot& s = _slots[slot];
+
+    // Remove the entry from the hash table by shifting back the entries following it
+    // in the same probe sequence, which avoids the need for tombstones
+    const size_t mask = _buckets.size() - 1;
+    size_t hole = findBucket(s.item().first, s.hash);
+    size_t bucket = hole;
+    while (true) {
+        bucket = (bucket + 1) & mask;
+        if (_buckets[bucket] == Invalid) {
+            break;
+        }
+        const size_t home = _slots[_buckets[bucket]].hash & mask;
+        // The entry can be moved into the hole if its home bucket is not cyclically
+        // located in the range (hole, bucket]
+        const bool isInRange = (hole <= bucket) ?
+            (home > hole && home <= bucket) :
+            (home > hole || home <= bucket);
+        if (!isInRange) {
+            _buckets[hole] = _buckets[bucket];
+            hole = bucket;
+        }
+    }
+    _buckets[hole] = Invalid;
+
+    unlink(slot);
+    Item item = std::move(s.item());
+    s.item().~Item();
+    s.previous = _firstFreeSlot;
+    _firstFreeSlot = slot;
+    --_size;
+    return item;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+    while (_size > _maximumCacheSize) {
+        removeSlot(_leastRecentlyUsed);
     }
 }
 
@@ -149,14 +312,99 @@ std::vector<std::pair<KeyType, ValueType>>
 LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+    while (_size > _maximumCacheSize) {
+        toReturn.push_back(removeSlot(_leastRecentlyUsed));
     }
     return toReturn;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::linkFront(Index slot) {
+    Slot& s = _slots[slot];
+    s.previous = Invalid;
+    s.next = _mostRecentlyUsed;
+    if (_mostRecentlyUsed != Invalid) {
+        _slots[_mostRecentlyUsed].previous = slot;
+    }
+    _mostRecentlyUsed = slot;
+    if (_leastRecentlyUsed == Invalid) {
+        _leastRecentlyUsed = slot;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(Index slot) {
+    Slot& s = _slots[slot];
+    if (s.previous != Invalid) {
+        _slots[s.previous].next = s.next;
+    }
+    else {
+        _mostRecentlyUsed = s.next;
+    }
+    if (s.next != Invalid) {
+        _slots[s.next].previous = s.previous;
+    }
+    else {
+        _leastRecentlyUsed = s.previous;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Index
+LRUCache<KeyType, ValueType, HasherType>::allocateSlot()
+{
+    ghoul_assert(_firstFreeSlot != Invalid, "No free slot available");
+    const Index slot = _firstFreeSlot;
+    _firstFreeSlot = _slots[slot].previous;
+    return slot;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::grow() {
+    const size_t capacity = _capacity > 0 ? _capacity * 2 : lrucache::InitialCapacity;
+    std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(capacity);
+
+    // Move the items into the same slots in the new array, which keeps the recency list
+    // intact
+    for (Index i = _mostRecentlyUsed; i != Invalid; i = _slots[i].next) {
+        Slot& from = _slots[i];
+        Slot& to = slots[i];
+        new (&to.storage) Item(std::move(from.item()));
+        from.item().~Item();
+        to.previous = from.previous;
+        to.next = from.next;
+        to.hash = from.hash;
+    }
+
+    // All new slots are free; the old ones are all occupied as we only grow when the
+    // free list is empty
+    for (size_t i = _capacity; i < capacity; ++i) {
+        slots[i].previous = static_cast<Index>(i + 1);
+    }
+    slots[capacity - 1].previous = Invalid;
+    _firstFreeSlot = static_cast<Index>(_capacity);
+
+    _slots = std::move(slots);
+    _capacity = capacity;
+    rebuildBuckets(_capacity * 2);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::rebuildBuckets(size_t nBuckets) {
+    size_t size = 1;
+    while (size < nBuckets) {
+        size <<= 1;
+    }
+    _buckets.assign(size, Invalid);
+
+    const size_t mask = size - 1;
+    for (Index i = _mostRecentlyUsed; i != Invalid; i = _slots[i].next) {
+        size_t bucket = _slots[i].hash & mask;
+        while (_buckets[bucket] != Invalid) {
+            bucket = (bucket + 1) & mask;
+        }
+        _buckets[bucket] = i;
+    }
+}
+
 } // namespace openspace::globebrowsing::cache
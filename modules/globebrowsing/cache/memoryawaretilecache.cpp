@@ -204,7 +204,7 @@ bool MemoryAwareTileCache::exist(const ProviderTileKey& key) const {
     return result != _textureContainerMap.cend();
 }
 
-Tile MemoryAwareTileCache::get(const ProviderTileKey& key) {
+const Tile& MemoryAwareTileCache::get(const ProviderTileKey& key) {
     const TextureContainerMap::const_iterator it = std::find_if(
         _textureContainerMap.cbegin(),
         _textureContainerMap.cend(),
@@ -90,7 +90,7 @@ public:
     void clear();
     void setSizeEstimated(size_t estimatedSize);
     bool exist(const ProviderTileKey& key) const;
-    Tile get(const ProviderTileKey& key);
+    const Tile& get(const ProviderTileKey& key);
     ghoul::opengl::Texture* texture(const TileTextureInitData& initData);
     void createTileAndPut(ProviderTileKey key, RawTile& rawTile);
     void put(const ProviderTileKey& key,
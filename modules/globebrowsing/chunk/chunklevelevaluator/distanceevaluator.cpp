@@ -32,6 +32,15 @@
 namespace openspace::globebrowsing::chunklevelevaluator {
 
 int Distance::desiredLevel(const Chunk& chunk, const RenderData& data) const {
+    const RenderableGlobe& globe = chunk.owner();
+    const double scaleFactor = globe.generalProperties().lodScaleFactor *
+                               globe.ellipsoid().minimumRadius();
+    const double projectedScaleFactor = scaleFactor / distance(chunk, data);
+    const int desiredLevel = static_cast<int>(ceil(log2(projectedScaleFactor)));
+    return desiredLevel;
+}
+
+double Distance::distance(const Chunk& chunk, const RenderData& data) const {
     // Calculations are done in the reference frame of the globe
     // (model space). Hence, the camera position needs to be transformed
     // with the inverse model matrix
@@ -56,15 +65,7 @@ int Distance::desiredLevel(const Chunk& chunk, const RenderData& data) const {
 
     const glm::dvec3 cameraToChunk = patchPosition - cameraPosition;
 
-    // Calculate desired level based on distance
-    const double distanceToPatch = glm::length(cameraToChunk);
-    const double distance = distanceToPatch;
-
-    const double scaleFactor = globe.generalProperties().lodScaleFactor *
-                               ellipsoid.minimumRadius();
-    const double projectedScaleFactor = scaleFactor / distance;
-    const int desiredLevel = static_cast<int>(ceil(log2(projectedScaleFactor)));
-    return desiredLevel;
+    return glm::length(cameraToChunk);
 }
 
 } // namespace openspace::globebrowsing::chunklevelevaluator
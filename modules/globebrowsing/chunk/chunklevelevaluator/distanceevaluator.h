@@ -37,6 +37,11 @@ namespace openspace::globebrowsing::chunklevelevaluator {
 class Distance : public Evaluator {
 public:
     int desiredLevel(const Chunk& chunk, const RenderData& data) const override;
+
+    /**
+     * \return the distance from the camera to the closest point of the \p chunk
+     */
+    double distance(const Chunk& chunk, const RenderData& data) const;
 };
 
 } // namespace openspace::globebrowsing::chunklevelevaluator
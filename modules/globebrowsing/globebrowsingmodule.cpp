@@ -24,10 +24,13 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 
+#include <modules/globebrowsing/cache/disktilecache.h>
 #include <modules/globebrowsing/cache/memoryawaretilecache.h>
 #include <modules/globebrowsing/geometry/geodetic3.h>
 #include <modules/globebrowsing/geometry/geodeticpatch.h>
+#include <modules/globebrowsing/other/workstealingthreadpool.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/gdalwrapper.h>
+#include <modules/globebrowsing/tile/tileprefetcher.h>
 #include <modules/globebrowsing/tile/tileprovider/defaulttileprovider.h>
 #include <modules/globebrowsing/tile/tileprovider/singleimageprovider.h>
 #include <modules/globebrowsing/tile/tileprovider/sizereferencetileprovider.h>
@@ -44,6 +47,8 @@
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <algorithm>
+#include <thread>
 #include <vector>
 
 #ifdef GLOBEBROWSING_USE_GDAL
@@ -68,6 +73,13 @@
 namespace {
     constexpr const char* _loggerCat = "GlobeBrowsingModule";
 
+    constexpr const char* KeyDiskTileCacheDirectory = "DiskTileCacheDirectory";
+    constexpr const char* KeyDiskTileCacheSize = "DiskTileCacheSize";
+    constexpr const char* KeyTileLoadingThreads = "TileLoadingThreads";
+
+    constexpr const char* DefaultDiskTileCacheDirectory = "${CACHE}/globebrowsing";
+    constexpr const double DefaultDiskTileCacheSize = 4096.0; // MB
+
 #ifdef GLOBEBROWSING_USE_GDAL
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -128,7 +140,22 @@ namespace openspace {
 
 GlobeBrowsingModule::GlobeBrowsingModule() : OpenSpaceModule(Name) {}
 
-void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
+void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& configuration) {
+    _diskTileCacheDirectory = DefaultDiskTileCacheDirectory;
+    configuration.getValue(KeyDiskTileCacheDirectory, _diskTileCacheDirectory);
+
+    double diskTileCacheSize = DefaultDiskTileCacheSize;
+    configuration.getValue(KeyDiskTileCacheSize, diskTileCacheSize);
+    _diskTileCacheSize = static_cast<size_t>(diskTileCacheSize) * 1024 * 1024;
+
+    // Tile loading is to a large extent waiting for disk or network, so we want at least
+    // a few threads even on machines with few cores
+    double nTileLoadingThreads = static_cast<double>(
+        std::max(std::thread::hardware_concurrency(), 4u)
+    );
+    configuration.getValue(KeyTileLoadingThreads, nTileLoadingThreads);
+    _nTileLoadingThreads = std::max(static_cast<size_t>(nTileLoadingThreads), size_t(1));
+
     // TODO: Remove dependency on OsEng.
     // Instead, make this class implement an interface that OsEng depends on.
     // Do not try to register module callbacks if OsEng does not exist,
@@ -146,6 +173,19 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
         [&]() {
             _tileCache = std::make_unique<globebrowsing::cache::MemoryAwareTileCache>();
             addPropertySubOwner(*_tileCache);
+
+            _tileLoadingThreadPool = std::make_shared<WorkStealingThreadPool>(
+                _nTileLoadingThreads
+            );
+
+            _diskTileCache = std::make_unique<globebrowsing::cache::DiskTileCache>(
+                absPath(_diskTileCacheDirectory),
+                _diskTileCacheSize
+            );
+            addPropertySubOwner(*_diskTileCache);
+
+            _tilePrefetcher = std::make_unique<TilePrefetcher>();
+            addPropertySubOwner(*_tilePrefetcher);
 #ifdef GLOBEBROWSING_USE_GDAL
             // Convert from MB to Bytes
             GdalWrapper::create(
@@ -157,10 +197,23 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
         }
     );
 
+    // PostSyncPreDraw
+    OsEng.registerModuleCallback(
+        OpenSpaceEngine::CallbackOption::PostSyncPreDraw,
+        [&]() {
+            // The camera has been updated at this point, so the prediction is valid for
+            // all globes that are rendered in this frame
+            _tilePrefetcher->update();
+        }
+    );
+
     // Render
     OsEng.registerModuleCallback(
         OpenSpaceEngine::CallbackOption::Render,
-        [&]() { _tileCache->update(); }
+        [&]() {
+            _tileCache->update();
+            _diskTileCache->update();
+        }
     );
 
     // Deinitialize
@@ -223,6 +276,20 @@ globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+globebrowsing::cache::DiskTileCache* GlobeBrowsingModule::diskTileCache() {
+    return _diskTileCache.get();
+}
+
+std::shared_ptr<globebrowsing::WorkStealingThreadPool>
+GlobeBrowsingModule::tileLoadingThreadPool()
+{
+    return _tileLoadingThreadPool;
+}
+
+globebrowsing::TilePrefetcher* GlobeBrowsingModule::tilePrefetcher() {
+    return _tilePrefetcher.get();
+}
+
 scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
     std::string listLayerGroups = layerGroupNamesList();
 
@@ -37,7 +37,13 @@ namespace openspace::globebrowsing {
     struct Geodetic2;
     struct Geodetic3;
 
-    namespace cache { class MemoryAwareTileCache; }
+    class TilePrefetcher;
+    class WorkStealingThreadPool;
+
+    namespace cache {
+        class DiskTileCache;
+        class MemoryAwareTileCache;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
@@ -58,6 +64,15 @@ public:
         double latitude, double longitude, double altitude);
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+    globebrowsing::cache::DiskTileCache* diskTileCache();
+
+    /**
+     * \return the thread pool that is shared by all tile providers for loading tiles
+     */
+    std::shared_ptr<globebrowsing::WorkStealingThreadPool> tileLoadingThreadPool();
+
+    globebrowsing::TilePrefetcher* tilePrefetcher();
+
     scripting::LuaLibrary luaLibrary() const override;
     const globebrowsing::RenderableGlobe* castFocusNodeRenderableToGlobe();
 
@@ -107,6 +122,13 @@ private:
     static std::string layerTypeNamesList();
 
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<globebrowsing::cache::DiskTileCache> _diskTileCache;
+    std::string _diskTileCacheDirectory;
+    size_t _diskTileCacheSize = 0;
+
+    std::shared_ptr<globebrowsing::WorkStealingThreadPool> _tileLoadingThreadPool;
+    size_t _nTileLoadingThreads = 0;
+    std::unique_ptr<globebrowsing::TilePrefetcher> _tilePrefetcher;
 
 #ifdef GLOBEBROWSING_USE_GDAL
     // name -> capabilities
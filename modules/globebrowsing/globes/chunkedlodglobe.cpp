@@ -33,18 +33,26 @@
 #include <modules/globebrowsing/chunk/culling/chunkculler.h>
 #include <modules/globebrowsing/chunk/culling/frustumculler.h>
 #include <modules/globebrowsing/chunk/culling/horizonculler.h>
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/globes/heightqueryservice.h>
 #include <modules/globebrowsing/globes/renderableglobe.h>
 #include <modules/globebrowsing/meshes/skirtedgrid.h>
 #include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tileprefetcher.h>
 #include <modules/globebrowsing/tile/tileprovider/tileprovider.h>
 #include <modules/globebrowsing/rendering/chunkrenderer.h>
 #include <modules/globebrowsing/rendering/layer/layer.h>
 #include <modules/globebrowsing/rendering/layer/layergroup.h>
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <modules/debugging/rendering/debugrenderer.h>
+#include <openspace/engine/moduleengine.h>
+#include <openspace/engine/openspaceengine.h>
 #include <openspace/util/time.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 //#include <math.h>
 
 namespace {
@@ -95,6 +103,12 @@ ChunkedLodGlobe::ChunkedLodGlobe(const RenderableGlobe& owner, size_t segmentsPe
     _chunkEvaluatorByDistance = std::make_unique<chunklevelevaluator::Distance>();
 
     _renderer = std::make_unique<ChunkRenderer>(geometry, layerManager, ellipsoid);
+
+    _heightQueryService = std::make_unique<HeightQueryService>(
+        owner,
+        *this,
+        layerManager
+    );
 }
 
 ChunkedLodGlobe::~ChunkedLodGlobe() {} // NOLINT
@@ -158,127 +172,11 @@ int ChunkedLodGlobe::desiredLevel(const Chunk& chunk,
 }
 
 float ChunkedLodGlobe::getHeight(const glm::dvec3& position) const {
-    float height = 0;
-
-    // Get the uv coordinates to sample from
-    const Geodetic2 geodeticPosition = _owner.ellipsoid().cartesianToGeodetic2(position);
-    const int chunkLevel = findChunkNode(geodeticPosition).chunk().tileIndex().level;
-
-    const TileIndex tileIndex = TileIndex(geodeticPosition, chunkLevel);
-    const GeodeticPatch patch = GeodeticPatch(tileIndex);
-
-    const Geodetic2 geoDiffPatch = patch.corner(Quad::NORTH_EAST) -
-                                   patch.corner(Quad::SOUTH_WEST);
-
-    const Geodetic2 geoDiffPoint = geodeticPosition - patch.corner(Quad::SOUTH_WEST);
-    const glm::vec2 patchUV = glm::vec2(
-        geoDiffPoint.lon / geoDiffPatch.lon,
-        geoDiffPoint.lat / geoDiffPatch.lat
-    );
-
-    // Get the tile providers for the height maps
-    const std::vector<std::shared_ptr<Layer>>& heightMapLayers =
-        _layerManager->layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
-
-    for (const std::shared_ptr<Layer>& layer : heightMapLayers) {
-        tileprovider::TileProvider* tileProvider = layer->tileProvider();
-        if (!tileProvider) {
-            continue;
-        }
-        // Transform the uv coordinates to the current tile texture
-        const ChunkTile chunkTile = tileProvider->chunkTile(tileIndex);
-        const Tile& tile = chunkTile.tile;
-        const TileUvTransform& uvTransform = chunkTile.uvTransform;
-        const TileDepthTransform& depthTransform = tileProvider->depthTransform();
-        if (tile.status() != Tile::Status::OK) {
-            return 0;
-        }
-
-        ghoul::opengl::Texture* tileTexture = tile.texture();
-        if (!tileTexture) {
-            return 0;
-        }
-
-        glm::vec2 transformedUv = layer->TileUvToTextureSamplePosition(
-            uvTransform,
-            patchUV,
-            glm::uvec2(tileTexture->dimensions())
-        );
-
-        // Sample and do linear interpolation
-        // (could possibly be moved as a function in ghoul texture)
-        // Suggestion: a function in ghoul::opengl::Texture that takes uv coordinates
-        // in range [0,1] and uses the set interpolation method and clamping.
-
-        const glm::uvec3 dimensions = tileTexture->dimensions();
-
-        const glm::vec2 samplePos = transformedUv * glm::vec2(dimensions);
-        glm::uvec2 samplePos00 = samplePos;
-        samplePos00 = glm::clamp(
-            samplePos00,
-            glm::uvec2(0, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
-
-        const glm::uvec2 samplePos10 = glm::min(
-            samplePos00 + glm::uvec2(1, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos01 = glm::min(
-            samplePos00 + glm::uvec2(0, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos11 = glm::min(
-            samplePos00 + glm::uvec2(1, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-
-        const float sample00 = tileTexture->texelAsFloat(samplePos00).x;
-        const float sample10 = tileTexture->texelAsFloat(samplePos10).x;
-        const float sample01 = tileTexture->texelAsFloat(samplePos01).x;
-        const float sample11 = tileTexture->texelAsFloat(samplePos11).x;
-
-        // In case the texture has NaN or no data values don't use this height map.
-        const bool anySampleIsNaN =
-            std::isnan(sample00) ||
-            std::isnan(sample01) ||
-            std::isnan(sample10) ||
-            std::isnan(sample11);
-
-        const bool anySampleIsNoData =
-            sample00 == tileProvider->noDataValueAsFloat() ||
-            sample01 == tileProvider->noDataValueAsFloat() ||
-            sample10 == tileProvider->noDataValueAsFloat() ||
-            sample11 == tileProvider->noDataValueAsFloat();
-
-        if (anySampleIsNaN || anySampleIsNoData) {
-            continue;
-        }
+    return _heightQueryService->height(position);
+}
 
-        const float sample0 = sample00 * (1.f - samplePosFract.x) +
-                              sample10 * samplePosFract.x;
-        const float sample1 = sample01 * (1.f - samplePosFract.x) +
-                              sample11 * samplePosFract.x;
-
-        const float sample = sample0 * (1.f - samplePosFract.y) +
-                             sample1 * samplePosFract.y;
-
-        // Same as is used in the shader. This is not a perfect solution but
-        // if the sample is actually a no-data-value (min_float) the interpolated
-        // value might not be. Therefore we have a cut-off. Assuming no data value
-        // is smaller than -100000
-        if (sample > -100000) {
-            // Perform depth transform to get the value in meters
-            height = depthTransform.depthOffset + depthTransform.depthScale * sample;
-            // Make sure that the height value follows the layer settings.
-            // For example if the multiplier is set to a value bigger than one,
-            // the sampled height should be modified as well.
-            height = layer->renderSettings().performLayerSettings(height);
-        }
-    }
-    // Return the result
-    return height;
+HeightQueryService& ChunkedLodGlobe::heightQueryService() const {
+    return *_heightQueryService;
 }
 
 void ChunkedLodGlobe::notifyShaderRecompilation() {
@@ -314,8 +212,14 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
                     viewTransform;
     const glm::dmat4 mvp = vp * _owner.modelTransform();
 
+    TilePrefetcher* prefetcher =
+        OsEng.moduleEngine().module<GlobeBrowsingModule>()->tilePrefetcher();
+    bool hasPrefetchBudget = prefetcher != nullptr;
+
     // Render function
-    auto renderJob = [this, &data, &mvp](const ChunkNode& chunkNode) {
+    auto renderJob = [this, &data, &mvp, prefetcher, &hasPrefetchBudget]
+                     (const ChunkNode& chunkNode)
+    {
 #ifdef DEBUG_GLOBEBROWSING_STATSRECORD
         stats.i["chunks nodes"]++;
 #endif // DEBUG_GLOBEBROWSING_STATSRECORD
@@ -329,8 +233,17 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
 #ifdef DEBUG_GLOBEBROWSING_STATSRECORD
                 stats.i["rendered chunks"]++;
 #endif // DEBUG_GLOBEBROWSING_STATSRECORD
-                _renderer->renderChunk(chunkNode.chunk(), data);
+                // Tiles that are requested while rendering a chunk are loaded in order
+                // of the distance between the camera and the chunk
+                const float tileRequestPriority = static_cast<float>(
+                    -_chunkEvaluatorByDistance->distance(chunk, data)
+                );
+                _renderer->renderChunk(chunkNode.chunk(), data, tileRequestPriority);
                 debugRenderChunk(chunk, mvp);
+
+                if (hasPrefetchBudget) {
+                    hasPrefetchBudget = prefetchUpcomingTiles(chunk, *prefetcher);
+                }
             }
         }
     };
@@ -338,6 +251,10 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
     _leftRoot->breadthFirst(renderJob);
     _rightRoot->breadthFirst(renderJob);
 
+    // Prefetching is done last so that the tiles needed for this frame are enqueued
+    // first
+    prefetchTiles();
+
     //_leftRoot->reverseBreadthFirst(renderJob);
     //_rightRoot->reverseBreadthFirst(renderJob);
 
@@ -387,6 +304,94 @@ void ChunkedLodGlobe::debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp
     }
 }
 
+bool ChunkedLodGlobe::prefetchUpcomingTiles(const Chunk& chunk,
+                                            TilePrefetcher& prefetcher)
+{
+    for (const std::shared_ptr<LayerGroup>& group : _layerManager->layerGroups()) {
+        for (const std::shared_ptr<Layer>& layer : group->activeLayers()) {
+            tileprovider::TileProvider* provider = layer->tileProvider();
+            if (provider && !provider->prefetchUpcoming(chunk.tileIndex(), prefetcher)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ChunkedLodGlobe::prefetchTiles() {
+    TilePrefetcher* prefetcher =
+        OsEng.moduleEngine().module<GlobeBrowsingModule>()->tilePrefetcher();
+    if (!prefetcher) {
+        return;
+    }
+
+    const std::vector<glm::dvec3>& positions = prefetcher->predictedCameraPositions();
+    const Ellipsoid& ellipsoid = _owner.ellipsoid();
+    const double scaleFactor = _owner.generalProperties().lodScaleFactor *
+                               ellipsoid.minimumRadius();
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const glm::dvec3 cameraPosition = glm::dvec3(
+            _owner.inverseModelTransform() * glm::dvec4(positions[i], 1.0)
+        );
+
+        // Same level as the distance evaluator would pick for a chunk right below the
+        // camera. The camera can be on or just above the surface, so the distance is
+        // kept positive and the level is clamped before it is converted to an integer
+        const Geodetic2 geodetic = ellipsoid.cartesianToGeodetic2(cameraPosition);
+        const double distance = std::max(
+            glm::length(ellipsoid.cartesianSurfacePosition(geodetic) - cameraPosition),
+            std::numeric_limits<double>::epsilon()
+        );
+        const double exactLevel = ceil(log2(scaleFactor / distance));
+        if (std::isnan(exactLevel)) {
+            continue;
+        }
+        const int level = static_cast<int>(glm::clamp(
+            exactLevel,
+            static_cast<double>(MinSplitDepth),
+            static_cast<double>(MaxSplitDepth)
+        ));
+
+        // The tile below the camera and its neighbors
+        const TileIndex center = TileIndex(geodetic, level);
+        const int nTilesX = 1 << level;
+        const int nTilesY = 1 << (level - 1);
+        for (int dy = -1; dy <= 1; ++dy) {
+            const int y = center.y + dy;
+            if (y < 0 || y >= nTilesY) {
+                continue;
+            }
+            for (int dx = -1; dx <= 1; ++dx) {
+                const TileIndex tileIndex = TileIndex(
+                    (center.x + dx + nTilesX) % nTilesX,
+                    y,
+                    level
+                );
+
+                for (const std::shared_ptr<LayerGroup>& group :
+                     _layerManager->layerGroups())
+                {
+                    for (const std::shared_ptr<Layer>& layer : group->activeLayers()) {
+                        tileprovider::TileProvider* provider = layer->tileProvider();
+                        if (!provider) {
+                            continue;
+                        }
+                        const bool hasBudget = prefetcher->prefetch(
+                            *provider,
+                            tileIndex,
+                            static_cast<int>(i)
+                        );
+                        if (!hasBudget) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 void ChunkedLodGlobe::update(const UpdateData& data) {
     setBoundingSphere(static_cast<float>(
         _owner.ellipsoid().maximumRadius() * data.modelTransform.scale
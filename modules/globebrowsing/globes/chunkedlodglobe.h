@@ -37,7 +37,10 @@
 
 namespace openspace::globebrowsing {
 
-namespace chunklevelevaluator { class Evaluator; }
+namespace chunklevelevaluator {
+    class Distance;
+    class Evaluator;
+} // namespace chunklevelevaluator
 
 namespace culling { class ChunkCuller; }
 
@@ -46,8 +49,10 @@ class ChunkNode;
 class ChunkRenderer;
 class Ellipsoid;
 struct Geodetic2;
+class HeightQueryService;
 class LayerManager;
 class RenderableGlobe;
+class TilePrefetcher;
 
 class ChunkedLodGlobe : public Renderable {
 public:
@@ -103,6 +108,13 @@ public:
      */
     float getHeight(const glm::dvec3& position) const;
 
+    /**
+     * Returns the service that answers height queries for this globe. It is more
+     * efficient to use the batched query of the service than calling getHeight for
+     * many positions.
+     */
+    HeightQueryService& heightQueryService() const;
+
     /**
      * Notifies the renderer to recompile its shaders the next time the render function is
      * called. The actual shader recompilation takes place in the render function because
@@ -127,6 +139,20 @@ public:
 private:
     void debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp) const;
 
+    /**
+     * Requests the tiles of all active layers that are going to replace the tiles of
+     * the \p chunk in the near future, such as the upcoming time steps of temporal
+     * layers. Called once for every rendered chunk.
+     * \return <code>false</code> if the budget of the \p prefetcher is exhausted
+     */
+    bool prefetchUpcomingTiles(const Chunk& chunk, TilePrefetcher& prefetcher);
+
+    /**
+     * Requests the tiles of all active layers for the area of the globe below the
+     * camera positions predicted by the TilePrefetcher of the GlobeBrowsingModule.
+     */
+    void prefetchTiles();
+
     const RenderableGlobe& _owner;
 
     // Covers all negative longitudes
@@ -142,10 +168,12 @@ private:
 
     std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByAvailableTiles;
     std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByProjectedArea;
-    std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByDistance;
+    std::unique_ptr<chunklevelevaluator::Distance> _chunkEvaluatorByDistance;
 
     std::shared_ptr<LayerManager> _layerManager;
 
+    std::unique_ptr<HeightQueryService> _heightQueryService;
+
     bool _shadersNeedRecompilation = true;
 };
 
@@ -0,0 +1,343 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/globes/heightqueryservice.h>
+
+#include <modules/globebrowsing/chunk/chunk.h>
+#include <modules/globebrowsing/chunk/chunknode.h>
+#include <modules/globebrowsing/geometry/geodeticpatch.h>
+#include <modules/globebrowsing/globes/chunkedlodglobe.h>
+#include <modules/globebrowsing/globes/renderableglobe.h>
+#include <modules/globebrowsing/rendering/layer/layer.h>
+#include <modules/globebrowsing/rendering/layer/layergroup.h>
+#include <modules/globebrowsing/rendering/layer/layermanager.h>
+#include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tileselector.h>
+#include <modules/globebrowsing/tile/tileprovider/tileprovider.h>
+#include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Same as is used in the shader. This is not a perfect solution but if the sample is
+    // actually a no-data-value (min_float) the interpolated value might not be.
+    // Therefore we have a cut-off. Assuming no data value is smaller than -100000
+    constexpr const float NoDataCutOff = -100000.f;
+
+    // The uv coordinates of the geodetic position within the tile
+    glm::vec2 patchUvCoordinates(const openspace::globebrowsing::TileIndex& tileIndex,
+                                 const openspace::globebrowsing::Geodetic2& geodetic)
+    {
+        using namespace openspace::globebrowsing;
+        const GeodeticPatch patch = GeodeticPatch(tileIndex);
+        const Geodetic2 geoDiffPatch = patch.corner(Quad::NORTH_EAST) -
+                                       patch.corner(Quad::SOUTH_WEST);
+        const Geodetic2 geoDiffPoint = geodetic - patch.corner(Quad::SOUTH_WEST);
+        return glm::vec2(
+            geoDiffPoint.lon / geoDiffPatch.lon,
+            geoDiffPoint.lat / geoDiffPatch.lat
+        );
+    }
+} // namespace
+
+namespace openspace::globebrowsing {
+
+HeightQueryService::HeightQueryService(const RenderableGlobe& owner,
+                                       const ChunkedLodGlobe& chunkedLodGlobe,
+                                       std::shared_ptr<LayerManager> layerManager,
+                                       size_t cacheSize)
+    : _owner(owner)
+    , _chunkedLodGlobe(chunkedLodGlobe)
+    , _layerManager(std::move(layerManager))
+    , _tileCache(cacheSize)
+{}
+
+float HeightQueryService::height(const glm::dvec3& position) {
+    const std::vector<std::shared_ptr<Layer>>& heightLayers =
+        _layerManager->layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+    return heightAt(position, heightLayers);
+}
+
+void HeightQueryService::heights(const std::vector<glm::dvec3>& positions,
+                                 std::vector<float>& heights)
+{
+    const std::vector<std::shared_ptr<Layer>>& heightLayers =
+        _layerManager->layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+
+    heights.assign(positions.size(), 0.f);
+    if (heightLayers.empty()) {
+        return;
+    }
+
+    struct Query {
+        TileIndex::TileHashKey key;
+        TileIndex tileIndex;
+        glm::vec2 patchUv;
+        size_t position;
+    };
+    std::vector<Query> queries;
+    queries.reserve(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const Geodetic2 geodetic = _owner.ellipsoid().cartesianToGeodetic2(positions[i]);
+        const TileIndex tileIndex = queryTileIndex(geodetic);
+        queries.push_back({
+            tileIndex.hashKey(),
+            tileIndex,
+            patchUvCoordinates(tileIndex, geodetic),
+            i
+        });
+    }
+
+    // Positions that fall on the same tile are next to each other after sorting, so that
+    // each tile only has to be looked up once for all of them
+    std::sort(
+        queries.begin(),
+        queries.end(),
+        [](const Query& lhs, const Query& rhs) { return lhs.key < rhs.key; }
+    );
+
+    size_t begin = 0;
+    while (begin < queries.size()) {
+        size_t end = begin + 1;
+        while (end < queries.size() && queries[end].key == queries[begin].key) {
+            ++end;
+        }
+
+        // Later layers take precedence over earlier ones
+        for (const std::shared_ptr<Layer>& layer : heightLayers) {
+            TileUvTransform uvTransform;
+            bool isTextureLoaded = false;
+            std::shared_ptr<HeightTile> tile = heightTile(
+                *layer,
+                queries[begin].tileIndex,
+                uvTransform,
+                isTextureLoaded
+            );
+            if (!tile) {
+                continue;
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                const float h = layerHeight(
+                    *layer,
+                    *tile,
+                    isTextureLoaded,
+                    uvTransform,
+                    queries[i].patchUv
+                );
+                if (!std::isnan(h)) {
+                    heights[queries[i].position] = h;
+                }
+            }
+        }
+
+        begin = end;
+    }
+}
+
+float HeightQueryService::heightAt(const glm::dvec3& position,
+                                const std::vector<std::shared_ptr<Layer>>& heightLayers)
+{
+    if (heightLayers.empty()) {
+        return 0.f;
+    }
+
+    const Geodetic2 geodetic = _owner.ellipsoid().cartesianToGeodetic2(position);
+    const TileIndex tileIndex = queryTileIndex(geodetic);
+    const glm::vec2 patchUv = patchUvCoordinates(tileIndex, geodetic);
+
+    // Later layers take precedence over earlier ones
+    float height = 0.f;
+    for (const std::shared_ptr<Layer>& layer : heightLayers) {
+        TileUvTransform uvTransform;
+        bool isTextureLoaded = false;
+        std::shared_ptr<HeightTile> tile = heightTile(
+            *layer,
+            tileIndex,
+            uvTransform,
+            isTextureLoaded
+        );
+        if (!tile) {
+            continue;
+        }
+
+        const float h = layerHeight(*layer, *tile, isTextureLoaded, uvTransform, patchUv);
+        if (!std::isnan(h)) {
+            height = h;
+        }
+    }
+    return height;
+}
+
+TileIndex HeightQueryService::queryTileIndex(const Geodetic2& geodetic) const {
+    const ChunkNode& chunkNode = _chunkedLodGlobe.findChunkNode(geodetic);
+    return TileIndex(geodetic, chunkNode.chunk().tileIndex().level);
+}
+
+float HeightQueryService::layerHeight(Layer& layer, HeightTile& tile,
+                                      bool isTextureLoaded,
+                                      const TileUvTransform& uvTransform,
+                                      const glm::vec2& patchUv)
+{
+    const glm::vec2 textureUv = layer.TileUvToTextureSamplePosition(
+        uvTransform,
+        patchUv,
+        tile.dimensions
+    );
+    const float sampled = sample(tile, textureUv, isTextureLoaded);
+    if (std::isnan(sampled) || sampled <= NoDataCutOff) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // Perform depth transform to get the value in meters and make sure that the height
+    // value follows the layer settings
+    const TileDepthTransform depthTransform = layer.tileProvider()->depthTransform();
+    return layer.renderSettings().performLayerSettings(
+        depthTransform.depthOffset + depthTransform.depthScale * sampled
+    );
+}
+
+void HeightQueryService::clear() {
+    _tileCache.clear();
+}
+
+std::shared_ptr<HeightQueryService::HeightTile> HeightQueryService::heightTile(
+                                                                     Layer& layer,
+                                                         const TileIndex& tileIndex,
+                                                             TileUvTransform& uvTransform,
+                                                                   bool& isTextureLoaded)
+{
+    isTextureLoaded = false;
+    tileprovider::TileProvider* tileProvider = layer.tileProvider();
+    if (!tileProvider) {
+        return nullptr;
+    }
+    const unsigned int providerID = tileProvider->uniqueIdentifier();
+
+    // The tile provider walks up the tree until it finds a loaded tile
+    const ChunkTile chunkTile = tileProvider->chunkTile(tileIndex);
+    const ghoul::opengl::Texture* texture = chunkTile.tile.texture();
+    if (chunkTile.tile.status() == Tile::Status::OK && texture) {
+        TileIndex loadedIndex = tileIndex;
+        const int levelDifference = static_cast<int>(
+            std::round(-std::log2(chunkTile.uvTransform.uvScale.x))
+        );
+        for (int i = 0; i < levelDifference; ++i) {
+            --loadedIndex;
+        }
+        uvTransform = chunkTile.uvTransform;
+
+        const cache::ProviderTileKey key = { loadedIndex, providerID };
+        isTextureLoaded = true;
+        if (_tileCache.exist(key)) {
+            std::shared_ptr<HeightTile> tile = _tileCache.get(key);
+            // Textures are reused for other tiles, so it is only a match if the data has
+            // not been replaced since it was decoded
+            if (tile->texture == texture) {
+                return tile;
+            }
+        }
+
+        // The rows are decoded when they are first sampled
+        auto tile = std::make_shared<HeightTile>();
+        tile->texture = texture;
+        tile->dimensions = glm::uvec2(texture->dimensions());
+        tile->noDataValue = tileProvider->noDataValueAsFloat();
+        tile->data.resize(
+            static_cast<size_t>(tile->dimensions.x) * tile->dimensions.y,
+            std::numeric_limits<float>::quiet_NaN()
+        );
+        tile->isRowDecoded.resize(tile->dimensions.y, false);
+
+        _tileCache.put(key, tile);
+        return tile;
+    }
+
+    // No tile is loaded for this provider right now, for example since the textures
+    // were removed from the tile cache or all tiles are still being loaded. The finest
+    // previously decoded tile is still better than no height at all
+    TileIndex index = tileIndex;
+    uvTransform = { glm::vec2(0.f), glm::vec2(1.f) };
+    while (index.level >= 0) {
+        const cache::ProviderTileKey key = { index, providerID };
+        if (_tileCache.exist(key)) {
+            return _tileCache.get(key);
+        }
+        tileselector::ascendToParent(index, uvTransform);
+    }
+    return nullptr;
+}
+
+void HeightQueryService::decodeRow(HeightTile& tile, unsigned int y) {
+    if (tile.isRowDecoded[y]) {
+        return;
+    }
+
+    float* row = tile.data.data() + static_cast<size_t>(y) * tile.dimensions.x;
+    for (unsigned int x = 0; x < tile.dimensions.x; ++x) {
+        const float v = tile.texture->texelAsFloat(x, y).x;
+        row[x] = (v == tile.noDataValue) ? std::numeric_limits<float>::quiet_NaN() : v;
+    }
+    tile.isRowDecoded[y] = true;
+}
+
+float HeightQueryService::sample(HeightTile& tile, const glm::vec2& textureUv,
+                                 bool canDecode)
+{
+    const glm::uvec2 max = tile.dimensions - glm::uvec2(1);
+
+    const glm::vec2 samplePos = textureUv * glm::vec2(tile.dimensions);
+    const glm::uvec2 samplePos00 = glm::clamp(
+        glm::uvec2(glm::max(samplePos, glm::vec2(0.f))),
+        glm::uvec2(0),
+        max
+    );
+    const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
+    const glm::uvec2 samplePos11 = glm::min(samplePos00 + glm::uvec2(1), max);
+
+    // Rows that can not be decoded anymore stay NaN and count as missing data
+    if (canDecode) {
+        decodeRow(tile, samplePos00.y);
+        decodeRow(tile, samplePos11.y);
+    }
+
+    auto texel = [&tile](unsigned int x, unsigned int y) {
+        return tile.data[y * tile.dimensions.x + x];
+    };
+    const float sample00 = texel(samplePos00.x, samplePos00.y);
+    const float sample10 = texel(samplePos11.x, samplePos00.y);
+    const float sample01 = texel(samplePos00.x, samplePos11.y);
+    const float sample11 = texel(samplePos11.x, samplePos11.y);
+
+    // NaN propagates through the interpolation
+    const float sample0 = sample00 * (1.f - samplePosFract.x) +
+                          sample10 * samplePosFract.x;
+    const float sample1 = sample01 * (1.f - samplePosFract.x) +
+                          sample11 * samplePosFract.x;
+
+    return sample0 * (1.f - samplePosFract.y) + sample1 * samplePosFract.y;
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,154 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_QUERY_SERVICE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_QUERY_SERVICE___H__
+
+#include <modules/globebrowsing/cache/lrucache.h>
+#include <modules/globebrowsing/cache/memoryawaretilecache.h>
+#include <modules/globebrowsing/tile/tileuvtransform.h>
+#include <ghoul/glm.h>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class Texture; }
+
+namespace openspace::globebrowsing {
+
+class ChunkedLodGlobe;
+class Layer;
+class LayerManager;
+class RenderableGlobe;
+struct Geodetic2;
+struct TileIndex;
+
+/**
+ * Answers queries for the height of the globe surface above the reference ellipsoid on
+ * the CPU, without reading back any textures from the GPU.
+ *
+ * The height tiles that are used are decoded into a float array, in which no-data values
+ * are marked as NaN, and are kept in a small cache of their own. A tile is decoded one
+ * row at a time, only when a row is sampled for the first time, so a query does not pay
+ * for decoding the rows that it does not touch. This makes repeated and batched lookups
+ * cheap and keeps the decoded rows of a tile available even after its texture has been
+ * removed from the MemoryAwareTileCache. If the tile for the rendered level is not
+ * loaded, the finest available coarser level is used instead.
+ *
+ * The service must only be used from the main thread, as querying tiles from the tile
+ * providers can enqueue tile requests.
+ */
+class HeightQueryService {
+public:
+    /**
+     * \param cacheSize is the maximum number of decoded height tiles that are kept
+     */
+    HeightQueryService(const RenderableGlobe& owner,
+        const ChunkedLodGlobe& chunkedLodGlobe, std::shared_ptr<LayerManager> layerManager,
+        size_t cacheSize = 64);
+
+    /**
+     * \param position is the position of a point that gets geodetically projected on
+     *        the reference ellipsoid, given in cartesian model space
+     * \return the height of the globe surface above the reference ellipsoid, or 0 if
+     *         no height data is available at all
+     */
+    float height(const glm::dvec3& position);
+
+    /**
+     * Batched version of height(const glm::dvec3&), which writes the height for each of
+     * the \p positions into \p heights. The positions are grouped by the tile that they
+     * fall on, so that each tile is only looked up once per layer.
+     */
+    void heights(const std::vector<glm::dvec3>& positions, std::vector<float>& heights);
+
+    /**
+     * Removes all decoded height tiles. This has to be called if the data of the height
+     * layers has changed, for example when the tile providers are reset.
+     */
+    void clear();
+
+private:
+    struct HeightTile {
+        /// The texture that the data was decoded from
+        const ghoul::opengl::Texture* texture = nullptr;
+        glm::uvec2 dimensions = glm::uvec2(0);
+        /// The value of the texture that marks texels without data
+        float noDataValue = 0.f;
+        /// The raw texel values in row-major order, NaN where there is no data or where
+        /// the row has not been decoded yet
+        std::vector<float> data;
+        std::vector<bool> isRowDecoded;
+    };
+
+    /**
+     * Computes the height at \p position from the active \p heightLayers. This is the
+     * body of height, which does not allocate any memory if the tiles are decoded.
+     */
+    float heightAt(const glm::dvec3& position,
+        const std::vector<std::shared_ptr<Layer>>& heightLayers);
+
+    /// Returns the index of the tile at the rendered level that covers \p geodetic
+    TileIndex queryTileIndex(const Geodetic2& geodetic) const;
+
+    /**
+     * Samples the \p layer in its decoded \p tile. Missing rows of the tile are decoded
+     * first if \p isTextureLoaded is <code>true</code>, which means that the texture of
+     * the tile is still valid.
+     * \return the height in meters after the layer settings have been applied, or NaN
+     *         if there is no data at \p patchUv
+     */
+    static float layerHeight(Layer& layer, HeightTile& tile, bool isTextureLoaded,
+        const TileUvTransform& uvTransform, const glm::vec2& patchUv);
+
+    /**
+     * Finds the decoded height tile covering \p tileIndex for \p layer, creating it if
+     * necessary. \p uvTransform is set to transform uv coordinates of \p tileIndex into
+     * the returned tile and \p isTextureLoaded to whether the texture of the tile is
+     * loaded, so that missing rows can be decoded from it.
+     * \return <code>nullptr</code> if there is no data for this layer at all
+     */
+    std::shared_ptr<HeightTile> heightTile(Layer& layer, const TileIndex& tileIndex,
+        TileUvTransform& uvTransform, bool& isTextureLoaded);
+
+    /// Decodes the row \p y of the \p tile from its texture if that has not happened yet
+    static void decodeRow(HeightTile& tile, unsigned int y);
+
+    /**
+     * Samples the \p tile using bilinear interpolation, decoding the rows that are used
+     * if \p canDecode is <code>true</code>.
+     * \return NaN if any of the samples is missing
+     */
+    static float sample(HeightTile& tile, const glm::vec2& textureUv, bool canDecode);
+
+    const RenderableGlobe& _owner;
+    const ChunkedLodGlobe& _chunkedLodGlobe;
+    std::shared_ptr<LayerManager> _layerManager;
+
+    cache::LRUCache<cache::ProviderTileKey, std::shared_ptr<HeightTile>,
+        cache::ProviderTileHasher> _tileCache;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_QUERY_SERVICE___H__
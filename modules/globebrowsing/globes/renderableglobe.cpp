@@ -26,6 +26,7 @@
 
 #include <modules/debugging/rendering/debugrenderer.h>
 #include <modules/globebrowsing/globes/chunkedlodglobe.h>
+#include <modules/globebrowsing/globes/heightqueryservice.h>
 #include <modules/globebrowsing/globes/pointglobe.h>
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <ghoul/logging/logmanager.h>
@@ -445,6 +446,7 @@ void RenderableGlobe::update(const UpdateData& data) {
 
     if (_debugProperties.resetTileProviders) {
         _layerManager->reset();
+        _chunkedLodGlobe->heightQueryService().clear();
         _debugProperties.resetTileProviders = false;
     }
     _layerManager->update();
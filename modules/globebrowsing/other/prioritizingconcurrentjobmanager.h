@@ -25,32 +25,50 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITIZING_CONCURRENT_JOB_MANAGER___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITIZING_CONCURRENT_JOB_MANAGER___H__
 
-#include <modules/globebrowsing/other/lruthreadpool.h>
+#include <modules/globebrowsing/other/workstealingthreadpool.h>
 
-//#include <openspace/util/concurrentjobmanager.h>
 #include <openspace/util/concurrentqueue.h>
 
+#include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 
 namespace openspace { template <typename T> struct Job; }
 
 namespace openspace::globebrowsing {
 
 /**
- * Concurrent job manager which prioritizes which jobs to work on depending on which
- * ones were enqueued latest. The class is templated both on the job type and the key
- * type which is used to identify jobs. In case a job need to be explicitly ended
- * It can be identified using its key.
+ * Concurrent job manager which prioritizes which jobs to work on depending on their
+ * priority and, for jobs with the same priority, on which ones were enqueued or touched
+ * latest. The class is templated both on the job type and the key type which is used to
+ * identify jobs. In case a job need to be explicitly ended It can be identified using
+ * its key.
+ *
+ * The jobs are executed by a WorkStealingThreadPool that can be shared between many job
+ * managers. Only a limited number of jobs is kept enqueued per job manager; if more jobs
+ * are enqueued, the least urgent ones are dropped and reported as unfinished.
  */
 template<typename P, typename KeyType>
 class PrioritizingConcurrentJobManager {
 public:
-    PrioritizingConcurrentJobManager(LRUThreadPool<KeyType> pool);
+    /**
+     * \param pool is the thread pool executing the jobs
+     * \param maxNumEnqueuedJobs is the maximum number of jobs waiting to be executed
+     */
+    PrioritizingConcurrentJobManager(std::shared_ptr<WorkStealingThreadPool> pool,
+        size_t maxNumEnqueuedJobs);
+
+    /**
+     * Cancels all enqueued jobs and waits for the jobs of this manager that are
+     * currently being executed.
+     */
+    ~PrioritizingConcurrentJobManager();
 
     /**
-     * Enqueues a job which is identified using a given key
+     * Enqueues a job which is identified using a given key. Jobs with a higher
+     * \p priority are executed first.
      */
-    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key);
+    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key, float priority = 0.f);
 
     /**
      * The keys returned by this function have been popped from the queue and corresponds
@@ -60,10 +78,14 @@ public:
      */
     std::vector<KeyType> keysToUnfinishedJobs();
 
+    /**
+     * Removes all jobs that have not been started yet and returns their keys.
+     */
     std::vector<KeyType> keysToEnqueuedJobs();
 
     /**
-     * Bumps the job identified with <code>key</code> to the beginning of the queue.
+     * Bumps the job identified with <code>key</code> to the beginning of the queue of
+     * jobs with the same priority.
      * In case the job was not already enqueued the function simply returns false and
      * no state is changed.
      * \param key is the identifier of the job to bump.
@@ -71,6 +93,11 @@ public:
      */
     bool touch(KeyType key);
 
+    /**
+     * Same as touch(KeyType), but also sets the priority of the job to \p priority.
+     */
+    bool touch(KeyType key, float priority);
+
     /**
      * Clear all enqueued jobs. Can not end jobs that workers are currently handling.
      * Therefore it is not safe to assume that there will be no finished jobs after
@@ -86,10 +113,26 @@ public:
     size_t numFinishedJobs() const;
 
 private:
+    using Task = WorkStealingThreadPool::Task;
+
+    /// Removes the entries of jobs that have been started or cancelled
+    void removeStartedJobs();
+    void jobEnded();
+
     ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
     std::mutex _finishedJobsMutex;
-    /// An LRU thread pool is used since the jobs can be bumped and hence prioritized.
-    LRUThreadPool<KeyType> _threadPool;
+
+    std::shared_ptr<WorkStealingThreadPool> _threadPool;
+    const size_t _maxNumEnqueuedJobs;
+
+    /// Only accessed from the thread that is enqueuing jobs
+    std::unordered_map<KeyType, std::shared_ptr<Task>> _enqueuedJobs;
+    std::vector<KeyType> _unfinishedJobs;
+
+    /// The number of jobs that have been enqueued but neither cancelled nor finished
+    size_t _nOutstandingJobs = 0;
+    std::mutex _outstandingJobsMutex;
+    std::condition_variable _outstandingJobsCondition;
 };
 
 } // namespace openspace::globebrowsing
@@ -28,41 +28,133 @@ namespace openspace::globebrowsing {
 
 template <typename P, typename KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::PrioritizingConcurrentJobManager(
-                                                              LRUThreadPool<KeyType> pool)
-    : _threadPool(pool)
+                                             std::shared_ptr<WorkStealingThreadPool> pool,
+                                                                size_t maxNumEnqueuedJobs)
+    : _threadPool(std::move(pool))
+    , _maxNumEnqueuedJobs(maxNumEnqueuedJobs)
 {}
 
+template <typename P, typename KeyType>
+PrioritizingConcurrentJobManager<P, KeyType>::~PrioritizingConcurrentJobManager() {
+    clearEnqueuedJobs();
+
+    // The running jobs refer to this object, so we have to wait for them
+    std::unique_lock<std::mutex> lock(_outstandingJobsMutex);
+    _outstandingJobsCondition.wait(lock, [this]() { return _nOutstandingJobs == 0; });
+}
+
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Job<P>> job,
-                                                              KeyType key)
+                                                              KeyType key, float priority)
 {
-    _threadPool.enqueue([this, job]() {
-        job->execute();
-        std::lock_guard<std::mutex> lock(_finishedJobsMutex);
-        _finishedJobs.push(job);
-    }, key);
+    {
+        std::lock_guard<std::mutex> lock(_outstandingJobsMutex);
+        _nOutstandingJobs++;
+    }
+
+    std::shared_ptr<Task> task = _threadPool->enqueue(
+        [this, job]() {
+            job->execute();
+            {
+                std::lock_guard<std::mutex> lock(_finishedJobsMutex);
+                _finishedJobs.push(job);
+            }
+            jobEnded();
+        },
+        priority
+    );
+
+    const auto it = _enqueuedJobs.find(key);
+    if (it != _enqueuedJobs.end()) {
+        // A job with the same key replaces the previous one
+        if (WorkStealingThreadPool::cancel(*it->second)) {
+            jobEnded();
+        }
+        it->second = std::move(task);
+    }
+    else {
+        _enqueuedJobs.emplace(key, std::move(task));
+    }
+
+    if (_enqueuedJobs.size() <= _maxNumEnqueuedJobs) {
+        return;
+    }
+
+    removeStartedJobs();
+    while (_enqueuedJobs.size() > _maxNumEnqueuedJobs) {
+        // Drop the least urgent job
+        auto leastUrgent = _enqueuedJobs.begin();
+        for (auto i = _enqueuedJobs.begin(); i != _enqueuedJobs.end(); ++i) {
+            const Task& t = *i->second;
+            const Task& l = *leastUrgent->second;
+            if (t.priority < l.priority ||
+                (t.priority == l.priority && t.sequence < l.sequence))
+            {
+                leastUrgent = i;
+            }
+        }
+
+        if (WorkStealingThreadPool::cancel(*leastUrgent->second)) {
+            _unfinishedJobs.push_back(leastUrgent->first);
+            jobEnded();
+        }
+        _enqueuedJobs.erase(leastUrgent);
+    }
 }
 
 template <typename P, typename KeyType>
 std::vector<KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::keysToUnfinishedJobs() {
-    return _threadPool.getUnqueuedTasksKeys();
+    std::vector<KeyType> unfinishedJobs;
+    std::swap(unfinishedJobs, _unfinishedJobs);
+    return unfinishedJobs;
 }
 
 template <typename P, typename KeyType>
 std::vector<KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::keysToEnqueuedJobs() {
-    return _threadPool.getQueuedTasksKeys();
+    std::vector<KeyType> enqueuedJobs;
+    for (const std::pair<const KeyType, std::shared_ptr<Task>>& p : _enqueuedJobs) {
+        if (WorkStealingThreadPool::cancel(*p.second)) {
+            enqueuedJobs.push_back(p.first);
+            jobEnded();
+        }
+    }
+    _enqueuedJobs.clear();
+    return enqueuedJobs;
 }
 
 template <typename P, typename KeyType>
 bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key) {
-    return _threadPool.touch(key);
+    const auto it = _enqueuedJobs.find(key);
+    if (it == _enqueuedJobs.end()) {
+        return false;
+    }
+    if (it->second->state != WorkStealingThreadPool::TaskState::Queued) {
+        _enqueuedJobs.erase(it);
+        return false;
+    }
+    _threadPool->setPriority(*it->second, it->second->priority);
+    return true;
+}
+
+template <typename P, typename KeyType>
+bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key, float priority) {
+    const auto it = _enqueuedJobs.find(key);
+    if (it == _enqueuedJobs.end()) {
+        return false;
+    }
+    if (it->second->state != WorkStealingThreadPool::TaskState::Queued) {
+        _enqueuedJobs.erase(it);
+        return false;
+    }
+    _threadPool->setPriority(*it->second, priority);
+    return true;
 }
 
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::clearEnqueuedJobs() {
-    _threadPool.clearEnqueuedTasks();
+    keysToEnqueuedJobs();
 }
 
 template <typename P, typename KeyType>
@@ -79,4 +171,23 @@ size_t PrioritizingConcurrentJobManager<P, KeyType>::numFinishedJobs() const {
     return _finishedJobs.size();
 }
 
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::removeStartedJobs() {
+    for (auto it = _enqueuedJobs.begin(); it != _enqueuedJobs.end();) {
+        if (it->second->state != WorkStealingThreadPool::TaskState::Queued) {
+            it = _enqueuedJobs.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::jobEnded() {
+    std::lock_guard<std::mutex> lock(_outstandingJobsMutex);
+    _nOutstandingJobs--;
+    _outstandingJobsCondition.notify_all();
+}
+
 } // namespace openspace::globebrowsing
@@ -74,6 +74,11 @@ struct TimeQuantizer {
     */
     std::vector<Time> quantized(const Time& start, const Time& end) const;
 
+    /**
+    * \return the time resolution in seconds
+    */
+    double resolution() const;
+
 private:
     TimeRange _timerange;
     double _resolution;
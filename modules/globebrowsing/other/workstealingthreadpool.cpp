@@ -0,0 +1,179 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/other/workstealingthreadpool.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace openspace::globebrowsing {
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t numThreads) {
+    ghoul_assert(numThreads > 0, "Need at least one thread");
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        _workers.emplace_back([this, i]() { work(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _stop = true;
+    }
+    _idleCondition.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<WorkStealingThreadPool::Task> WorkStealingThreadPool::enqueue(
+                                                                std::function<void()> f,
+                                                                          float priority)
+{
+    std::shared_ptr<Task> task = std::make_shared<Task>();
+    task->function = std::move(f);
+    task->priority = priority;
+    task->sequence = _nextSequence++;
+
+    // The counter has to be incremented before the task is published as a worker might
+    // otherwise take the task and decrement the counter below zero
+    _nQueuedTasks++;
+    WorkerQueue& queue = *_queues[_nextQueue++ % _queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    // Taking the lock ensures that a worker cannot miss the notification between
+    // checking the number of queued tasks and going to sleep
+    { std::lock_guard<std::mutex> lock(_idleMutex); }
+    _idleCondition.notify_one();
+
+    return task;
+}
+
+void WorkStealingThreadPool::setPriority(Task& task, float priority) {
+    task.priority = priority;
+    task.sequence = _nextSequence++;
+}
+
+bool WorkStealingThreadPool::cancel(Task& task) {
+    TaskState expected = TaskState::Queued;
+    return task.state.compare_exchange_strong(expected, TaskState::Cancelled);
+}
+
+size_t WorkStealingThreadPool::numThreads() const {
+    return _workers.size();
+}
+
+void WorkStealingThreadPool::work(size_t workerIndex) {
+    while (true) {
+        std::shared_ptr<Task> task = popTask(workerIndex);
+        if (task) {
+            task->function();
+            // Release the resources captured by the function as early as possible
+            task->function = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_idleMutex);
+        _idleCondition.wait(lock, [this]() { return _stop || _nQueuedTasks > 0; });
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+std::shared_ptr<WorkStealingThreadPool::Task> WorkStealingThreadPool::popTask(
+                                                                       size_t workerIndex)
+{
+    // Start with the own queue and then try to steal from the others
+    for (size_t i = 0; i < _queues.size(); ++i) {
+        WorkerQueue& queue = *_queues[(workerIndex + i) % _queues.size()];
+        std::shared_ptr<Task> task = takeMostUrgentTask(queue);
+        if (task) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<WorkStealingThreadPool::Task>
+WorkStealingThreadPool::takeMostUrgentTask(WorkerQueue& queue)
+{
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    while (!queue.tasks.empty()) {
+        // The queues are short enough that a linear search is faster than maintaining
+        // a heap, which would also be invalidated by every priority change
+        bool hasTask = false;
+        size_t best = 0;
+        float bestPriority = 0.f;
+        uint64_t bestSequence = 0;
+        for (size_t i = 0; i < queue.tasks.size();) {
+            const Task& t = *queue.tasks[i];
+            if (t.state == TaskState::Cancelled) {
+                queue.tasks[i] = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                _nQueuedTasks--;
+                continue;
+            }
+
+            const float priority = t.priority;
+            const uint64_t sequence = t.sequence;
+            const bool isMoreUrgent = !hasTask ||
+                (priority > bestPriority) ||
+                (priority == bestPriority && sequence > bestSequence);
+            if (isMoreUrgent) {
+                hasTask = true;
+                best = i;
+                bestPriority = priority;
+                bestSequence = sequence;
+            }
+            ++i;
+        }
+
+        if (!hasTask) {
+            return nullptr;
+        }
+
+        std::shared_ptr<Task> task = std::move(queue.tasks[best]);
+        queue.tasks[best] = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        _nQueuedTasks--;
+
+        // The task might have been cancelled since we looked at it
+        TaskState expected = TaskState::Queued;
+        if (task->state.compare_exchange_strong(expected, TaskState::Running)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace openspace::globebrowsing
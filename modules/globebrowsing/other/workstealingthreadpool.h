@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___WORK_STEALING_THREAD_POOL___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___WORK_STEALING_THREAD_POOL___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+/**
+ * A thread pool in which every worker owns its own queue of tasks. Tasks are distributed
+ * over the queues when they are enqueued and a worker that runs out of tasks steals from
+ * the queues of the other workers, so that the workers only contend for the same lock
+ * when stealing.
+ *
+ * Every task has a numeric priority, where a higher value is more urgent. A worker
+ * always picks the task with the highest priority from a queue and, among tasks with the
+ * same priority, the one that was enqueued or updated most recently. The priority of a
+ * task can be changed and a task can be cancelled as long as it has not been started.
+ * Both operations are lock-free; cancelled tasks are removed from the queues lazily by
+ * the workers.
+ */
+class WorkStealingThreadPool {
+public:
+    enum class TaskState : int {
+        Queued = 0,
+        Running,
+        Cancelled
+    };
+
+    struct Task {
+        std::function<void()> function;
+        std::atomic<float> priority = { 0.f };
+        std::atomic<uint64_t> sequence = { 0 };
+        std::atomic<TaskState> state = { TaskState::Queued };
+    };
+
+    explicit WorkStealingThreadPool(size_t numThreads);
+    ~WorkStealingThreadPool();
+
+    /**
+     * Enqueues the function \p f with the provided \p priority. The returned handle can
+     * be used to change the priority or to cancel the task.
+     */
+    std::shared_ptr<Task> enqueue(std::function<void()> f, float priority);
+
+    /**
+     * Changes the priority of the \p task. This also marks the task as the most
+     * recently updated among the tasks with the same priority.
+     */
+    void setPriority(Task& task, float priority);
+
+    /**
+     * Cancels the \p task.
+     * \return <code>true</code> if the task was cancelled before it was started, in
+     *         which case it will never be executed
+     */
+    static bool cancel(Task& task);
+
+    size_t numThreads() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Task>> tasks;
+    };
+
+    void work(size_t workerIndex);
+    std::shared_ptr<Task> popTask(size_t workerIndex);
+    std::shared_ptr<Task> takeMostUrgentTask(WorkerQueue& queue);
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic<size_t> _nextQueue = { 0 };
+    std::atomic<uint64_t> _nextSequence = { 0 };
+
+    /// The number of tasks in all queues, including cancelled tasks not yet removed
+    std::atomic<size_t> _nQueuedTasks = { 0 };
+
+    /// Only used to put idle workers to sleep
+    std::mutex _idleMutex;
+    std::condition_variable _idleCondition;
+    std::atomic<bool> _stop = { false };
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___WORK_STEALING_THREAD_POOL___H__
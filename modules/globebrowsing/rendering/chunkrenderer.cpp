@@ -69,15 +69,17 @@ ChunkRenderer::ChunkRenderer(std::shared_ptr<Grid> grid,
 
 ChunkRenderer::~ChunkRenderer() {} // NOLINT
 
-void ChunkRenderer::renderChunk(const Chunk& chunk, const RenderData& data) {
+void ChunkRenderer::renderChunk(const Chunk& chunk, const RenderData& data,
+                                float tileRequestPriority)
+{
     // A little arbitrary with 10 but it works
     if (chunk.tileIndex().level <
         chunk.owner().debugProperties().modelSpaceRenderingCutoffLevel)
     {
-        renderChunkGlobally(chunk, data);
+        renderChunkGlobally(chunk, data, tileRequestPriority);
     }
     else {
-        renderChunkLocally(chunk, data);
+        renderChunkLocally(chunk, data, tileRequestPriority);
     }
 }
 
@@ -95,7 +97,8 @@ void ChunkRenderer::recompileShaders(const RenderableGlobe& globe) {
 ghoul::opengl::ProgramObject* ChunkRenderer::getActivatedProgramWithTileData(
                                                  LayerShaderManager& layeredShaderManager,
                                                          GPULayerManager& gpuLayerManager,
-                                                                       const Chunk& chunk)
+                                                                       const Chunk& chunk,
+                                                                float tileRequestPriority)
 {
     const TileIndex& tileIndex = chunk.tileIndex();
 
@@ -109,7 +112,12 @@ ghoul::opengl::ProgramObject* ChunkRenderer::getActivatedProgramWithTileData(
     // Activate the shader program
     programObject->activate();
 
-    gpuLayerManager.setValue(programObject, *_layerManager, tileIndex);
+    gpuLayerManager.setValue(
+        programObject,
+        *_layerManager,
+        tileIndex,
+        tileRequestPriority
+    );
 
     // The length of the skirts is proportional to its size
     programObject->setUniform(
@@ -349,11 +357,14 @@ void ChunkRenderer::setCommonUniforms(ghoul::opengl::ProgramObject& programObjec
     }
 }
 
-void ChunkRenderer::renderChunkGlobally(const Chunk& chunk, const RenderData& data) {
+void ChunkRenderer::renderChunkGlobally(const Chunk& chunk, const RenderData& data,
+                                        float tileRequestPriority)
+{
     ghoul::opengl::ProgramObject* programObject = getActivatedProgramWithTileData(
         *_globalLayerShaderManager,
         *_globalGpuLayerManager,
-        chunk
+        chunk,
+        tileRequestPriority
     );
     if (!programObject) {
         return;
@@ -443,11 +454,14 @@ void ChunkRenderer::renderChunkGlobally(const Chunk& chunk, const RenderData& da
     programObject->deactivate();
 }
 
-void ChunkRenderer::renderChunkLocally(const Chunk& chunk, const RenderData& data) {
+void ChunkRenderer::renderChunkLocally(const Chunk& chunk, const RenderData& data,
+                                       float tileRequestPriority)
+{
     ghoul::opengl::ProgramObject* programObject = getActivatedProgramWithTileData(
         *_localLayerShaderManager,
         *_localGpuLayerManager,
-        chunk
+        chunk,
+        tileRequestPriority
     );
     if (!programObject) {
         return;
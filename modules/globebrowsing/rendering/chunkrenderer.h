@@ -50,9 +50,11 @@ public:
 
     /**
      * Chooses to render a chunk either locally or globally depending on the chunklevel
-     * of the <code>Chunk</code>.
+     * of the <code>Chunk</code>. Tiles that are missing for the chunk are requested with
+     * the provided \p tileRequestPriority.
     */
-    void renderChunk(const Chunk& chunk, const RenderData& data);
+    void renderChunk(const Chunk& chunk, const RenderData& data,
+        float tileRequestPriority);
     void update();
 
     void recompileShaders(const RenderableGlobe& globe);
@@ -66,7 +68,8 @@ private:
      * point precision by doing this which means that the camera too close to a global
      * tile will lead to jagging. We only render global chunks for lower chunk levels.
      */
-    void renderChunkGlobally(const Chunk& chunk, const RenderData& data);
+    void renderChunkGlobally(const Chunk& chunk, const RenderData& data,
+        float tileRequestPriority);
 
     /**
      * Local rendering of chunks are done using linear interpolation in camera space.
@@ -79,11 +82,12 @@ private:
      * levels) the better the approximation becomes. This is why we only render local
      * chunks for higher chunk levels.
      */
-    void renderChunkLocally(const Chunk& chunk, const RenderData& data);
+    void renderChunkLocally(const Chunk& chunk, const RenderData& data,
+        float tileRequestPriority);
 
     ghoul::opengl::ProgramObject* getActivatedProgramWithTileData(
         LayerShaderManager& layeredShaderManager, GPULayerManager& gpuLayerManager,
-        const Chunk& chunk);
+        const Chunk& chunk, float tileRequestPriority);
 
     void calculateEclipseShadows(const Chunk& chunk,
         ghoul::opengl::ProgramObject* programObject, const RenderData& data);
@@ -30,9 +30,9 @@ namespace openspace::globebrowsing {
 
 void GPUHeightLayer::setValue(ghoul::opengl::ProgramObject* programObject,
                               const Layer& layer, const TileIndex& tileIndex,
-                              int pileSize)
+                              int pileSize, float tileRequestPriority)
 {
-    GPULayer::setValue(programObject, layer, tileIndex, pileSize);
+    GPULayer::setValue(programObject, layer, tileIndex, pileSize, tileRequestPriority);
     _gpuDepthTransform.setValue(programObject, layer.depthTransform());
 }
 
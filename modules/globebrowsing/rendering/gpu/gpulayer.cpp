@@ -29,7 +29,8 @@
 namespace openspace::globebrowsing {
 
 void GPULayer::setValue(ghoul::opengl::ProgramObject* programObject, const Layer& layer,
-                        const TileIndex& tileIndex, int pileSize)
+                        const TileIndex& tileIndex, int pileSize,
+                        float tileRequestPriority)
 {
     gpuRenderSettings.setValue(programObject, layer.renderSettings());
     gpuLayerAdjustment.setValue(programObject, layer.layerAdjustment());
@@ -43,7 +44,11 @@ void GPULayer::setValue(ghoul::opengl::ProgramObject* programObject, const Layer
         case layergroupid::TypeID::TileIndexTileLayer:
         case layergroupid::TypeID::ByIndexTileLayer:
         case layergroupid::TypeID::ByLevelTileLayer: {
-            ChunkTilePile chunkTilePile = layer.chunkTilePile(tileIndex, pileSize);
+            ChunkTilePile chunkTilePile = layer.chunkTilePile(
+                tileIndex,
+                pileSize,
+                tileRequestPriority
+            );
             gpuChunkTilePile.setValue(programObject, chunkTilePile);
             paddingStartOffset.setValue(programObject, layer.tilePixelStartOffset());
             paddingSizeDifference.setValue(
@@ -48,10 +48,11 @@ public:
     /**
      * Sets the value of <code>Layer</code> to its corresponding
      * GPU struct. OBS! Users must ensure bind has been
-     * called before setting using this method.
+     * called before setting using this method. Missing tiles are requested with the
+     * provided \p tileRequestPriority.
      */
     virtual void setValue(ghoul::opengl::ProgramObject* programObject, const Layer& layer,
-        const TileIndex& tileIndex, int pileSize);
+        const TileIndex& tileIndex, int pileSize, float tileRequestPriority);
 
     /**
      * Binds this object with GLSL variables with identifiers starting
@@ -34,7 +34,8 @@ namespace openspace::globebrowsing {
 GPULayerGroup::~GPULayerGroup() {} // NOLINT
 
 void GPULayerGroup::setValue(ghoul::opengl::ProgramObject* programObject,
-                             const LayerGroup& layerGroup, const TileIndex& tileIndex)
+                             const LayerGroup& layerGroup, const TileIndex& tileIndex,
+                             float tileRequestPriority)
 {
     auto& activeLayers = layerGroup.activeLayers();
     ghoul_assert(
@@ -46,7 +47,8 @@ void GPULayerGroup::setValue(ghoul::opengl::ProgramObject* programObject,
             programObject,
             *activeLayers[i],
             tileIndex,
-            layerGroup.pileSize()
+            layerGroup.pileSize(),
+            tileRequestPriority
         );
     }
 }
@@ -46,10 +46,12 @@ public:
     /**
      * Sets the value of <code>LayerGroup</code> to its corresponding
      * GPU struct. OBS! Users must ensure bind has been
-     * called before setting using this method.
+     * called before setting using this method. Missing tiles are requested with the
+     * provided \p tileRequestPriority.
      */
     void setValue(ghoul::opengl::ProgramObject* programObject,
-        const LayerManager& manager, const TileIndex& tileIndex);
+        const LayerManager& manager, const TileIndex& tileIndex,
+        float tileRequestPriority);
 
     /**
      * Binds this object with GLSL variables with identifiers starting
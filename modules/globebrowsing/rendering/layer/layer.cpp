@@ -242,9 +242,11 @@ void Layer::deinitialize() {
     }
 }
 
-ChunkTilePile Layer::chunkTilePile(const TileIndex& tileIndex, int pileSize) const {
+ChunkTilePile Layer::chunkTilePile(const TileIndex& tileIndex, int pileSize,
+                                   float tileRequestPriority) const
+{
     if (_tileProvider) {
-        return _tileProvider->chunkTilePile(tileIndex, pileSize);
+        return _tileProvider->chunkTilePile(tileIndex, pileSize, tileRequestPriority);
     }
     else {
         ChunkTilePile chunkTilePile;
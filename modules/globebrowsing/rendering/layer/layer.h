@@ -59,7 +59,8 @@ public:
     void initialize();
     void deinitialize();
 
-    ChunkTilePile chunkTilePile(const TileIndex& tileIndex, int pileSize) const;
+    ChunkTilePile chunkTilePile(const TileIndex& tileIndex, int pileSize,
+        float tileRequestPriority) const;
     Tile::Status tileStatus(const TileIndex& index) const;
 
     layergroupid::TypeID type() const;
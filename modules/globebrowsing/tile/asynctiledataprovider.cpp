@@ -24,6 +24,7 @@
 
 #include <modules/globebrowsing/tile/asynctiledataprovider.h>
 
+#include <modules/globebrowsing/cache/disktilecache.h>
 #include <modules/globebrowsing/cache/memoryawaretilecache.h>
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/other/pixelbuffercontainer.h>
@@ -33,20 +34,42 @@
 #include <openspace/engine/openspaceengine.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <cstdint>
 
 namespace openspace::globebrowsing {
 
 namespace {
     constexpr const char* _loggerCat = "AsyncTileDataProvider";
+
+    // 32-bit FNV-1a hash. Unlike std::hash, the result is the same for every build and
+    // standard library, which is required for identifiers that are persisted on disk
+    unsigned int fnv1a(const std::string& value) {
+        uint32_t hash = 2166136261u;
+        for (char c : value) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return static_cast<unsigned int>(hash);
+    }
 } // namespace
 
 AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
-                               const std::shared_ptr<RawTileDataReader> rawTileDataReader)
+                               const std::shared_ptr<RawTileDataReader> rawTileDataReader,
+                                             const std::string& diskCacheIdentifier)
     : _name(std::move(name))
+    , _globeBrowsingModule(OsEng.moduleEngine().module<GlobeBrowsingModule>())
     , _rawTileDataReader(std::move(rawTileDataReader))
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
+    , _concurrentJobManager(_globeBrowsingModule->tileLoadingThreadPool(), 10)
+    , _useDiskCache(!diskCacheIdentifier.empty())
 {
-    _globeBrowsingModule = OsEng.moduleEngine().module<GlobeBrowsingModule>();
+    if (_useDiskCache) {
+        // The identifier has to stay the same between sessions. The texture init data
+        // is part of the hash since the same dataset can be read with different tile
+        // sizes or formats
+        const std::string id = diskCacheIdentifier + "|" +
+            std::to_string(_rawTileDataReader->tileTextureInitData().hashKey());
+        _diskCacheProviderID = fnv1a(id);
+    }
     performReset(ResetRawTileDataReader::No);
 }
 
@@ -56,15 +79,24 @@ std::shared_ptr<RawTileDataReader> AsyncTileDataProvider::rawTileDataReader() co
     return _rawTileDataReader;
 }
 
-bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
-    if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
+bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex, float priority) {
+    if (_resetMode == ResetMode::ShouldNotReset &&
+        satisfiesEnqueueCriteria(tileIndex, priority))
+    {
+        cache::DiskTileCache* diskCache = nullptr;
+        if (_useDiskCache && _globeBrowsingModule->diskTileCache() &&
+            _globeBrowsingModule->diskTileCache()->isEnabled())
+        {
+            diskCache = _globeBrowsingModule->diskTileCache();
+        }
+
         if (_pboContainer) {
             char* dataPtr = static_cast<char*>(_pboContainer->mapBuffer(
                 tileIndex.hashKey(), PixelBuffer::Access::WriteOnly));
             if (dataPtr) {
                 auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex,
-                    dataPtr);
-                _concurrentJobManager.enqueueJob(job, tileIndex.hashKey());
+                    dataPtr, diskCache, _diskCacheProviderID);
+                _concurrentJobManager.enqueueJob(job, tileIndex.hashKey(), priority);
                 _enqueuedTileRequests.insert(tileIndex.hashKey());
             }
             else {
@@ -72,8 +104,9 @@ bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
             }
         }
         else {
-            auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex);
-            _concurrentJobManager.enqueueJob(job, tileIndex.hashKey());
+            auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex,
+                diskCache, _diskCacheProviderID);
+            _concurrentJobManager.enqueueJob(job, tileIndex.hashKey(), priority);
             _enqueuedTileRequests.insert(tileIndex.hashKey());
         }
         return true;
@@ -81,6 +114,11 @@ bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     return false;
 }
 
+bool AsyncTileDataProvider::isEnqueued(const TileIndex& tileIndex) const {
+    return _enqueuedTileRequests.find(tileIndex.hashKey()) !=
+           _enqueuedTileRequests.end();
+}
+
 std::vector<std::shared_ptr<RawTile>> AsyncTileDataProvider::rawTiles() {
     std::vector<std::shared_ptr<RawTile>> readyResults;
     std::shared_ptr<RawTile> finishedJob = popFinishedRawTile();
@@ -121,9 +159,15 @@ std::shared_ptr<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
     }
 }
 
-bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex) {
-    // Only satisfies if it is not already enqueued. Also bumps the request to the top.
-    const bool alreadyEnqueued = _concurrentJobManager.touch(tileIndex.hashKey());
+bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex,
+                                                     float priority)
+{
+    // Only satisfies if it is not already enqueued. Also updates the priority of the
+    // request
+    const bool alreadyEnqueued = _concurrentJobManager.touch(
+        tileIndex.hashKey(),
+        priority
+    );
 
     // Concurrent job manager can start jobs which will pop them from enqueued, however
     // they are still in _enqueuedTileRequests until finished
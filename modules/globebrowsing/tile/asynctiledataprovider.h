@@ -49,16 +49,27 @@ public:
     /**
      * \param rawTileDataReader is the reader that will be used for the asynchronous
      * tile loading.
+     * \param diskCacheIdentifier uniquely identifies the data source across sessions. If
+     * it is not empty, loaded tiles are stored in and read from the DiskTileCache of the
+     * GlobeBrowsingModule.
      */
     AsyncTileDataProvider(std::string name,
-        std::shared_ptr<RawTileDataReader> rawTileDataReader);
+        std::shared_ptr<RawTileDataReader> rawTileDataReader,
+        const std::string& diskCacheIdentifier = "");
 
     ~AsyncTileDataProvider();
 
     /**
-     * Creates a job which asynchronously loads a raw tile. This job is enqueued.
+     * Creates a job which asynchronously loads a raw tile. This job is enqueued with the
+     * provided \p priority, where a higher value means that the tile is loaded sooner.
+     * If the tile is already enqueued, only its priority is updated.
      */
-    bool enqueueTileIO(const TileIndex& tileIndex);
+    bool enqueueTileIO(const TileIndex& tileIndex, float priority);
+
+    /**
+     * \returns true if the tile is enqueued or currently being loaded
+     */
+    bool isEnqueued(const TileIndex& tileIndex) const;
 
     /**
      * Get all finished jobs.
@@ -91,11 +102,12 @@ protected:
 
     /**
      * \returns true if tile of index <code>tileIndex</code> is not already enqueued.
+     * Already enqueued tiles get their priority updated to \p priority.
      */
-    bool satisfiesEnqueueCriteria(const TileIndex& tileIndex);
+    bool satisfiesEnqueueCriteria(const TileIndex& tileIndex, float priority);
 
     /**
-     * An unfinished job is a load tile job that has been popped from the thread pool due
+     * An unfinished job is a load tile job that has been dropped from the thread pool due
      * to its low priority. Once it has been popped, it is marked as unfinished and needs
      * to be explicitly ended.
      */
@@ -120,6 +132,10 @@ private:
     std::unique_ptr<PixelBufferContainer<TileIndex::TileHashKey>> _pboContainer;
     std::set<TileIndex::TileHashKey> _enqueuedTileRequests;
 
+    bool _useDiskCache = false;
+    /// Stable identifier of this data source that is used as the key in the disk cache
+    unsigned int _diskCacheProviderID = 0;
+
     ResetMode _resetMode = ResetMode::ShouldResetAllButRawTileDataReader;
     bool _shouldBeDeleted = false;
 };
@@ -24,22 +24,32 @@
 
 #include <modules/globebrowsing/tile/tileloadjob.h>
 
+#include <modules/globebrowsing/cache/disktilecache.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
+#include <openspace/performance/tracer.h>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
 TileLoadJob::TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-                         const TileIndex& tileIndex)
+                         const TileIndex& tileIndex, cache::DiskTileCache* diskCache,
+                         unsigned int diskCacheProviderID)
     : _rawTileDataReader(std::move(rawTileDataReader))
     , _chunkIndex(tileIndex)
+    , _diskCache(diskCache)
+    , _diskCacheProviderID(diskCacheProviderID)
 {}
 
 
 TileLoadJob::TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-                         const TileIndex& tileIndex, char* pboDataPtr)
+                         const TileIndex& tileIndex, char* pboDataPtr,
+                         cache::DiskTileCache* diskCache,
+                         unsigned int diskCacheProviderID)
     : _rawTileDataReader(std::move(rawTileDataReader))
     , _chunkIndex(tileIndex)
     , _pboMappedDataDestination(pboDataPtr)
+    , _diskCache(diskCache)
+    , _diskCacheProviderID(diskCacheProviderID)
 {}
 
 TileLoadJob::~TileLoadJob() {
@@ -51,6 +61,9 @@ TileLoadJob::~TileLoadJob() {
 }
 
 void TileLoadJob::execute() {
+    performance::Tracer::setThreadName("TileLoader");
+    TraceZone("TileLoadJob::execute");
+
     size_t numBytes = _rawTileDataReader->tileTextureInitData().totalNumBytes();
     char* dataPtr = nullptr;
     if (_rawTileDataReader->tileTextureInitData().shouldAllocateDataOnCPU() ||
@@ -59,11 +72,46 @@ void TileLoadJob::execute() {
         dataPtr = new char[numBytes];
         _hasOwnershipOfData = true;
     }
-    _rawTile = _rawTileDataReader->readTileData(
-        _chunkIndex,
-        dataPtr,
-        _pboMappedDataDestination
-    );
+
+    const cache::ProviderTileKey key = { _chunkIndex, _diskCacheProviderID };
+    if (_diskCache) {
+        TraceZone("DiskTileCache::read");
+        _rawTile = _diskCache->read(
+            key,
+            _rawTileDataReader->tileTextureInitData(),
+            dataPtr,
+            _pboMappedDataDestination
+        );
+        if (_rawTile) {
+            return;
+        }
+    }
+
+    // The pixel buffer is mapped write-only, so the disk cache can not read the tile back
+    // from it. Instead, the tile is decoded into a scratch buffer that is copied into the
+    // pixel buffer and written to the cache
+    std::vector<char> scratch;
+    char* decodeDestination = dataPtr;
+    if (_diskCache && !dataPtr) {
+        scratch.resize(numBytes);
+        decodeDestination = scratch.data();
+    }
+
+    {
+        TraceZone("RawTileDataReader::readTileData");
+        _rawTile = _rawTileDataReader->readTileData(
+            _chunkIndex,
+            decodeDestination,
+            _pboMappedDataDestination
+        );
+    }
+
+    if (_diskCache) {
+        TraceZone("DiskTileCache::write");
+        _diskCache->write(key, *_rawTile, decodeDestination);
+    }
+    // The scratch buffer does not outlive this job
+    _rawTile->imageData = dataPtr;
 }
 
 std::shared_ptr<RawTile> TileLoadJob::product() {
@@ -34,15 +34,22 @@ namespace openspace::globebrowsing {
 class RawTileDataReader;
 struct RawTile;
 
+namespace cache { class DiskTileCache; }
+
 struct TileLoadJob : public Job<RawTile> {
     /**
      * Allocates enough data for one tile. When calling <code>product()</code>, the
      * ownership of this data will be released. If <code>product()</code> has not been
      * called before the TileLoadJob is finished, the data will be deleted as it has not
      * been exposed outside of this object.
+     *
+     * If \p diskCache is specified, the tile is first looked up in the disk cache using
+     * the \p diskCacheProviderID and is only read from the RawTileDataReader if it was
+     * not found. Tiles read from the RawTileDataReader are then added to the cache.
      */
     TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-        const TileIndex& tileIndex);
+        const TileIndex& tileIndex, cache::DiskTileCache* diskCache = nullptr,
+        unsigned int diskCacheProviderID = 0);
 
     /**
      * No data is allocated unless specified so by the TileTextureInitData of
@@ -50,7 +57,8 @@ struct TileLoadJob : public Job<RawTile> {
      * buffer object.
      */
     TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-        const TileIndex& tileIndex, char* pboDataPtr);
+        const TileIndex& tileIndex, char* pboDataPtr,
+        cache::DiskTileCache* diskCache = nullptr, unsigned int diskCacheProviderID = 0);
 
     /**
      * Destroys the allocated data pointer if it has been allocated and the TileLoadJob
@@ -86,6 +94,8 @@ protected:
     TileIndex _chunkIndex;
     char* _pboMappedDataDestination = nullptr;
     bool _hasOwnershipOfData = false;
+    cache::DiskTileCache* _diskCache = nullptr;
+    unsigned int _diskCacheProviderID = 0;
 };
 
 } // namespace openspace::globebrowsing
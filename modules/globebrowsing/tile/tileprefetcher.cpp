@@ -0,0 +1,177 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/tileprefetcher.h>
+
+#include <modules/globebrowsing/tile/tileprovider/tileprovider.h>
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
+#include <openspace/interaction/keyframenavigator.h>
+#include <openspace/interaction/navigationhandler.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/camera.h>
+#include <algorithm>
+#include <limits>
+
+namespace {
+    constexpr const size_t ByteToMegaByte = 1024 * 1024;
+
+    // Tiles that are needed for rendering are requested with the negative distance to
+    // the camera as priority (see ChunkedLodGlobe::render), which is always larger than
+    // this value
+    constexpr const float LowestPriority = -1e30f;
+
+    // The weight of the velocity of the last frame when smoothing the camera velocity
+    constexpr const double VelocitySmoothing = 0.5;
+
+    const openspace::properties::Property::PropertyInfo EnabledInfo = {
+        "Enabled",
+        "Enabled",
+        "If this value is enabled, tiles are requested for the positions that the "
+        "camera is predicted to reach within the next frames."
+    };
+
+    const openspace::properties::Property::PropertyInfo LookaheadFramesInfo = {
+        "LookaheadFrames",
+        "Lookahead (frames)",
+        "The number of frames ahead of the current frame for which the camera position "
+        "is predicted."
+    };
+
+    const openspace::properties::Property::PropertyInfo BudgetInfo = {
+        "Budget",
+        "Budget per frame (MB)",
+        "The maximum amount of tile data (in MB) that is requested for prefetching in "
+        "a single frame."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchedTilesInfo = {
+        "PrefetchedTiles",
+        "Prefetched tiles",
+        "The number of tiles that were requested for prefetching in this session."
+    };
+} // namespace
+
+namespace openspace::globebrowsing {
+
+TilePrefetcher::TilePrefetcher()
+    : properties::PropertyOwner({ "TilePrefetcher" })
+    , _enabled(EnabledInfo, true)
+    , _lookaheadFrames(LookaheadFramesInfo, 30, 1, 600)
+    , _budget(BudgetInfo, 4, 0, 1024)
+    , _nPrefetchedTiles(PrefetchedTilesInfo, 0, 0, std::numeric_limits<int>::max())
+{
+    addProperty(_enabled);
+    addProperty(_lookaheadFrames);
+    addProperty(_budget);
+
+    _nPrefetchedTiles.setReadOnly(true);
+    addProperty(_nPrefetchedTiles);
+
+    _predictedCameraPositions.reserve(NumSamples);
+}
+
+void TilePrefetcher::update() {
+    _predictedCameraPositions.clear();
+    _remainingBudget = static_cast<size_t>(_budget) * ByteToMegaByte;
+
+    const Camera* camera = OsEng.navigationHandler().camera();
+    if (!camera) {
+        _hasPreviousCameraPosition = false;
+        return;
+    }
+
+    const glm::dvec3 cameraPosition = camera->positionVec3();
+    const double deltaTime = OsEng.windowWrapper().deltaTime();
+    if (_hasPreviousCameraPosition && deltaTime > 0.0) {
+        const glm::dvec3 velocity = (cameraPosition - _previousCameraPosition) /
+                                    deltaTime;
+        _cameraVelocity = glm::mix(_cameraVelocity, velocity, VelocitySmoothing);
+    }
+    else {
+        _cameraVelocity = glm::dvec3(0.0);
+    }
+    _previousCameraPosition = cameraPosition;
+    _hasPreviousCameraPosition = true;
+
+    if (!_enabled || _budget == 0) {
+        return;
+    }
+
+    const double lookahead = _lookaheadFrames * OsEng.windowWrapper().averageDeltaTime();
+
+    const interaction::KeyframeNavigator& keyframeNavigator =
+        OsEng.navigationHandler().keyframeNavigator();
+    const Scene* scene = OsEng.renderEngine().scene();
+    if (keyframeNavigator.nKeyframes() > 0 && scene) {
+        // The path is known ahead of time, so we can use the exact positions
+        const double now = OsEng.windowWrapper().applicationTime();
+        for (int i = 1; i <= NumSamples; ++i) {
+            glm::dvec3 position;
+            const bool success = keyframeNavigator.cameraPositionAt(
+                now + lookahead * i / NumSamples,
+                *scene,
+                position
+            );
+            if (!success) {
+                break;
+            }
+            _predictedCameraPositions.push_back(position);
+        }
+    }
+    else if (glm::length(_cameraVelocity) * lookahead > 1.0) {
+        for (int i = 1; i <= NumSamples; ++i) {
+            _predictedCameraPositions.push_back(
+                cameraPosition + _cameraVelocity * (lookahead * i / NumSamples)
+            );
+        }
+    }
+}
+
+const std::vector<glm::dvec3>& TilePrefetcher::predictedCameraPositions() const {
+    return _predictedCameraPositions;
+}
+
+bool TilePrefetcher::prefetch(tileprovider::TileProvider& tileProvider,
+                              const TileIndex& tileIndex, int sample)
+{
+    if (_remainingBudget == 0) {
+        return false;
+    }
+
+    const size_t nBytes = tileProvider.prefetch(tileIndex, prefetchPriority(sample));
+    if (nBytes > 0) {
+        _remainingBudget -= std::min(nBytes, _remainingBudget);
+        _nPrefetchedTiles = _nPrefetchedTiles + 1;
+    }
+    return _remainingBudget > 0;
+}
+
+float TilePrefetcher::prefetchPriority(int order) {
+    // The factor keeps the priorities of different orders distinguishable in float
+    // precision
+    return LowestPriority * static_cast<float>(1 + order);
+}
+
+} // namespace openspace::globebrowsing
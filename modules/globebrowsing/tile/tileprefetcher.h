@@ -0,0 +1,102 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREFETCHER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREFETCHER___H__
+
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <ghoul/glm.h>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+struct TileIndex;
+
+namespace tileprovider { class TileProvider; }
+
+/**
+ * Predicts where the camera will be during the next frames and lets the globes request
+ * the tiles for those positions before they are needed for rendering. If the camera is
+ * controlled by the KeyframeNavigator, the positions are taken from the keyframes;
+ * otherwise the camera path is extrapolated from its current velocity.
+ *
+ * Prefetched tiles are enqueued with a priority that is lower than that of any tile
+ * which is needed for rendering, and the amount of data that can be requested per frame
+ * is limited by a byte budget. All methods must be called from the main thread.
+ */
+class TilePrefetcher : public properties::PropertyOwner {
+public:
+    /// The number of predicted camera positions spread out over the lookahead interval
+    constexpr static const int NumSamples = 4;
+
+    TilePrefetcher();
+
+    /**
+     * Updates the predicted camera positions and resets the byte budget. Should be
+     * called once per frame after the camera has been updated.
+     */
+    void update();
+
+    /**
+     * \return the predicted world space positions of the camera, ordered so that the
+     *         position that is reached first comes first. The list is empty if the
+     *         prefetching is disabled or the camera is not moving
+     */
+    const std::vector<glm::dvec3>& predictedCameraPositions() const;
+
+    /**
+     * Requests the tile \p tileIndex from the \p tileProvider for the predicted camera
+     * position with index \p sample if there is any budget left.
+     * \return <code>false</code> if the byte budget for this frame is exhausted
+     */
+    bool prefetch(tileprovider::TileProvider& tileProvider, const TileIndex& tileIndex,
+        int sample);
+
+    /**
+     * \return the priority of a prefetch request, which is lower than the priority of
+     *         any request for a tile that is needed for rendering. Requests with a
+     *         higher \p order are less urgent
+     */
+    static float prefetchPriority(int order);
+
+private:
+    properties::BoolProperty _enabled;
+    properties::IntProperty _lookaheadFrames;
+    properties::IntProperty _budget;
+    properties::IntProperty _nPrefetchedTiles;
+
+    std::vector<glm::dvec3> _predictedCameraPositions;
+
+    bool _hasPreviousCameraPosition = false;
+    glm::dvec3 _previousCameraPosition;
+    glm::dvec3 _cameraVelocity;
+
+    size_t _remainingBudget = 0;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREFETCHER___H__
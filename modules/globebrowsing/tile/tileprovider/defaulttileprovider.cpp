@@ -39,6 +39,21 @@ namespace {
     constexpr const char* KeyFilePath = "FilePath";
     constexpr const char* KeyPreCacheLevel = "PreCacheLevel";
     constexpr const char* KeyPadTiles = "PadTiles";
+    constexpr const char* KeyCacheOnDisk = "CacheOnDisk";
+
+    // Datasets described by a GDAL XML description are usually served by a remote
+    // server and benefit from being cached on disk, whereas local images do not
+    bool isRemoteDataset(const std::string& filePath) {
+        if (!filePath.empty() && filePath.front() == '<') {
+            return true;
+        }
+        const std::string::size_type dot = filePath.find_last_of('.');
+        if (dot == std::string::npos) {
+            return false;
+        }
+        const std::string extension = filePath.substr(dot + 1);
+        return extension == "wms" || extension == "xml";
+    }
 
     const openspace::properties::Property::PropertyInfo FilePathInfo = {
         "FilePath",
@@ -87,6 +102,9 @@ DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
 
     dictionary.getValue<bool>(KeyPadTiles, _padTiles);
 
+    _cacheOnDisk = isRemoteDataset(_filePath.value());
+    dictionary.getValue<bool>(KeyCacheOnDisk, _cacheOnDisk);
+
     TileTextureInitData initData(LayerManager::getTileTextureInitData(
         _layerGroupID,
         LayerManager::PadTiles(_padTiles),
@@ -164,7 +182,7 @@ int DefaultTileProvider::maxLevel() {
     }
 }
 
-Tile DefaultTileProvider::tile(const TileIndex& tileIndex) {
+Tile DefaultTileProvider::tile(const TileIndex& tileIndex, float priority) {
     if (_asyncTextureDataProvider) {
         if (tileIndex.level > maxLevel()) {
             return Tile(nullptr, nullptr, Tile::Status::OutOfRange);
@@ -175,7 +193,7 @@ Tile DefaultTileProvider::tile(const TileIndex& tileIndex) {
         const Tile tile = _tileCache->get(key);
 
         if (!tile.texture()) {
-            _asyncTextureDataProvider->enqueueTileIO(tileIndex);
+            _asyncTextureDataProvider->enqueueTileIO(tileIndex, priority);
         }
 
         return tile;
@@ -223,7 +241,8 @@ void DefaultTileProvider::initAsyncTileDataReader(TileTextureInitData initData)
 
     _asyncTextureDataProvider = std::make_shared<AsyncTileDataProvider>(
         _name,
-        tileDataset
+        tileDataset,
+        _cacheOnDisk ? _filePath.value() : ""
     );
 
     // Tiles are only available for levels 2 and higher.
@@ -234,7 +253,10 @@ void DefaultTileProvider::initAsyncTileDataReader(TileTextureInitData initData)
         for (int level = 0; level <= _preCacheLevel; ++level) {
             for (int x = 0; x <= level * 2; ++x) {
                 for (int y = 0; y <= level; ++y) {
-                    _asyncTextureDataProvider->enqueueTileIO({ x, y, level });
+                    _asyncTextureDataProvider->enqueueTileIO(
+                        { x, y, level },
+                        DefaultRequestPriority
+                    );
                 }
             }
         }
@@ -259,6 +281,26 @@ Tile::Status DefaultTileProvider::tileStatus(const TileIndex& tileIndex) {
     }
 }
 
+size_t DefaultTileProvider::prefetch(const TileIndex& tileIndex, float priority) {
+    if (!_asyncTextureDataProvider || tileIndex.level > maxLevel()) {
+        return 0;
+    }
+
+    const cache::ProviderTileKey key = { tileIndex, uniqueIdentifier() };
+    // Tiles that are already requested must not have their priority lowered
+    if (_tileCache->exist(key) || _asyncTextureDataProvider->isEnqueued(tileIndex)) {
+        return 0;
+    }
+
+    if (_asyncTextureDataProvider->enqueueTileIO(tileIndex, priority)) {
+        return _asyncTextureDataProvider->rawTileDataReader()->tileTextureInitData()
+            .totalNumBytes();
+    }
+    else {
+        return 0;
+    }
+}
+
 TileDepthTransform DefaultTileProvider::depthTransform() {
     if (_asyncTextureDataProvider) {
         return _asyncTextureDataProvider->rawTileDataReader()->depthTransform();
@@ -57,9 +57,10 @@ public:
      * \return A Tile with status OK iff it exists in in-memory cache. If not, it may
      *         enqueue some IO operations on a separate thread.
      */
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
 
     virtual Tile::Status tileStatus(const TileIndex& tileIndex) override;
+    virtual size_t prefetch(const TileIndex& tileIndex, float priority) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
     virtual void reset() override;
@@ -87,6 +88,7 @@ private:
     int _preCacheLevel = 0;
     bool _performPreProcessing = false;
     bool _padTiles = true;
+    bool _cacheOnDisk = false;
 };
 
 } // namespace openspace::globebrowsing::tileprovider
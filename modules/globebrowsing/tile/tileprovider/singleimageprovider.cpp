@@ -59,7 +59,7 @@ SingleImageProvider::SingleImageProvider(const std::string& imagePath)
     reset();
 }
 
-Tile SingleImageProvider::tile(const TileIndex&) {
+Tile SingleImageProvider::tile(const TileIndex&, float) {
     return _tile;
 }
 
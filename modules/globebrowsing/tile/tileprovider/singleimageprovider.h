@@ -37,7 +37,7 @@ public:
     SingleImageProvider(const std::string& imagePath);
     virtual ~SingleImageProvider() = default;
 
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
     virtual Tile::Status tileStatus(const TileIndex& index) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
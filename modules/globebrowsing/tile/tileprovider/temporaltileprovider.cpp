@@ -27,15 +27,20 @@
 #include <modules/globebrowsing/tile/tileprovider/temporaltileprovider.h>
 
 #include <modules/globebrowsing/tile/tiledepthtransform.h>
+#include <modules/globebrowsing/tile/tileprefetcher.h>
 #include <modules/globebrowsing/tile/tileprovider/defaulttileprovider.h>
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/fromstring.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include "cpl_minixml.h"
 
 namespace {
@@ -52,6 +57,40 @@ namespace {
         "This is the path to the XML configuration file that describes the temporal tile "
         "information."
     };
+
+    const openspace::properties::Property::PropertyInfo MaxCachedTimeStepsInfo = {
+        "MaxCachedTimeSteps",
+        "Max cached time steps",
+        "The maximum number of time steps for which the datasets are kept open. If "
+        "more time steps are used, the least recently used ones are closed."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchTimeStepsInfo = {
+        "PrefetchTimeSteps",
+        "Prefetched time steps",
+        "The number of time steps ahead of the current time, in the direction that the "
+        "time is running, for which tiles are loaded before they are shown."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchHitsInfo = {
+        "PrefetchHits",
+        "Prefetch hits",
+        "The number of times that a new time step was shown whose tiles had finished "
+        "prefetching before it was shown."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchMissesInfo = {
+        "PrefetchMisses",
+        "Prefetch misses",
+        "The number of times that a new time step was shown while the time was "
+        "running whose tiles were not prefetched."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchHitRateInfo = {
+        "PrefetchHitRate",
+        "Prefetch hit rate",
+        "The fraction of new time steps whose tiles were prefetched."
+    };
 } // namespace
 
 namespace ghoul {
@@ -124,11 +163,28 @@ namespace {
 TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
     : _initDict(dictionary)
     , _filePath(FilePathInfo)
+    , _maxCachedTimeSteps(MaxCachedTimeStepsInfo, 16, 1, 10000)
+    , _nPrefetchTimeSteps(PrefetchTimeStepsInfo, 2, 0, 32)
+    , _prefetchHits(PrefetchHitsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _prefetchMisses(PrefetchMissesInfo, 0, 0, std::numeric_limits<int>::max())
+    , _prefetchHitRate(PrefetchHitRateInfo, 0.f, 0.f, 1.f)
+    , _tileProviderCache(std::numeric_limits<size_t>::max())
     , _successfulInitialization(false)
 {
     _filePath = dictionary.value<std::string>(KeyFilePath);
     addProperty(_filePath);
 
+    _maxCachedTimeSteps.onChange([&]() { removeUnusedTileProviders(); });
+    addProperty(_maxCachedTimeSteps);
+    addProperty(_nPrefetchTimeSteps);
+
+    _prefetchHits.setReadOnly(true);
+    addProperty(_prefetchHits);
+    _prefetchMisses.setReadOnly(true);
+    addProperty(_prefetchMisses);
+    _prefetchHitRate.setReadOnly(true);
+    addProperty(_prefetchHitRate);
+
     if (readFilePath()) {
         const bool hasStart = dictionary.hasKeyAndValue<std::string>(
             KeyPreCacheStartTime
@@ -141,6 +197,11 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
                 Time(Time::convertTime(start)),
                 Time(Time::convertTime(end))
             );
+            // All precached time steps have to fit into the cache
+            _maxCachedTimeSteps = std::max(
+                _maxCachedTimeSteps.value(),
+                static_cast<int>(_preCacheTimes.size())
+            );
         }
         _successfulInitialization = true;
     }
@@ -272,10 +333,62 @@ Tile::Status TemporalTileProvider::tileStatus(const TileIndex& tileIndex) {
     }
 }
 
-Tile TemporalTileProvider::tile(const TileIndex& tileIndex) {
+size_t TemporalTileProvider::prefetch(const TileIndex& tileIndex, float priority) {
+    if (_successfulInitialization) {
+        ensureUpdated();
+        return _currentTileProvider->prefetch(tileIndex, priority);
+    }
+    else {
+        return 0;
+    }
+}
+
+bool TemporalTileProvider::prefetchUpcoming(const TileIndex& tileIndex,
+                                            TilePrefetcher& prefetcher)
+{
+    if (!_successfulInitialization) {
+        return true;
+    }
+    ensureUpdated();
+
+    // Chunks below the highest level of the dataset are rendered with the tile of
+    // their closest ancestor that exists
+    TileIndex index = tileIndex;
+    while (index.level > 1 && index.level > _currentTileProvider->maxLevel()) {
+        index = index.parent();
+    }
+
+    // The same tile is going to be needed for the next time steps
+    for (size_t i = 0; i < _prefetchTileProviders.size(); ++i) {
+        const bool hasBudget = prefetcher.prefetch(
+            *_prefetchTileProviders[i],
+            index,
+            static_cast<int>(i)
+        );
+
+        // A time step only counts as prefetched if every tile that was requested for it
+        // is loaded by the time it is shown
+        const bool isLoaded = _prefetchTileProviders[i]->tileStatus(index) ==
+                              Tile::Status::OK;
+        bool& isCompleted = _prefetchCompleted.emplace(_prefetchTimeKeys[i], true)
+                                              .first->second;
+        isCompleted = isCompleted && isLoaded;
+
+        if (!hasBudget) {
+            // The remaining time steps did not get their tile requested at all
+            for (size_t j = i + 1; j < _prefetchTimeKeys.size(); ++j) {
+                _prefetchCompleted[_prefetchTimeKeys[j]] = false;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+Tile TemporalTileProvider::tile(const TileIndex& tileIndex, float priority) {
     if (_successfulInitialization) {
         ensureUpdated();
-        return _currentTileProvider->tile(tileIndex);
+        return _currentTileProvider->tile(tileIndex, priority);
     }
     else {
         return Tile::TileUnavailable;
@@ -301,29 +414,124 @@ void TemporalTileProvider::ensureUpdated() {
 
 void TemporalTileProvider::update() {
     if (_successfulInitialization) {
-        std::shared_ptr<TileProvider> newCurrent = getTileProvider(
-            OsEng.timeManager().time()
-        );
-        if (newCurrent) {
-            _currentTileProvider = newCurrent;
+        const Time& time = OsEng.timeManager().time();
+
+        TimeKey timeKey;
+        if (quantizedTimeKey(time, timeKey) && timeKey != _currentTimeKey) {
+            const auto it = _prefetchCompleted.find(timeKey);
+            const bool wasPrefetched = it != _prefetchCompleted.end() && it->second;
+            std::shared_ptr<TileProvider> newCurrent = getTileProvider(time);
+            if (newCurrent) {
+                _currentTileProvider = newCurrent;
+                _currentTimeKey = timeKey;
+
+                // Jumps in time while the time is paused are not expected to be
+                // prefetched
+                if (!time.paused() && time.deltaTime() != 0.0) {
+                    updatePrefetchMetrics(wasPrefetched);
+                }
+            }
+        }
+        else if (_currentTileProvider) {
+            // Keep the current time step the most recently used one
+            _tileProviderCache.touch(_currentTimeKey);
+        }
+
+        _prefetchCompleted.clear();
+        updatePrefetchTileProviders(time);
+
+        if (_currentTileProvider) {
+            _currentTileProvider->update();
+        }
+        for (const std::shared_ptr<TileProvider>& tp : _prefetchTileProviders) {
+            tp->update();
         }
-        _currentTileProvider->update();
     }
 }
 
 void TemporalTileProvider::reset() {
     if (_successfulInitialization) {
-        using K = TimeKey;
-        using V = std::shared_ptr<TileProvider>;
-        for (std::pair<const K, V>& it : _tileProviderMap) {
-            it.second->reset();
+        // The datasets of all other time steps are reopened when they are needed
+        _prefetchTileProviders.clear();
+        _prefetchTimeKeys.clear();
+        _prefetchCompleted.clear();
+        _tileProviderCache.clear();
+        if (_currentTileProvider) {
+            _currentTileProvider->reset();
+            _tileProviderCache.put(_currentTimeKey, _currentTileProvider);
         }
     }
 }
-std::shared_ptr<TileProvider> TemporalTileProvider::getTileProvider(const Time& t) {
+
+bool TemporalTileProvider::quantizedTimeKey(const Time& t, TimeKey& timeKey) const {
     Time tCopy(t);
     if (_timeQuantizer.quantize(tCopy, true)) {
-        TimeKey timeKey = timeStringify(_timeFormat, tCopy);
+        timeKey = timeStringify(_timeFormat, tCopy);
+        return true;
+    }
+    return false;
+}
+
+void TemporalTileProvider::updatePrefetchTileProviders(const Time& t) {
+    _prefetchTileProviders.clear();
+    _prefetchTimeKeys.clear();
+
+    const double deltaTime = t.deltaTime();
+    if (_nPrefetchTimeSteps > 0 && !t.paused() && deltaTime != 0.0) {
+        // If the time is running faster than one time step per frame, the time steps in
+        // between will never be shown
+        const double step = std::max(
+            _timeQuantizer.resolution(),
+            std::abs(deltaTime) * OsEng.windowWrapper().averageDeltaTime()
+        );
+        const double direction = deltaTime > 0.0 ? 1.0 : -1.0;
+
+        for (int i = 1; i <= _nPrefetchTimeSteps; ++i) {
+            TimeKey timeKey;
+            const Time next(t.j2000Seconds() + direction * step * i);
+            // Times outside of the dataset are clamped to the first or last time step
+            if (!quantizedTimeKey(next, timeKey) || timeKey == _currentTimeKey ||
+                std::find(_prefetchTimeKeys.begin(), _prefetchTimeKeys.end(), timeKey) !=
+                _prefetchTimeKeys.end())
+            {
+                continue;
+            }
+
+            std::shared_ptr<TileProvider> tileProvider = getTileProvider(next);
+            if (tileProvider) {
+                _prefetchTileProviders.push_back(std::move(tileProvider));
+                _prefetchTimeKeys.push_back(std::move(timeKey));
+            }
+        }
+    }
+}
+
+void TemporalTileProvider::removeUnusedTileProviders() {
+    // The current and prefetched time steps are the most recently used ones and are
+    // never removed
+    const size_t maxSize = std::max(
+        static_cast<size_t>(_maxCachedTimeSteps),
+        static_cast<size_t>(_nPrefetchTimeSteps) + 1
+    );
+    while (_tileProviderCache.size() > maxSize) {
+        _tileProviderCache.popLRU();
+    }
+}
+
+void TemporalTileProvider::updatePrefetchMetrics(bool wasPrefetched) {
+    if (wasPrefetched) {
+        _prefetchHits = _prefetchHits + 1;
+    }
+    else {
+        _prefetchMisses = _prefetchMisses + 1;
+    }
+    _prefetchHitRate = static_cast<float>(_prefetchHits) /
+                       static_cast<float>(_prefetchHits + _prefetchMisses);
+}
+
+std::shared_ptr<TileProvider> TemporalTileProvider::getTileProvider(const Time& t) {
+    TimeKey timeKey;
+    if (quantizedTimeKey(t, timeKey)) {
         try {
             return getTileProvider(timeKey);
         }
@@ -338,15 +546,15 @@ std::shared_ptr<TileProvider> TemporalTileProvider::getTileProvider(const Time&
 std::shared_ptr<TileProvider> TemporalTileProvider::getTileProvider(
                                                                    const TimeKey& timekey)
 {
-    const auto it = _tileProviderMap.find(timekey);
-    if (it != _tileProviderMap.end()) {
-        return it->second;
+    if (_tileProviderCache.exist(timekey)) {
+        return _tileProviderCache.get(timekey);
     }
     else {
         std::shared_ptr<TileProvider> tileProvider = initTileProvider(timekey);
         tileProvider->initialize();
 
-        _tileProviderMap[timekey] = tileProvider;
+        _tileProviderCache.put(timekey, tileProvider);
+        removeUnusedTileProviders();
         return tileProvider;
     }
 }
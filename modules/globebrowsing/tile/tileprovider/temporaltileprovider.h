@@ -29,8 +29,11 @@
 
 #include <modules/globebrowsing/tile/tileprovider/tileprovider.h>
 
+#include <modules/globebrowsing/cache/lrucache.h>
 #include <modules/globebrowsing/other/timequantizer.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <unordered_map>
 
 struct CPLXMLNode;
@@ -47,6 +50,11 @@ namespace openspace::globebrowsing::tileprovider {
  * extra tags describing the temporal properties of the dataset. See
  * <code>TemporalTileProvider::TemporalXMLTags</code>
  *
+ * A TileProvider is created for each time step that is requested. Only a limited number
+ * of them is kept, and the least recently used ones are removed. While the time is
+ * running, the TileProviders for the time steps that will be shown next are created
+ * ahead of time and the tiles that are requested for the current time step are
+ * prefetched for them as well.
  */
 class TemporalTileProvider : public TileProvider {
 public:
@@ -67,8 +75,11 @@ public:
 
     // These methods implements the TileProvider interface
 
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
     virtual Tile::Status tileStatus(const TileIndex& tileIndex) override;
+    virtual size_t prefetch(const TileIndex& tileIndex, float priority) override;
+    virtual bool prefetchUpcoming(const TileIndex& tileIndex,
+        TilePrefetcher& prefetcher) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
     virtual void reset() override;
@@ -180,6 +191,27 @@ private:
      */
     void ensureUpdated();
 
+    /**
+     * Quantizes the time \p t and converts it into the TimeKey of the time step.
+     *
+     * \return <code>false</code> if the time could not be quantized
+     */
+    bool quantizedTimeKey(const Time& t, TimeKey& timeKey) const;
+
+    /**
+     * Creates the TileProviders for the time steps that follow the time \p t in the
+     * direction and at the rate at which the time is currently changing.
+     */
+    void updatePrefetchTileProviders(const Time& t);
+
+    /**
+     * Removes the least recently used TileProviders until the maximum number of cached
+     * time steps is reached.
+     */
+    void removeUnusedTileProviders();
+
+    void updatePrefetchMetrics(bool wasPrefetched);
+
     bool readFilePath();
 
     // Used for creation of time specific instances of CachingTileProvider
@@ -187,11 +219,28 @@ private:
     properties::StringProperty _filePath;
     std::string _gdalXmlTemplate;
 
-    std::unordered_map<TimeKey, std::shared_ptr<TileProvider>> _tileProviderMap;
+    properties::IntProperty _maxCachedTimeSteps;
+    properties::IntProperty _nPrefetchTimeSteps;
+    properties::IntProperty _prefetchHits;
+    properties::IntProperty _prefetchMisses;
+    properties::FloatProperty _prefetchHitRate;
 
+    /// The cache is not bounded by itself as the bound can be changed at runtime, see
+    /// removeUnusedTileProviders
+    cache::LRUCache<TimeKey, std::shared_ptr<TileProvider>, std::hash<TimeKey>>
+        _tileProviderCache;
 
+    TimeKey _currentTimeKey;
     std::shared_ptr<TileProvider> _currentTileProvider;
 
+    /// Ordered by how soon the time steps are going to be shown
+    std::vector<std::shared_ptr<TileProvider>> _prefetchTileProviders;
+    /// The time steps of the _prefetchTileProviders, in the same order
+    std::vector<TimeKey> _prefetchTimeKeys;
+    /// Whether all tiles that were prefetched for a time step during the last frame had
+    /// finished loading. Time steps for which nothing was prefetched are not contained
+    std::unordered_map<TimeKey, bool> _prefetchCompleted;
+
     TimeFormatType _timeFormat;
     TimeQuantizer _timeQuantizer;
 
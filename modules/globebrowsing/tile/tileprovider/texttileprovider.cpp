@@ -69,7 +69,7 @@ bool TextTileProvider::deinitialize() {
     return TileProvider::deinitialize();
 }
 
-Tile TextTileProvider::tile(const TileIndex& tileIndex) {
+Tile TextTileProvider::tile(const TileIndex& tileIndex, float) {
     cache::ProviderTileKey key = { tileIndex, uniqueIdentifier() };
 
     Tile tile = _tileCache->get(key);
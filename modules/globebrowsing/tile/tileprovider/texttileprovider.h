@@ -59,7 +59,7 @@ public:
     bool deinitialize() override;
 
     // The TileProvider interface below is implemented in this class
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
     virtual Tile::Status tileStatus(const TileIndex& index) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
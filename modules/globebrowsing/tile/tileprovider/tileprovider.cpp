@@ -72,12 +72,22 @@ bool TileProvider::deinitialize() {
     return true;
 };
 
+size_t TileProvider::prefetch(const TileIndex&, float) {
+    return 0;
+}
+
+bool TileProvider::prefetchUpcoming(const TileIndex&, TilePrefetcher&) {
+    return true;
+}
+
 float TileProvider::noDataValueAsFloat() {
     ghoul_assert(_isInitialized, "TileProvider was not initialized.");
     return std::numeric_limits<float>::min();
 }
 
-ChunkTile TileProvider::chunkTile(TileIndex tileIndex, int parents, int maxParents) {
+ChunkTile TileProvider::chunkTile(TileIndex tileIndex, int parents, int maxParents,
+                                  float priority)
+{
     ghoul_assert(_isInitialized, "TileProvider was not initialized.");
     TileUvTransform uvTransform = {
         glm::vec2(0.f, 0.f),
@@ -104,7 +114,7 @@ ChunkTile TileProvider::chunkTile(TileIndex tileIndex, int parents, int maxParen
     // Step 3. Traverse 0 or more parents up the chunkTree until we find a chunk that
     //         has a loaded tile ready to use.
     while (tileIndex.level > 1) {
-        Tile t = tile(tileIndex);
+        Tile t = tile(tileIndex, priority);
         if (t.status() != Tile::Status::OK) {
             if (--maxParents < 0) {
                 return ChunkTile {
@@ -123,13 +133,15 @@ ChunkTile TileProvider::chunkTile(TileIndex tileIndex, int parents, int maxParen
     return ChunkTile{ Tile::TileUnavailable, uvTransform, TileDepthTransform() };
 }
 
-ChunkTilePile TileProvider::chunkTilePile(TileIndex tileIndex, int pileSize) {
+ChunkTilePile TileProvider::chunkTilePile(TileIndex tileIndex, int pileSize,
+                                          float priority)
+{
     ghoul_assert(_isInitialized, "TileProvider was not initialized.");
     ghoul_assert(pileSize >= 0, "pileSize must be positive");
 
     ChunkTilePile chunkTilePile(pileSize);
     for (int i = 0; i < pileSize; ++i) {
-        chunkTilePile[i] = chunkTile(tileIndex, i);
+        chunkTilePile[i] = chunkTile(tileIndex, i, 1337, priority);
         if (chunkTilePile[i].tile.status() == Tile::Status::Unavailable) {
             if (i > 0) {
                 chunkTilePile[i].tile = chunkTilePile[i-1].tile;
@@ -30,6 +30,7 @@
 #include <modules/globebrowsing/rendering/layer/layergroupid.h>
 #include <modules/globebrowsing/tile/tile.h>
 #include <ghoul/misc/dictionary.h>
+#include <limits>
 #include <vector>
 
 namespace openspace::globebrowsing {
@@ -37,6 +38,7 @@ namespace openspace::globebrowsing {
     using ChunkTilePile = std::vector<ChunkTile>;
     struct TileDepthTransform;
     struct TileIndex;
+    class TilePrefetcher;
 } // namespace openspace::globebrowsing
 
 namespace openspace::globebrowsing::tileprovider {
@@ -64,6 +66,14 @@ public:
      */
     TileProvider(const ghoul::Dictionary& dictionary = ghoul::Dictionary());
 
+    /**
+     * The priority of tile requests that do not originate from rendering a chunk. It is
+     * lower than the priority of all tiles that are visible or prefetched, which are
+     * requested with the negative distance to the camera
+     */
+    static constexpr const float DefaultRequestPriority =
+        std::numeric_limits<float>::lowest();
+
     /**
      * Virtual destructor that subclasses should override to do
      * clean up.
@@ -86,17 +96,20 @@ public:
      *
      * \param tileIndex specifying a region of a map for which
      * we want tile data.
+     * \param priority The priority with which the tile is requested if it is not
+     * available yet. A higher value means that the tile is loaded sooner.
      *
      * \returns The tile corresponding to the TileIndex by the time
      * the method was invoked.
      */
-    virtual Tile tile(const TileIndex& tileIndex) = 0;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) = 0;
 
 
     virtual ChunkTile chunkTile(TileIndex tileIndex, int parents = 0,
-        int maxParents = 1337);
+        int maxParents = 1337, float priority = DefaultRequestPriority);
 
-    virtual ChunkTilePile chunkTilePile(TileIndex tileIndex, int pileSize);
+    virtual ChunkTilePile chunkTilePile(TileIndex tileIndex, int pileSize,
+        float priority);
 
     Tile defaultTile() const;
 
@@ -108,6 +121,27 @@ public:
      */
     virtual Tile::Status tileStatus(const TileIndex& index) = 0;
 
+    /**
+     * Requests the <code>Tile</code> for the provided <code>TileIndex</code> to be
+     * loaded before it is needed, using the provided \p priority. Tiles that are
+     * already available or requested are not requested again. The default
+     * implementation does nothing.
+     *
+     * \returns The number of bytes that were requested to be loaded
+     */
+    virtual size_t prefetch(const TileIndex& tileIndex, float priority);
+
+    /**
+     * Requests the tiles that are going to replace the <code>Tile</code> for the
+     * provided <code>TileIndex</code> in the near future, for example the same tile in
+     * the next time steps of a temporal dataset, through the \p prefetcher. This should
+     * be called at most once per chunk and frame. The default implementation does
+     * nothing.
+     *
+     * \returns <code>false</code> if the budget of the \p prefetcher is exhausted
+     */
+    virtual bool prefetchUpcoming(const TileIndex& tileIndex, TilePrefetcher& prefetcher);
+
     /**
      * Get the associated depth transform for this TileProvider.
      * This is necessary for TileProviders serving height map
@@ -94,10 +94,12 @@ TileProviderByIndex::TileProviderByIndex(const ghoul::Dictionary& dictionary) {
     }
 }
 
-Tile TileProviderByIndex::tile(const TileIndex& tileIndex) {
+Tile TileProviderByIndex::tile(const TileIndex& tileIndex, float priority) {
     const auto it = _tileProviderMap.find(tileIndex.hashKey());
     const bool hasProvider = it != _tileProviderMap.end();
-    return hasProvider ? it->second->tile(tileIndex) : Tile::TileUnavailable;
+    return hasProvider ?
+        it->second->tile(tileIndex, priority) :
+        Tile::TileUnavailable;
 }
 
 Tile::Status TileProviderByIndex::tileStatus(const TileIndex& tileIndex) {
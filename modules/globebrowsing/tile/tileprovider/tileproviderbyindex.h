@@ -38,7 +38,7 @@ public:
     TileProviderByIndex(const std::string& imagePath);
     virtual ~TileProviderByIndex() = default;
 
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
     virtual Tile::Status tileStatus(const TileIndex& tileIndex) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
@@ -121,16 +121,26 @@ bool TileProviderByLevel::deinitialize() {
     return TileProvider::deinitialize() && success;
 }
 
-Tile TileProviderByLevel::tile(const TileIndex& tileIndex) {
+Tile TileProviderByLevel::tile(const TileIndex& tileIndex, float priority) {
     TileProvider* provider = levelProvider(tileIndex.level);
     if (provider) {
-        return provider->tile(tileIndex);
+        return provider->tile(tileIndex, priority);
     }
     else {
         return Tile::TileUnavailable;
     }
 }
 
+size_t TileProviderByLevel::prefetch(const TileIndex& tileIndex, float priority) {
+    TileProvider* provider = levelProvider(tileIndex.level);
+    if (provider) {
+        return provider->prefetch(tileIndex, priority);
+    }
+    else {
+        return 0;
+    }
+}
+
 Tile::Status TileProviderByLevel::tileStatus(const TileIndex& index) {
     TileProvider* provider = levelProvider(index.level);
     if (provider) {
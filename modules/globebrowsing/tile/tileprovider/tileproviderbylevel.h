@@ -38,8 +38,9 @@ public:
     bool initialize() override;
     bool deinitialize() override;
 
-    virtual Tile tile(const TileIndex& tileIndex) override;
+    virtual Tile tile(const TileIndex& tileIndex, float priority) override;
     virtual Tile::Status tileStatus(const TileIndex& index) override;
+    virtual size_t prefetch(const TileIndex& tileIndex, float priority) override;
     virtual TileDepthTransform depthTransform() override;
     virtual void update() override;
     virtual void reset() override;
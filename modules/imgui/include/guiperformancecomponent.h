@@ -49,6 +49,7 @@ protected:
 
     properties::BoolProperty _sceneGraphIsEnabled;
     properties::BoolProperty _functionsIsEnabled;
+    properties::BoolProperty _synchronizationIsEnabled;
     properties::BoolProperty _outputLogs;
 };
 
@@ -28,6 +28,7 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/performance/performancelayout.h>
 #include <openspace/performance/performancemanager.h>
+#include <openspace/engine/syncengine.h>
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/misc/sharedmemory.h>
 #include <array>
@@ -64,6 +65,13 @@ namespace {
         "individual functions is visible."
     };
 
+    const openspace::properties::Property::PropertyInfo SynchronizationEnabledInfo = {
+        "ShowSynchronization",
+        "Show Synchronization Measurements",
+        "If this value is enabled, the window showing the number of bytes that each "
+        "synchronized value contributes to the cluster synchronization is visible."
+    };
+
     const openspace::properties::Property::PropertyInfo OutputLogsInfo = {
         "OutputLogs",
         "Output Logs",
@@ -79,12 +87,14 @@ GuiPerformanceComponent::GuiPerformanceComponent()
     , _sortingSelection(SortingSelectionInfo, -1, -1, 6)
     , _sceneGraphIsEnabled(SceneGraphEnabledInfo, false)
     , _functionsIsEnabled(FunctionsEnabledInfo, false)
+    , _synchronizationIsEnabled(SynchronizationEnabledInfo, false)
     , _outputLogs(OutputLogsInfo, false)
 {
     addProperty(_sortingSelection);
 
     addProperty(_sceneGraphIsEnabled);
     addProperty(_functionsIsEnabled);
+    addProperty(_synchronizationIsEnabled);
     addProperty(_outputLogs);
 }
 
@@ -113,6 +123,9 @@ void GuiPerformanceComponent::render() {
     v = _functionsIsEnabled;
     ImGui::Checkbox("Functions", &v);
     _functionsIsEnabled = v;
+    v = _synchronizationIsEnabled;
+    ImGui::Checkbox("Synchronization", &v);
+    _synchronizationIsEnabled = v;
     v = _outputLogs;
     ImGui::Checkbox("Output Logs", &v);
     OsEng.renderEngine().performanceManager()->setLogging(v);
@@ -452,6 +465,26 @@ void GuiPerformanceComponent::render() {
         ImGui::End();
     }
 
+    if (_synchronizationIsEnabled) {
+        bool se = _synchronizationIsEnabled;
+        ImGui::Begin("Synchronization", &se);
+        _synchronizationIsEnabled = se;
+
+        const SyncEngine& syncEngine = OsEng.syncEngine();
+        ImGui::Text("Payload: %zu bytes", syncEngine.payloadSize());
+        ImGui::Text("Transmitted: %zu bytes", syncEngine.transmittedSize());
+        ImGui::Separator();
+
+        for (const SyncEngine::SyncableInfo& info : syncEngine.syncables()) {
+            ImGui::Text(
+                "%s: %zu bytes",
+                info.name.empty() ? "<unnamed>" : info.name.c_str(),
+                info.nBytes
+            );
+        }
+        ImGui::End();
+    }
+
     ImGui::End();
 }
 
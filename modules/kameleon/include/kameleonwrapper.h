@@ -93,13 +93,22 @@ public:
     float* uniformSampledVectorValues(const std::string& xVar, const std::string& yVar,
         const std::string& zVar, const glm::size3_t& outDimensions) const;
 
+    /**
+     * Traces a field line through every seed point and colors it by where its two ends
+     * lead. The seed points are traced on \p nThreads threads or, if \p nThreads is 0,
+     * on defaultParallelThreadCount threads. The result does not depend on the number of
+     * threads.
+     */
     Fieldlines classifiedFieldLines(const std::string& xVar, const std::string& yVar,
         const std::string& zVar, const std::vector<glm::vec3>& seedPoints,
-        float stepSize) const;
+        float stepSize, unsigned int nThreads = 0) const;
 
+    /**
+     * Same as classifiedFieldLines, but all field lines get the same \p color
+     */
     Fieldlines fieldLines(const std::string& xVar, const std::string& yVar,
         const std::string& zVar, const std::vector<glm::vec3>& seedPoints, float stepSize,
-        const glm::vec4& color) const;
+        const glm::vec4& color, unsigned int nThreads = 0) const;
 
     Fieldlines lorentzTrajectories(const std::vector<glm::vec3>& seedPoints,
         const glm::vec4& color, float stepsize) const;
@@ -127,9 +136,15 @@ public:
 private:
     using TraceLine = std::vector<glm::vec3>;
 
-    TraceLine traceCartesianFieldline(const std::string& xVar, const std::string& yVar,
-        const std::string& zVar, const glm::vec3& seedPoint, float stepSize,
-        TraceDirection direction, FieldlineEnd& end) const;
+    Fieldlines traceFieldlines(const std::string& xVar, const std::string& yVar,
+        const std::string& zVar, const std::vector<glm::vec3>& seedPoints, float stepSize,
+        bool shouldClassify, const glm::vec4& color, unsigned int nThreads) const;
+
+    // Writes the traced line into \p line, which is cleared first. Passing the same
+    // vector to consecutive calls lets them reuse its allocation
+    void traceCartesianFieldline(ccmc::Interpolator& interpolator, long int xID,
+        long int yID, long int zID, const glm::vec3& seedPoint, float stepSize,
+        TraceDirection direction, FieldlineEnd& end, TraceLine& line) const;
 
     TraceLine traceLorentzTrajectory(const glm::vec3& seedPoint, float stepsize,
         float eCharge) const;
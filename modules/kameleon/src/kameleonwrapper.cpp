@@ -30,6 +30,8 @@
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/misc.h>
+#include <openspace/util/brickedtraversal.h>
+#include <openspace/util/parallelfor.h>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -50,6 +52,12 @@
 namespace {
     constexpr const char* _loggerCat = "KameleonWrapper";
     constexpr const float RE_TO_METER = 6371000;
+
+    // The interpolators cache the last cell they found and are therefore not safe to
+    // share between threads. Every thread of a parallel traversal gets its own
+    std::unique_ptr<ccmc::Interpolator> createInterpolator(ccmc::Model* model) {
+        return std::unique_ptr<ccmc::Interpolator>(model->createNewInterpolator());
+    }
 } // namespace
 
 namespace openspace {
@@ -189,6 +197,9 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
     float* data = new float[size];
     std::vector<double> doubleData(size);
 
+    // Load the variable before the threads start sampling it
+    _model->loadVariable(var);
+    const long varId = _model->getVariableID(var);
 
     const double varMin =
         _model->getVariableAttribute(var, "actual_min").getAttributeFloat();
@@ -210,89 +221,100 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
         return glm::clamp(izerotoone, 0, NBins - 1);
     };
 
-    // ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Spherical) {
-                    // Put r in the [0..sqrt(3)] range
-                    const double rNorm = glm::root_three<double>() * x /
-                                         outDimensions.x - 1;
-
-                    // Put theta in the [0..PI] range
-                    const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
-
-                    // Put phi in the [0..2PI] range
-                    const double phiNorm = glm::two_pi<double>() * z /
-                                           outDimensions.z - 1;
-
-                    // Go to physical coordinates before sampling
-                    const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                    const double thetaPh = thetaNorm;
-                    // phi range needs to be mapped to the slightly different model
-                    // range to avoid gaps in the data Subtract a small term to
-                    // avoid rounding errors when comparing to phiMax.
-                    const double phiPh = _min.z + phiNorm /
-                                    glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
-
-                    double value = 0.0;
-                    // See if sample point is inside domain
-                    if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                        thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                    {
-                        if (phiPh > _max.z) {
-                            LWARNING("Warning: There might be a gap in the data");
-                        }
-                        // Leave values at zero if outside domain
-                    } else { // if inside
-                        // ENLIL CDF specific hacks!
-                        // Convert from meters to AU for interpolator
-                        const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                        // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
-                        const double localThetaPh = -thetaPh * 180.f /
-                                                    glm::pi<double>() + 90.f;
-                        // Convert from [0, 2pi] rad to [0, 360] degrees
-                        const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                        // Sample
-                        value = _interpolator->interpolate(
-                            var,
-                            static_cast<float>(localRPh),
-                            static_cast<float>(localThetaPh),
-                            static_cast<float>(localPhiPh)
-                        );
-                    }
-
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
-
-                } else {
-                    // Assume cartesian for fallback purpose
-                    const double stepX = (_max.x - _min.x) /
-                                         (static_cast<double>(outDimensions.x));
-                    const double stepY = (_max.y - _min.y) /
-                                         (static_cast<double>(outDimensions.y));
-                    const double stepZ = (_max.z - _min.z) /
-                                         (static_cast<double>(outDimensions.z));
-
-                    const double xPos = _min.x + stepX * x;
-                    const double yPos = _min.y + stepY * y;
-                    const double zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    // swap yPos and zPos because model has Z as up
-                    double value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos)
-                    );
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
+    struct ThreadState {
+        std::unique_ptr<ccmc::Interpolator> interpolator;
+        std::vector<int> histogram = std::vector<int>(NBins, 0);
+    };
+    std::vector<ThreadState> threadStates(defaultParallelThreadCount());
+    for (ThreadState& state : threadStates) {
+        state.interpolator = createInterpolator(_model);
+    }
+
+    auto sample = [&](ThreadState& state, const glm::uvec3& cell) {
+        const size_t x = cell.x;
+        const size_t y = cell.y;
+        const size_t z = cell.z;
+        const size_t index = x + y * outDimensions.x +
+                             z * outDimensions.x * outDimensions.y;
+
+        if (_gridType == GridType::Spherical) {
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * x / outDimensions.x - 1;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * z / outDimensions.z - 1;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model
+            // range to avoid gaps in the data Subtract a small term to
+            // avoid rounding errors when comparing to phiMax.
+            const double phiPh = _min.z + phiNorm /
+                                 glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
+
+            double value = 0.0;
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
                 }
+                // Leave values at zero if outside domain
+            } else { // if inside
+                // ENLIL CDF specific hacks!
+                // Convert from meters to AU for interpolator
+                const double localRPh = rPh / ccmc::constants::AU_in_meters;
+                // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
+                const double localThetaPh = -thetaPh * 180.f / glm::pi<double>() + 90.f;
+                // Convert from [0, 2pi] rad to [0, 360] degrees
+                const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+                // Sample
+                value = state.interpolator->interpolate(
+                    varId,
+                    static_cast<float>(localRPh),
+                    static_cast<float>(localThetaPh),
+                    static_cast<float>(localPhiPh)
+                );
             }
+
+            doubleData[index] = value;
+            state.histogram[mapToHistogram(value)]++;
+
+        } else {
+            // Assume cartesian for fallback purpose
+            const double stepX = (_max.x - _min.x) /
+                                 (static_cast<double>(outDimensions.x));
+            const double stepY = (_max.y - _min.y) /
+                                 (static_cast<double>(outDimensions.y));
+            const double stepZ = (_max.z - _min.z) /
+                                 (static_cast<double>(outDimensions.z));
+
+            const double xPos = _min.x + stepX * x;
+            const double yPos = _min.y + stepY * y;
+            const double zPos = _min.z + stepZ * z;
+
+            // get interpolated data value for (xPos, yPos, zPos)
+            // swap yPos and zPos because model has Z as up
+            double value = state.interpolator->interpolate(
+                varId,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos)
+            );
+            doubleData[index] = value;
+            state.histogram[mapToHistogram(value)]++;
+        }
+    };
+    traverseBricksParallel(glm::uvec3(outDimensions), threadStates, sample);
+
+    for (const ThreadState& state : threadStates) {
+        for (int i = 0; i < NBins; ++i) {
+            histogram[i] += state.histogram[i];
         }
     }
 
@@ -367,87 +389,96 @@ float* KameleonWrapper::uniformSliceValues(const std::string& var,
     //double minValue = std::numeric_limits<double>::max();
 
     float missingValue = _model->getMissingValue();
+    const long varId = _model->getVariableID(var);
 
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for(size_t z = 0; z < outDimensions.z; ++z){
-
-                const float xi = (hasXSlice) ? slice : x;
-                const float yi = (hasYSlice) ? slice : y;
-                const float zi = (hasZSlice) ? slice : z;
-
-                double value = 0;
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-                if (_gridType == GridType::Spherical) {
-                        // int z = zSlice;
-                        // Put r in the [0..sqrt(3)] range
-                        const double rNorm = glm::root_three<double>() * xi / xDim;
-
-                        // Put theta in the [0..PI] range
-                        const double thetaNorm = glm::pi<double>() * yi / yDim;
-
-                        // Put phi in the [0..2PI] range
-                        const double phiNorm = glm::two_pi<double>() * zi / zDim;
-
-                        // Go to physical coordinates before sampling
-                        const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                        const double thetaPh = thetaNorm;
-                        // phi range needs to be mapped to the slightly different model
-                        // range to avoid gaps in the data Subtract a small term to
-                        // avoid rounding errors when comparing to phiMax.
-                        const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
-                                             (_max.z - _min.z - 0.000001);
-
-                        // See if sample point is inside domain
-                        if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                            thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                        {
-                            if (phiPh > _max.z) {
-                                LWARNING("Warning: There might be a gap in the data");
-                            }
-                            // Leave values at zero if outside domain
-                        } else { // if inside
-                            // ENLIL CDF specific hacks!
-                            // Convert from meters to AU for interpolator
-                            const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                            // Convert from colatitude [0, pi] rad to [-90, 90] deg
-                            const double localThetaPh = -thetaPh * 180.f /
-                                                        glm::pi<double>() + 90.f;
-                            // Convert from [0, 2pi] rad to [0, 360] degrees
-                            const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                            // Sample
-                            value = _interpolator->interpolate(
-                                var,
-                                static_cast<float>(localRPh),
-                                static_cast<float>(localPhiPh),
-                                static_cast<float>(localThetaPh)
-                            );
-                        }
-
-                } else {
-                    const double xPos = _min.x + stepX * xi;
-                    const double yPos = _min.y + stepY * yi;
-                    const double zPos = _min.z + stepZ * zi;
-
-                    // std::cout << zPos << ", " << zpos << std::endl;
-                    // Should y and z be flipped?
-                    value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos));
-                }
+    std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators(
+        defaultParallelThreadCount()
+    );
+    for (std::unique_ptr<ccmc::Interpolator>& interpolator : interpolators) {
+        interpolator = createInterpolator(_model);
+    }
 
-                if (value != missingValue) {
-                    doubleData[index] = value;
-                    data[index] = static_cast<float>(value);
-                } else {
-                    doubleData[index] = 0;
+    auto sample = [&](std::unique_ptr<ccmc::Interpolator>& interpolator,
+                      const glm::uvec3& cell)
+    {
+        const size_t x = cell.x;
+        const size_t y = cell.y;
+        const size_t z = cell.z;
+
+        const float xi = (hasXSlice) ? slice : x;
+        const float yi = (hasYSlice) ? slice : y;
+        const float zi = (hasZSlice) ? slice : z;
+
+        double value = 0;
+        const size_t index = x + y * outDimensions.x +
+                             z * outDimensions.x * outDimensions.y;
+        if (_gridType == GridType::Spherical) {
+            // int z = zSlice;
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * xi / xDim;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * yi / yDim;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * zi / zDim;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model
+            // range to avoid gaps in the data Subtract a small term to
+            // avoid rounding errors when comparing to phiMax.
+            const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
+                                 (_max.z - _min.z - 0.000001);
+
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
                 }
+                // Leave values at zero if outside domain
+            } else { // if inside
+                // ENLIL CDF specific hacks!
+                // Convert from meters to AU for interpolator
+                const double localRPh = rPh / ccmc::constants::AU_in_meters;
+                // Convert from colatitude [0, pi] rad to [-90, 90] deg
+                const double localThetaPh = -thetaPh * 180.f / glm::pi<double>() + 90.f;
+                // Convert from [0, 2pi] rad to [0, 360] degrees
+                const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+                // Sample
+                value = interpolator->interpolate(
+                    varId,
+                    static_cast<float>(localRPh),
+                    static_cast<float>(localPhiPh),
+                    static_cast<float>(localThetaPh)
+                );
             }
+
+        } else {
+            const double xPos = _min.x + stepX * xi;
+            const double yPos = _min.y + stepY * yi;
+            const double zPos = _min.z + stepZ * zi;
+
+            // std::cout << zPos << ", " << zpos << std::endl;
+            // Should y and z be flipped?
+            value = interpolator->interpolate(
+                varId,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos));
         }
-    }
+
+        if (value != missingValue) {
+            doubleData[index] = value;
+            data[index] = static_cast<float>(value);
+        } else {
+            doubleData[index] = 0;
+        }
+    };
+    traverseBricksParallel(glm::uvec3(outDimensions), interpolators, sample);
 
     return data;
 }
@@ -488,41 +519,50 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     //LDEBUG(zVar << "Min: " << varZMin);
     //LDEBUG(zVar << "Max: " << varZMax);
 
-    //ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        //pb.print(x);
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x * NumChannels + y * NumChannels * outDimensions.x +
-                                     z * NumChannels * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Cartesian) {
-                    const float xPos = _min.x + stepX * x;
-                    const float yPos = _min.y + stepY * y;
-                    const float zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    const float xVal = _interpolator->interpolate(xVar, xPos, yPos, zPos);
-                    const float yVal = _interpolator->interpolate(yVar, xPos, yPos, zPos);
-                    const float zVal = _interpolator->interpolate(zVar, xPos, yPos, zPos);
-
-                    // scale to [0,1]
-                    data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
-                    data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
-                    data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
-                    // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
-                    data[index + 3] = 1.f;
-                } else {
-                    LERROR(
-                        "Only cartesian grid supported for "
-                        "uniformSampledVectorValues (for now)"
-                    );
-                    return data;
-                }
-            }
-        }
+    if (_gridType != GridType::Cartesian) {
+        LERROR("Only cartesian grid supported for uniformSampledVectorValues (for now)");
+        return data;
     }
 
+    // Load the variables before the threads start sampling them
+    _model->loadVariable(xVar);
+    _model->loadVariable(yVar);
+    _model->loadVariable(zVar);
+    const long xId = _model->getVariableID(xVar);
+    const long yId = _model->getVariableID(yVar);
+    const long zId = _model->getVariableID(zVar);
+
+    std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators(
+        defaultParallelThreadCount()
+    );
+    for (std::unique_ptr<ccmc::Interpolator>& interpolator : interpolators) {
+        interpolator = createInterpolator(_model);
+    }
+
+    auto sample = [&](std::unique_ptr<ccmc::Interpolator>& interpolator,
+                      const glm::uvec3& cell)
+    {
+        const size_t index = NumChannels * (cell.x + cell.y * outDimensions.x +
+                             cell.z * outDimensions.x * outDimensions.y);
+
+        const float xPos = _min.x + stepX * cell.x;
+        const float yPos = _min.y + stepY * cell.y;
+        const float zPos = _min.z + stepZ * cell.z;
+
+        // get interpolated data value for (xPos, yPos, zPos)
+        const float xVal = interpolator->interpolate(xId, xPos, yPos, zPos);
+        const float yVal = interpolator->interpolate(yId, xPos, yPos, zPos);
+        const float zVal = interpolator->interpolate(zId, xPos, yPos, zPos);
+
+        // scale to [0,1]
+        data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
+        data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
+        data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
+        // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
+        data[index + 3] = 1.f;
+    };
+    traverseBricksParallel(glm::uvec3(outDimensions), interpolators, sample);
+
     return data;
 }
 
@@ -530,7 +570,8 @@ KameleonWrapper::Fieldlines KameleonWrapper::classifiedFieldLines(const std::str
                                                                   const std::string& yVar,
                                                                   const std::string& zVar,
                                                  const std::vector<glm::vec3>& seedPoints,
-                                                                     float stepSize) const
+                                                                           float stepSize,
+                                                               unsigned int nThreads) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
     LINFO(fmt::format(
@@ -538,51 +579,16 @@ KameleonWrapper::Fieldlines KameleonWrapper::classifiedFieldLines(const std::str
         seedPoints.size(), xVar, yVar, zVar
     ));
 
-    std::vector<std::vector<LinePoint> > fieldLines;
-
-    if (_type == Model::BATSRUS) {
-        fieldLines.reserve(seedPoints.size());
-        for (const glm::vec3& seedPoint : seedPoints) {
-            FieldlineEnd forwardEnd;
-            std::vector<glm::vec3> fLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
-                stepSize,
-                TraceDirection::FORWARD,
-                forwardEnd
-            );
-            FieldlineEnd backEnd;
-            std::vector<glm::vec3> bLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
-                stepSize,
-                TraceDirection::BACK,
-                backEnd
-            );
-
-            bLine.erase(bLine.begin());
-            bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
-
-            // classify
-            glm::vec4 color = classifyFieldline(forwardEnd, backEnd);
-
-            // write colors and convert positions to meter
-            std::vector<LinePoint> line;
-            for (glm::vec3& position : bLine) {
-                line.push_back({ RE_TO_METER * std::move(position), color });
-            }
-
-            fieldLines.push_back(line);
-        }
-    } else {
-        LERROR("Fieldlines are only supported for BATSRUS model");
-    }
-
-    return fieldLines;
+    return traceFieldlines(
+        xVar,
+        yVar,
+        zVar,
+        seedPoints,
+        stepSize,
+        true,
+        glm::vec4(0.f),
+        nThreads
+    );
 }
 
 KameleonWrapper::Fieldlines KameleonWrapper::fieldLines(const std::string& xVar,
@@ -590,7 +596,8 @@ KameleonWrapper::Fieldlines KameleonWrapper::fieldLines(const std::string& xVar,
                                                         const std::string& zVar,
                                                  const std::vector<glm::vec3>& seedPoints,
                                                                            float stepSize,
-                                                             const glm::vec4& color) const
+                                                                   const glm::vec4& color,
+                                                               unsigned int nThreads) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
 
@@ -599,47 +606,99 @@ KameleonWrapper::Fieldlines KameleonWrapper::fieldLines(const std::string& xVar,
         seedPoints.size(), xVar, yVar, zVar
     ));
 
-    Fieldlines fieldLines;
-
-    if (_type == Model::BATSRUS) {
-        fieldLines.reserve(seedPoints.size());
-        for (const glm::vec3& seedPoint : seedPoints) {
-            FieldlineEnd forwardEnd;
-            std::vector<glm::vec3> fLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
-                stepSize,
-                TraceDirection::FORWARD,
-                forwardEnd
-            );
-            FieldlineEnd backEnd;
-            std::vector<glm::vec3> bLine = traceCartesianFieldline(
-                xVar,
-                yVar,
-                zVar,
-                seedPoint,
-                stepSize,
-                TraceDirection::BACK,
-                backEnd
-            );
+    return traceFieldlines(
+        xVar,
+        yVar,
+        zVar,
+        seedPoints,
+        stepSize,
+        false,
+        color,
+        nThreads
+    );
+}
 
-            bLine.erase(bLine.begin());
-            bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
+KameleonWrapper::Fieldlines KameleonWrapper::traceFieldlines(const std::string& xVar,
+                                                             const std::string& yVar,
+                                                             const std::string& zVar,
+                                                 const std::vector<glm::vec3>& seedPoints,
+                                                                           float stepSize,
+                                                                      bool shouldClassify,
+                                                                   const glm::vec4& color,
+                                                               unsigned int nThreads) const
+{
+    if (_type != Model::BATSRUS) {
+        LERROR("Fieldlines are only supported for BATSRUS model");
+        return Fieldlines();
+    }
 
-            // write colors and convert positions to meter
-            std::vector<LinePoint> line;
-            for (glm::vec3& position : bLine) {
-                line.push_back({ RE_TO_METER * std::move(position), color });
-            }
+    // Load the variables before the threads start sampling them
+    _model->loadVariable(xVar);
+    _model->loadVariable(yVar);
+    _model->loadVariable(zVar);
+    const long int xID = _model->getVariableID(xVar);
+    const long int yID = _model->getVariableID(yVar);
+    const long int zID = _model->getVariableID(zVar);
 
-            fieldLines.push_back(line);
-        }
-    } else {
-        LERROR("Fieldlines are only supported for BATSRUS model");
+    // Every thread has its own interpolator and keeps its trace buffers between seeds
+    struct ThreadState {
+        std::unique_ptr<ccmc::Interpolator> interpolator;
+        TraceLine forwardLine;
+        TraceLine backLine;
+    };
+    std::vector<ThreadState> threadStates(
+        nThreads > 0 ? nThreads : defaultParallelThreadCount()
+    );
+    for (ThreadState& state : threadStates) {
+        state.interpolator = createInterpolator(_model);
     }
 
+    // Every line is written to the slot of its seed point, so the result does not
+    // depend on the order in which the threads finish
+    Fieldlines fieldLines(seedPoints.size());
+    auto trace = [&](ThreadState& state, size_t i) {
+        FieldlineEnd forwardEnd;
+        traceCartesianFieldline(
+            *state.interpolator,
+            xID,
+            yID,
+            zID,
+            seedPoints[i],
+            stepSize,
+            TraceDirection::FORWARD,
+            forwardEnd,
+            state.forwardLine
+        );
+        FieldlineEnd backEnd;
+        traceCartesianFieldline(
+            *state.interpolator,
+            xID,
+            yID,
+            zID,
+            seedPoints[i],
+            stepSize,
+            TraceDirection::BACK,
+            backEnd,
+            state.backLine
+        );
+
+        const glm::vec4 lineColor = shouldClassify ?
+            classifyFieldline(forwardEnd, backEnd) :
+            color;
+
+        // The forward line in reverse, followed by the back line without the seed point
+        // that both of them start with. Positions are converted to meter
+        std::vector<LinePoint>& line = fieldLines[i];
+        line.reserve(state.forwardLine.size() + state.backLine.size() - 1);
+        for (auto it = state.forwardLine.rbegin(); it != state.forwardLine.rend(); ++it) {
+            line.push_back({ RE_TO_METER * *it, lineColor });
+        }
+        for (auto it = state.backLine.begin() + 1; it != state.backLine.end(); ++it) {
+            line.push_back({ RE_TO_METER * *it, lineColor });
+        }
+    };
+    parallelForEach(seedPoints.size(), threadStates, trace);
+
     return fieldLines;
 }
 
@@ -767,29 +826,19 @@ KameleonWrapper::GridType KameleonWrapper::gridType() const {
     return _gridType;
 }
 
-KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
-                                                                  const std::string& xVar,
-                                                                  const std::string& yVar,
-                                                                  const std::string& zVar,
+void KameleonWrapper::traceCartesianFieldline(ccmc::Interpolator& interpolator,
+                                              long int xID, long int yID, long int zID,
                                                                const glm::vec3& seedPoint,
                                                                            float stepSize,
                                                                  TraceDirection direction,
-                                                                  FieldlineEnd& end) const
+                                                                        FieldlineEnd& end,
+                                                                    TraceLine& line) const
 {
     constexpr const int MaxSteps = 5000;
 
-    _model->loadVariable(xVar);
-    const long int xID = _model->getVariableID(xVar);
-
-    _model->loadVariable(yVar);
-    const long int yID = _model->getVariableID(yVar);
-
-    _model->loadVariable(zVar);
-    const long int zID = _model->getVariableID(zVar);
-
     glm::vec3 pos = seedPoint;
     int numSteps = 0;
-    TraceLine line;
+    line.clear();
 
     // While we are inside the models boundaries and not inside earth
     while ((pos.x < _max.x && pos.x > _min.x && pos.y < _max.y && pos.y > _min.y &&
@@ -805,9 +854,9 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
         float stepY;
         float stepZ;
         glm::vec3 k1 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, pos.x, pos.y, pos.z, stepX, stepY, stepZ),
-            _interpolator->interpolate(yID, pos.x, pos.y, pos.z),
-            _interpolator->interpolate(zID, pos.x, pos.y, pos.z)
+            interpolator.interpolate(xID, pos.x, pos.y, pos.z, stepX, stepY, stepZ),
+            interpolator.interpolate(yID, pos.x, pos.y, pos.z),
+            interpolator.interpolate(zID, pos.x, pos.y, pos.z)
         ));
         k1 = (direction == TraceDirection::FORWARD) ? k1 : -1.f * k1;
 
@@ -815,25 +864,25 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
 
         glm::vec3 k1Pos = pos + step / 2.f * k1;
         glm::vec3 k2 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(yID, k1Pos.x, k1Pos.y, k1Pos.z),
-            _interpolator->interpolate(zID, k1Pos.x, k1Pos.y, k1Pos.z)
+            interpolator.interpolate(xID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(yID, k1Pos.x, k1Pos.y, k1Pos.z),
+            interpolator.interpolate(zID, k1Pos.x, k1Pos.y, k1Pos.z)
         ));
         k2 = (direction == TraceDirection::FORWARD) ? k2 : -1.f * k2;
 
         glm::vec3 k2Pos = pos + step / 2.f * k2;
         glm::vec3 k3 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k2Pos.x, k2Pos.y, k2Pos.z),
-            _interpolator->interpolate(yID, k2Pos.x, k2Pos.y, k2Pos.z),
-            _interpolator->interpolate(zID, k2Pos.x, k2Pos.y, k2Pos.z)
+            interpolator.interpolate(xID, k2Pos.x, k2Pos.y, k2Pos.z),
+            interpolator.interpolate(yID, k2Pos.x, k2Pos.y, k2Pos.z),
+            interpolator.interpolate(zID, k2Pos.x, k2Pos.y, k2Pos.z)
         ));
         k3 = (direction == TraceDirection::FORWARD) ? k3 : -1.f * k3;
 
         glm::vec3 k3Pos = pos + step / 2.f * k3;
         glm::vec3 k4 = glm::normalize(glm::vec3(
-            _interpolator->interpolate(xID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(yID, k3Pos.x, k3Pos.y, k3Pos.z),
-            _interpolator->interpolate(zID, k3Pos.x, k3Pos.y, k3Pos.z)
+            interpolator.interpolate(xID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(yID, k3Pos.x, k3Pos.y, k3Pos.z),
+            interpolator.interpolate(zID, k3Pos.x, k3Pos.y, k3Pos.z)
         ));
         k4 = (direction == TraceDirection::FORWARD) ? k4 : -1.f * k4;
 
@@ -857,8 +906,6 @@ KameleonWrapper::TraceLine KameleonWrapper::traceCartesianFieldline(
     else {
         end = FieldlineEnd::FAROUT;
     }
-
-    return line;
 }
 
 KameleonWrapper::TraceLine KameleonWrapper::traceLorentzTrajectory(
@@ -26,6 +26,7 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/volume/rawvolume.h>
+#include <openspace/util/brickedtraversal.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -83,18 +84,14 @@ KameleonVolumeReader::KameleonVolumeReader(std::string path) : _path(std::move(p
         LERROR(fmt::format("Failed to open file '{}' with Kameleon", _path));
         throw ghoul::RuntimeError("Failed to open file: " + _path + " with Kameleon");
     }
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(
-        _kameleon.model->createNewInterpolator()
-    );
 }
 
 std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                             const glm::uvec3 & dimensions,
                                                               const std::string& variable,
                                                         const glm::vec3& lowerDomainBound,
-                                                  const glm::vec3& upperDomainBound) const
+                                                        const glm::vec3& upperDomainBound,
+                                 const std::function<void(float)>& progressCallback) const
 {
     float min, max;
     return readFloatVolume(
@@ -103,7 +100,8 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
         lowerDomainBound,
         upperDomainBound,
         min,
-        max
+        max,
+        progressCallback
     );
 }
 
@@ -113,31 +111,61 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                               const glm::vec3& lowerBound,
                                                               const glm::vec3& upperBound,
                                                                           float& minValue,
-                                                                    float& maxValue) const
+                                                                         float& maxValue,
+                                 const std::function<void(float)>& progressCallback) const
 {
-    minValue = std::numeric_limits<float>::max();
-    maxValue = -std::numeric_limits<float>::max();
-
     std::unique_ptr<volume::RawVolume<float>> volume =
         std::make_unique<volume::RawVolume<float>>(dimensions);
 
     const glm::vec3 dims = volume->dimensions();
     const glm::vec3 diff = upperBound - lowerBound;
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
+    // Load the variable up front, so that the threads don't race to load it lazily, and
+    // look up its id once instead of once per sample
+    _kameleon.model->loadVariable(variable);
+    const long variableId = _kameleon.model->getVariableID(variable);
+
+    // The interpolators cache the last cell they found and are therefore not safe to
+    // share between threads
+    struct ThreadState {
+        std::unique_ptr<ccmc::Interpolator> interpolator;
+        float minValue = std::numeric_limits<float>::max();
+        float maxValue = -std::numeric_limits<float>::max();
     };
+    std::vector<ThreadState> threadStates(defaultParallelThreadCount());
+    for (ThreadState& state : threadStates) {
+        state.interpolator = std::unique_ptr<ccmc::Interpolator>(
+            _kameleon.model->createNewInterpolator()
+        );
+    }
 
     float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); ++index) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+    traverseBricksParallel(
+        dimensions,
+        threadStates,
+        [&](ThreadState& state, const glm::uvec3& coords) {
+            const glm::vec3 coordsZeroToOne = glm::vec3(coords) / dims;
+            const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+
+            const float value = state.interpolator->interpolate(
+                variableId,
+                volumeCoords[0],
+                volumeCoords[1],
+                volumeCoords[2]
+            );
+            data[volume->coordsToIndex(coords)] = value;
 
-        data[index] = interpolate(variable, volumeCoords);
+            state.minValue = glm::min(state.minValue, value);
+            state.maxValue = glm::max(state.maxValue, value);
+        },
+        progressCallback
+    );
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
+    minValue = std::numeric_limits<float>::max();
+    maxValue = -std::numeric_limits<float>::max();
+    for (const ThreadState& state : threadStates) {
+        minValue = glm::min(minValue, state.minValue);
+        maxValue = glm::max(maxValue, state.maxValue);
     }
 
     return volume;
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMEREADER___H__
 
 #include <ghoul/glm.h>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -42,8 +43,6 @@
 #pragma warning (pop)
 #endif // WIN32
 
-namespace ccmc { class Interpolator; }
-
 namespace ghoul { class Dictionary; }
 namespace openspace::volume { template <typename T> class RawVolume; }
 
@@ -55,12 +54,20 @@ public:
 
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
-        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound) const;
-
+        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound,
+        const std::function<void(float)>& progressCallback = nullptr) const;
+
+    /**
+     * Resamples the \p variable onto a regular grid with the provided \p dimensions.
+     * The grid is split into bricks that are sampled in parallel, each thread using
+     * its own interpolator. The \p progressCallback is called from the calling thread
+     * with the fraction of the volume that has been sampled.
+     */
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
-        float& maxValue) const;
+        float& maxValue,
+        const std::function<void(float)>& progressCallback = nullptr) const;
 
     ghoul::Dictionary readMetaData() const;
 
@@ -84,7 +91,6 @@ private:
 
     std::string _path;
     ccmc::Kameleon _kameleon;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
 };
 
 } // namespace openspace::kameleonvolume
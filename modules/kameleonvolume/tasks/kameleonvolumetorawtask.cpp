@@ -164,15 +164,15 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         );
     }
 
+    // Resampling is by far the most expensive step, so it gets most of the progress
     std::unique_ptr<volume::RawVolume<float>> rawVolume = reader.readFloatVolume(
         _dimensions,
         _variable,
         _lowerDomainBound,
-        _upperDomainBound
+        _upperDomainBound,
+        [&progressCallback](float progress) { progressCallback(0.8f * progress); }
     );
 
-    progressCallback(0.5f);
-
     volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath);
     writer.write(*rawVolume);
 
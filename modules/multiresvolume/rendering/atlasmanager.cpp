@@ -28,8 +28,8 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "AtlasManager";
@@ -51,7 +51,6 @@ bool AtlasManager::initialize() {
     _atlasDim = _nBricksPerDim * _paddedBrickDim;
     _nBrickVals = _paddedBrickDim*_paddedBrickDim*_paddedBrickDim;
     _brickSize = _nBrickVals * sizeof(float);
-    _volumeSize = _brickSize * _nOtLeaves;
     _atlasMap = std::vector<unsigned int>(_nOtLeaves, NOT_USED);
     _nBricksInAtlas = _nBricksInMap;
 
@@ -71,6 +70,12 @@ bool AtlasManager::initialize() {
 
     glGenBuffers(2, _pboHandle);
 
+    _streamer = std::make_unique<BrickStreamer>(
+        _tsp->filename(),
+        TSP::dataPosition(),
+        _nBrickVals
+    );
+
     glGenBuffers(1, &_atlasMapBuffer);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     glBufferData(
@@ -100,47 +105,115 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
         _requiredBricks.insert(brickIndices[i]);
     }
 
-    for (unsigned int it : _prevRequiredBricks) {
-        if (!_requiredBricks.count(it)) {
-            removeFromAtlas(it);
+    std::vector<unsigned int> missingBricks;
+    size_t nNewBricks = 0;
+    for (unsigned int brick : _requiredBricks) {
+        if (!_brickMap.count(brick)) {
+            missingBricks.push_back(brick);
+        }
+        if (!_prevRequiredBricks.count(brick)) {
+            nNewBricks++;
         }
     }
+    _streamer->request(missingBricks);
+
+    // The previous selection is kept in the atlas while the new bricks are streamed,
+    // unless there is nothing to show yet, the selection has been lagging behind for
+    // too long, or both selections do not fit into the atlas at the same time
+    const bool shouldWait = !missingBricks.empty() &&
+        (_prevRequiredBricks.empty() || _framesBehind >= _maxFramesBehind ||
+         _prevRequiredBricks.size() + nNewBricks > _nBricksInAtlas);
+    if (shouldWait) {
+        _prevRequiredBricks.clear();
+        _streamer->waitUntilIdle();
+    }
+
+    // Remove all bricks that are neither used by the current atlas map nor required
+    std::vector<unsigned int> unusedBricks;
+    for (const std::pair<const unsigned int, unsigned int>& brick : _brickMap) {
+        if (!_requiredBricks.count(brick.first) &&
+            !_prevRequiredBricks.count(brick.first))
+        {
+            unusedBricks.push_back(brick.first);
+        }
+    }
+    for (unsigned int brick : unusedBricks) {
+        removeFromAtlas(brick);
+    }
 
     // Stats
     _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
     _nStreamedBricks = 0;
-    _nDiskReads = 0;
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, 0, GL_STREAM_DRAW);
-    float* mappedBuffer = reinterpret_cast<float*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
-
-    if (!mappedBuffer) {
-        LERROR("Failed to map PBO");
-        std::cout << glGetError() << std::endl;
-        return;
+    // Bricks that have been deselected while they were streamed are dropped
+    std::vector<BrickStreamer::Brick> finishedBricks = _streamer->takeFinishedBricks();
+    std::vector<const BrickStreamer::Brick*> uploads;
+    for (const BrickStreamer::Brick& brick : finishedBricks) {
+        if (_requiredBricks.count(brick.index) && !_brickMap.count(brick.index) &&
+            uploads.size() < _freeAtlasCoords.size())
+        {
+            uploads.push_back(&brick);
+        }
     }
 
-    for (auto itStart = _requiredBricks.begin(); itStart != _requiredBricks.end();) {
-        int firstBrick = *itStart;
-        int lastBrick = firstBrick;
+    if (!uploads.empty()) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
+        glBufferData(
+            GL_PIXEL_UNPACK_BUFFER,
+            uploads.size() * _brickSize,
+            0,
+            GL_STREAM_DRAW
+        );
+        float* mappedBuffer = reinterpret_cast<float*>(
+            glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)
+        );
+
+        if (!mappedBuffer) {
+            LERROR("Failed to map PBO");
+            std::cout << glGetError() << std::endl;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            for (BrickStreamer::Brick& brick : finishedBricks) {
+                _streamer->recycle(std::move(brick.data));
+            }
+            return;
+        }
 
-        auto itEnd = itStart;
-        for (itEnd++;
-            itEnd != _requiredBricks.end() &&
-            *itEnd == static_cast<unsigned int>(lastBrick) + 1;
-            itEnd++)
-        {
-            lastBrick = *itEnd;
+        // The bricks are packed one after the other in the PBO and copied into their
+        // own region of the atlas, leaving the bricks that are in use untouched
+        std::vector<unsigned int> uploadedBricks;
+        for (size_t i = 0; i < uploads.size(); ++i) {
+            std::copy(
+                uploads[i]->data.begin(),
+                uploads[i]->data.end(),
+                mappedBuffer + i * _nBrickVals
+            );
+            addToAtlas(uploads[i]->index);
+            uploadedBricks.push_back(uploads[i]->index);
         }
 
-        addToAtlas(firstBrick, lastBrick, mappedBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-        itStart = itEnd;
+        pboToAtlas(bufferIndex, uploadedBricks);
     }
 
-    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    for (BrickStreamer::Brick& brick : finishedBricks) {
+        _streamer->recycle(std::move(brick.data));
+    }
+
+    _streamingStatistics = _streamer->takeStatistics();
+    _nDiskReads = _streamingStatistics.nDiskReads;
+
+    const bool isComplete = std::all_of(
+        _requiredBricks.begin(),
+        _requiredBricks.end(),
+        [this](unsigned int brick) { return _brickMap.count(brick) > 0; }
+    );
+    if (!isComplete) {
+        _framesBehind++;
+        return;
+    }
+    _framesBehind = 0;
 
     for (size_t i = 0; i < nBrickIndices; i++) {
         _atlasMap[i] = _brickMap[brickIndices[i]];
@@ -148,8 +221,6 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
 
     std::swap(_prevRequiredBricks, _requiredBricks);
 
-    pboToAtlas(bufferIndex);
-
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     GLint *to = reinterpret_cast<GLint*>(
         glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY)
@@ -159,34 +230,16 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer) {
-    while (_brickMap.count(firstBrickIndex) && firstBrickIndex <= lastBrickIndex) firstBrickIndex++;
-    while (_brickMap.count(lastBrickIndex) && lastBrickIndex >= firstBrickIndex) lastBrickIndex--;
-    if (lastBrickIndex < firstBrickIndex) return;
-
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
-
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) * static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
-
-    for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
-        if (!_brickMap.count(brickIndex)) {
-            unsigned int atlasCoords = _freeAtlasCoords.back();
-            _freeAtlasCoords.pop_back();
-            int level = _nOtLevels - static_cast<int>(floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1);
-            ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
-            unsigned int atlasData = (level << 28) + atlasCoords;
-            _brickMap.insert(std::pair<unsigned int, unsigned int>(brickIndex, atlasData));
-            _nStreamedBricks++;
-            fillVolume(&sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)], mappedBuffer, atlasCoords);
-        }
-    }
-
-    delete[] sequenceBuffer;
+void AtlasManager::addToAtlas(unsigned int brickIndex) {
+    unsigned int atlasCoords = _freeAtlasCoords.back();
+    _freeAtlasCoords.pop_back();
+    int level = _nOtLevels - static_cast<int>(
+        floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1
+    );
+    ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
+    unsigned int atlasData = (level << 28) + atlasCoords;
+    _brickMap.insert(std::pair<unsigned int, unsigned int>(brickIndex, atlasData));
+    _nStreamedBricks++;
 }
 
 void AtlasManager::removeFromAtlas(int brickIndex) {
@@ -196,51 +249,35 @@ void AtlasManager::removeFromAtlas(int brickIndex) {
     _freeAtlasCoords.push_back(atlasCoords);
 }
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
-    int x = linearAtlasCoords % _nBricksPerDim;
-    int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
-    int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
-
-    unsigned int xMin = x*_paddedBrickDim;
-    unsigned int yMin = y*_paddedBrickDim;
-    unsigned int zMin = z*_paddedBrickDim;
-    unsigned int xMax = xMin + _paddedBrickDim;
-    unsigned int yMax = yMin + _paddedBrickDim;
-    unsigned int zMax = zMin + _paddedBrickDim;
-
-    unsigned int from = 0;
-    for (unsigned int zValCoord = zMin; zValCoord<zMax; ++zValCoord) {
-        for (unsigned int yValCoord = yMin; yValCoord<yMax; ++yValCoord) {
-            for (unsigned int xValCoord = xMin; xValCoord<xMax; ++xValCoord) {
-                unsigned int idx =
-                    xValCoord +
-                    yValCoord*_atlasDim +
-                    zValCoord*_atlasDim*_atlasDim;
-
-                out[idx] = in[from];
-                from++;
-            }
-        }
-    }
+void AtlasManager::setMaxFramesBehind(int nFrames) {
+    _maxFramesBehind = nFrames;
 }
 
-void AtlasManager::pboToAtlas(BufferIndex bufferIndex) {
+void AtlasManager::pboToAtlas(BufferIndex bufferIndex,
+                              const std::vector<unsigned int>& bricks)
+{
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glm::size3_t dim = _textureAtlas->dimensions();
     glBindTexture(GL_TEXTURE_3D, *_textureAtlas);
-    glTexSubImage3D(
-        GL_TEXTURE_3D,                // target
-        0,                            // level
-        0,                            // xoffset
-        0,                            // yoffset
-        0,                            // zoffset
-        static_cast<GLsizei>(dim[0]), // width
-        static_cast<GLsizei>(dim[1]), // height
-        static_cast<GLsizei>(dim[2]), // depth
-        GL_RED,                       // format
-        GL_FLOAT,                     // type
-        NULL                          // *pixels
-    );
+    for (size_t i = 0; i < bricks.size(); ++i) {
+        unsigned int atlasCoords = _brickMap[bricks[i]] & 0x0FFFFFFF;
+        int x = atlasCoords % _nBricksPerDim;
+        int y = (atlasCoords / _nBricksPerDim) % _nBricksPerDim;
+        int z = atlasCoords / _nBricksPerDim / _nBricksPerDim;
+
+        glTexSubImage3D(
+            GL_TEXTURE_3D,                           // target
+            0,                                       // level
+            x * _paddedBrickDim,                     // xoffset
+            y * _paddedBrickDim,                     // yoffset
+            z * _paddedBrickDim,                     // zoffset
+            _paddedBrickDim,                         // width
+            _paddedBrickDim,                         // height
+            _paddedBrickDim,                         // depth
+            GL_RED,                                  // format
+            GL_FLOAT,                                // type
+            reinterpret_cast<void*>(i * _brickSize)  // offset into the PBO
+        );
+    }
     glBindTexture(GL_TEXTURE_3D, 0);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
@@ -262,6 +299,10 @@ unsigned int AtlasManager::getNumStreamedBricks() {
     return _nStreamedBricks;
 }
 
+const BrickStreamer::Statistics& AtlasManager::getStreamingStatistics() {
+    return _streamingStatistics;
+}
+
 glm::size3_t AtlasManager::textureSize() {
     return _textureAtlas->dimensions();
 }
@@ -25,9 +25,12 @@
 #ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -45,25 +48,35 @@ public:
     AtlasManager(TSP* tsp);
     ~AtlasManager() = default;
 
+    /**
+     * Requests the bricks in \p brickIndices from the background streamer and uploads
+     * the bricks that have finished loading since the last call. The atlas map only
+     * switches to the new selection once all of its bricks are in the atlas. Until
+     * then, the previous selection is kept for at most #setMaxFramesBehind calls,
+     * after which the call waits for the remaining bricks.
+     */
     void updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices);
-    void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
+    void addToAtlas(unsigned int brickIndex);
     void removeFromAtlas(int brickIndex);
+    void setMaxFramesBehind(int nFrames);
     bool initialize();
     const std::vector<unsigned int>& atlasMap() const;
     unsigned int atlasMapBuffer() const;
 
-    void pboToAtlas(BufferIndex bufferIndex);
+    void pboToAtlas(BufferIndex bufferIndex, const std::vector<unsigned int>& bricks);
     ghoul::opengl::Texture& textureAtlas();
     glm::size3_t textureSize();
 
     unsigned int getNumDiskReads();
     unsigned int getNumUsedBricks();
     unsigned int getNumStreamedBricks();
+    const BrickStreamer::Statistics& getStreamingStatistics();
 
 private:
     const unsigned int NOT_USED = std::numeric_limits<unsigned int>::max();
 
     TSP* _tsp;
+    std::unique_ptr<BrickStreamer> _streamer;
     unsigned int _pboHandle[2];
     unsigned int _atlasMapBuffer;
 
@@ -72,6 +85,8 @@ private:
     std::vector<unsigned int> _freeAtlasCoords;
     std::set<unsigned int> _requiredBricks;
     std::set<unsigned int> _prevRequiredBricks;
+    int _framesBehind = 0;
+    int _maxFramesBehind = 2;
 
     ghoul::opengl::Texture* _textureAtlas;
 
@@ -79,6 +94,7 @@ private:
     unsigned int _nUsedBricks;
     unsigned int _nStreamedBricks;
     unsigned int _nDiskReads;
+    BrickStreamer::Statistics _streamingStatistics;
 
     unsigned int _nBricksPerDim;
     unsigned int _nOtLeaves;
@@ -86,13 +102,10 @@ private:
     unsigned int _nOtLevels;
     unsigned int _brickSize;
     unsigned int _nBrickVals;
-    unsigned int _volumeSize;
     unsigned int _paddedBrickDim;
     unsigned int _nBricksInAtlas;
     unsigned int _nBricksInMap;
     unsigned int _atlasDim;
-
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
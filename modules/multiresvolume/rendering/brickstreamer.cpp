@@ -0,0 +1,194 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "BrickStreamer";
+} // namespace
+
+namespace openspace {
+
+BrickStreamer::BrickStreamer(std::string filename, long long dataPosition,
+                             size_t nBrickValues, unsigned int maxGapBricks,
+                             unsigned int maxBricksPerRead)
+    : _filename(std::move(filename))
+    , _dataPosition(dataPosition)
+    , _nBrickValues(nBrickValues)
+    , _maxGapBricks(maxGapBricks)
+    , _maxBricksPerRead(std::max(maxBricksPerRead, 1u))
+    , _file(_filename, std::ios::in | std::ios::binary)
+{
+    if (!_file.is_open()) {
+        LERROR(fmt::format("Could not open {} for streaming", _filename));
+    }
+    _thread = std::thread([this]() { streamLoop(); });
+}
+
+BrickStreamer::~BrickStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shouldStop = true;
+    }
+    _requestCondition.notify_one();
+    _thread.join();
+}
+
+void BrickStreamer::request(const std::vector<unsigned int>& bricks) {
+    const Clock::time_point now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::map<unsigned int, Clock::time_point> pending;
+        for (unsigned int brick : bricks) {
+            if (_inFlight.count(brick) || _finished.count(brick)) {
+                continue;
+            }
+            // Keep the time of the first request for bricks that are still wanted
+            auto it = _pending.find(brick);
+            pending[brick] = (it != _pending.end()) ? it->second : now;
+        }
+        _pending = std::move(pending);
+    }
+    _requestCondition.notify_one();
+}
+
+void BrickStreamer::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idleCondition.wait(lock, [this]() {
+        return _pending.empty() && _inFlight.empty();
+    });
+}
+
+std::vector<BrickStreamer::Brick> BrickStreamer::takeFinishedBricks() {
+    std::map<unsigned int, std::vector<float>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(finished, _finished);
+    }
+
+    std::vector<Brick> bricks;
+    bricks.reserve(finished.size());
+    for (std::pair<const unsigned int, std::vector<float>>& f : finished) {
+        bricks.push_back({ f.first, std::move(f.second) });
+    }
+    return bricks;
+}
+
+void BrickStreamer::recycle(std::vector<float> buffer) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pool.push_back(std::move(buffer));
+}
+
+BrickStreamer::Statistics BrickStreamer::takeStatistics() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Statistics statistics = _statistics;
+    _statistics = Statistics();
+    return statistics;
+}
+
+void BrickStreamer::streamLoop() {
+    while (true) {
+        std::map<unsigned int, Clock::time_point> run;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _requestCondition.wait(lock, [this]() {
+                return _shouldStop || !_pending.empty();
+            });
+            if (_shouldStop) {
+                return;
+            }
+
+            // Take the bricks that can be read with a single call, starting with the
+            // brick that comes first in the file. The remaining bricks stay pending so
+            // that they can still be replaced by newer requests
+            const unsigned int first = _pending.begin()->first;
+            unsigned int last = first;
+            auto it = _pending.begin();
+            while (it != _pending.end() &&
+                   it->first - last <= _maxGapBricks + 1 &&
+                   it->first - first < _maxBricksPerRead)
+            {
+                last = it->first;
+                _inFlight.insert(it->first);
+                run.insert(*it);
+                it = _pending.erase(it);
+            }
+        }
+
+        readBricks(run);
+        _idleCondition.notify_all();
+    }
+}
+
+void BrickStreamer::readBricks(const std::map<unsigned int, Clock::time_point>& bricks)
+{
+    const unsigned int first = bricks.begin()->first;
+    const unsigned int last = bricks.rbegin()->first;
+    const size_t nValues = (last - first + 1) * _nBrickValues;
+    const size_t nBytes = nValues * sizeof(float);
+    _readBuffer.resize(nValues);
+
+    const Clock::time_point readStart = Clock::now();
+    _file.clear();
+    _file.seekg(_dataPosition + static_cast<long long>(first * _nBrickValues *
+                                                       sizeof(float)));
+    _file.read(reinterpret_cast<char*>(_readBuffer.data()), nBytes);
+    if (!_file) {
+        LERROR(fmt::format(
+            "Could not read bricks {} to {} from {}", first, last, _filename
+        ));
+        std::fill(_readBuffer.begin(), _readBuffer.end(), 0.f);
+    }
+    const Clock::time_point readEnd = Clock::now();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statistics.nDiskReads++;
+    _statistics.nBytesRead += nBytes;
+    _statistics.readTime += std::chrono::duration<double>(readEnd - readStart).count();
+
+    for (const std::pair<const unsigned int, Clock::time_point>& brick : bricks) {
+        std::vector<float> buffer;
+        if (!_pool.empty()) {
+            buffer = std::move(_pool.back());
+            _pool.pop_back();
+        }
+        const auto begin = _readBuffer.begin() + (brick.first - first) * _nBrickValues;
+        buffer.assign(begin, begin + _nBrickValues);
+        _finished[brick.first] = std::move(buffer);
+        _inFlight.erase(brick.first);
+
+        const double latency = std::chrono::duration<double>(
+            readEnd - brick.second
+        ).count();
+        _statistics.nBricksLoaded++;
+        _statistics.totalLatency += latency;
+        _statistics.maxLatency = std::max(_statistics.maxLatency, latency);
+    }
+}
+
+} // namespace openspace
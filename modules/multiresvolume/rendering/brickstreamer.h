@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Reads bricks from a TSP file on a background thread. The bricks that are requested
+ * are sorted by their position in the file, and nearby bricks are merged into a single
+ * large read, also reading the bricks in between if they are at most #maxGapBricks
+ * bricks apart. The finished bricks are copied into buffers from a staging pool and
+ * collected by the rendering thread with #takeFinishedBricks. The buffers should be
+ * returned with #recycle once their content has been uploaded.
+ */
+class BrickStreamer {
+public:
+    struct Brick {
+        unsigned int index;
+        std::vector<float> data;
+    };
+
+    /// Counters that are accumulated since the last call to #takeStatistics
+    struct Statistics {
+        /// The number of read calls that were made to the file
+        unsigned int nDiskReads = 0;
+        /// The number of bricks that were read, not counting bricks that were only
+        /// read because they were in a gap between two requested bricks
+        unsigned int nBricksLoaded = 0;
+        /// The number of bytes that were read, including the gaps
+        size_t nBytesRead = 0;
+        /// The time spent in read calls, in seconds
+        double readTime = 0.0;
+        /// The summed and maximum time between a brick being requested and it being
+        /// ready to be taken, in seconds
+        double totalLatency = 0.0;
+        double maxLatency = 0.0;
+    };
+
+    /**
+     * Creates a streamer for the bricks in \p filename, whose voxel data start at
+     * \p dataPosition, each brick being \p nBrickValues floats. Bricks that are at most
+     * \p maxGapBricks apart are read with a single call, but a single read never covers
+     * more than \p maxBricksPerRead bricks.
+     */
+    BrickStreamer(std::string filename, long long dataPosition, size_t nBrickValues,
+        unsigned int maxGapBricks = 4, unsigned int maxBricksPerRead = 256);
+    ~BrickStreamer();
+
+    /**
+     * Replaces the bricks that are waiting to be read by \p bricks. Bricks that are
+     * currently being read or that are finished but not yet taken are not read again.
+     */
+    void request(const std::vector<unsigned int>& bricks);
+
+    /// Blocks until all requested bricks have been read
+    void waitUntilIdle();
+
+    /// Returns all bricks that have been read since the last call, in index order
+    std::vector<Brick> takeFinishedBricks();
+
+    /// Returns the buffer of a taken brick to the staging pool
+    void recycle(std::vector<float> buffer);
+
+    /// Returns the statistics since the last call and resets them
+    Statistics takeStatistics();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void streamLoop();
+    void readBricks(const std::map<unsigned int, Clock::time_point>& bricks);
+
+    const std::string _filename;
+    const long long _dataPosition;
+    const size_t _nBrickValues;
+    const unsigned int _maxGapBricks;
+    const unsigned int _maxBricksPerRead;
+
+    std::ifstream _file;
+    std::vector<float> _readBuffer;
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _requestCondition;
+    std::condition_variable _idleCondition;
+    bool _shouldStop = false;
+
+    // Bricks that wait to be read and when they were first requested
+    std::map<unsigned int, Clock::time_point> _pending;
+    std::set<unsigned int> _inFlight;
+    std::map<unsigned int, std::vector<float>> _finished;
+    std::vector<std::vector<float>> _pool;
+    Statistics _statistics;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
@@ -29,7 +29,8 @@
 
 #include <modules/multiresvolume/rendering/errorhistogrammanager.h>
 #include <openspace/util/histogram.h>
-
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/parallelfor.h>
 #include <openspace/util/progressbar.h>
 
 #include <ghoul/logging/logmanager.h>
@@ -37,6 +38,38 @@
 
 namespace {
     constexpr const char* _loggerCat = "ErrorHistogramManager";
+
+    struct LeafRange {
+        unsigned int first;
+        unsigned int count;
+        unsigned int levelsAbove;
+    };
+
+    // Returns the leaves that are covered by the node at offset in a complete tree
+    // with base children per node and leafLevel + 1 levels, stored in level order
+    LeafRange coveredLeaves(unsigned int offset, unsigned int base,
+                            unsigned int leafLevel)
+    {
+        unsigned int level = 0;
+        unsigned int firstInLevel = 0;
+        unsigned int nodesInLevel = 1;
+        while (offset >= firstInLevel + nodesInLevel) {
+            firstInLevel += nodesInLevel;
+            nodesInLevel *= base;
+            ++level;
+        }
+        const unsigned int inLevelOffset = offset - firstInLevel;
+
+        LeafRange range = { 0, 1, leafLevel - level };
+        while (level < leafLevel) {
+            firstInLevel += nodesInLevel;
+            nodesInLevel *= base;
+            range.count *= base;
+            ++level;
+        }
+        range.first = firstInLevel + inLevelOffset * range.count;
+        return range;
+    }
 } // namespace
 
 namespace openspace {
@@ -48,8 +81,9 @@ ErrorHistogramManager::~ErrorHistogramManager() {}
 bool ErrorHistogramManager::buildHistograms(int numBins) {
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
+    const MemoryMappedFile file(_tsp->filename());
+    const float* voxels = _tsp->mappedVoxels(file);
+    if (!voxels) {
         return false;
     }
     _minBin = 0.0; // Should be calculated from tsp file
@@ -65,112 +99,101 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
     _histograms = std::vector<Histogram>(_numInnerNodes);
     LINFO(fmt::format("Build {} histograms with {} bins each", _numInnerNodes, numBins));
 
-    // All TSP Leaves
-    int numOtNodes = _tsp->numOTNodes();
-    int otOffset = (pow(8, numOtLevels - 1) - 1) / 7;
-
-    int numBstNodes = _tsp->numBSTNodes();
-    int bstOffset = numBstNodes / 2;
-
-    int numberOfLeaves = (numBstNodes - bstOffset) * (numOtNodes - otOffset);
-    ProgressBar pb(numberOfLeaves);
-    int processedLeaves = 0;
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromLeaf(bst, ot);
-            if (!success) return false;
-            pb.print(++processedLeaves);
+    // Every histogram is built on its own from the leaves it covers, so no two threads
+    // write to the same histogram. The inner nodes closest to the root cover the most
+    // leaves and come first, which keeps the threads busy until the end
+    ProgressBar pb(_numInnerNodes);
+    std::vector<char> threadStates(_tsp->numThreads());
+    parallelForEach(
+        _numInnerNodes,
+        threadStates,
+        [this, voxels](char&, size_t innerNodeIndex) {
+            buildFromInnerNode(static_cast<unsigned int>(innerNodeIndex), voxels);
+        },
+        [this, &pb](float progress) {
+            pb.print(static_cast<int>(progress * _numInnerNodes));
         }
-    }
+    );
 
-    return success;
+    return true;
 }
 
-bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset) {
-    // Traverse all ancestors of leaf and add errors to their histograms
+void ErrorHistogramManager::buildFromInnerNode(unsigned int innerNodeIndex,
+                                               const float* voxels)
+{
+    // Add the errors of all leaves that the inner node covers to its histogram. The
+    // leaves are visited in the same order as a loop over all BST leaves and octree
+    // leaves would, so the bins are always summed up in the same order
 
     unsigned int brickDim = _tsp->brickDim();
     unsigned int paddedBrickDim = _tsp->paddedBrickDim();
     unsigned int padding = (paddedBrickDim - brickDim) / 2;
 
     int numOtNodes = _tsp->numOTNodes();
-    unsigned int leafIndex = bstOffset * numOtNodes + octreeOffset;
-    std::vector<float> leafValues = readValues(leafIndex);
-//    int numVoxels = leafValues.size();
-
-    int bstNode = bstOffset;
-    bool bstRightOnly = true;
-    unsigned int bstLevel = 0;
-
-    do {
-
-        glm::vec3 leafOffset(0.0); // Leaf offset in leaf sized voxels
-        unsigned int octreeLevel = 0;
-        unsigned int octreeNode = octreeOffset;
-        bool octreeLastOnly = true;
-        do {
-            // Visit ancestor
-            if (bstNode != bstOffset || octreeNode != octreeOffset) {
-                // Is actually an ancestor
-
-                std::vector<float> ancestorVoxels;
-                unsigned int ancestorBrickIndex = bstNode * numOtNodes + octreeNode;
-                unsigned int innerNodeIndex = brickToInnerNodeIndex(ancestorBrickIndex);
-                auto it = _voxelCache.find(innerNodeIndex);
-                if (it == _voxelCache.end()) {
-                    // First visit
-                    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
-                    ancestorVoxels = readValues(ancestorBrickIndex);
-                    _voxelCache[innerNodeIndex] = ancestorVoxels;
-                } else {
-                    ancestorVoxels = it->second;
-                }
-
-                float voxelScale = pow(2, octreeLevel);
-                float invVoxelScale = 1.0 / voxelScale;
+    unsigned int ancestorBrickIndex = innerNodeToBrickIndex(innerNodeIndex);
+    const float* ancestorVoxels = brickValues(voxels, ancestorBrickIndex);
 
-                // Calculate leaf offset in ancestor sized voxels
-                glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) + glm::vec3(padding - 0.5);
+    const LeafRange bstLeaves = coveredLeaves(
+        ancestorBrickIndex / numOtNodes,
+        2,
+        _tsp->numBSTLevels() - 1
+    );
+    const LeafRange octreeLeaves = coveredLeaves(
+        ancestorBrickIndex % numOtNodes,
+        8,
+        _tsp->numOTLevels() - 1
+    );
 
-                for (int z = 0; z < brickDim; z++) {
-                    for (int y = 0; y < brickDim; y++) {
-                        for (int x = 0; x < brickDim; x++) {
-                            glm::vec3 leafSamplePoint = glm::vec3(x, y, z) + glm::vec3(padding);
-                            glm::vec3 ancestorSamplePoint = ancestorOffset + (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
-                            float leafValue = leafValues[linearCoords(leafSamplePoint)];
-                            float ancestorValue = interpolate(ancestorSamplePoint, ancestorVoxels);
+    unsigned int octreeLevel = octreeLeaves.levelsAbove;
+    float voxelScale = pow(2, octreeLevel);
+    float invVoxelScale = 1.0 / voxelScale;
+
+    Histogram histogram(_minBin, _maxBin, _numBins);
+    for (unsigned int b = 0; b < bstLeaves.count; ++b) {
+        for (unsigned int o = 0; o < octreeLeaves.count; ++o) {
+            unsigned int octreeOffset = octreeLeaves.first + o;
+            unsigned int leafIndex = (bstLeaves.first + b) * numOtNodes + octreeOffset;
+            const float* leafValues = brickValues(voxels, leafIndex);
+
+            // Leaf offset in leaf sized voxels
+            glm::vec3 leafOffset(0.0);
+            unsigned int octreeNode = octreeOffset;
+            for (unsigned int level = 0; level < octreeLevel; ++level) {
+                int octreeChild = (octreeNode - 1) % 8;
+                octreeNode = parentOffset(octreeNode, 8);
+
+                int childSize = pow(2, level) * brickDim;
+                leafOffset.x += (octreeChild % 2) * childSize;
+                leafOffset.y += ((octreeChild / 2) % 2) * childSize;
+                leafOffset.z += (octreeChild / 4) * childSize;
+            }
 
-                            _histograms[innerNodeIndex].addRectangle(leafValue, ancestorValue, std::abs(leafValue - ancestorValue));
-                        }
+            // Calculate leaf offset in ancestor sized voxels
+            glm::vec3 ancestorOffset =
+                (leafOffset * invVoxelScale) + glm::vec3(padding - 0.5);
+
+            for (int z = 0; z < brickDim; z++) {
+                for (int y = 0; y < brickDim; y++) {
+                    for (int x = 0; x < brickDim; x++) {
+                        glm::vec3 leafSamplePoint =
+                            glm::vec3(x, y, z) + glm::vec3(padding);
+                        glm::vec3 ancestorSamplePoint = ancestorOffset +
+                            (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
+                        float leafValue = leafValues[linearCoords(leafSamplePoint)];
+                        float ancestorValue =
+                            interpolate(ancestorSamplePoint, ancestorVoxels);
+
+                        histogram.addRectangle(
+                            leafValue,
+                            ancestorValue,
+                            std::abs(leafValue - ancestorValue)
+                        );
                     }
                 }
-
-                if (bstRightOnly && octreeLastOnly) {
-                    _voxelCache.erase(innerNodeIndex);
-                }
             }
-
-            // Traverse to next octree ancestor
-            int octreeChild = (octreeNode - 1) % 8;
-            octreeLastOnly &= octreeChild == 7;
-            octreeNode = parentOffset(octreeNode, 8);
-
-            int childSize = pow(2, octreeLevel) * brickDim;
-            leafOffset.x += (octreeChild % 2) * childSize;
-            leafOffset.y += ((octreeChild / 2) % 2) * childSize;
-            leafOffset.z += (octreeChild / 4) * childSize;
-
-            octreeLevel++;
-        } while (octreeNode != -1);
-
-        bstRightOnly &= (bstNode % 2 == 0);
-        bstNode = parentOffset(bstNode, 2);
-
-        bstLevel++;
-    } while (bstNode != -1);
-
-    return true;
+        }
+    }
+    _histograms[innerNodeIndex] = std::move(histogram);
 }
 
 bool ErrorHistogramManager::loadFromFile(const std::string& filename) {
@@ -243,7 +266,9 @@ unsigned int ErrorHistogramManager::linearCoords(glm::ivec3 coords) const {
     return coords.z * paddedBrickDim * paddedBrickDim + coords.y * paddedBrickDim + coords.x;
 }
 
-float ErrorHistogramManager::interpolate(glm::vec3 samplePoint, const std::vector<float>& voxels) const {
+float ErrorHistogramManager::interpolate(glm::vec3 samplePoint,
+                                         const float* voxels) const
+{
     int lowX = samplePoint.x;
     int lowY = samplePoint.y;
     int lowZ = samplePoint.z;
@@ -302,18 +327,12 @@ int ErrorHistogramManager::parentOffset(int offset, int base) const {
     return parentOffset;
 }
 
-std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) const {
+const float* ErrorHistogramManager::brickValues(const float* voxels,
+                                                unsigned int brickIndex) const
+{
     unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-    unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
-    std::vector<float> voxelValues(numBrickVals);
-
-    std::streampos offset = _tsp->dataPosition() + static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(reinterpret_cast<char*>(&voxelValues[0]),
-        static_cast<size_t>(numBrickVals)*sizeof(float));
-
-    return voxelValues;
+    size_t numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
+    return voxels + brickIndex * numBrickVals;
 }
 
 unsigned int ErrorHistogramManager::brickToInnerNodeIndex(unsigned int brickIndex) const {
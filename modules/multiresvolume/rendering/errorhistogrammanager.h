@@ -28,7 +28,6 @@
 #include <fstream>
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <openspace/util/histogram.h>
-#include <map>
 
 #include <ghoul/glm.h>
 
@@ -47,7 +46,6 @@ public:
 
 private:
     TSP* _tsp;
-    std::ifstream* _file;
 
     std::vector<Histogram> _histograms;
     unsigned int _numInnerNodes;
@@ -55,10 +53,8 @@ private:
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
-
-    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset);
-    std::vector<float> readValues(unsigned int brickIndex) const;
+    void buildFromInnerNode(unsigned int innerNodeIndex, const float* voxels);
+    const float* brickValues(const float* voxels, unsigned int brickIndex) const;
 
     int parentOffset(int offset, int base) const;
 
@@ -68,7 +64,7 @@ private:
     unsigned int linearCoords(int x, int y, int z) const;
     unsigned int linearCoords(glm::ivec3 coords) const;
 
-    float interpolate(glm::vec3 samplePoint, const std::vector<float>& voxels) const;
+    float interpolate(glm::vec3 samplePoint, const float* voxels) const;
 };
 
 } // namespace openspace
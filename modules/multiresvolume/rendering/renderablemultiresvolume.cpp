@@ -134,6 +134,15 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    const openspace::properties::Property::PropertyInfo MaxFramesBehindInfo = {
+        "MaxFramesBehind",
+        "Max Frames Behind",
+        "The number of frames for which the previous selection of bricks is rendered "
+        "while the bricks of a new selection are streamed from disk. If the new bricks "
+        "are not loaded by then, the frame waits for them. A value of 0 loads all "
+        "bricks before the frame is rendered."
+    };
+
     const openspace::properties::Property::PropertyInfo ScalingExponentInfo = {
         "ScalingExponent",
         "Scaling Exponent",
@@ -182,6 +191,7 @@ RenderableMultiresVolume::RenderableMultiresVolume (const ghoul::Dictionary& dic
     , _gatheringStats(false)
     , _statsToFile(StatsToFileInfo, false)
     , _statsToFileName(StatsToFileNameInfo)
+    , _maxFramesBehind(MaxFramesBehindInfo, 2, 0, 60)
     , _scalingExponent(ScalingExponentInfo, 1, -10, 20)
     , _scaling(ScalingInfo, glm::vec3(1.f), glm::vec3(0.f), glm::vec3(10.f))
     , _translation(TranslationInfo, glm::vec3(0.f), glm::vec3(0.f), glm::vec3(10.f))
@@ -211,7 +221,7 @@ RenderableMultiresVolume::RenderableMultiresVolume (const ghoul::Dictionary& dic
 
 
 
-    float scalingExponent, stepSizeCoefficient;
+    float scalingExponent, stepSizeCoefficient, maxFramesBehind;
     glm::vec3 scaling, translation, rotation;
 
     if (dictionary.getValue("ScalingExponent", scalingExponent)) {
@@ -226,6 +236,9 @@ RenderableMultiresVolume::RenderableMultiresVolume (const ghoul::Dictionary& dic
     if (dictionary.getValue("Rotation", rotation)) {
         _rotation = rotation;
     }
+    if (dictionary.getValue(MaxFramesBehindInfo.identifier, maxFramesBehind)) {
+        _maxFramesBehind = static_cast<int>(maxFramesBehind);
+    }
     if (dictionary.getValue("StepSizeCoefficient", stepSizeCoefficient)) {
         _stepSizeCoefficient = stepSizeCoefficient;
     }
@@ -330,6 +343,7 @@ RenderableMultiresVolume::RenderableMultiresVolume (const ghoul::Dictionary& dic
     addProperty(_loop);
     addProperty(_statsToFile);
     addProperty(_statsToFileName);
+    addProperty(_maxFramesBehind);
     addProperty(_scaling);
     addProperty(_scalingExponent);
     addProperty(_translation);
@@ -671,12 +685,23 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
 
         std::ofstream ofs(_statsFileName, std::ofstream::out);
 
+        // The streaming latency is the time in seconds between a brick being
+        // requested and it being read, and the throughput is in bytes per second
+        const BrickStreamer::Statistics& s = _atlasManager->getStreamingStatistics();
+        const double averageLatency = s.nBricksLoaded > 0 ?
+            s.totalLatency / s.nBricksLoaded :
+            0.0;
+        const double throughput = s.readTime > 0.0 ? s.nBytesRead / s.readTime : 0.0;
+
         ofs << frameDuration.count() << " "
             << _selectionDuration.count() << " "
             << _uploadDuration.count() << " "
             << _nUsedBricks << " "
             << _nStreamedBricks << " "
-            << _nDiskReads;
+            << _nDiskReads << " "
+            << averageLatency << " "
+            << s.maxLatency << " "
+            << throughput;
 
         ofs.close();
 
@@ -745,6 +770,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             uploadStart = selectionEnd;
         }
 
+        _atlasManager->setMaxFramesBehind(_maxFramesBehind);
         _atlasManager->updateAtlas(AtlasManager::EVEN, _brickIndices);
 
         if (_gatheringStats) {
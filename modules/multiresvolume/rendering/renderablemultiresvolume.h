@@ -99,6 +99,7 @@ private:
     properties::StringProperty _selectorName;
     properties::BoolProperty _statsToFile;
     properties::StringProperty _statsToFileName;
+    properties::IntProperty _maxFramesBehind;
 
     // Stats timers
     std::string _statsFileName;
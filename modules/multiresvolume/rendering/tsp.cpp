@@ -24,6 +24,10 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/parallelfor.h>
+#include <openspace/util/progressbar.h>
+
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
@@ -50,6 +54,7 @@ TSP::TSP(const std::string& filename)
     , numBSTNodes_(0)
     , numOTLevels_(0)
     , numOTNodes_(0)
+    , numThreads_(defaultParallelThreadCount())
     , minSpatialError_(0.0f)
     , maxSpatialError_(0.0f)
     , medianSpatialError_(0.0f)
@@ -159,8 +164,10 @@ bool TSP::readHeader() {
 bool TSP::construct() {
     LDEBUG("Constructing TSP tree");
 
-    // Loop over the OTs (one per BST node)
-    for (unsigned int OT = 0; OT<numBSTNodes_; ++OT) {
+    // Loop over the OTs (one per BST node). Every OT writes to its own range of nodes
+    std::vector<char> threadStates(numThreads_);
+    parallelForEach(numBSTNodes_, threadStates, [this](char&, size_t index) {
+        const unsigned int OT = static_cast<unsigned int>(index);
 
         // Start at the root of each OT
         unsigned int OTNode = OT*numOTNodes_;
@@ -219,7 +226,7 @@ bool TSP::construct() {
 
             OTLevel++;
         }
-    }
+    });
     return true;
 }
 
@@ -249,6 +256,29 @@ std::ifstream& TSP::file() {
     return _file;
 }
 
+const std::string& TSP::filename() const {
+    return _filename;
+}
+
+void TSP::setNumThreads(unsigned int nThreads) {
+    numThreads_ = std::max(nThreads, 1u);
+}
+
+unsigned int TSP::numThreads() const {
+    return numThreads_;
+}
+
+const float* TSP::mappedVoxels(const MemoryMappedFile& file) const {
+    const size_t numBrickVals = static_cast<size_t>(paddedBrickDim_) *
+                                paddedBrickDim_ * paddedBrickDim_;
+    const size_t dataEnd = static_cast<size_t>(dataPosition()) +
+                           numTotalNodes_ * numBrickVals * sizeof(float);
+    if (!file.isValid() || file.size() < dataEnd) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float*>(file.data() + dataPosition());
+}
+
 unsigned int TSP::numTotalNodes() const { 
     return numTotalNodes_; 
 }
@@ -290,45 +320,47 @@ GLuint TSP::ssbo() const {
 }
 
 bool TSP::calculateSpatialError() {
+    static_assert(
+        sizeof(float) == sizeof(int),
+        "Float and int sizes don't match, can't reintepret"
+    );
+
     unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
 
-    if (!_file.is_open())
+    const MemoryMappedFile file(_filename);
+    const float* voxels = mappedVoxels(file);
+    if (!voxels) {
+        LERROR(fmt::format("Could not map the bricks in {}", _filename));
         return false;
+    }
 
-    std::vector<float> buffer(numBrickVals);
     std::vector<float> averages(numTotalNodes_);
     std::vector<float> stdDevs(numTotalNodes_);
 
+    // Both passes compute the value of each brick on its own, in the same order as a
+    // serial loop would, so the result does not depend on the number of threads
+    std::vector<char> threadStates(numThreads_);
+    ProgressBar pb(100);
+    auto progress = [&pb](float p) { pb.print(static_cast<int>(p * 100)); };
+
     // First pass: Calculate average color for each brick
     LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        // Offset in file
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
+    parallelForEach(numTotalNodes_, threadStates, [&](char&, size_t brick) {
+        const float* brickVoxels = voxels + brick * numBrickVals;
 
         double average = 0.0;
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
-            average += *it;
+        for (unsigned int v = 0; v < numBrickVals; ++v) {
+            average += brickVoxels[v];
         }
 
         averages[brick] = static_cast<float>(average / static_cast<double>(numBrickVals));
-    }
-
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(numTotalNodes_);
+    });
 
     // Second pass: For each brick, compare the covered leaf voxels with
     // the brick average
     LDEBUG("Calculating spatial error, second pass");
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        // Fetch mean intensity 
+    parallelForEach(numTotalNodes_, threadStates, [&](char&, size_t brick) {
+        // Fetch mean intensity
         float brickAvg = averages[brick];
 
         // Sum  for std dev computation
@@ -336,7 +368,7 @@ bool TSP::calculateSpatialError() {
 
         // Get a list of leaf bricks that the current brick covers
         std::list<unsigned int> coveredLeafBricks =
-            CoveredLeafBricks(brick);
+            CoveredLeafBricks(static_cast<unsigned int>(brick));
 
         // If the brick is already a leaf, assign a negative error.
         // Ad hoc "hack" to distinguish leafs from other nodes that happens
@@ -345,58 +377,24 @@ bool TSP::calculateSpatialError() {
             stdDev = -0.1f;
         }
         else {
-
             // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = coveredLeafBricks.begin();
-                lb != coveredLeafBricks.end(); ++lb) {
-
-                // Read brick
-                std::streampos offset = dataPosition() + static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
-
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
+            for (unsigned int leaf : coveredLeafBricks) {
+                const float* leafVoxels =
+                    voxels + static_cast<size_t>(leaf) * numBrickVals;
 
                 // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
+                for (unsigned int v = 0; v < numBrickVals; ++v) {
+                    stdDev += pow(leafVoxels[v] - brickAvg, 2.f);
                 }
-
-
             }
 
             // Finish calculation
-            if (sizeof(float) != sizeof(int)) {
-                LERROR("Float and int sizes don't match, can't reintepret");
-                return false;
-            }
-
             stdDev /= static_cast<float>(coveredLeafBricks.size()*numBrickVals);
             stdDev = sqrt(stdDev);
-
         } // if not leaf
 
-        if (stdDev < minError) {
-            minError = stdDev;
-        }
-        else if (stdDev > maxError) {
-            maxError = stdDev;
-        }
-
         stdDevs[brick] = stdDev;
-        medianArray[brick] = stdDev;
-
-    }
-
-    std::sort(medianArray.begin(), medianArray.end());
-    //float medError = medianArray[medianArray.size()/2];
-
-    /*
-    LDEBUG("\nMin spatial std dev: " << minError);
-    LDEBUG("Max spatial std dev: " << maxError);
-    LDEBUG("Median spatial std dev: " << medError);
-    LDEBUG("");
-    */
+    }, progress);
 
     // "Normalize" errors
     float minNorm = 1e20f;
@@ -431,68 +429,64 @@ bool TSP::calculateSpatialError() {
 }
 
 bool TSP::calculateTemporalError() {
+    unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
 
-    if (!_file.is_open())
+    const MemoryMappedFile file(_filename);
+    const float* voxels = mappedVoxels(file);
+    if (!voxels) {
+        LERROR(fmt::format("Could not map the bricks in {}", _filename));
         return false;
+    }
 
     LDEBUG("Calculating temporal error");
 
-    // Statistics
-    //float minErr = 1e20f;
-    //float maxErr = 0.f;
-    std::vector<float> meanArray(numTotalNodes_);
-
     // Save errors
     std::vector<float> errors(numTotalNodes_);
 
-    // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        unsigned int numBrickVals =
-            paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
-
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(reinterpret_cast<char*>(&voxelAverages[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
-
-        // Build a list of the BST leaf bricks (within the same octree level) that
-        // this brick covers
-        std::list<unsigned int> coveredBricks = CoveredBSTLeafBricks(brick);
-
-        // If the brick is at the lowest BST level, automatically set the error 
-        // to -0.1 (enables using -1 as a marker for "no error accepted");
-        // Somewhat ad hoc to get around the fact that the error could be
-        // 0.0 higher up in the tree
-        if (coveredBricks.size() == 1) {
-            errors[brick] = -0.1f;
-        } else {
-            // Calculate standard deviation per voxel, average over brick
-            float avgStdDev = 0.f;
-            for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
-
-                float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf) {
-
-                    // Sample the leaves at the corresponding voxel position
-
-                    std::streampos offset = dataPosition() + static_cast<long long>((*leaf*numBrickVals + voxel)*sizeof(float));
-                    _file.seekg(offset);
+    // Each thread keeps the sums of squared differences for every voxel of the brick
+    // it is currently working on
+    std::vector<std::vector<float>> threadStates(numThreads_);
+    ProgressBar pb(100);
+    auto progress = [&pb](float p) { pb.print(static_cast<int>(p * 100)); };
 
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
+    // Calculate temporal error for one brick at a time
+    parallelForEach(numTotalNodes_, threadStates,
+        [&](std::vector<float>& sums, size_t brick) {
+            // Save the individual voxel's average over timesteps. Because the
+            // BSTs are built by averaging leaf nodes, we only need to sample
+            // the brick at the correct coordinate.
+            const float* voxelAverages = voxels + brick * numBrickVals;
+
+            // Build a list of the BST leaf bricks (within the same octree level) that
+            // this brick covers
+            std::list<unsigned int> coveredBricks =
+                CoveredBSTLeafBricks(static_cast<unsigned int>(brick));
+
+            // If the brick is at the lowest BST level, automatically set the error
+            // to -0.1 (enables using -1 as a marker for "no error accepted");
+            // Somewhat ad hoc to get around the fact that the error could be
+            // 0.0 higher up in the tree
+            if (coveredBricks.size() == 1) {
+                errors[brick] = -0.1f;
+                return;
+            }
 
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+            // Sample the leaves at the corresponding voxel positions. The leaves are
+            // read one whole brick at a time, but each voxel still adds up the leaves
+            // in the order of the list
+            sums.assign(numBrickVals, 0.f);
+            for (unsigned int leaf : coveredBricks) {
+                const float* leafVoxels =
+                    voxels + static_cast<size_t>(leaf) * numBrickVals;
+                for (unsigned int voxel = 0; voxel < numBrickVals; ++voxel) {
+                    sums[voxel] += pow(leafVoxels[voxel] - voxelAverages[voxel], 2.f);
                 }
+            }
+
+            // Calculate standard deviation per voxel, average over brick
+            float avgStdDev = 0.f;
+            for (unsigned int voxel = 0; voxel < numBrickVals; ++voxel) {
+                float stdDev = sums[voxel];
                 stdDev /= static_cast<float>(coveredBricks.size());
                 stdDev = sqrt(stdDev);
 
@@ -500,29 +494,10 @@ bool TSP::calculateTemporalError() {
             } // for voxel
 
             avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
             errors[brick] = avgStdDev;
-
-        }
-
-        /*
-        if (avgStdDev < minErr) {
-        minErr = avgStdDev;
-        } else if (avgStdDev > maxErr) {
-        maxErr = avgStdDev;
-        }
-        */
-
-    } // for all bricks
-
-    std::sort(meanArray.begin(), meanArray.end());
-    //float medErr = meanArray[meanArray.size()/2];
-
-    /*
-    LDEBUG("\nMin temporal error: " << minErr);
-    LDEBUG("Max temporal error: " << maxErr);
-    LDEBUG("Median temporal error: " << medErr);
-    */
+        },
+        progress
+    );
 
     // Adjust errors using user-provided exponents
     float minNorm = 1e20f;
@@ -34,6 +34,9 @@
 #include <ghoul/opengl/ghoul_gl.h>
 
 namespace openspace {
+
+class MemoryMappedFile;
+
 class TSP {
 public:
     struct Header {
@@ -72,6 +75,12 @@ public:
     const Header& header() const;
     static long long dataPosition();
     std::ifstream& file();
+    const std::string& filename() const;
+
+    // Returns the voxels of all bricks in the memory mapped data file, or nullptr if
+    // the file is not mapped or is too small to contain all the bricks
+    const float* mappedVoxels(const MemoryMappedFile& file) const;
+
     unsigned int numTotalNodes() const;
     unsigned int numValuesPerNode() const;
     unsigned int numBSTNodes() const;
@@ -83,6 +92,12 @@ public:
     unsigned int numBricksPerAxis() const;
     GLuint ssbo() const;
 
+    // The number of threads that construct, calculateSpatialError,
+    // calculateTemporalError and the ErrorHistogramManager use. The results do not
+    // depend on it
+    void setNumThreads(unsigned int nThreads);
+    unsigned int numThreads() const;
+
     bool calculateSpatialError();
     bool calculateTemporalError();
 
@@ -130,6 +145,8 @@ private:
 
     const unsigned int paddingWidth_ = 1;
 
+    unsigned int numThreads_;
+
     // Error stats
     float minSpatialError_;
     float maxSpatialError_;
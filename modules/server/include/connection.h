@@ -27,9 +27,12 @@
 
 #include <ghoul/misc/templatefactory.h>
 #include <ext/json/json.hpp>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace ghoul::io { class Socket; }
 
@@ -39,14 +42,33 @@ using TopicId = size_t;
 
 class Topic;
 
+/**
+ * A Connection represents one client of the ServerModule. All outgoing messages are
+ * collected during a frame and are handed to a separate sending thread as one batch in
+ * #preSync, which serializes them and writes them to the socket. This keeps both the
+ * serialization and the potentially blocking socket writes off the render thread.
+ */
 class Connection {
 public:
     Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address);
+    ~Connection();
 
     void handleMessage(const std::string& message);
-    void sendMessage(const std::string& message);
     void handleJson(const nlohmann::json& json);
-    void sendJson(const nlohmann::json& json);
+
+    /**
+     * Queues the \p json to be sent to the client. The message is sent together with
+     * all other messages of this frame the next time #preSync is called
+     */
+    void sendJson(nlohmann::json json);
+
+    /**
+     * Gives all topics the chance to queue their coalesced updates for this frame and
+     * then hands all queued messages to the sending thread as one batch. This method
+     * has to be called once per frame from the main thread
+     */
+    void preSync();
+
     void setAuthorized(bool status);
 
     bool isAuthorized() const;
@@ -68,6 +90,19 @@ private:
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
 
     bool isWhitelisted() const;
+
+    /// The loop of the sending thread that writes the batches to the socket
+    void sendMessages();
+
+    /// Messages that have been queued during the current frame
+    std::vector<nlohmann::json> _pendingMessages;
+
+    /// Messages that have been handed to the sending thread
+    std::vector<nlohmann::json> _outgoingMessages;
+    std::mutex _outgoingMutex;
+    std::condition_variable _outgoingCondition;
+    bool _isStopping = false;
+    std::thread _sendThread;
 };
 
 } // namespace openspace
@@ -27,10 +27,21 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
 
+/**
+ * A subscription to the value of a property. Changes to the property only mark the
+ * subscription as dirty; the new value is sent at most once per frame from #preSync.
+ * A client can further limit the update frequency by providing either a
+ * <code>maxRate</code> in updates per second or a <code>minInterval</code> in
+ * milliseconds when starting the subscription. The last change is always sent
+ * eventually, even if it happened while the subscription was rate limited.
+ */
 class SubscriptionTopic : public Topic {
 public:
     SubscriptionTopic() = default;
@@ -38,15 +49,28 @@ public:
 
     void handleJson(const nlohmann::json& json) override;
     bool isDone() const override;
+    void preSync() override;
 
 private:
     const int UnsetCallbackHandle = -1;
 
+    /// Sends the current value of the property to the client
+    void sendValue();
+
     bool _requestedResourceIsSubscribable = false;
     bool _isSubscribedTo = false;
     int _onChangeHandle = UnsetCallbackHandle;
     int _onDeleteHandle = UnsetCallbackHandle;
     properties::Property* _prop = nullptr;
+
+    /// The description of the property only needs to be generated once
+    nlohmann::json _description;
+
+    /// Set whenever the property changes and cleared when the value has been sent
+    std::atomic_bool _isDirty = false;
+    std::chrono::steady_clock::duration _minInterval =
+        std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point _lastUpdateTime;
 };
 
 } // namespace openspace
@@ -43,6 +43,12 @@ public:
     virtual void handleJson(const nlohmann::json& json) = 0;
     virtual bool isDone() const = 0;
 
+    /**
+     * Called once per frame on the main thread before the messages of the connection
+     * are sent. Topics that coalesce their updates send them from here
+     */
+    virtual void preSync();
+
 protected:
     size_t _topicId;
     Connection* _connection;
@@ -94,6 +94,11 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Send the coalesced subscription updates and all responses of this frame
+    for (ConnectionData& connectionData : _connections) {
+        connectionData.connection->preSync();
+    }
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -139,7 +144,7 @@ void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
 void ServerModule::consumeMessages() {
     std::lock_guard<std::mutex> lock(_messageQueueMutex);
     while (!_messageQueue.empty()) {
-        const Message& m = _messageQueue.front();
+        const Message m = std::move(_messageQueue.front());
         _messageQueue.pop_front();
         if (std::shared_ptr<Connection> c = m.connection.lock()) {
             c->handleMessage(m.messageString);
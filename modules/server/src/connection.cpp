@@ -40,6 +40,7 @@
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
 #include <fmt/format.h>
+#include <iterator>
 
 namespace {
     constexpr const char* _loggerCat = "ServerModule: Connection";
@@ -77,6 +78,19 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address
 
     // see if the default config for requiring auth (on) is overwritten
     _requireAuthorization = OsEng.configuration().doesRequireSocketAuthentication;
+
+    _sendThread = std::thread([this]() { sendMessages(); });
+}
+
+Connection::~Connection() {
+    {
+        std::lock_guard<std::mutex> lock(_outgoingMutex);
+        _isStopping = true;
+    }
+    _outgoingCondition.notify_one();
+    if (_sendThread.joinable()) {
+        _sendThread.join();
+    }
 }
 
 void Connection::handleMessage(const std::string& message) {
@@ -158,12 +172,56 @@ void Connection::handleJson(const nlohmann::json& json) {
     }
 }
 
-void Connection::sendMessage(const std::string& message) {
-    _socket->putMessage(message);
+void Connection::sendJson(nlohmann::json json) {
+    _pendingMessages.push_back(std::move(json));
+}
+
+void Connection::preSync() {
+    for (std::pair<const TopicId, std::unique_ptr<Topic>>& topic : _topics) {
+        topic.second->preSync();
+    }
+
+    if (_pendingMessages.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_outgoingMutex);
+        if (_outgoingMessages.empty()) {
+            _outgoingMessages.swap(_pendingMessages);
+        }
+        else {
+            // The sending thread has not caught up with the previous frame yet
+            std::move(
+                _pendingMessages.begin(),
+                _pendingMessages.end(),
+                std::back_inserter(_outgoingMessages)
+            );
+            _pendingMessages.clear();
+        }
+    }
+    _outgoingCondition.notify_one();
 }
 
-void Connection::sendJson(const nlohmann::json& json) {
-    sendMessage(json.dump());
+void Connection::sendMessages() {
+    std::vector<nlohmann::json> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_outgoingMutex);
+            _outgoingCondition.wait(
+                lock,
+                [this]() { return _isStopping || !_outgoingMessages.empty(); }
+            );
+            if (_isStopping) {
+                return;
+            }
+            batch.swap(_outgoingMessages);
+        }
+
+        for (const nlohmann::json& json : batch) {
+            _socket->putMessage(json.dump());
+        }
+        batch.clear();
+    }
 }
 
 bool Connection::isAuthorized() const {
@@ -36,6 +36,8 @@ namespace {
     constexpr const char* _loggerCat = "SubscriptionTopic";
     constexpr const char* PropertyKey = "property";
     constexpr const char* EventKey = "event";
+    constexpr const char* MaxRateKey = "maxRate";
+    constexpr const char* MinIntervalKey = "minInterval";
 
     constexpr const char* StartSubscription = "start_subscription";
     constexpr const char* StopSubscription = "stop_subscription";
@@ -49,13 +51,13 @@ SubscriptionTopic::~SubscriptionTopic() {
     if (_prop && _onChangeHandle != UnsetCallbackHandle) {
         _prop->removeOnChange(_onChangeHandle);
     }
-    if (_prop && !_onDeleteHandle) {
+    if (_prop && _onDeleteHandle != UnsetCallbackHandle) {
         _prop->removeOnDelete(_onDeleteHandle);
     }
 }
 
 bool SubscriptionTopic::isDone() const {
-    return _requestedResourceIsSubscribable && _isSubscribedTo;
+    return !_requestedResourceIsSubscribable || !_isSubscribedTo;
 }
 
 void SubscriptionTopic::handleJson(const nlohmann::json& json) {
@@ -65,23 +67,41 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     if (event == StartSubscription) {
         LDEBUG(fmt::format("Subscribing to property '{}'", key));
 
+        using namespace std::chrono;
+        auto maxRate = json.find(MaxRateKey);
+        if (maxRate != json.end() && maxRate->is_number() && *maxRate > 0.0) {
+            _minInterval = duration_cast<steady_clock::duration>(
+                duration<double>(1.0 / maxRate->get<double>())
+            );
+        }
+        auto minInterval = json.find(MinIntervalKey);
+        if (minInterval != json.end() && minInterval->is_number()) {
+            _minInterval = std::max(
+                _minInterval,
+                duration_cast<steady_clock::duration>(
+                    duration<double, std::milli>(minInterval->get<double>())
+                )
+            );
+        }
+
         _prop = property(key);
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                LDEBUG("Updating subscription '" + k + "'.");
-                _connection->sendJson(wrappedPayload(_prop));
-            };
-            _onChangeHandle = _prop->onChange(onChange);
-            _prop->onDelete([this]() {
+
+            const nlohmann::json description = _prop;
+            _description = description["Description"];
+
+            _onChangeHandle = _prop->onChange([this]() { _isDirty = true; });
+            _onDeleteHandle = _prop->onDelete([this]() {
                 _onChangeHandle = UnsetCallbackHandle;
                 _onDeleteHandle = UnsetCallbackHandle;
                 _isSubscribedTo = false;
+                _prop = nullptr;
             });
 
             // immediately send the value
-            onChange();
+            sendValue();
         }
         else {
             LWARNING(fmt::format("Could not subscribe. Property '{}' not found", key));
@@ -92,4 +112,28 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
 }
 
+void SubscriptionTopic::preSync() {
+    if (!_isSubscribedTo || !_prop || !_isDirty) {
+        return;
+    }
+
+    // A rate limited change stays dirty, so it is sent once the interval has passed
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - _lastUpdateTime < _minInterval) {
+        return;
+    }
+    sendValue();
+}
+
+void SubscriptionTopic::sendValue() {
+    _isDirty = false;
+    _lastUpdateTime = std::chrono::steady_clock::now();
+
+    const nlohmann::json payload = {
+        { "Description", _description },
+        { "Value", _prop->jsonValue() }
+    };
+    _connection->sendJson(wrappedPayload(payload));
+}
+
 } // namespace openspace
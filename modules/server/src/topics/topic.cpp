@@ -33,6 +33,8 @@ void Topic::initialize(Connection* connection, size_t topicId) {
     _topicId = topicId;
 };
 
+void Topic::preSync() {}
+
 nlohmann::json Topic::wrappedPayload(const nlohmann::json& payload) const {
     // TODO: add message time
     nlohmann::json j = {
@@ -28,12 +28,12 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <fstream>
-#include "SpiceUsr.h"
 
 namespace {
     constexpr float convertHrsToRadians(float rightAscension) {
@@ -328,14 +328,14 @@ bool RenderableConstellationBounds::loadVertexFile() {
         // Convert the (right ascension, declination) to rectangular coordinates)
         // The 1.0 is the distance of the celestial sphere, we will scale that in the
         // render function
-        double rectangularValues[3];
-        radrec_c(1.0, ra, dec, rectangularValues);
+        const glm::dvec3 rectangularValues =
+            SpiceManager::ref().rectangularFromRaDec(1.0, ra, dec);
 
         // Add the new vertex to our list of vertices
         _vertexValues.push_back({
-            static_cast<float>(rectangularValues[0]),
-            static_cast<float>(rectangularValues[1]),
-            static_cast<float>(rectangularValues[2])
+            static_cast<float>(rectangularValues.x),
+            static_cast<float>(rectangularValues.y),
+            static_cast<float>(rectangularValues.z)
         });
         ++currentLineNumber;
     }
@@ -24,6 +24,8 @@
 
 #include <modules/space/rendering/renderablestars.h>
 
+#include <modules/space/rendering/staroctreestreamer.h>
+#include <modules/space/staroctree.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
@@ -32,6 +34,7 @@
 
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
@@ -50,6 +53,8 @@ namespace {
 
     constexpr int8_t CurrentCacheVersion = 1;
 
+    constexpr double Parsec = 0.308567756E17;
+
     struct ColorVBOLayout {
         std::array<float, 4> position; // (x,y,z,e)
 
@@ -121,6 +126,30 @@ namespace {
         "This value is used as a lower limit on the size of stars that are rendered. Any "
         "stars that have a smaller apparent size will be discarded entirely."
     };
+
+    const openspace::properties::Property::PropertyInfo MagnitudeLimitInfo = {
+        "MagnitudeLimit",
+        "Magnitude Limit",
+        "If the stars are streamed from a star octree file, this value is the faintest "
+        "apparent magnitude for which parts of the catalog are still loaded. The "
+        "magnitude of each part is determined by its brightest star and its distance "
+        "to the camera."
+    };
+
+    const openspace::properties::Property::PropertyInfo GpuMemoryBudgetInfo = {
+        "GpuMemoryBudget",
+        "GPU Memory Budget (MB)",
+        "If the stars are streamed from a star octree file, this value is the amount of "
+        "GPU memory in megabytes that is reserved for the stars."
+    };
+
+    const openspace::properties::Property::PropertyInfo CpuMemoryBudgetInfo = {
+        "CpuMemoryBudget",
+        "CPU Memory Budget (MB)",
+        "If the stars are streamed from a star octree file, this value is the amount of "
+        "main memory in megabytes that is used to cache parts of the catalog read from "
+        "disk. Only as many parts are shown as fit into both budgets."
+    };
 }  // namespace
 
 namespace openspace {
@@ -141,7 +170,9 @@ documentation::Documentation RenderableStars::Documentation() {
                 new StringVerifier,
                 Optional::No,
                 "The path to the SPECK file that contains information about the stars "
-                "being rendered."
+                "being rendered. Alternatively, this is the path to a star octree file "
+                "created with the ConstructStarOctreeTask, in which case the stars are "
+                "streamed from disk depending on the position of the camera."
             },
             {
                 PsfTextureInfo.identifier,
@@ -180,6 +211,24 @@ documentation::Documentation RenderableStars::Documentation() {
                 new DoubleVerifier,
                 Optional::Yes,
                 MinBillboardSizeInfo.description
+            },
+            {
+                MagnitudeLimitInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                MagnitudeLimitInfo.description
+            },
+            {
+                GpuMemoryBudgetInfo.identifier,
+                new IntVerifier,
+                Optional::Yes,
+                GpuMemoryBudgetInfo.description
+            },
+            {
+                CpuMemoryBudgetInfo.identifier,
+                new IntVerifier,
+                Optional::Yes,
+                CpuMemoryBudgetInfo.description
             }
         }
     };
@@ -198,6 +247,10 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     , _alphaValue(TransparencyInfo, 1.f, 0.f, 1.f)
     , _scaleFactor(ScaleFactorInfo, 1.f, 0.f, 10.f)
     , _minBillboardSize(MinBillboardSizeInfo, 1.f, 1.f, 100.f)
+    , _magnitudeLimit(MagnitudeLimitInfo, 12.f, -10.f, 30.f)
+    , _gpuMemoryBudget(GpuMemoryBudgetInfo, 256, 16, 16384)
+    , _cpuMemoryBudget(CpuMemoryBudgetInfo, 512, 16, 65536)
+    , _isOctreeFile(false)
     , _program(nullptr)
     , _speckFile("")
     , _nValuesPerStar(0)
@@ -280,12 +333,50 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
             );
     }
     addProperty(_minBillboardSize);
+
+    _isOctreeFile = staroctree::isOctreeFile(_speckFile);
+    if (_isOctreeFile) {
+        if (dictionary.hasKey(MagnitudeLimitInfo.identifier)) {
+            _magnitudeLimit = static_cast<float>(
+                dictionary.value<double>(MagnitudeLimitInfo.identifier)
+            );
+        }
+        _magnitudeLimit.onChange([&] {
+            if (_octreeStreamer) {
+                _octreeStreamer->setMagnitudeLimit(_magnitudeLimit);
+            }
+        });
+        addProperty(_magnitudeLimit);
+
+        if (dictionary.hasKey(GpuMemoryBudgetInfo.identifier)) {
+            _gpuMemoryBudget = static_cast<int>(
+                dictionary.value<double>(GpuMemoryBudgetInfo.identifier)
+            );
+        }
+        if (dictionary.hasKey(CpuMemoryBudgetInfo.identifier)) {
+            _cpuMemoryBudget = static_cast<int>(
+                dictionary.value<double>(CpuMemoryBudgetInfo.identifier)
+            );
+        }
+        auto updateBudgets = [&]() {
+            if (_octreeStreamer) {
+                _octreeStreamer->setMemoryBudgets(
+                    static_cast<size_t>(_gpuMemoryBudget) * 1024 * 1024,
+                    static_cast<size_t>(_cpuMemoryBudget) * 1024 * 1024
+                );
+            }
+        };
+        _gpuMemoryBudget.onChange(updateBudgets);
+        _cpuMemoryBudget.onChange(updateBudgets);
+        addProperty(_gpuMemoryBudget);
+        addProperty(_cpuMemoryBudget);
+    }
 }
 
 RenderableStars::~RenderableStars() {} // NOLINT
 
 bool RenderableStars::isReady() const {
-    return (_program != nullptr) && (!_fullData.empty());
+    return (_program != nullptr) && (!_fullData.empty() || _octreeStreamer);
 }
 
 void RenderableStars::initializeGL() {
@@ -307,6 +398,24 @@ void RenderableStars::initializeGL() {
     _uniformCache.psfTexture = _program->uniformLocation("psfTexture");
     _uniformCache.colorTexture = _program->uniformLocation("colorTexture");
 
+    if (_isOctreeFile) {
+        staroctree::Octree octree;
+        if (!staroctree::loadStructure(_speckFile, octree)) {
+            throw ghoul::RuntimeError("Error loading star octree");
+        }
+        _octreeStreamer = std::make_unique<StarOctreeStreamer>(
+            _speckFile,
+            std::move(octree)
+        );
+        _octreeStreamer->setMagnitudeLimit(_magnitudeLimit);
+        _octreeStreamer->setMemoryBudgets(
+            static_cast<size_t>(_gpuMemoryBudget) * 1024 * 1024,
+            static_cast<size_t>(_cpuMemoryBudget) * 1024 * 1024
+        );
+        _octreeStreamer->initializeGL(*_program);
+        return;
+    }
+
     bool success = loadData();
     if (!success) {
         throw ghoul::RuntimeError("Error loading data");
@@ -319,6 +428,11 @@ void RenderableStars::deinitializeGL() {
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
+    if (_octreeStreamer) {
+        _octreeStreamer->deinitializeGL();
+        _octreeStreamer = nullptr;
+    }
+
     _pointSpreadFunctionTexture = nullptr;
     _colorTexture = nullptr;
 
@@ -362,18 +476,34 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     _colorTexture->bind();
     _program->setUniform(_uniformCache.colorTexture, colorUnit);
 
-    glBindVertexArray(_vao);
-    const GLsizei nStars = static_cast<GLsizei>(_fullData.size() / _nValuesPerStar);
-    glDrawArrays(GL_POINTS, 0, nStars);
+    if (_octreeStreamer) {
+        // The octree is stored in parsec in the catalog's frame, so the camera has to
+        // be transformed by the inverse of the full model transform
+        const glm::dmat4 modelMatrix =
+            glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+            glm::dmat4(data.modelTransform.rotation) *
+            glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale));
+        const glm::dvec3 cameraPosition = glm::dvec3(
+            glm::inverse(modelMatrix) * glm::dvec4(data.camera.positionVec3(), 1.0)
+        ) / Parsec;
+        _octreeStreamer->render(cameraPosition);
+    }
+    else {
+        glBindVertexArray(_vao);
+        const GLsizei nStars = static_cast<GLsizei>(_fullData.size() / _nValuesPerStar);
+        glDrawArrays(GL_POINTS, 0, nStars);
+        glBindVertexArray(0);
+    }
 
-    glBindVertexArray(0);
     _program->deactivate();
 
     glDepthMask(true);
 }
 
 void RenderableStars::update(const UpdateData&) {
-    if (_dataIsDirty) {
+    // Streamed stars carry all values for every color option, so they never need to be
+    // regenerated
+    if (_dataIsDirty && !_octreeStreamer) {
         const int value = _colorOption;
         LDEBUG("Regenerating data");
 
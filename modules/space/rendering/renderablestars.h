@@ -30,6 +30,7 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
@@ -44,6 +45,8 @@ namespace openspace {
 
 namespace documentation { struct Documentation; }
 
+class StarOctreeStreamer;
+
 class RenderableStars : public Renderable {
 public:
     explicit RenderableStars(const ghoul::Dictionary& dictionary);
@@ -90,6 +93,13 @@ private:
     properties::FloatProperty _scaleFactor;
     properties::FloatProperty _minBillboardSize;
 
+    // Only used when the stars are streamed from a star octree file
+    properties::FloatProperty _magnitudeLimit;
+    properties::IntProperty _gpuMemoryBudget;
+    properties::IntProperty _cpuMemoryBudget;
+    bool _isOctreeFile;
+    std::unique_ptr<StarOctreeStreamer> _octreeStreamer;
+
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
     UniformCache(view, projection, colorOption, alphaValue, scaleFactor,
         minBillboardSize, screenSize, scaling, psfTexture, colorTexture) _uniformCache;
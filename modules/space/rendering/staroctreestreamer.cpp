@@ -0,0 +1,427 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/rendering/staroctreestreamer.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/programobject.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+
+namespace {
+    constexpr const char* _loggerCat = "StarOctreeStreamer";
+
+    // Uploading a node is a single glBufferSubData call, but limiting the number per
+    // frame avoids stalls when the camera jumps to a completely different region
+    constexpr const int MaxUploadsPerFrame = 32;
+
+    // Apparent magnitudes are computed with at least this distance (in parsec) to avoid
+    // infinities for nodes that contain the camera
+    constexpr const double MinimumDistance = 1e-3;
+
+    using namespace openspace::staroctree;
+} // namespace
+
+namespace openspace {
+
+StarOctreeStreamer::StarOctreeStreamer(std::string file, staroctree::Octree octree)
+    : _file(std::move(file))
+    , _octree(std::move(octree))
+    , _bytesPerNode(
+        static_cast<size_t>(_octree.maxStarsPerNode) * ValuesPerVertex * sizeof(float)
+    )
+{
+    _worker = std::thread([this]() { workerLoop(); });
+}
+
+StarOctreeStreamer::~StarOctreeStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _shouldStop = true;
+    }
+    _requestCondition.notify_one();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void StarOctreeStreamer::initializeGL(const ghoul::opengl::ProgramObject& program) {
+    _positionAttrib = program.attributeLocation("in_position");
+    _brightnessAttrib = program.attributeLocation("in_brightness");
+    _velocityAttrib = program.attributeLocation("in_velocity");
+    _speedAttrib = program.attributeLocation("in_speed");
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(1, &_vbo);
+    _bufferIsDirty = true;
+}
+
+void StarOctreeStreamer::deinitializeGL() {
+    glDeleteBuffers(1, &_vbo);
+    _vbo = 0;
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+
+    _slotOfNode.clear();
+    _freeSlots.clear();
+    _drawFirst.clear();
+    _drawCount.clear();
+}
+
+void StarOctreeStreamer::setMagnitudeLimit(float magnitudeLimit) {
+    std::lock_guard<std::mutex> lock(_requestMutex);
+    _magnitudeLimit = magnitudeLimit;
+    _hasRequest = _hasPostedRequest;
+    _requestCondition.notify_one();
+}
+
+void StarOctreeStreamer::setMemoryBudgets(size_t gpuBytes, size_t cpuBytes) {
+    std::lock_guard<std::mutex> lock(_requestMutex);
+    const size_t maxGpuNodes = std::max<size_t>(gpuBytes / _bytesPerNode, 1);
+    if (maxGpuNodes != _maxGpuNodes) {
+        _maxGpuNodes = maxGpuNodes;
+        _bufferIsDirty = true;
+    }
+    _maxCpuNodes = std::max<size_t>(cpuBytes / _bytesPerNode, 1);
+    _hasRequest = _hasPostedRequest;
+    _requestCondition.notify_one();
+}
+
+void StarOctreeStreamer::render(const glm::dvec3& cameraPosition) {
+    if (_bufferIsDirty) {
+        allocateBuffer();
+    }
+
+    if (!_hasPostedRequest || cameraPosition != _lastCameraPosition) {
+        {
+            std::lock_guard<std::mutex> lock(_requestMutex);
+            _requestedCameraPosition = cameraPosition;
+            _hasRequest = true;
+        }
+        _requestCondition.notify_one();
+        _lastCameraPosition = cameraPosition;
+        _hasPostedRequest = true;
+    }
+
+    applySelection();
+
+    if (_drawFirst.empty()) {
+        return;
+    }
+    glBindVertexArray(_vao);
+    glMultiDrawArrays(
+        GL_POINTS,
+        _drawFirst.data(),
+        _drawCount.data(),
+        static_cast<GLsizei>(_drawFirst.size())
+    );
+    glBindVertexArray(0);
+}
+
+void StarOctreeStreamer::allocateBuffer() {
+    size_t nSlots = 0;
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        nSlots = _maxGpuNodes;
+        _bufferIsDirty = false;
+    }
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(GL_ARRAY_BUFFER, nSlots * _bytesPerNode, nullptr, GL_DYNAMIC_DRAW);
+
+    const GLsizei stride = static_cast<GLsizei>(ValuesPerVertex * sizeof(float));
+    glEnableVertexAttribArray(_positionAttrib);
+    glVertexAttribPointer(_positionAttrib, 4, GL_FLOAT, GL_FALSE, stride, nullptr);
+    glEnableVertexAttribArray(_brightnessAttrib);
+    glVertexAttribPointer(
+        _brightnessAttrib,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        stride,
+        reinterpret_cast<void*>(4 * sizeof(float))
+    );
+    glEnableVertexAttribArray(_velocityAttrib);
+    glVertexAttribPointer(
+        _velocityAttrib,
+        3,
+        GL_FLOAT,
+        GL_TRUE,
+        stride,
+        reinterpret_cast<void*>(7 * sizeof(float))
+    );
+    glEnableVertexAttribArray(_speedAttrib);
+    glVertexAttribPointer(
+        _speedAttrib,
+        1,
+        GL_FLOAT,
+        GL_TRUE,
+        stride,
+        reinterpret_cast<void*>(10 * sizeof(float))
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    // All previous contents are gone, so every wanted node has to be uploaded again.
+    // The worker only hands out references to its cache, so the data is still around
+    // if it is part of the next selection
+    _slotOfNode.clear();
+    _freeSlots.clear();
+    for (int i = static_cast<int>(nSlots) - 1; i >= 0; --i) {
+        _freeSlots.push_back(i);
+    }
+    _drawFirst.clear();
+    _drawCount.clear();
+    _wanted.clear();
+
+    std::lock_guard<std::mutex> lock(_requestMutex);
+    _hasRequest = _hasPostedRequest;
+    _requestCondition.notify_one();
+}
+
+void StarOctreeStreamer::applySelection() {
+    bool residencyChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(_resultMutex);
+        if (_hasNewResult) {
+            _wanted = std::move(_result);
+            _result.clear();
+            _hasNewResult = false;
+
+            std::unordered_set<uint32_t> wantedNodes;
+            for (const std::pair<uint32_t, NodeData>& n : _wanted) {
+                wantedNodes.insert(n.first);
+            }
+            for (auto it = _slotOfNode.begin(); it != _slotOfNode.end();) {
+                if (wantedNodes.find(it->first) == wantedNodes.end()) {
+                    _freeSlots.push_back(it->second);
+                    it = _slotOfNode.erase(it);
+                    residencyChanged = true;
+                }
+                else {
+                    ++it;
+                }
+            }
+            _hasPendingUploads = true;
+        }
+    }
+
+    if (_hasPendingUploads) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        int nUploads = 0;
+        _hasPendingUploads = false;
+        // _wanted is sorted by importance, so the brightest nodes are uploaded first
+        for (std::pair<uint32_t, NodeData>& n : _wanted) {
+            if (!n.second || _slotOfNode.find(n.first) != _slotOfNode.end()) {
+                continue;
+            }
+            if (_freeSlots.empty() || nUploads >= MaxUploadsPerFrame) {
+                _hasPendingUploads = !_freeSlots.empty();
+                break;
+            }
+
+            const int slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                slot * _bytesPerNode,
+                n.second->size() * sizeof(float),
+                n.second->data()
+            );
+            _slotOfNode[n.first] = slot;
+            // The data is on the GPU now; the worker's cache keeps its own reference
+            n.second = nullptr;
+            ++nUploads;
+            residencyChanged = true;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    if (residencyChanged) {
+        _drawFirst.clear();
+        _drawCount.clear();
+        const GLint slotSize = static_cast<GLint>(_octree.maxStarsPerNode);
+        for (const std::pair<const uint32_t, int>& n : _slotOfNode) {
+            _drawFirst.push_back(n.second * slotSize);
+            _drawCount.push_back(static_cast<GLsizei>(_octree.nodes[n.first].nStars));
+        }
+    }
+}
+
+std::vector<uint32_t> StarOctreeStreamer::selectNodes(const glm::dvec3& cameraPosition,
+                                                      float magnitudeLimit,
+                                                      size_t maxNodes) const
+{
+    using Candidate = std::pair<double, uint32_t>;
+
+    auto apparentMagnitude = [&](const Node& node) {
+        // Distance from the camera to the closest point of the node
+        const glm::dvec3 d = glm::max(
+            glm::abs(cameraPosition - glm::dvec3(node.center)) -
+                static_cast<double>(node.halfSize),
+            glm::dvec3(0.0)
+        );
+        const double distance = std::max(glm::length(d), MinimumDistance);
+        return node.brightestMagnitude + 5.0 * std::log10(distance / 10.0);
+    };
+
+    // The stars of a child are never brighter and never closer than those of its parent,
+    // so the priority queue always yields parents before their children and the first
+    // node above the limit terminates the traversal
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    std::vector<uint32_t> selected;
+    if (_octree.nodes.empty()) {
+        return selected;
+    }
+    queue.push({ apparentMagnitude(_octree.nodes[0]), 0 });
+    while (!queue.empty() && selected.size() < maxNodes) {
+        const Candidate c = queue.top();
+        queue.pop();
+        if (c.first > magnitudeLimit) {
+            break;
+        }
+        selected.push_back(c.second);
+        for (uint32_t child : _octree.nodes[c.second].children) {
+            if (child != 0) {
+                queue.push({ apparentMagnitude(_octree.nodes[child]), child });
+            }
+        }
+    }
+    return selected;
+}
+
+StarOctreeStreamer::NodeData StarOctreeStreamer::loadNode(std::ifstream& file,
+                                                          uint32_t node)
+{
+    std::vector<float> values;
+    if (!readStars(file, _octree, _octree.nodes[node], values)) {
+        LERROR(fmt::format("Error reading node {} from '{}'", node, _file));
+        return nullptr;
+    }
+
+    // Convert into the vertex layout: the position as a power scaled coordinate in
+    // meters, followed by the B-V color, luminance, absolute magnitude, velocity, and
+    // speed
+    const size_t nStars = values.size() / NValues;
+    auto vertices = std::make_shared<std::vector<float>>(nStars * ValuesPerVertex);
+    for (size_t i = 0; i < nStars; ++i) {
+        const float* s = values.data() + i * NValues;
+        float* v = vertices->data() + i * ValuesPerVertex;
+        v[0] = s[PositionX] * 0.308567756f;
+        v[1] = s[PositionY] * 0.308567756f;
+        v[2] = s[PositionZ] * 0.308567756f;
+        v[3] = 17.f;
+        v[4] = s[BvColor];
+        v[5] = s[Luminance];
+        v[6] = s[AbsoluteMagnitude];
+        v[7] = s[VelocityX];
+        v[8] = s[VelocityY];
+        v[9] = s[VelocityZ];
+        v[10] = s[Speed];
+    }
+    return vertices;
+}
+
+void StarOctreeStreamer::workerLoop() {
+    std::ifstream file(_file, std::ifstream::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Error opening star octree file '{}'", _file));
+        return;
+    }
+
+    while (true) {
+        glm::dvec3 cameraPosition;
+        float magnitudeLimit;
+        size_t maxNodes;
+        size_t maxCpuNodes;
+        {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _requestCondition.wait(lock, [this]() { return _hasRequest || _shouldStop; });
+            if (_shouldStop) {
+                return;
+            }
+            _hasRequest = false;
+            cameraPosition = _requestedCameraPosition;
+            magnitudeLimit = _magnitudeLimit;
+            maxCpuNodes = _maxCpuNodes;
+            maxNodes = std::min(_maxGpuNodes, _maxCpuNodes);
+        }
+
+        const std::vector<uint32_t> selected = selectNodes(
+            cameraPosition,
+            magnitudeLimit,
+            maxNodes
+        );
+
+        std::vector<std::pair<uint32_t, NodeData>> result;
+        result.reserve(selected.size());
+        bool isInterrupted = false;
+        for (uint32_t node : selected) {
+            auto it = _cache.find(node);
+            if (it != _cache.end()) {
+                _cacheOrder.splice(_cacheOrder.begin(), _cacheOrder, it->second.second);
+                result.emplace_back(node, it->second.first);
+                continue;
+            }
+
+            if (!isInterrupted) {
+                // Stop loading if the camera has moved on in the meantime. The cached
+                // nodes and those loaded so far are still handed out below so that the
+                // view fills in gradually
+                std::lock_guard<std::mutex> lock(_requestMutex);
+                isInterrupted = _hasRequest || _shouldStop;
+            }
+            if (isInterrupted) {
+                continue;
+            }
+
+            NodeData data = loadNode(file, node);
+            if (!data) {
+                continue;
+            }
+            _cacheOrder.push_front(node);
+            _cache[node] = { data, _cacheOrder.begin() };
+            result.emplace_back(node, std::move(data));
+        }
+
+        // Evict the least recently used nodes. All selected nodes were just moved to
+        // the front and the selection never exceeds the cache size, so they survive
+        while (_cache.size() > maxCpuNodes) {
+            _cache.erase(_cacheOrder.back());
+            _cacheOrder.pop_back();
+        }
+
+        std::lock_guard<std::mutex> lock(_resultMutex);
+        _result = std::move(result);
+        _hasNewResult = true;
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___STAROCTREESTREAMER___H__
+#define __OPENSPACE_MODULE_SPACE___STAROCTREESTREAMER___H__
+
+#include <modules/space/staroctree.h>
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+/**
+ * Streams the nodes of a star octree file to the GPU. The nodes are selected on a worker
+ * thread in the order of the apparent magnitude of their brightest star, as seen from
+ * the camera, until either the magnitude limit or the memory budgets are reached.
+ * Selected nodes are read from disk on the same thread and kept in an LRU cache that is
+ * bounded by the CPU memory budget. The rendering thread uploads a limited number of
+ * loaded nodes per frame into a fixed-size vertex buffer that is bounded by the GPU
+ * memory budget.
+ */
+class StarOctreeStreamer {
+public:
+    /// The number of floats that are uploaded to the GPU for each star
+    static constexpr const int ValuesPerVertex = 11;
+
+    StarOctreeStreamer(std::string file, staroctree::Octree octree);
+    ~StarOctreeStreamer();
+
+    /**
+     * Creates the vertex buffer and binds the in_position, in_brightness, in_velocity,
+     * and in_speed attributes of the \p program to it.
+     */
+    void initializeGL(const ghoul::opengl::ProgramObject& program);
+    void deinitializeGL();
+
+    /// Sets the faintest apparent magnitude for which nodes are still selected
+    void setMagnitudeLimit(float magnitudeLimit);
+
+    /// Sets the memory budgets in bytes. A new GPU budget reallocates the vertex buffer
+    void setMemoryBudgets(size_t gpuBytes, size_t cpuBytes);
+
+    /**
+     * Requests a new selection for the \p cameraPosition, given in parsec in the frame of
+     * the catalog, uploads newly loaded nodes, and draws all resident stars.
+     */
+    void render(const glm::dvec3& cameraPosition);
+
+private:
+    using NodeData = std::shared_ptr<const std::vector<float>>;
+
+    void workerLoop();
+    std::vector<uint32_t> selectNodes(const glm::dvec3& cameraPosition,
+        float magnitudeLimit, size_t maxNodes) const;
+    NodeData loadNode(std::ifstream& file, uint32_t node);
+
+    void allocateBuffer();
+    void applySelection();
+
+    const std::string _file;
+    const staroctree::Octree _octree;
+    const size_t _bytesPerNode;
+
+    // Shared between the rendering and the worker thread
+    mutable std::mutex _requestMutex;
+    std::condition_variable _requestCondition;
+    glm::dvec3 _requestedCameraPosition = glm::dvec3(0.0);
+    float _magnitudeLimit = 12.f;
+    size_t _maxCpuNodes = 1;
+    size_t _maxGpuNodes = 1;
+    bool _hasRequest = false;
+    bool _shouldStop = false;
+
+    std::mutex _resultMutex;
+    std::vector<std::pair<uint32_t, NodeData>> _result;
+    bool _hasNewResult = false;
+
+    // Owned by the worker thread
+    std::list<uint32_t> _cacheOrder;
+    std::unordered_map<uint32_t, std::pair<NodeData, std::list<uint32_t>::iterator>>
+        _cache;
+
+    std::thread _worker;
+
+    // Owned by the rendering thread
+    std::vector<std::pair<uint32_t, NodeData>> _wanted;
+    std::unordered_map<uint32_t, int> _slotOfNode;
+    std::vector<int> _freeSlots;
+    std::vector<GLint> _drawFirst;
+    std::vector<GLsizei> _drawCount;
+    bool _bufferIsDirty = true;
+    bool _hasPendingUploads = false;
+    bool _hasPostedRequest = false;
+    glm::dvec3 _lastCameraPosition = glm::dvec3(0.0);
+
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    GLint _positionAttrib = -1;
+    GLint _brightnessAttrib = -1;
+    GLint _velocityAttrib = -1;
+    GLint _speedAttrib = -1;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___STAROCTREESTREAMER___H__
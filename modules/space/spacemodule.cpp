@@ -29,6 +29,7 @@
 #include <modules/space/rendering/renderablerings.h>
 #include <modules/space/rendering/renderablestars.h>
 #include <modules/space/rendering/simplespheregeometry.h>
+#include <modules/space/tasks/constructstaroctreetask.h>
 #include <modules/space/translation/keplertranslation.h>
 #include <modules/space/translation/spicetranslation.h>
 #include <modules/space/translation/tletranslation.h>
@@ -37,6 +38,7 @@
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -77,6 +79,10 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary&) {
     auto fGeometry = FactoryManager::ref().factory<planetgeometry::PlanetGeometry>();
     ghoul_assert(fGeometry, "Planet geometry factory was not created");
     fGeometry->registerClass<planetgeometry::SimpleSphereGeometry>("SimpleSphere");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<ConstructStarOctreeTask>("ConstructStarOctreeTask");
 }
 
 void SpaceModule::internalDeinitializeGL() {
@@ -94,7 +100,8 @@ std::vector<documentation::Documentation> SpaceModule::documentations() const {
         KeplerTranslation::Documentation(),
         TLETranslation::Documentation(),
         planetgeometry::PlanetGeometry::Documentation(),
-        planetgeometry::SimpleSphereGeometry::Documentation()
+        planetgeometry::SimpleSphereGeometry::Documentation(),
+        ConstructStarOctreeTask::documentation()
     };
 }
 
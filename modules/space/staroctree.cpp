@@ -0,0 +1,362 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/staroctree.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+namespace {
+    constexpr const char* _loggerCat = "StarOctree";
+
+    // File layout (all values in native byte order):
+    //   char[8]   signature
+    //   uint32_t  version
+    //   uint32_t  number of values per star
+    //   uint32_t  maximum number of stars in a node
+    //   uint32_t  number of nodes
+    //   nodes     NodeRecordSize bytes each
+    //   float[]   star data, NValues per star, ordered by node
+    constexpr const char Signature[8] = { 'O', 'S', 'S', 'T', 'A', 'R', 'O', 'C' };
+    constexpr uint32_t CurrentVersion = 1;
+    constexpr uint64_t HeaderSize = sizeof(Signature) + 4 * sizeof(uint32_t);
+    constexpr uint64_t NodeRecordSize = 5 * sizeof(float) + sizeof(uint32_t) +
+        sizeof(uint64_t) + 8 * sizeof(uint32_t);
+
+    using namespace openspace::staroctree;
+
+    class Builder {
+    public:
+        Builder(const std::vector<float>& stars, uint32_t maxStarsPerNode, int maxDepth)
+            : _stars(stars)
+            , _maxStarsPerNode(maxStarsPerNode)
+            , _maxDepth(maxDepth)
+        {}
+
+        uint32_t createNode(std::vector<uint32_t>::iterator begin,
+                            std::vector<uint32_t>::iterator end, glm::vec3 center,
+                            float halfSize, int depth)
+        {
+            const uint32_t index = static_cast<uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+
+            const size_t nStars = static_cast<size_t>(std::distance(begin, end));
+            const bool isLeaf = nStars <= _maxStarsPerNode || depth >= _maxDepth;
+
+            // The brightest stars of the subtree are moved to the front and stay in
+            // this node; the remaining ones are distributed among the children
+            const auto ownEnd = isLeaf ? end : begin + _maxStarsPerNode;
+            if (!isLeaf) {
+                std::nth_element(
+                    begin, ownEnd, end,
+                    [this](uint32_t lhs, uint32_t rhs) {
+                        return value(lhs, AbsoluteMagnitude) <
+                               value(rhs, AbsoluteMagnitude);
+                    }
+                );
+            }
+
+            Node node;
+            node.center = center;
+            node.halfSize = halfSize;
+            node.nStars = static_cast<uint32_t>(std::distance(begin, ownEnd));
+            node.firstStar = static_cast<uint64_t>(std::distance(_orderBegin, begin));
+            node.brightestMagnitude = std::numeric_limits<float>::max();
+            for (auto it = begin; it != ownEnd; ++it) {
+                node.brightestMagnitude = std::min(
+                    node.brightestMagnitude,
+                    value(*it, AbsoluteMagnitude)
+                );
+            }
+
+            if (!isLeaf) {
+                // Split the remaining stars into the octants, first along x, then
+                // along y, and finally along z
+                std::array<std::vector<uint32_t>::iterator, 9> octants;
+                octants[0] = ownEnd;
+                octants[8] = end;
+                octants[4] = partition(octants[0], octants[8], PositionX, center.x);
+                octants[2] = partition(octants[0], octants[4], PositionY, center.y);
+                octants[6] = partition(octants[4], octants[8], PositionY, center.y);
+                for (int i = 0; i < 8; i += 2) {
+                    octants[i + 1] = partition(
+                        octants[i],
+                        octants[i + 2],
+                        PositionZ,
+                        center.z
+                    );
+                }
+
+                const float childHalfSize = halfSize / 2.f;
+                for (int i = 0; i < 8; ++i) {
+                    if (octants[i] == octants[i + 1]) {
+                        continue;
+                    }
+                    const glm::vec3 offset = glm::vec3(
+                        (i & 4) ? childHalfSize : -childHalfSize,
+                        (i & 2) ? childHalfSize : -childHalfSize,
+                        (i & 1) ? childHalfSize : -childHalfSize
+                    );
+                    node.children[i] = createNode(
+                        octants[i],
+                        octants[i + 1],
+                        center + offset,
+                        childHalfSize,
+                        depth + 1
+                    );
+                }
+            }
+
+            _nodes[index] = node;
+            return index;
+        }
+
+        std::vector<uint32_t>::iterator _orderBegin;
+        std::vector<Node> _nodes;
+
+    private:
+        float value(uint32_t star, int v) const {
+            return _stars[static_cast<size_t>(star) * NValues + v];
+        }
+
+        std::vector<uint32_t>::iterator partition(std::vector<uint32_t>::iterator begin,
+                                                  std::vector<uint32_t>::iterator end,
+                                                  int axis, float split) const
+        {
+            return std::partition(
+                begin, end,
+                [this, axis, split](uint32_t star) { return value(star, axis) < split; }
+            );
+        }
+
+        const std::vector<float>& _stars;
+        const uint32_t _maxStarsPerNode;
+        const int _maxDepth;
+    };
+
+    template <typename T>
+    void write(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T read(std::ifstream& file) {
+        T value = T();
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+} // namespace
+
+namespace openspace::staroctree {
+
+Octree build(std::vector<float>& stars, uint32_t maxStarsPerNode, int maxDepth) {
+    Octree octree;
+    const size_t nStars = stars.size() / NValues;
+    if (nStars == 0 || maxStarsPerNode == 0) {
+        return octree;
+    }
+
+    glm::vec3 minimum = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 maximum = glm::vec3(-std::numeric_limits<float>::max());
+    for (size_t i = 0; i < nStars; ++i) {
+        const glm::vec3 p = glm::vec3(
+            stars[i * NValues + PositionX],
+            stars[i * NValues + PositionY],
+            stars[i * NValues + PositionZ]
+        );
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+    const glm::vec3 extent = maximum - minimum;
+    // Slightly enlarge the root so that no star lies exactly on its boundary
+    const float halfSize = std::max(
+        std::max(extent.x, std::max(extent.y, extent.z)) * 0.5f * 1.001f,
+        std::numeric_limits<float>::min()
+    );
+
+    std::vector<uint32_t> order(nStars);
+    std::iota(order.begin(), order.end(), 0);
+
+    Builder builder(stars, maxStarsPerNode, maxDepth);
+    builder._orderBegin = order.begin();
+    builder.createNode(
+        order.begin(),
+        order.end(),
+        (minimum + maximum) * 0.5f,
+        halfSize,
+        0
+    );
+    octree.nodes = std::move(builder._nodes);
+
+    for (const Node& node : octree.nodes) {
+        octree.maxStarsPerNode = std::max(octree.maxStarsPerNode, node.nStars);
+    }
+
+    // Reorder the star data so that the stars of every node are contiguous
+    std::vector<float> ordered(stars.size());
+    for (size_t i = 0; i < nStars; ++i) {
+        std::memcpy(
+            ordered.data() + i * NValues,
+            stars.data() + static_cast<size_t>(order[i]) * NValues,
+            NValues * sizeof(float)
+        );
+    }
+    stars = std::move(ordered);
+
+    return octree;
+}
+
+bool saveFile(const Octree& octree, const std::vector<float>& stars,
+              const std::string& path)
+{
+    std::ofstream file(path, std::ofstream::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Error opening file '{}' for writing", path));
+        return false;
+    }
+
+    file.write(Signature, sizeof(Signature));
+    write(file, CurrentVersion);
+    write(file, static_cast<uint32_t>(NValues));
+    write(file, octree.maxStarsPerNode);
+    write(file, static_cast<uint32_t>(octree.nodes.size()));
+
+    for (const Node& node : octree.nodes) {
+        write(file, node.center.x);
+        write(file, node.center.y);
+        write(file, node.center.z);
+        write(file, node.halfSize);
+        write(file, node.brightestMagnitude);
+        write(file, node.nStars);
+        write(file, node.firstStar);
+        for (uint32_t child : node.children) {
+            write(file, child);
+        }
+    }
+
+    file.write(
+        reinterpret_cast<const char*>(stars.data()),
+        stars.size() * sizeof(float)
+    );
+    return file.good();
+}
+
+bool isOctreeFile(const std::string& path) {
+    std::ifstream file(path, std::ifstream::binary);
+    char signature[sizeof(Signature)] = {};
+    file.read(signature, sizeof(signature));
+    return file.good() && std::equal(signature, signature + sizeof(signature), Signature);
+}
+
+bool loadStructure(const std::string& path, Octree& octree) {
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Error opening star octree file '{}'", path));
+        return false;
+    }
+    file.seekg(0, std::ifstream::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ifstream::beg);
+
+    char signature[sizeof(Signature)] = {};
+    file.read(signature, sizeof(signature));
+    if (!std::equal(signature, signature + sizeof(signature), Signature)) {
+        LERROR(fmt::format("File '{}' is not a star octree file", path));
+        return false;
+    }
+
+    const uint32_t version = read<uint32_t>(file);
+    const uint32_t nValues = read<uint32_t>(file);
+    if (version != CurrentVersion || nValues != NValues) {
+        LERROR(fmt::format(
+            "Star octree file '{}' has version {} with {} values per star, expected "
+            "version {} with {} values per star",
+            path, version, nValues, CurrentVersion, static_cast<int>(NValues)
+        ));
+        return false;
+    }
+
+    octree.maxStarsPerNode = read<uint32_t>(file);
+    const uint32_t nNodes = read<uint32_t>(file);
+    octree.dataOffset = HeaderSize + nNodes * NodeRecordSize;
+    if (!file.good() || octree.dataOffset > fileSize) {
+        LERROR(fmt::format("Star octree file '{}' is truncated", path));
+        return false;
+    }
+
+    const uint64_t nFileStars =
+        (fileSize - octree.dataOffset) / (NValues * sizeof(float));
+    octree.nodes.resize(nNodes);
+    for (Node& node : octree.nodes) {
+        node.center.x = read<float>(file);
+        node.center.y = read<float>(file);
+        node.center.z = read<float>(file);
+        node.halfSize = read<float>(file);
+        node.brightestMagnitude = read<float>(file);
+        node.nStars = read<uint32_t>(file);
+        node.firstStar = read<uint64_t>(file);
+        for (uint32_t& child : node.children) {
+            child = read<uint32_t>(file);
+        }
+
+        const bool childrenValid = std::all_of(
+            node.children.begin(), node.children.end(),
+            [nNodes](uint32_t child) { return child < nNodes; }
+        );
+        if (!childrenValid || node.nStars > octree.maxStarsPerNode ||
+            node.firstStar + node.nStars > nFileStars)
+        {
+            LERROR(fmt::format("Star octree file '{}' is corrupt", path));
+            octree.nodes.clear();
+            return false;
+        }
+    }
+
+    if (!file.good()) {
+        LERROR(fmt::format("Star octree file '{}' is truncated", path));
+        octree.nodes.clear();
+        return false;
+    }
+    return true;
+}
+
+bool readStars(std::ifstream& file, const Octree& octree, const Node& node,
+               std::vector<float>& stars)
+{
+    stars.resize(static_cast<size_t>(node.nStars) * NValues);
+    file.clear();
+    file.seekg(octree.dataOffset + node.firstStar * NValues * sizeof(float));
+    file.read(
+        reinterpret_cast<char*>(stars.data()),
+        stars.size() * sizeof(float)
+    );
+    return file.good();
+}
+
+} // namespace openspace::staroctree
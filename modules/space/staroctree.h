@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___STAROCTREE___H__
+#define __OPENSPACE_MODULE_SPACE___STAROCTREE___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace openspace::staroctree {
+
+/**
+ * The values that are stored for every star in an octree file, in this order. Positions
+ * are in parsec relative to the origin of the catalog.
+ */
+enum StarValue {
+    PositionX = 0,
+    PositionY,
+    PositionZ,
+    BvColor,
+    Luminance,
+    AbsoluteMagnitude,
+    VelocityX,
+    VelocityY,
+    VelocityZ,
+    Speed,
+    NValues
+};
+
+/**
+ * A single node of the star octree. Every node stores the brightest stars of its subtree
+ * that are not already stored in one of its ancestors, so a node's stars are always at
+ * least as bright as any star further down the tree. Rendering a node together with all
+ * of its ancestors therefore shows every star of that region down to the node's faintest
+ * magnitude, without any star being duplicated.
+ */
+struct Node {
+    glm::vec3 center = glm::vec3(0.f);
+    float halfSize = 0.f;
+    /// The smallest absolute magnitude of this node's stars and thus of its subtree
+    float brightestMagnitude = 0.f;
+    uint32_t nStars = 0;
+    /// The index of the first star of this node in the star data of the file
+    uint64_t firstStar = 0;
+    /// The indices of the children in Octree::nodes; 0 if the child does not exist
+    std::array<uint32_t, 8> children = {};
+};
+
+/**
+ * The structure of a star octree. The root is always the first node. The star data
+ * itself is not part of this structure and is read on demand using readStars.
+ */
+struct Octree {
+    /// The largest number of stars in any node
+    uint32_t maxStarsPerNode = 0;
+    std::vector<Node> nodes;
+    /// The byte offset of the star data in the file
+    uint64_t dataOffset = 0;
+};
+
+/**
+ * Partitions the \p stars, which contain StarValue::NValues values per star, into an
+ * octree in which every node holds at most \p maxStarsPerNode stars. The stars are
+ * reordered so that the stars of every node are contiguous. Only if the subdivision
+ * reaches \p maxDepth, a leaf might contain more stars.
+ */
+Octree build(std::vector<float>& stars, uint32_t maxStarsPerNode, int maxDepth = 21);
+
+/**
+ * Writes the \p octree and the \p stars it was built from into the file at \p path.
+ * Returns \c false if the file could not be written.
+ */
+bool saveFile(const Octree& octree, const std::vector<float>& stars,
+    const std::string& path);
+
+/// Returns whether the file at \p path starts with the star octree file signature
+bool isOctreeFile(const std::string& path);
+
+/**
+ * Reads the structure of the octree stored in the file at \p path into \p octree, but
+ * none of the star data. Returns \c false if the file could not be read or is invalid.
+ */
+bool loadStructure(const std::string& path, Octree& octree);
+
+/**
+ * Reads the stars of the \p node of the \p octree from the \p file into \p stars, which
+ * is resized to contain StarValue::NValues values for each star. Returns \c false if the
+ * star data could not be read.
+ */
+bool readStars(std::ifstream& file, const Octree& octree, const Node& node,
+    std::vector<float>& stars);
+
+} // namespace openspace::staroctree
+
+#endif // __OPENSPACE_MODULE_SPACE___STAROCTREE___H__
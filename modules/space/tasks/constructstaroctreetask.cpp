@@ -0,0 +1,310 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/tasks/constructstaroctreetask.h>
+
+#include <modules/space/staroctree.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* _loggerCat = "ConstructStarOctreeTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeyMaxStarsPerNode = "MaxStarsPerNode";
+
+    constexpr const int DefaultMaxStarsPerNode = 8192;
+
+    using namespace openspace::staroctree;
+
+    // The columns of a Speck star catalog, including X Y Z, that are stored for each
+    // star. These are the same columns that RenderableStars reads from a Speck file
+    constexpr const std::array<int, NValues> SpeckColumns = {
+        0, 1, 2, 3, 4, 5, 12, 13, 14, 15
+    };
+
+    // The names of the header columns of a CSV star catalog, matching the names of the
+    // data variables of a Speck star catalog
+    constexpr const std::array<const char*, NValues> CsvColumns = {
+        "x", "y", "z", "colorb_v", "lum", "absmag", "vx", "vy", "vz", "speed"
+    };
+
+    // Reads up to values.size() floating point values separated by whitespace or by the
+    // separator and returns the number of values that were read
+    size_t parseValues(const std::string& line, std::vector<float>& values,
+                       char separator)
+    {
+        const char* p = line.c_str();
+        size_t n = 0;
+        while (n < values.size()) {
+            while (*p == ' ' || *p == '\t' || *p == separator) {
+                ++p;
+            }
+            char* end = nullptr;
+            const float value = std::strtof(p, &end);
+            if (end == p) {
+                break;
+            }
+            values[n++] = value;
+            p = end;
+        }
+        return n;
+    }
+
+    std::string trim(const std::string& s) {
+        const size_t first = s.find_first_not_of(" \t\r\"");
+        if (first == std::string::npos) {
+            return "";
+        }
+        const size_t last = s.find_last_not_of(" \t\r\"");
+        return s.substr(first, last - first + 1);
+    }
+} // namespace
+
+namespace openspace {
+
+ConstructStarOctreeTask::ConstructStarOctreeTask(const ghoul::Dictionary& dictionary)
+    : _maxStarsPerNode(DefaultMaxStarsPerNode)
+{
+    documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ConstructStarOctreeTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+    if (dictionary.hasKey(KeyMaxStarsPerNode)) {
+        _maxStarsPerNode = static_cast<int>(
+            dictionary.value<double>(KeyMaxStarsPerNode)
+        );
+    }
+}
+
+std::string ConstructStarOctreeTask::description() {
+    return fmt::format(
+        "Construct a star octree with at most {} stars per node from the catalog {} and "
+        "write it to {}",
+        _maxStarsPerNode, _inputPath, _outputPath
+    );
+}
+
+void ConstructStarOctreeTask::perform(const Task::ProgressCallback& progressCallback) {
+    const std::string extension = ghoul::filesystem::File(_inputPath).fileExtension();
+
+    std::vector<float> stars;
+    const bool success = (extension == "csv") ?
+        readCsvFile(stars, progressCallback) :
+        readSpeckFile(stars, progressCallback);
+    if (!success) {
+        LERROR(fmt::format("Could not read star catalog '{}'", _inputPath));
+        return;
+    }
+
+    const Octree octree = build(stars, static_cast<uint32_t>(_maxStarsPerNode));
+    LINFO(fmt::format(
+        "Partitioned {} stars into {} nodes with at most {} stars per node",
+        stars.size() / NValues, octree.nodes.size(), octree.maxStarsPerNode
+    ));
+    progressCallback(0.75f);
+
+    if (!saveFile(octree, stars, _outputPath)) {
+        LERROR(fmt::format("Could not write file '{}'", _outputPath));
+        return;
+    }
+    progressCallback(1.f);
+}
+
+bool ConstructStarOctreeTask::readSpeckFile(std::vector<float>& stars,
+                                         const ProgressCallback& progressCallback) const
+{
+    std::ifstream file(_inputPath);
+    if (!file.good()) {
+        return false;
+    }
+    file.seekg(0, std::ifstream::end);
+    const double fileSize = static_cast<double>(file.tellg());
+    file.seekg(0, std::ifstream::beg);
+
+    // Skip the header, counting the data variables to get the number of values per star
+    int nValuesPerStar = 0;
+    std::string line;
+    while (true) {
+        const std::streampos position = file.tellg();
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line.substr(0, 7) != "datavar" && line.substr(0, 10) != "texturevar" &&
+            line.substr(0, 7) != "texture")
+        {
+            file.seekg(position);
+            break;
+        }
+        if (line.substr(0, 7) == "datavar") {
+            std::stringstream str(line);
+            std::string dummy;
+            str >> dummy >> nValuesPerStar;
+            nValuesPerStar += 1;
+        }
+    }
+    nValuesPerStar += 3;
+
+    std::vector<float> values(nValuesPerStar);
+    size_t nLines = 0;
+    while (std::getline(file, line)) {
+        std::fill(values.begin(), values.end(), 0.f);
+        if (parseValues(line, values, ' ') == 0) {
+            continue;
+        }
+
+        bool isNull = true;
+        for (float v : values) {
+            if (v != 0.f) {
+                isNull = false;
+                break;
+            }
+        }
+        if (isNull) {
+            continue;
+        }
+
+        for (int column : SpeckColumns) {
+            stars.push_back(column < nValuesPerStar ? values[column] : 0.f);
+        }
+
+        if (++nLines % 100000 == 0) {
+            progressCallback(0.5f * static_cast<float>(file.tellg() / fileSize));
+        }
+    }
+    progressCallback(0.5f);
+    return true;
+}
+
+bool ConstructStarOctreeTask::readCsvFile(std::vector<float>& stars,
+                                         const ProgressCallback& progressCallback) const
+{
+    std::ifstream file(_inputPath);
+    if (!file.good()) {
+        return false;
+    }
+    file.seekg(0, std::ifstream::end);
+    const double fileSize = static_cast<double>(file.tellg());
+    file.seekg(0, std::ifstream::beg);
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+
+    // Map each stored value to its column in the file; missing columns are set to 0
+    std::vector<std::string> header;
+    std::stringstream headerStream(line);
+    std::string name;
+    while (std::getline(headerStream, name, ',')) {
+        header.push_back(trim(name));
+    }
+    std::array<int, NValues> columns;
+    for (int i = 0; i < NValues; ++i) {
+        auto it = std::find(header.begin(), header.end(), CsvColumns[i]);
+        columns[i] = it != header.end() ?
+            static_cast<int>(std::distance(header.begin(), it)) :
+            -1;
+        if (columns[i] == -1 && i <= PositionZ) {
+            LERROR(fmt::format("CSV file is missing the column '{}'", CsvColumns[i]));
+            return false;
+        }
+    }
+
+    std::vector<float> values(header.size());
+    size_t nLines = 0;
+    while (std::getline(file, line)) {
+        std::fill(values.begin(), values.end(), 0.f);
+        if (parseValues(line, values, ',') == 0) {
+            continue;
+        }
+        for (int column : columns) {
+            stars.push_back(column != -1 ? values[column] : 0.f);
+        }
+
+        if (++nLines % 100000 == 0) {
+            progressCallback(0.5f * static_cast<float>(file.tellg() / fileSize));
+        }
+    }
+    progressCallback(0.5f);
+    return true;
+}
+
+documentation::Documentation ConstructStarOctreeTask::documentation() {
+    using namespace documentation;
+    return {
+        "ConstructStarOctreeTask",
+        "space_construct_star_octree_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ConstructStarOctreeTask"),
+                Optional::No,
+                "The type of this task"
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A speck or csv file"),
+                Optional::No,
+                "The star catalog that is converted. Files with the extension 'csv' are "
+                "read as comma separated values with a header row containing the columns "
+                "x, y, z, colorb_v, lum, absmag, vx, vy, vz, and speed, of which all but "
+                "the positions are optional. All other files are read as Speck files"
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The star octree file that is written. It can be used as the File of a "
+                "RenderableStars"
+            },
+            {
+                KeyMaxStarsPerNode,
+                new IntGreaterVerifier(0),
+                Optional::Yes,
+                "The maximum number of stars in each node of the octree. Smaller nodes "
+                "allow a finer level of detail at the cost of more draw ranges and disk "
+                "reads. The default value is 8192"
+            }
+        }
+    };
+}
+
+} // namespace openspace
@@ -48,6 +48,83 @@ T solveIteration(const Func& function, T x0, const T& err = 0.0, int maxIter = 1
     return x2;
 }
 
+double eccentricAnomaly(double meanAnomaly, double eccentricity) {
+    // Compute the eccentric anomaly (the location of the spacecraft taking the
+    // eccentricity of the orbit into account) using different solves for the regimes in
+    // which they are most efficient
+
+    if (eccentricity == 0.0) {
+        // In a circular orbit, the eccentric anomaly = mean anomaly
+        return meanAnomaly;
+    }
+    else if (eccentricity < 0.2) {
+        auto solver = [eccentricity, &meanAnomaly](double x) -> double {
+            // For low eccentricity, using a first order solver sufficient
+            return meanAnomaly + eccentricity * sin(x);
+        };
+        return solveIteration(solver, meanAnomaly, 0.0, 5);
+    }
+    else if (eccentricity < 0.9) {
+        auto solver = [eccentricity, &meanAnomaly](double x) -> double {
+            const double e = eccentricity;
+            return x + (meanAnomaly + e * sin(x) - x) / (1.0 - e * cos(x));
+        };
+        return solveIteration(solver, meanAnomaly, 0.0, 6);
+    }
+    else if (eccentricity < 1.0) {
+        auto sign = [](double val) -> double {
+            return val > 0.0 ? 1.0 : ((val < 0.0) ? -1.0 : 0.0);
+        };
+        double e = meanAnomaly + 0.85 * eccentricity * sign(sin(meanAnomaly));
+
+        auto solver = [eccentricity, &meanAnomaly, &sign](double x) -> double {
+            const double s = eccentricity * sin(x);
+            const double c = eccentricity * cos(x);
+            const double f = x - s - meanAnomaly;
+            const double f1 = 1 - c;
+            const double f2 = s;
+            return x + (-5 * f / (f1 + sign(f1) *
+                sqrt(std::abs(16 * f1 * f1 - 20 * f * f2))));
+        };
+        return solveIteration(solver, e, 0.0, 8);
+    }
+    else {
+        ghoul_assert(false, "Eccentricity must not be >= 1.0");
+        LERRORC("KeplerTranslation", "Eccentricity must not be >= 1.0");
+        return 0.0;
+    }
+}
+
+// Returns the rotation of the orbit plane; all angles are given in degrees
+glm::dmat3 orbitPlaneRotation(double ascendingNode, double inclination,
+                              double argumentOfPeriapsis)
+{
+    // We assume the following coordinate system:
+    // z = axis of rotation
+    // x = pointing towards the first point of Aries
+    // y completes the righthanded coordinate system
+
+    // Perform three rotations:
+    // 1. Around the z axis to place the location of the ascending node
+    // 2. Around the x axis (now aligned with the ascending node) to get the correct
+    // inclination
+    // 3. Around the new z axis to place the closest approach to the correct location
+
+    const glm::vec3 ascendingNodeAxisRot = { 0.f, 0.f, 1.f };
+    const glm::vec3 inclinationAxisRot = { 1.f, 0.f, 0.f };
+    const glm::vec3 argPeriapsisAxisRot = { 0.f, 0.f, 1.f };
+
+    const double asc = glm::radians(ascendingNode);
+    const double inc = glm::radians(inclination);
+    const double per = glm::radians(argumentOfPeriapsis);
+
+    return glm::dmat3(
+        glm::rotate(asc, glm::dvec3(ascendingNodeAxisRot)) *
+        glm::rotate(inc, glm::dvec3(inclinationAxisRot)) *
+        glm::rotate(per, glm::dvec3(argPeriapsisAxisRot))
+    );
+}
+
     const openspace::properties::Property::PropertyInfo EccentricityInfo = {
         "Eccentricity",
         "Eccentricity",
@@ -238,50 +315,7 @@ KeplerTranslation::KeplerTranslation(const ghoul::Dictionary& dictionary)
 }
 
 double KeplerTranslation::eccentricAnomaly(double meanAnomaly) const {
-    // Compute the eccentric anomaly (the location of the spacecraft taking the
-    // eccentricity of the orbit into account) using different solves for the regimes in
-    // which they are most efficient
-
-    if (_eccentricity == 0.0) {
-        // In a circular orbit, the eccentric anomaly = mean anomaly
-        return meanAnomaly;
-    }
-    else if (_eccentricity < 0.2) {
-        auto solver = [this, &meanAnomaly](double x) -> double {
-            // For low eccentricity, using a first order solver sufficient
-            return meanAnomaly + _eccentricity * sin(x);
-        };
-        return solveIteration(solver, meanAnomaly, 0.0, 5);
-    }
-    else if (_eccentricity < 0.9) {
-        auto solver = [this, &meanAnomaly](double x) -> double {
-            const double e = _eccentricity;
-            return x + (meanAnomaly + e * sin(x) - x) / (1.0 - e * cos(x));
-        };
-        return solveIteration(solver, meanAnomaly, 0.0, 6);
-    }
-    else if (_eccentricity < 1.0) {
-        auto sign = [](double val) -> double {
-            return val > 0.0 ? 1.0 : ((val < 0.0) ? -1.0 : 0.0);
-        };
-        double e = meanAnomaly + 0.85 * _eccentricity * sign(sin(meanAnomaly));
-
-        auto solver = [this, &meanAnomaly, &sign](double x) -> double {
-            const double s = _eccentricity * sin(x);
-            const double c = _eccentricity * cos(x);
-            const double f = x - s - meanAnomaly;
-            const double f1 = 1 - c;
-            const double f2 = s;
-            return x + (-5 * f / (f1 + sign(f1) *
-                sqrt(std::abs(16 * f1 * f1 - 20 * f * f2))));
-        };
-        return solveIteration(solver, e, 0.0, 8);
-    }
-    else {
-        ghoul_assert(false, "Eccentricity must not be >= 1.0");
-        LERRORC("KeplerTranslation", "Eccentricity must not be >= 1.0");
-        return 0.0;
-    }
+    return ::eccentricAnomaly(meanAnomaly, _eccentricity);
 }
 
 glm::dvec3 KeplerTranslation::position(const Time& time) const {
@@ -304,29 +338,44 @@ glm::dvec3 KeplerTranslation::position(const Time& time) const {
     return _orbitPlaneRotation * p;
 }
 
-void KeplerTranslation::computeOrbitPlane() const {
-    // We assume the following coordinate system:
-    // z = axis of rotation
-    // x = pointing towards the first point of Aries
-    // y completes the righthanded coordinate system
-
-    // Perform three rotations:
-    // 1. Around the z axis to place the location of the ascending node
-    // 2. Around the x axis (now aligned with the ascending node) to get the correct
-    // inclination
-    // 3. Around the new z axis to place the closest approach to the correct location
-
-    const glm::vec3 ascendingNodeAxisRot = { 0.f, 0.f, 1.f };
-    const glm::vec3 inclinationAxisRot = { 1.f, 0.f, 0.f };
-    const glm::vec3 argPeriapsisAxisRot = { 0.f, 0.f, 1.f };
-
-    const double asc = glm::radians(_ascendingNode.value());
-    const double inc = glm::radians(_inclination.value());
-    const double per = glm::radians(_argumentOfPeriapsis.value());
+Translation::BatchSampler KeplerTranslation::batchSampler() const {
+    // Everything that does not depend on the time is computed once here, so that the
+    // sampler only has to solve for the eccentric anomaly and evaluate the ellipse
+    const double eccentricity = _eccentricity;
+    const double epoch = _epoch;
+    const double meanMotion = glm::two_pi<double>() / _period;
+    const double meanAnomalyAtEpoch = glm::radians(_meanAnomalyAtEpoch.value());
+    const double a = _semiMajorAxis * 1000.0;
+    const double b = a * sqrt(1.0 - eccentricity * eccentricity);
+    const glm::dmat3 rotation = orbitPlaneRotation(
+        _ascendingNode,
+        _inclination,
+        _argumentOfPeriapsis
+    );
+    // The positions lie in the x-y plane of the orbit, so only the first two columns of
+    // the rotation are needed. The periapsis offset is folded into the first column
+    const glm::dvec3 offset = rotation[0] * (-a * eccentricity);
+    const glm::dvec3 xAxis = rotation[0] * a;
+    const glm::dvec3 yAxis = rotation[1] * b;
+
+    return [=](const std::vector<double>& times) {
+        std::vector<glm::dvec3> result(times.size());
+        for (size_t i = 0; i < times.size(); ++i) {
+            const double meanAnomaly = meanAnomalyAtEpoch +
+                                       (times[i] - epoch) * meanMotion;
+            const double e = ::eccentricAnomaly(meanAnomaly, eccentricity);
+            result[i] = offset + xAxis * cos(e) + yAxis * sin(e);
+        }
+        return result;
+    };
+}
 
-    _orbitPlaneRotation = glm::rotate(asc, glm::dvec3(ascendingNodeAxisRot)) *
-                          glm::rotate(inc, glm::dvec3(inclinationAxisRot)) *
-                          glm::rotate(per, glm::dvec3(argPeriapsisAxisRot));
+void KeplerTranslation::computeOrbitPlane() const {
+    _orbitPlaneRotation = orbitPlaneRotation(
+        _ascendingNode,
+        _inclination,
+        _argumentOfPeriapsis
+    );
 
     notifyObservers();
     _orbitPlaneDirty = false;
@@ -68,6 +68,12 @@ public:
     */
     glm::dvec3 position(const Time& time) const override;
 
+    /**
+     * Returns a sampler that evaluates the orbit for many times at once. The orbit plane
+     * and the ellipse parameters are computed only once for all of the times.
+     */
+    BatchSampler batchSampler() const override;
+
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictinoary
      * that can be passed to the constructor.
@@ -32,12 +32,17 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* KeyKernels = "Kernels";
 
     constexpr const char* DefaultReferenceFrame = "GALACTIC";
 
+    // The number of times that are passed to the SpiceManager at once when sampling. All
+    // other SPICE queries wait while a batch is computed, so it is kept short
+    constexpr const size_t SamplesPerBatch = 256;
+
     const openspace::properties::Property::PropertyInfo TargetInfo = {
         "Target",
         "Target",
@@ -186,4 +191,27 @@ glm::dvec3 SpiceTranslation::position(const Time& time) const {
     ) * glm::pow(10.0, 3.0);
 }
 
+Translation::BatchSampler SpiceTranslation::batchSampler() const {
+    return [target = _target.value(), observer = _observer.value(),
+            frame = _frame.value()](const std::vector<double>& times)
+    {
+        std::vector<glm::dvec3> result;
+        result.reserve(times.size());
+
+        std::vector<double> batch;
+        for (size_t i = 0; i < times.size(); i += SamplesPerBatch) {
+            batch.assign(
+                times.begin() + i,
+                times.begin() + std::min(i + SamplesPerBatch, times.size())
+            );
+            const std::vector<glm::dvec3> positions =
+                SpiceManager::ref().targetPositions(target, observer, frame, {}, batch);
+            for (const glm::dvec3& p : positions) {
+                result.push_back(p * glm::pow(10.0, 3.0));
+            }
+        }
+        return result;
+    };
+}
+
 } // namespace openspace
@@ -36,6 +36,7 @@ public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const Time& time) const override;
+    BatchSampler batchSampler() const override;
 
     static documentation::Documentation Documentation();
 
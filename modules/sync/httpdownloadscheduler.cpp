@@ -0,0 +1,446 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/httpdownloadscheduler.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+
+#ifdef OPENSPACE_CURL_ENABLED
+#ifdef WIN32
+#pragma warning (push)
+#pragma warning (disable: 4574) // 'INCL_WINSOCK_API_TYPEDEFS' is defined to be '0'
+#endif // WIN32
+
+#include <curl/curl.h>
+
+#ifdef WIN32
+#pragma warning (pop)
+#endif // WIN32
+#endif // OPENSPACE_CURL_ENABLED
+
+namespace {
+    constexpr const char* _loggerCat = "HttpDownloadScheduler";
+
+    constexpr const long StatusCodeRangeNotSatisfiable = 416;
+
+    // Maximum time the I/O thread blocks while waiting for socket activity, which also
+    // bounds the latency with which newly enqueued downloads are started
+    constexpr const int WaitTimeoutMs = 100;
+
+    // Transfers that are slower than 1 byte/s for this long are considered stalled and
+    // will be retried
+    constexpr const long StallTimeSeconds = 30;
+    constexpr const long ConnectTimeoutSeconds = 30;
+} // namespace
+
+namespace openspace {
+
+struct HttpDownloadScheduler::Transfer {
+    Download download;
+    int nAttempts = 0;
+    // Transfers that are waiting to be retried must not be started before this time
+    std::chrono::steady_clock::time_point retryTime;
+
+    CURL* handle = nullptr;
+    std::FILE* file = nullptr;
+    // The number of bytes that were present in the destination file when the transfer
+    // was started and which were requested to be skipped by the server
+    size_t resumeOffset = 0;
+};
+
+size_t HttpDownloadScheduler::writeCallback(char* ptr, size_t size, size_t nmemb,
+                                           void* userData)
+{
+    Transfer* t = reinterpret_cast<Transfer*>(userData);
+
+    return std::fwrite(ptr, size, nmemb, t->file) * size;
+}
+
+int HttpDownloadScheduler::progressCallback(void* userData, int64_t nTotalDownloadBytes,
+                                            int64_t nDownloadedBytes, int64_t, int64_t)
+{
+    Transfer* t = reinterpret_cast<Transfer*>(userData);
+
+    const HttpRequest::Progress p = {
+        nTotalDownloadBytes > 0,
+        static_cast<size_t>(nTotalDownloadBytes) + t->resumeOffset,
+        static_cast<size_t>(nDownloadedBytes) + t->resumeOffset
+    };
+    // Return a non-zero value to cancel the transfer
+    return t->download.onProgress(p) ? 0 : 1;
+}
+
+HttpDownloadScheduler::HttpDownloadScheduler(int maxConnections)
+    : _maxConnections(maxConnections)
+{
+    ghoul_assert(maxConnections > 0, "maxConnections must be positive");
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    _multiHandle = curl_multi_init();
+    _thread = std::thread([this]() { run(); });
+}
+
+HttpDownloadScheduler::~HttpDownloadScheduler() {
+    stop();
+    curl_multi_cleanup(_multiHandle);
+    curl_global_cleanup();
+}
+
+void HttpDownloadScheduler::enqueue(Download download) {
+    ghoul_assert(download.onFinished, "Download must have a finish callback");
+    if (!download.onProgress) {
+        download.onProgress = [](HttpRequest::Progress) { return true; };
+    }
+
+    auto transfer = std::make_unique<Transfer>();
+    transfer->download = std::move(download);
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        if (!_shouldStop) {
+            _queue.push_back(std::move(transfer));
+        }
+    }
+
+    if (transfer) {
+        // The scheduler has already been stopped
+        transfer->download.onFinished(false);
+        return;
+    }
+    _queueCondition.notify_one();
+}
+
+void HttpDownloadScheduler::setMaxConnections(int maxConnections) {
+    ghoul_assert(maxConnections > 0, "maxConnections must be positive");
+    _maxConnections = maxConnections;
+    _queueCondition.notify_one();
+}
+
+int HttpDownloadScheduler::maxConnections() const {
+    return _maxConnections;
+}
+
+void HttpDownloadScheduler::setMaxRetries(int maxRetries) {
+    ghoul_assert(maxRetries >= 0, "maxRetries must not be negative");
+    _maxRetries = maxRetries;
+}
+
+int HttpDownloadScheduler::maxRetries() const {
+    return _maxRetries;
+}
+
+void HttpDownloadScheduler::setInitialRetryDelay(int milliseconds) {
+    ghoul_assert(milliseconds >= 0, "milliseconds must not be negative");
+    _initialRetryDelay = milliseconds;
+}
+
+int HttpDownloadScheduler::initialRetryDelay() const {
+    return _initialRetryDelay;
+}
+
+int HttpDownloadScheduler::nActiveDownloads() const {
+    return _nActiveDownloads;
+}
+
+size_t HttpDownloadScheduler::nQueuedDownloads() const {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    return _queue.size();
+}
+
+void HttpDownloadScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _shouldStop = true;
+    }
+    _queueCondition.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+bool HttpDownloadScheduler::fileHasChecksum(const std::string& path, uint32_t checksum,
+                                            size_t& fileSize)
+{
+    static const std::array<uint32_t, 256> Table = []() {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.good()) {
+        return false;
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    fileSize = 0;
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        const std::streamsize n = file.gcount();
+        for (std::streamsize i = 0; i < n; ++i) {
+            const uint8_t b = static_cast<uint8_t>(buffer[i]);
+            crc = Table[(crc ^ b) & 0xFF] ^ (crc >> 8);
+        }
+        fileSize += static_cast<size_t>(n);
+    }
+    return (crc ^ 0xFFFFFFFF) == checksum;
+}
+
+void HttpDownloadScheduler::run() {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::unique_ptr<Transfer>> newTransfers;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            while (_activeTransfers.empty() && !_shouldStop) {
+                // Sleep until the earliest of the queued transfers may be started
+                Clock::time_point next = Clock::time_point::max();
+                for (const std::unique_ptr<Transfer>& t : _queue) {
+                    next = std::min(next, t->retryTime);
+                }
+                if (next <= Clock::now()) {
+                    break;
+                }
+                if (next == Clock::time_point::max()) {
+                    _queueCondition.wait(lock);
+                }
+                else {
+                    _queueCondition.wait_until(lock, next);
+                }
+            }
+            if (_shouldStop) {
+                break;
+            }
+
+            // Transfers that are waiting for a retry keep their place in the queue
+            const Clock::time_point now = Clock::now();
+            const size_t maxConnections = static_cast<size_t>(_maxConnections);
+            auto it = _queue.begin();
+            while (_activeTransfers.size() + newTransfers.size() < maxConnections &&
+                   it != _queue.end())
+            {
+                if ((*it)->retryTime <= now) {
+                    newTransfers.push_back(std::move(*it));
+                    it = _queue.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        // The transfers are started outside of the lock as their callbacks are allowed
+        // to enqueue new downloads
+        for (std::unique_ptr<Transfer>& t : newTransfers) {
+            startTransfer(std::move(t));
+        }
+        newTransfers.clear();
+
+        int nRunning = 0;
+        curl_multi_perform(_multiHandle, &nRunning);
+
+        int nMessages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(_multiHandle, &nMessages)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer); // NOLINT
+            finishTransfer(transfer, msg->data.result);
+        }
+
+        if (!_activeTransfers.empty()) {
+            curl_multi_wait(_multiHandle, nullptr, 0, WaitTimeoutMs, nullptr);
+        }
+    }
+
+    // Everything that is left over is reported as failed
+    while (!_activeTransfers.empty()) {
+        finishTransfer(_activeTransfers.back().get(), CURLE_ABORTED_BY_CALLBACK);
+    }
+    std::deque<std::unique_ptr<Transfer>> queue;
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        queue.swap(_queue);
+    }
+    for (std::unique_ptr<Transfer>& t : queue) {
+        t->download.onFinished(false);
+    }
+}
+
+void HttpDownloadScheduler::startTransfer(std::unique_ptr<Transfer> transfer) {
+    Transfer& t = *transfer;
+
+    // Partial files from earlier attempts or earlier runs are appended to
+    t.file = std::fopen(t.download.destination.c_str(), "ab");
+    if (!t.file) {
+        LERROR(fmt::format("Could not open file {}", t.download.destination));
+        t.download.onFinished(false);
+        return;
+    }
+    std::fseek(t.file, 0, SEEK_END);
+    const long fileSize = std::ftell(t.file);
+    t.resumeOffset = fileSize > 0 ? static_cast<size_t>(fileSize) : 0;
+
+    // Queued downloads might have been cancelled while they were waiting
+    if (!t.download.onProgress({ false, 0, t.resumeOffset })) {
+        std::fclose(t.file);
+        t.download.onFinished(false);
+        return;
+    }
+
+    t.handle = curl_easy_init();
+    if (!t.handle) {
+        std::fclose(t.file);
+        t.download.onFinished(false);
+        return;
+    }
+
+    CURL* h = t.handle;
+    curl_easy_setopt(h, CURLOPT_URL, t.download.url.c_str()); // NOLINT
+    curl_easy_setopt(h, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
+    // Error responses must not end up in the destination file
+    curl_easy_setopt(h, CURLOPT_FAILONERROR, 1L); // NOLINT
+    curl_easy_setopt(h, CURLOPT_PRIVATE, &t); // NOLINT
+
+    curl_easy_setopt(h, CURLOPT_WRITEDATA, &t); // NOLINT
+    curl_easy_setopt(h, CURLOPT_WRITEFUNCTION, writeCallback); // NOLINT
+
+    curl_easy_setopt(h, CURLOPT_NOPROGRESS, 0L); // NOLINT
+    curl_easy_setopt(h, CURLOPT_XFERINFODATA, &t); // NOLINT
+    curl_easy_setopt(h, CURLOPT_XFERINFOFUNCTION, progressCallback); // NOLINT
+
+    curl_easy_setopt(h, CURLOPT_CONNECTTIMEOUT, ConnectTimeoutSeconds); // NOLINT
+    curl_easy_setopt(h, CURLOPT_LOW_SPEED_LIMIT, 1L); // NOLINT
+    curl_easy_setopt(h, CURLOPT_LOW_SPEED_TIME, StallTimeSeconds); // NOLINT
+
+    if (t.resumeOffset > 0) {
+        const curl_off_t offset = static_cast<curl_off_t>(t.resumeOffset);
+        curl_easy_setopt(h, CURLOPT_RESUME_FROM_LARGE, offset); // NOLINT
+    }
+
+    curl_multi_add_handle(_multiHandle, h);
+    _activeTransfers.push_back(std::move(transfer));
+    ++_nActiveDownloads;
+}
+
+void HttpDownloadScheduler::finishTransfer(Transfer* transfer, int result) {
+    auto it = std::find_if(
+        _activeTransfers.begin(),
+        _activeTransfers.end(),
+        [transfer](const std::unique_ptr<Transfer>& t) { return t.get() == transfer; }
+    );
+    ghoul_assert(it != _activeTransfers.end(), "Transfer was not active");
+    std::unique_ptr<Transfer> t = std::move(*it);
+    _activeTransfers.erase(it);
+    --_nActiveDownloads;
+
+    long responseCode = 0;
+    curl_easy_getinfo(t->handle, CURLINFO_RESPONSE_CODE, &responseCode); // NOLINT
+    curl_multi_remove_handle(_multiHandle, t->handle);
+    curl_easy_cleanup(t->handle);
+    t->handle = nullptr;
+    if (t->file) {
+        std::fclose(t->file);
+        t->file = nullptr;
+    }
+
+    const CURLcode code = static_cast<CURLcode>(result);
+    if (code == CURLE_ABORTED_BY_CALLBACK) {
+        // Cancelled downloads keep their partial file so that they can be resumed
+        t->download.onFinished(false);
+        return;
+    }
+
+    std::string error;
+    // Restarting from scratch is not a sign of an overloaded server, so it is retried
+    // right away instead of backing off
+    bool isRestart = false;
+    if (code == CURLE_OK) {
+        size_t fileSize = 0;
+        const bool isValid = !t->download.hasChecksum ||
+            fileHasChecksum(t->download.destination, t->download.checksum, fileSize);
+        if (isValid) {
+            t->download.onFinished(true);
+            return;
+        }
+        // The file is corrupt, which can also be caused by resuming a partial file
+        // that belongs to a different version of the file, so we start over
+        error = "Checksum mismatch";
+        std::remove(t->download.destination.c_str());
+        isRestart = true;
+    }
+    else {
+        error = curl_easy_strerror(code);
+        if (code == CURLE_RANGE_ERROR ||
+            responseCode == StatusCodeRangeNotSatisfiable)
+        {
+            // Either the server does not support byte ranges or the partial file does
+            // not belong to the file on the server; in both cases we have to start over
+            std::remove(t->download.destination.c_str());
+            isRestart = true;
+        }
+    }
+
+    ++t->nAttempts;
+    if (t->nAttempts > _maxRetries) {
+        LWARNING(fmt::format("Failed to download {}: {}", t->download.url, error));
+        t->download.onFinished(false);
+        return;
+    }
+
+    // Back off exponentially so that a server that is temporarily unavailable or
+    // overloaded is not hammered with requests
+    const int exponent = std::min(t->nAttempts - 1, 16);
+    const int delay = isRestart ?
+        0 :
+        static_cast<int>(std::min<int64_t>(
+            static_cast<int64_t>(_initialRetryDelay) << exponent,
+            MaxRetryDelay
+        ));
+    t->retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+
+    LDEBUG(fmt::format(
+        "Retrying download of {} in {} ms ({}/{}): {}",
+        t->download.url, delay, t->nAttempts, _maxRetries, error
+    ));
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    _queue.push_back(std::move(t));
+}
+
+} // namespace openspace
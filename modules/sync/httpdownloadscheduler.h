@@ -0,0 +1,145 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___HTTPDOWNLOADSCHEDULER___H__
+#define __OPENSPACE_MODULE_SYNC___HTTPDOWNLOADSCHEDULER___H__
+
+#include <openspace/util/httprequest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The HttpDownloadScheduler downloads files using a single curl multi handle that is
+ * driven by one I/O thread. At most #maxConnections transfers are active at the same
+ * time, all other downloads wait in the order in which they were enqueued. If the
+ * destination file already exists, the download is resumed from the end of the file
+ * using an HTTP Range request; if the server does not honor the range, the file is
+ * downloaded again from the beginning. Failed transfers are retried, and thus resumed,
+ * up to #maxRetries times before they are reported as failed. The delay before a retry
+ * starts at #initialRetryDelay and doubles with every further attempt of the same
+ * download.
+ */
+class HttpDownloadScheduler {
+public:
+    struct Download {
+        std::string url;
+        /// The file that is written to. Its directory has to exist
+        std::string destination;
+        /// Called from the I/O thread, returning \c false cancels the download
+        std::function<bool(HttpRequest::Progress)> onProgress;
+        /// Called from the I/O thread exactly once when the download has finished
+        std::function<void(bool success)> onFinished;
+        /**
+         * If this is \c true, a downloaded file whose CRC-32 does not match the
+         * \c checksum is removed and the download is retried
+         */
+        bool hasChecksum = false;
+        uint32_t checksum = 0;
+    };
+
+    static constexpr const int DefaultMaxConnections = 8;
+    static constexpr const int DefaultMaxRetries = 3;
+    static constexpr const int DefaultInitialRetryDelay = 1000;
+    static constexpr const int MaxRetryDelay = 60000;
+
+    explicit HttpDownloadScheduler(int maxConnections = DefaultMaxConnections);
+    ~HttpDownloadScheduler();
+
+    /**
+     * Adds the \p download to the end of the queue. The \c onFinished callback of the
+     * \p download will be called even if it is cancelled or the scheduler is stopped.
+     */
+    void enqueue(Download download);
+
+    void setMaxConnections(int maxConnections);
+    int maxConnections() const;
+
+    void setMaxRetries(int maxRetries);
+    int maxRetries() const;
+
+    /// Sets the delay before the first retry of a failed download in milliseconds
+    void setInitialRetryDelay(int milliseconds);
+    int initialRetryDelay() const;
+
+    int nActiveDownloads() const;
+    size_t nQueuedDownloads() const;
+
+    /**
+     * Stops the I/O thread. All downloads that have not finished yet are reported as
+     * failed; their partial files are kept so that they can be resumed later.
+     */
+    void stop();
+
+    /**
+     * Returns \c true if the file at \p path exists and its CRC-32 is \p checksum. The
+     * size of the file is written to \p fileSize.
+     */
+    static bool fileHasChecksum(const std::string& path, uint32_t checksum,
+        size_t& fileSize);
+
+private:
+    struct Transfer;
+
+    void run();
+    void startTransfer(std::unique_ptr<Transfer> transfer);
+    void finishTransfer(Transfer* transfer, int result);
+
+    static size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+    static int progressCallback(void* userData, int64_t nTotalDownloadBytes,
+        int64_t nDownloadedBytes, int64_t nTotalUploadBytes, int64_t nUploadBytes);
+
+    /// The CURLM handle, which is typedef'ed to void by curl
+    void* _multiHandle = nullptr;
+
+    /// Only accessed from the I/O thread
+    std::vector<std::unique_ptr<Transfer>> _activeTransfers;
+
+    mutable std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::deque<std::unique_ptr<Transfer>> _queue;
+    bool _shouldStop = false;
+
+    std::atomic_int _maxConnections;
+    std::atomic_int _maxRetries = DefaultMaxRetries;
+    std::atomic_int _initialRetryDelay = DefaultInitialRetryDelay;
+    std::atomic_int _nActiveDownloads = 0;
+
+    std::thread _thread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SYNC___HTTPDOWNLOADSCHEDULER___H__
@@ -34,6 +34,7 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/resourcesynchronization.h>
+#include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
@@ -44,6 +45,8 @@ namespace {
     constexpr const char* KeyHttpSynchronizationRepositories =
         "HttpSynchronizationRepositories";
     constexpr const char* KeySynchronizationRoot = "SynchronizationRoot";
+    constexpr const char* KeyHttpSynchronizationMaxConnections =
+        "HttpSynchronizationMaxConnections";
 } // namespace
 
 namespace openspace {
@@ -61,6 +64,25 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
         }
     }
 
+    if (configuration.hasKey(KeyHttpSynchronizationMaxConnections)) {
+        const int maxConnections = static_cast<int>(
+            configuration.value<double>(KeyHttpSynchronizationMaxConnections)
+        );
+        if (maxConnections > 0) {
+            _httpDownloadScheduler.setMaxConnections(maxConnections);
+        }
+        else {
+            LWARNINGC(
+                "SyncModule",
+                fmt::format(
+                    "{} has to be positive. Using {} connections",
+                    KeyHttpSynchronizationMaxConnections,
+                    _httpDownloadScheduler.maxConnections()
+                )
+            );
+        }
+    }
+
     if (configuration.hasKey(KeySynchronizationRoot)) {
         _synchronizationRoot = configuration.value<std::string>(KeySynchronizationRoot);
     } else {
@@ -82,7 +104,8 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
             return new HttpSynchronization(
                 dictionary,
                 _synchronizationRoot,
-                _synchronizationRepositories
+                _synchronizationRepositories,
+                _httpDownloadScheduler
             );
         }
     );
@@ -117,12 +140,16 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     // Deinitialize
     OsEng.registerModuleCallback(
         OpenSpaceEngine::CallbackOption::Deinitialize,
-        [&]() { _torrentClient.deinitialize(); }
+        [&]() {
+            _torrentClient.deinitialize();
+            _httpDownloadScheduler.stop();
+        }
     );
 }
 
 void SyncModule::internalDeinitialize() {
     _torrentClient.deinitialize();
+    _httpDownloadScheduler.stop();
 }
 
 std::string SyncModule::synchronizationRoot() const {
@@ -133,6 +160,10 @@ void SyncModule::addHttpSynchronizationRepository(std::string repository) {
     _synchronizationRepositories.push_back(std::move(repository));
 }
 
+HttpDownloadScheduler& SyncModule::httpDownloadScheduler() {
+    return _httpDownloadScheduler;
+}
+
 std::vector<std::string> SyncModule::httpSynchronizationRepositories() const {
     return _synchronizationRepositories;
 }
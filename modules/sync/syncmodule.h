@@ -27,6 +27,7 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/sync/httpdownloadscheduler.h>
 #include <modules/sync/torrentclient.h>
 
 namespace openspace {
@@ -43,6 +44,7 @@ public:
     std::vector<std::string> httpSynchronizationRepositories() const;
 
     TorrentClient& torrentClient();
+    HttpDownloadScheduler& httpDownloadScheduler();
 
     std::vector<documentation::Documentation> documentations() const override;
 
@@ -52,6 +54,7 @@ protected:
 
 private:
     TorrentClient _torrentClient;
+    HttpDownloadScheduler _httpDownloadScheduler;
     std::vector<std::string> _synchronizationRepositories;
     std::string _synchronizationRoot;
 };
@@ -24,6 +24,7 @@
 
 #include <modules/sync/syncs/httpsynchronization.h>
 
+#include <modules/sync/httpdownloadscheduler.h>
 #include <modules/sync/syncmodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
@@ -32,8 +33,12 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <numeric>
+#include <mutex>
+#include <sstream>
 
 namespace {
     constexpr const char* KeyIdentifier = "Identifier";
@@ -45,6 +50,47 @@ namespace {
     constexpr const char* QueryKeyFileVersion = "file_version";
     constexpr const char* QueryKeyApplicationVersion = "application_version";
     constexpr const int ApplicationVersion = 1;
+
+    struct FileEntry {
+        std::string url;
+        std::string destination;
+        // The optional checksum of the file. If it is present, files with a matching
+        // checksum are not downloaded again and downloaded files are verified
+        bool hasChecksum = false;
+        uint32_t checksum = 0;
+    };
+
+    // Each line of the file list contains the URL of a file, optionally followed by the
+    // CRC-32 checksum of the file as a hexadecimal number
+    std::vector<FileEntry> parseFileList(const std::vector<char>& buffer,
+                                         const std::string& directory)
+    {
+        std::vector<FileEntry> entries;
+
+        std::istringstream fileList(std::string(buffer.begin(), buffer.end()));
+        std::string line;
+        while (std::getline(fileList, line)) {
+            std::istringstream lineStream(line);
+            FileEntry entry;
+            if (!(lineStream >> entry.url)) {
+                continue;
+            }
+            std::string checksum;
+            if (lineStream >> checksum) {
+                char* end = nullptr;
+                const unsigned long value = std::strtoul(checksum.c_str(), &end, 16);
+                entry.hasChecksum = (*end == '\0');
+                entry.checksum = static_cast<uint32_t>(value);
+            }
+
+            const size_t lastSlash = entry.url.find_last_of('/');
+            entry.destination = directory +
+                                ghoul::filesystem::FileSystem::PathSeparator +
+                                entry.url.substr(lastSlash + 1);
+            entries.push_back(std::move(entry));
+        }
+        return entries;
+    }
 } // namespace
 
 namespace openspace {
@@ -73,11 +119,12 @@ documentation::Documentation HttpSynchronization::Documentation() {
 
 HttpSynchronization::HttpSynchronization(const ghoul::Dictionary& dict,
                                          const std::string& synchronizationRoot,
-                               const std::vector<std::string>& synchronizationRepositories
-)
+                                         const std::vector<std::string>& repositories,
+                                         HttpDownloadScheduler& scheduler)
     : openspace::ResourceSynchronization(dict)
     , _synchronizationRoot(synchronizationRoot)
-    , _synchronizationRepositories(synchronizationRepositories)
+    , _synchronizationRepositories(repositories)
+    , _scheduler(scheduler)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -195,100 +242,133 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
         return false;
     }
 
-    const std::vector<char>& buffer = fileListDownload.downloadedData();
+    const std::string directoryName = directory();
+    std::vector<FileEntry> files = parseFileList(
+        fileListDownload.downloadedData(),
+        directoryName
+    );
+
     _nSynchronizedBytes = 0;
     _nTotalBytes = 0;
     _nTotalBytesKnown = false;
 
-    std::istringstream fileList(std::string(buffer.begin(), buffer.end()));
-
-    std::string line;
-
-    std::unordered_map<std::string, size_t> fileSizes;
-    std::mutex fileSizeMutex;
-    std::atomic_bool startedAllDownloads(false);
-    std::atomic_size_t nDownloads(0);
-
-    std::vector<std::unique_ptr<AsyncHttpFileDownload>> downloads;
-
-    while (fileList >> line) {
-        size_t lastSlash = line.find_last_of('/');
-        std::string filename = line.substr(lastSlash + 1);
-
-        std::string fileDestination = directory() +
-            ghoul::filesystem::FileSystem::PathSeparator +
-            filename + TempSuffix;
-
-        downloads.push_back(std::make_unique<AsyncHttpFileDownload>(
-            line, fileDestination, HttpFileDownload::Overwrite::Yes));
-
-        auto& fileDownload = downloads.back();
+    FileSys.createDirectory(directoryName, ghoul::filesystem::FileSystem::Recursive::Yes);
 
-        ++nDownloads;
+    // Files whose checksum matches the one in the file list are already up to date
+    std::vector<const FileEntry*> downloads;
+    size_t nUnchangedBytes = 0;
+    for (const FileEntry& file : files) {
+        size_t fileSize = 0;
+        const bool isUnchanged = file.hasChecksum &&
+            HttpDownloadScheduler::fileHasChecksum(
+                file.destination,
+                file.checksum,
+                fileSize
+            );
+        if (isUnchanged) {
+            nUnchangedBytes += fileSize;
+        }
+        else {
+            downloads.push_back(&file);
+        }
+    }
+    if (downloads.size() < files.size()) {
+        LDEBUGC(
+            "HttpSynchronization",
+            fmt::format(
+                "{}: Skipping {} unchanged files",
+                _identifier, files.size() - downloads.size()
+            )
+        );
+    }
+    _nSynchronizedBytes = nUnchangedBytes;
+    if (downloads.empty()) {
+        _nTotalBytes = nUnchangedBytes;
+        _nTotalBytesKnown = true;
+        return true;
+    }
 
-        fileDownload->onProgress(
-            [this, line, &fileSizes, &fileSizeMutex,
-             &startedAllDownloads, &nDownloads](HttpRequest::Progress p)
+    // The state is shared with the callbacks, which are called from the scheduler's
+    // thread, so all of it is guarded by the mutex
+    struct State {
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t nRemaining;
+        std::vector<HttpRequest::Progress> progress;
+        size_t nTotalBytesKnown = 0;
+        std::vector<bool> succeeded;
+    } state;
+    state.nRemaining = downloads.size();
+    state.progress.resize(downloads.size());
+    state.succeeded.resize(downloads.size(), false);
+
+    for (size_t i = 0; i < downloads.size(); ++i) {
+        HttpDownloadScheduler::Download download;
+        download.url = downloads[i]->url;
+        download.destination = downloads[i]->destination + TempSuffix;
+        // The scheduler verifies the downloaded file and retries corrupt downloads
+        download.hasChecksum = downloads[i]->hasChecksum;
+        download.checksum = downloads[i]->checksum;
+        download.onProgress = [this, i, nUnchangedBytes, &state](HttpRequest::Progress p)
         {
-            if (p.totalBytesKnown) {
-                std::lock_guard<std::mutex> guard(fileSizeMutex);
-                fileSizes[line] = p.totalBytes;
-
-                if (!_nTotalBytesKnown && startedAllDownloads &&
-                    fileSizes.size() == nDownloads)
-                {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            HttpRequest::Progress& previous = state.progress[i];
+            _nSynchronizedBytes += p.downloadedBytes - previous.downloadedBytes;
+            if (p.totalBytesKnown && !previous.totalBytesKnown) {
+                ++state.nTotalBytesKnown;
+                _nTotalBytes += p.totalBytes;
+                if (state.nTotalBytesKnown == state.progress.size()) {
+                    _nTotalBytes += nUnchangedBytes;
                     _nTotalBytesKnown = true;
-                    _nTotalBytes = std::accumulate(
-                        fileSizes.begin(),
-                        fileSizes.end(),
-                        size_t(0),
-                        [](size_t a, auto b) { return a + b.second; }
-                    );
                 }
             }
+            else if (!p.totalBytesKnown) {
+                // Keep the known total in case the server stops reporting it
+                p.totalBytesKnown = previous.totalBytesKnown;
+                p.totalBytes = previous.totalBytes;
+            }
+            previous = p;
             return !_shouldCancel;
-        });
+        };
+        download.onFinished = [i, &state](bool success) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.succeeded[i] = success;
+            --state.nRemaining;
+            state.finished.notify_one();
+        };
+        _scheduler.enqueue(std::move(download));
+    }
 
-        fileDownload->start(opt);
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.finished.wait(lock, [&state]() { return state.nRemaining == 0; });
     }
-    startedAllDownloads = true;
 
     bool failed = false;
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-        d->wait();
-        if (d->hasSucceeded()) {
-            // If we are forcing the override, we download to a temporary file
-            // first, so when we are done here, we need to rename the file to the
-            // original name
-
-            const std::string& tempName = d->destination();
-            std::string originalName = tempName.substr(
-                0,
-                tempName.size() - strlen(TempSuffix)
-            );
+    for (size_t i = 0; i < downloads.size(); ++i) {
+        if (!state.succeeded[i]) {
+            // The partial file is kept so that the next attempt can resume it
+            failed = true;
+            continue;
+        }
 
-            FileSys.deleteFile(originalName);
-            int success = rename(tempName.c_str(), originalName.c_str());
-            if (success != 0) {
-                LERRORC(
-                    "HTTPSynchronization",
-                    fmt::format("Error renaming file {} to {}", tempName, originalName)
-                );
+        const FileEntry& file = *downloads[i];
+        const std::string tempName = file.destination + TempSuffix;
+
+        // We download to a temporary file first, so when we are done here, we need to
+        // rename the file to the original name
+        FileSys.deleteFile(file.destination);
+        int success = rename(tempName.c_str(), file.destination.c_str());
+        if (success != 0) {
+            LERRORC(
+                "HTTPSynchronization",
+                fmt::format("Error renaming file {} to {}", tempName, file.destination)
+            );
 
-                failed = true;
-            }
-        }
-        else {
             failed = true;
         }
     }
-    if (!failed) {
-        return true;
-    }
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-        d->cancel();
-    }
-    return false;
+    return !failed;
 }
 
 } // namespace openspace
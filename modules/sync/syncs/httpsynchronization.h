@@ -32,11 +32,14 @@
 
 namespace openspace {
 
+class HttpDownloadScheduler;
+
 class HttpSynchronization : public ResourceSynchronization {
 public:
     HttpSynchronization(const ghoul::Dictionary& dict,
         const std::string& synchronizationRoot,
-        const std::vector<std::string>& synchronizationRepositories);
+        const std::vector<std::string>& synchronizationRepositories,
+        HttpDownloadScheduler& scheduler);
 
     virtual ~HttpSynchronization();
 
@@ -66,6 +69,7 @@ private:
     int _version = -1;
     std::string _synchronizationRoot;
     std::vector<std::string> _synchronizationRepositories;
+    HttpDownloadScheduler& _scheduler;
 
     std::thread _syncThread;
 };
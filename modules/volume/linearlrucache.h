@@ -45,6 +45,8 @@ public:
 
     void evict();
     size_t capacity() const;
+    void setCapacity(size_t capacity);
+    size_t size() const;
 
 private:
     void insert(size_t key, const ValueType& value);
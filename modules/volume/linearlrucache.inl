@@ -38,7 +38,7 @@ bool LinearLruCache<ValueType>::has(size_t key) const {
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::set(size_t key, ValueType value) {
-    auto prev = _cache[key];
+    auto& prev = _cache[key];
     if (prev.first != nullptr) {
         prev.first = value;
         const std::list<size_t>::iterator trackerIter = prev.second;
@@ -73,9 +73,25 @@ size_t LinearLruCache<ValueType>::capacity() const {
     return _capacity;
 }
 
+template <typename ValueType>
+void LinearLruCache<ValueType>::setCapacity(size_t capacity) {
+    _capacity = capacity;
+    while (_tracker.size() > _capacity) {
+        evict();
+    }
+}
+
+template <typename ValueType>
+size_t LinearLruCache<ValueType>::size() const {
+    return _tracker.size();
+}
+
 template <typename ValueType>
 void LinearLruCache<ValueType>::insert(size_t key, const ValueType& value) {
-    if (_tracker.size() == _capacity) {
+    if (_capacity == 0) {
+        return;
+    }
+    if (_tracker.size() >= _capacity) {
         evict();
     }
     auto iter = _tracker.insert(_tracker.end(), key);
@@ -43,6 +43,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableTimeVaryingVolume";
@@ -63,6 +64,9 @@ namespace {
     constexpr const char* KeyMaxValue = "MaxValue";
     constexpr const char* KeyTime = "Time";
     constexpr const char* KeyUnit = "VisUnit";
+    constexpr const char* KeyCpuMemoryBudget = "CpuMemoryBudget";
+    constexpr const char* KeyGpuMemoryBudget = "GpuMemoryBudget";
+    constexpr const char* KeyPrefetchTimesteps = "PrefetchTimesteps";
     constexpr const float SecondsInOneDay = 60 * 60 * 24;
 
     const openspace::properties::Property::PropertyInfo StepSizeInfo = {
@@ -136,6 +140,27 @@ namespace {
         "Radius upper bound",
         "" // @TODO Missing documentation
     };
+
+    const openspace::properties::Property::PropertyInfo CpuMemoryBudgetInfo = {
+        "cpuMemoryBudget",
+        "CPU Memory Budget (MB)",
+        "The maximum amount of memory used for timesteps that are kept in RAM. The "
+        "least recently used timesteps are evicted when the budget is exceeded."
+    };
+
+    const openspace::properties::Property::PropertyInfo GpuMemoryBudgetInfo = {
+        "gpuMemoryBudget",
+        "GPU Memory Budget (MB)",
+        "The maximum amount of video memory used for timestep textures. The least "
+        "recently used textures are evicted when the budget is exceeded."
+    };
+
+    const openspace::properties::Property::PropertyInfo PrefetchTimestepsInfo = {
+        "prefetchTimesteps",
+        "Prefetched timesteps",
+        "The number of timesteps ahead of the current one, in the direction that time "
+        "is moving, that are loaded in the background before they are needed."
+    };
 } // namespace
 
 namespace openspace::volume {
@@ -171,6 +196,24 @@ namespace openspace::volume {
                 Optional::No,
                 "Specifies the number of seconds to show the the last timestep after its "
                 "actual time"
+            },
+            {
+                KeyCpuMemoryBudget,
+                new IntVerifier,
+                Optional::Yes,
+                CpuMemoryBudgetInfo.description
+            },
+            {
+                KeyGpuMemoryBudget,
+                new IntVerifier,
+                Optional::Yes,
+                GpuMemoryBudgetInfo.description
+            },
+            {
+                KeyPrefetchTimesteps,
+                new IntVerifier,
+                Optional::Yes,
+                PrefetchTimestepsInfo.description
             }
         }
     };
@@ -238,6 +281,9 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
     , _currentTimestep(CurrentTimeStepInfo, 0, 0, 256)
+    , _cpuMemoryBudget(CpuMemoryBudgetInfo, 1024, 16, 65536)
+    , _gpuMemoryBudget(GpuMemoryBudgetInfo, 512, 16, 16384)
+    , _nPrefetchTimesteps(PrefetchTimestepsInfo, 4, 0, 64)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -279,9 +325,30 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
         );
         _gridType = static_cast<std::underlying_type_t<VolumeGridType>>(gridType);
     }
+
+    if (dictionary.hasKey(KeyCpuMemoryBudget)) {
+        _cpuMemoryBudget = static_cast<int>(dictionary.value<double>(KeyCpuMemoryBudget));
+    }
+    if (dictionary.hasKey(KeyGpuMemoryBudget)) {
+        _gpuMemoryBudget = static_cast<int>(dictionary.value<double>(KeyGpuMemoryBudget));
+    }
+    if (dictionary.hasKey(KeyPrefetchTimesteps)) {
+        _nPrefetchTimesteps = static_cast<int>(
+            dictionary.value<double>(KeyPrefetchTimesteps)
+        );
+    }
 }
 
-RenderableTimeVaryingVolume::~RenderableTimeVaryingVolume() {}
+RenderableTimeVaryingVolume::~RenderableTimeVaryingVolume() {
+    if (_loaderThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_loaderMutex);
+            _shouldStopLoading = true;
+        }
+        _loaderCondition.notify_one();
+        _loaderThread.join();
+    }
+}
 
 void RenderableTimeVaryingVolume::initializeGL() {
     using RawPath = ghoul::filesystem::Directory::RawPath;
@@ -304,44 +371,24 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        std::string path = FileSys.pathByAppendingComponent(
-            _sourceDirectory, t.baseName
-        ) + ".rawvolume";
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read();
-
-        float min = t.metadata.minValue;
-        float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (int i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
+    // The timesteps are read lazily on the loader thread and only the ones within the
+    // memory budgets are kept resident
+    for (const std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        const glm::uvec3& dims = p.second.metadata.dimensions;
+        const size_t size = static_cast<size_t>(dims.x) * dims.y * dims.z * sizeof(float);
+        _timestepSize = std::max(_timestepSize, size);
     }
+    _ramCache = std::make_unique<LinearLruCache<std::shared_ptr<RawVolume<float>>>>(
+        1,
+        _volumeTimesteps.size()
+    );
+    _gpuCache = std::make_unique<
+        LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>>
+    >(1, _volumeTimesteps.size());
+    _hasFailedToLoad = std::vector<bool>(_volumeTimesteps.size(), false);
+    updateCacheCapacities();
+    _shouldStopLoading = false;
+    _loaderThread = std::thread([this]() { loaderLoop(); });
 
     //_transferFunction->initialize();
     _clipPlanes->initialize();
@@ -385,6 +432,12 @@ void RenderableTimeVaryingVolume::initializeGL() {
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
     addProperty(_gridType);
+    addProperty(_cpuMemoryBudget);
+    addProperty(_gpuMemoryBudget);
+    addProperty(_nPrefetchTimesteps);
+
+    _cpuMemoryBudget.onChange([this]() { updateCacheCapacities(); });
+    _gpuMemoryBudget.onChange([this]() { updateCacheCapacities(); });
 
     _raycaster->setGridType(static_cast<VolumeGridType>(_gridType.value()));
     _gridType.onChange([this] {
@@ -412,8 +465,6 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     Timestep t;
     t.metadata = metadata;
     t.baseName = ghoul::filesystem::File(path).baseName();
-    t.inRam = false;
-    t.onGpu = false;
 
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
@@ -487,44 +538,28 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     }
 }
 
-void RenderableTimeVaryingVolume::update(const UpdateData&) {
+void RenderableTimeVaryingVolume::update(const UpdateData& data) {
     if (_raycaster) {
+        const double currentTime = data.time.j2000Seconds();
+        if (currentTime != _previousTime) {
+            _playbackDirection = (currentTime > _previousTime) ? 1 : -1;
+            _previousTime = currentTime;
+        }
+
         Timestep* t = currentTimestep();
-        _currentTimestep = timestepIndex(t);
-
-        // Set scale and translation matrices:
-        // The original data cube is a unit cube centered in 0
-        // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
-        if (t && t->texture) {
-            if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
-                glm::dvec3 scale = t->metadata.upperDomainBound -
-                    t->metadata.lowerDomainBound;
-                glm::dvec3 translation =
-                    (t->metadata.lowerDomainBound + t->metadata.upperDomainBound) * 0.5f;
-
-                glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), translation);
-                glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
-                modelTransform = modelTransform * scaleMatrix;
-                _raycaster->setModelTransform(glm::mat4(modelTransform));
-            } else {
-                // The diameter is two times the maximum radius.
-                // No translation: the sphere is always centered in (0, 0, 0)
-                _raycaster->setModelTransform(
-                    glm::scale(
-                        glm::dmat4(1.0),
-                        glm::dvec3(2.0 * t->metadata.upperDomainBound[0])
-                    )
-                );
-            }
-            _raycaster->setVolumeTexture(t->texture);
-            //_transferFunctionHandler->setUnit(t->metadata.valueUnit);
-            //_transferFunctionHandler->setMinAndMaxValue(
-            //    t->metadata.minValue, t->metadata.maxValue);
+        const int index = timestepIndex(t);
+        _currentTimestep = index;
+
+        updateResidentTimesteps(index);
 
-            //_transferFunctionHandler->setHistogramProperty(t->histogram);
-        } else {
+        if (t && _gpuCache->has(index)) {
+            setRaycasterTimestep(*t, index);
+        }
+        else if (!t) {
             _raycaster->setVolumeTexture(nullptr);
         }
+        // else: keep showing the previous timestep until the current one is resident
+
         _raycaster->setStepSize(_stepSize);
         _raycaster->setOpacity(_opacity);
         _raycaster->setRNormalization(_rNormalization);
@@ -543,10 +578,247 @@ bool RenderableTimeVaryingVolume::isReady() const {
 }
 
 void RenderableTimeVaryingVolume::deinitializeGL() {
+    if (_loaderThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_loaderMutex);
+            _shouldStopLoading = true;
+        }
+        _loaderCondition.notify_one();
+        _loaderThread.join();
+    }
+    _loadRequests.clear();
+    _loadedTimesteps.clear();
+    _ramCache = nullptr;
+    _gpuCache = nullptr;
+    _hasFailedToLoad.clear();
+
     if (_raycaster) {
         OsEng.renderEngine().raycasterManager().detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
     }
 }
 
+void RenderableTimeVaryingVolume::updateCacheCapacities() {
+    if (!_ramCache || !_gpuCache || _timestepSize == 0) {
+        return;
+    }
+    // The current timestep is always allowed to be resident, even if it alone exceeds
+    // the budget
+    const size_t cpuBudget = static_cast<size_t>(_cpuMemoryBudget) * 1024 * 1024;
+    const size_t gpuBudget = static_cast<size_t>(_gpuMemoryBudget) * 1024 * 1024;
+    _ramCache->setCapacity(std::max<size_t>(cpuBudget / _timestepSize, 1));
+    _gpuCache->setCapacity(std::max<size_t>(gpuBudget / _timestepSize, 1));
+}
+
+void RenderableTimeVaryingVolume::updateResidentTimesteps(int currentIndex) {
+    std::vector<LoadedTimestep> loaded;
+    {
+        std::lock_guard<std::mutex> lock(_loaderMutex);
+        loaded.swap(_loadedTimesteps);
+    }
+    for (LoadedTimestep& l : loaded) {
+        Timestep* t = timestepFromIndex(l.index);
+        if (t && l.rawVolume) {
+            t->histogram = std::move(l.histogram);
+            _ramCache->set(l.index, std::move(l.rawVolume));
+        }
+        else {
+            // Don't retry a timestep that is missing or broken on disk every frame
+            _hasFailedToLoad[l.index] = true;
+        }
+    }
+
+    if (currentIndex < 0) {
+        std::lock_guard<std::mutex> lock(_loaderMutex);
+        _loadRequests.clear();
+        return;
+    }
+
+    // The current timestep followed by the ones that time is moving towards. The window
+    // is limited by the capacities so that the prefetched timesteps do not evict the
+    // current one, or each other
+    const int nTimesteps = static_cast<int>(_volumeTimesteps.size());
+    const int nRam = static_cast<int>(_ramCache->capacity());
+    const int nGpu = static_cast<int>(_gpuCache->capacity());
+    const int nAhead = std::min(_nPrefetchTimesteps.value(), nRam - 1);
+    std::vector<int> wanted;
+    for (int i = 0; i <= nAhead; ++i) {
+        const int index = currentIndex + i * _playbackDirection;
+        if (index < 0 || index >= nTimesteps) {
+            break;
+        }
+        wanted.push_back(index);
+    }
+
+    // Keep the wanted timesteps as the most recently used ones, with the current
+    // timestep being the most recent
+    for (auto it = wanted.rbegin(); it != wanted.rend(); ++it) {
+        if (_ramCache->has(*it)) {
+            _ramCache->use(*it);
+        }
+    }
+
+    // Upload at most one texture per frame to bound the stall, preferring the current
+    // timestep. Prefetched uploads stay within the texture budget
+    for (int i = 0; i < static_cast<int>(wanted.size()) && i < nGpu; ++i) {
+        const int index = wanted[i];
+        if (_gpuCache->has(index)) {
+            continue;
+        }
+        if (_ramCache->has(index)) {
+            uploadTimestep(index);
+            break;
+        }
+        if (i == 0) {
+            // The current timestep is not in RAM yet, so there is nothing to upload
+            break;
+        }
+    }
+    for (auto it = wanted.rbegin(); it != wanted.rend(); ++it) {
+        if (_gpuCache->has(*it)) {
+            _gpuCache->use(*it);
+        }
+    }
+
+    std::vector<LoadRequest> requests;
+    for (int index : wanted) {
+        if (_ramCache->has(index) || _gpuCache->has(index) || _hasFailedToLoad[index]) {
+            continue;
+        }
+        const Timestep* t = timestepFromIndex(index);
+        std::string path = FileSys.pathByAppendingComponent(
+            _sourceDirectory, t->baseName
+        ) + ".rawvolume";
+        requests.push_back({ index, std::move(path), t->metadata });
+    }
+
+    {
+        // Replace the outstanding requests, as they might not be needed anymore
+        std::lock_guard<std::mutex> lock(_loaderMutex);
+        _loadRequests.clear();
+        for (LoadRequest& r : requests) {
+            const bool isLoading = (r.index == _indexBeingLoaded);
+            const bool isLoaded = std::any_of(
+                _loadedTimesteps.begin(),
+                _loadedTimesteps.end(),
+                [&r](const LoadedTimestep& l) { return l.index == r.index; }
+            );
+            if (!isLoading && !isLoaded) {
+                _loadRequests.push_back(std::move(r));
+            }
+        }
+    }
+    _loaderCondition.notify_one();
+}
+
+void RenderableTimeVaryingVolume::uploadTimestep(int index) {
+    const Timestep* t = timestepFromIndex(index);
+    std::shared_ptr<RawVolume<float>> volume = _ramCache->get(index);
+
+    std::shared_ptr<ghoul::opengl::Texture> texture =
+        std::make_shared<ghoul::opengl::Texture>(
+            t->metadata.dimensions,
+            ghoul::opengl::Texture::Format::Red,
+            GL_RED,
+            GL_FLOAT,
+            ghoul::opengl::Texture::FilterMode::Linear,
+            ghoul::opengl::Texture::WrappingMode::Clamp
+        );
+
+    texture->setPixelData(
+        reinterpret_cast<void*>(volume->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    texture->uploadTexture();
+    // The voxels might be evicted from RAM while the texture is still in use
+    texture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+
+    _gpuCache->set(index, std::move(texture));
+}
+
+void RenderableTimeVaryingVolume::setRaycasterTimestep(const Timestep& t, int index) {
+    // Set scale and translation matrices:
+    // The original data cube is a unit cube centered in 0
+    // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
+    if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
+        glm::dvec3 scale = t.metadata.upperDomainBound - t.metadata.lowerDomainBound;
+        glm::dvec3 translation =
+            (t.metadata.lowerDomainBound + t.metadata.upperDomainBound) * 0.5f;
+
+        glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), translation);
+        glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
+        modelTransform = modelTransform * scaleMatrix;
+        _raycaster->setModelTransform(glm::mat4(modelTransform));
+    } else {
+        // The diameter is two times the maximum radius.
+        // No translation: the sphere is always centered in (0, 0, 0)
+        _raycaster->setModelTransform(
+            glm::scale(
+                glm::dmat4(1.0),
+                glm::dvec3(2.0 * t.metadata.upperDomainBound[0])
+            )
+        );
+    }
+    _raycaster->setVolumeTexture(_gpuCache->get(index));
+    //_transferFunctionHandler->setUnit(t->metadata.valueUnit);
+    //_transferFunctionHandler->setMinAndMaxValue(
+    //    t->metadata.minValue, t->metadata.maxValue);
+
+    //_transferFunctionHandler->setHistogramProperty(t->histogram);
+}
+
+void RenderableTimeVaryingVolume::loaderLoop() {
+    while (true) {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(_loaderMutex);
+            _indexBeingLoaded = -1;
+            _loaderCondition.wait(lock, [this]() {
+                return _shouldStopLoading || !_loadRequests.empty();
+            });
+            if (_shouldStopLoading) {
+                return;
+            }
+            request = std::move(_loadRequests.front());
+            _loadRequests.pop_front();
+            _indexBeingLoaded = request.index;
+        }
+
+        LoadedTimestep loaded = loadTimestep(request);
+
+        std::lock_guard<std::mutex> lock(_loaderMutex);
+        _loadedTimesteps.push_back(std::move(loaded));
+    }
+}
+
+RenderableTimeVaryingVolume::LoadedTimestep RenderableTimeVaryingVolume::loadTimestep(
+                                                               const LoadRequest& request)
+{
+    LoadedTimestep result = { request.index, nullptr, nullptr };
+    try {
+        RawVolumeReader<float> reader(request.path, request.metadata.dimensions);
+        result.rawVolume = reader.read();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Could not load timestep '{}': {}", request.path, e.message));
+        return result;
+    }
+
+    float min = request.metadata.minValue;
+    float diff = request.metadata.maxValue - request.metadata.minValue;
+    float* data = result.rawVolume->data();
+    for (size_t i = 0; i < result.rawVolume->nCells(); ++i) {
+        data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+    }
+
+    result.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
+    for (size_t i = 0; i < result.rawVolume->nCells(); ++i) {
+        result.histogram->add(data[i]);
+    }
+
+    // TODO: handle normalization properly for different timesteps + transfer function
+
+    return result;
+}
+
 } // namespace openspace::volume
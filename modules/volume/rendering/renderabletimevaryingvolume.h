@@ -30,8 +30,10 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 // #include <modules/volume/rawvolume.h>
  #include <modules/volume/rawvolumemetadata.h>
+#include <modules/volume/linearlrucache.h>
 // #include <modules/volume/rendering/basicvolumeraycaster.h>
 // #include <modules/volume/rendering/volumeclipplanes.h>
 
@@ -41,6 +43,11 @@
 // #include <openspace/util/boxgeometry.h>
 // #include <openspace/util/histogram.h>
 // #include <openspace/rendering/transferfunction.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace openspace {
     class Histogram;
@@ -70,11 +77,21 @@ public:
 private:
     struct Timestep {
         std::string baseName;
-        bool inRam;
-        bool onGpu;
         RawVolumeMetadata metadata;
+        std::shared_ptr<Histogram> histogram;
+    };
+
+    // A timestep that should be read from disk on the loader thread
+    struct LoadRequest {
+        int index;
+        std::string path;
+        RawVolumeMetadata metadata;
+    };
+
+    // A timestep that was read and normalized by the loader thread
+    struct LoadedTimestep {
+        int index;
         std::shared_ptr<RawVolume<float>> rawVolume;
-        std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<Histogram> histogram;
     };
 
@@ -85,6 +102,13 @@ private:
 
     void loadTimestepMetadata(const std::string& path);
 
+    void updateResidentTimesteps(int currentIndex);
+    void updateCacheCapacities();
+    void uploadTimestep(int index);
+    void setRaycasterTimestep(const Timestep& t, int index);
+    void loaderLoop();
+    static LoadedTimestep loadTimestep(const LoadRequest& request);
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
@@ -100,8 +124,29 @@ private:
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
     properties::IntProperty _currentTimestep;
+    properties::IntProperty _cpuMemoryBudget;
+    properties::IntProperty _gpuMemoryBudget;
+    properties::IntProperty _nPrefetchTimesteps;
 
     std::map<double, Timestep> _volumeTimesteps;
+
+    // Resident timesteps, indexed by their position in _volumeTimesteps. Both caches are
+    // only accessed from the main thread
+    std::unique_ptr<LinearLruCache<std::shared_ptr<RawVolume<float>>>> _ramCache;
+    std::unique_ptr<LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>>> _gpuCache;
+    // Size in bytes of the largest timestep, used to turn the budgets into capacities
+    size_t _timestepSize = 0;
+    std::vector<bool> _hasFailedToLoad;
+    int _playbackDirection = 1;
+    double _previousTime = 0.0;
+
+    std::thread _loaderThread;
+    std::mutex _loaderMutex;
+    std::condition_variable _loaderCondition;
+    std::deque<LoadRequest> _loadRequests;
+    std::vector<LoadedTimestep> _loadedTimesteps;
+    int _indexBeingLoaded = -1;
+    bool _shouldStopLoading = false;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
 
     std::shared_ptr<openspace::TransferFunction> _transferFunction;
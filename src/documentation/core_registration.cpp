@@ -34,6 +34,7 @@
 #include <openspace/mission/mission.h>
 #include <openspace/mission/missionmanager.h>
 #include <openspace/network/parallelpeer.h>
+#include <openspace/performance/tracer.h>
 #include <openspace/rendering/dashboard.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
@@ -75,6 +76,7 @@ void registerCoreClasses(scripting::ScriptEngine& engine) {
     engine.addLibrary(Scene::luaLibrary());
     engine.addLibrary(Time::luaLibrary());
     engine.addLibrary(WindowWrapper::luaLibrary());
+    engine.addLibrary(performance::Tracer::luaLibrary());
     engine.addLibrary(interaction::KeyBindingManager::luaLibrary());
     engine.addLibrary(interaction::NavigationHandler::luaLibrary());
     engine.addLibrary(scripting::ScriptScheduler::luaLibrary());
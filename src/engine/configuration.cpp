@@ -86,6 +86,7 @@ namespace {
     constexpr const char* KeyLogEachOpenGLCall = "LogEachOpenGLCall";
     constexpr const char* KeyUseMultithreadedInitialization =
                                                          "UseMultithreadedInitialization";
+    constexpr const char* KeyUseMultithreadedSceneUpdate = "UseMultithreadedSceneUpdate";
     constexpr const char* KeyLoadingScreen = "LoadingScreen";
     constexpr const char* KeyShowMessage = "ShowMessage";
     constexpr const char* KeyShowNodeNames = "ShowNodeNames";
@@ -276,6 +277,7 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyFonts, c.fonts);
     getValue(s, KeyScriptLog, c.scriptLog);
     getValue(s, KeyUseMultithreadedInitialization, c.useMultithreadedInitialization);
+    getValue(s, KeyUseMultithreadedSceneUpdate, c.useMultithreadedSceneUpdate);
     getValue(s, KeyCheckOpenGLState, c.isCheckingOpenGLState);
     getValue(s, KeyLogEachOpenGLCall, c.isLoggingOpenGLCalls);
     getValue(s, KeyShutdownCountdown, c.shutdownCountdown);
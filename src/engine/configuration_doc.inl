@@ -443,6 +443,18 @@ documentation::Documentation Configuration::Documentation = {
             "initialize in parallel. The only use for this value is to disable it for "
             "debugging support."
         },
+        {
+            KeyUseMultithreadedSceneUpdate,
+            new BoolVerifier,
+            Optional::Yes,
+            "This value determines whether the scene graph nodes should be updated on "
+            "multiple threads every frame. Nodes that do not depend on each other are "
+            "updated in parallel, while nodes whose translation, rotation, scale, or "
+            "renderable does not support parallel updates are still updated on the main "
+            "thread. In this mode, the transforms of all nodes are updated before any "
+            "renderable is updated, instead of updating each node's transform and "
+            "renderable together. This value defaults to 'false'."
+        },
         {
             KeyLoadingScreen,
             new TableVerifier({
@@ -40,6 +40,7 @@
 #include <openspace/network/networkengine.h>
 #include <openspace/network/parallelpeer.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/performance/tracer.h>
 #include <openspace/rendering/dashboard.h>
 #include <openspace/rendering/dashboarditem.h>
 #include <openspace/rendering/loadingscreen.h>
@@ -177,6 +178,7 @@ OpenSpaceEngine::OpenSpaceEngine(std::string programName,
         _rootPropertyOwner->addPropertySubOwner(_windowWrapper.get());
     }
     _rootPropertyOwner->addPropertySubOwner(_parallelPeer.get());
+    _rootPropertyOwner->addPropertySubOwner(_syncEngine.get());
     _rootPropertyOwner->addPropertySubOwner(_console.get());
     _rootPropertyOwner->addPropertySubOwner(_dashboard.get());
 
@@ -218,7 +220,7 @@ OpenSpaceEngine::OpenSpaceEngine(std::string programName,
     SpiceManager::initialize();
     TransformationManager::initialize();
 
-    _syncEngine->addSyncable(_scriptEngine.get());
+    _syncEngine->addSyncable(_scriptEngine.get(), "ScriptEngine");
 }
 
 OpenSpaceEngine& OpenSpaceEngine::ref() {
@@ -495,6 +497,8 @@ void OpenSpaceEngine::destroy() {
 void OpenSpaceEngine::initialize() {
     LTRACE("OpenSpaceEngine::initialize(begin)");
 
+    performance::Tracer::setThreadName("Main");
+
     glbinding::Binding::useCurrentContext();
     glbinding::Binding::initialize();
 
@@ -615,16 +619,21 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
         _rootPropertyOwner->removePropertySubOwner(_scene.get());
     }
 
+    unsigned int nAvailableThreads = std::thread::hardware_concurrency();
+    unsigned int nThreads = nAvailableThreads == 0 ? 2 : nAvailableThreads - 1;
+
     std::unique_ptr<SceneInitializer> sceneInitializer;
     if (_configuration->useMultithreadedInitialization) {
-        unsigned int nAvailableThreads = std::thread::hardware_concurrency();
-        unsigned int nThreads = nAvailableThreads == 0 ? 2 : nAvailableThreads - 1;
         sceneInitializer = std::make_unique<MultiThreadedSceneInitializer>(nThreads);
     } else {
         sceneInitializer = std::make_unique<SingleThreadedSceneInitializer>();
     }
 
-    _scene = std::make_unique<Scene>(std::move(sceneInitializer));
+    // The main thread takes part in the update in addition to the update threads
+    const unsigned int nUpdateThreads =
+        _configuration->useMultithreadedSceneUpdate ? nThreads : 0;
+
+    _scene = std::make_unique<Scene>(std::move(sceneInitializer), nUpdateThreads);
     _rootPropertyOwner->addPropertySubOwner(_scene.get());
     _scene->setCamera(std::make_unique<Camera>());
     Camera* camera = _scene->camera();
@@ -713,9 +722,9 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
     _renderEngine->setGlobalBlackOutFactor(0.f);
     _renderEngine->startFading(1, 3.f);
 
-    _syncEngine->addSyncables(_timeManager->getSyncables());
+    _syncEngine->addSyncables(_timeManager->getSyncables(), "Time");
     if (_scene && _scene->camera()) {
-        _syncEngine->addSyncables(_scene->camera()->getSyncables());
+        _syncEngine->addSyncables(_scene->camera()->getSyncables(), "Camera");
     }
 
 #ifdef __APPLE__
@@ -1113,6 +1122,8 @@ void OpenSpaceEngine::initializeGL() {
 void OpenSpaceEngine::preSynchronization() {
     LTRACE("OpenSpaceEngine::preSynchronization(begin)");
 
+    TraceZone("OpenSpaceEngine::preSynchronization");
+
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (OsEng.renderEngine().performanceManager()) {
         perf = std::make_unique<performance::PerformanceMeasurement>(
@@ -1172,6 +1183,8 @@ void OpenSpaceEngine::preSynchronization() {
 void OpenSpaceEngine::postSynchronizationPreDraw() {
     LTRACE("OpenSpaceEngine::postSynchronizationPreDraw(begin)");
 
+    TraceZone("OpenSpaceEngine::postSynchronizationPreDraw");
+
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (OsEng.renderEngine().performanceManager()) {
         perf = std::make_unique<performance::PerformanceMeasurement>(
@@ -1246,6 +1259,8 @@ void OpenSpaceEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& view
 {
     LTRACE("OpenSpaceEngine::render(begin)");
 
+    TraceZone("OpenSpaceEngine::render");
+
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (OsEng.renderEngine().performanceManager()) {
         perf = std::make_unique<performance::PerformanceMeasurement>(
@@ -1272,6 +1287,8 @@ void OpenSpaceEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& view
 void OpenSpaceEngine::drawOverlays() {
     LTRACE("OpenSpaceEngine::drawOverlays(begin)");
 
+    TraceZone("OpenSpaceEngine::drawOverlays");
+
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (OsEng.renderEngine().performanceManager()) {
         perf = std::make_unique<performance::PerformanceMeasurement>(
@@ -1298,6 +1315,8 @@ void OpenSpaceEngine::drawOverlays() {
 void OpenSpaceEngine::postDraw() {
     LTRACE("OpenSpaceEngine::postDraw(begin)");
 
+    TraceZone("OpenSpaceEngine::postDraw");
+
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (OsEng.renderEngine().performanceManager()) {
         perf = std::make_unique<performance::PerformanceMeasurement>(
@@ -1408,6 +1427,8 @@ void OpenSpaceEngine::setJoystickInputStates(interaction::JoystickInputStates& s
 }
 
 void OpenSpaceEngine::encode() {
+    TraceZone("OpenSpaceEngine::encode");
+
     _syncEngine->encodeSyncables();
 
     _networkEngine->publishStatusMessage();
@@ -1415,6 +1436,8 @@ void OpenSpaceEngine::encode() {
 }
 
 void OpenSpaceEngine::decode() {
+    TraceZone("OpenSpaceEngine::decode");
+
     _syncEngine->decodeSyncables();
 }
 
@@ -1616,6 +1639,11 @@ RenderEngine& OpenSpaceEngine::renderEngine() {
     return *_renderEngine;
 }
 
+SyncEngine& OpenSpaceEngine::syncEngine() {
+    ghoul_assert(_syncEngine, "SyncEngine must not be nullptr");
+    return *_syncEngine;
+}
+
 TimeManager& OpenSpaceEngine::timeManager() {
     ghoul_assert(_timeManager, "Download Manager must not be nullptr");
     return *_timeManager;
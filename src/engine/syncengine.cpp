@@ -25,61 +25,122 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <algorithm>
 
+namespace {
+    constexpr const char* _loggerCat = "SyncEngine";
+
+    const openspace::properties::Property::PropertyInfo OnlySyncChangesInfo = {
+        "OnlySyncChanges",
+        "Only Synchronize Changes",
+        "If this value is enabled, the values that have not changed since the previous "
+        "frame are not transmitted to the other nodes in the cluster."
+    };
+
+    const openspace::properties::Property::PropertyInfo CompressFramesInfo = {
+        "CompressFrames",
+        "Compress Frames",
+        "If this value is enabled, the synchronization frames are compressed with LZ4 "
+        "before they are transmitted. This reduces the bandwidth for large frames at "
+        "the cost of some processing time on all nodes."
+    };
+
+    const openspace::properties::Property::PropertyInfo FullFrameIntervalInfo = {
+        "FullFrameInterval",
+        "Full Frame Interval",
+        "If only changes are synchronized, a frame containing all values is transmitted "
+        "every this many frames anyway to make sure that the nodes cannot diverge."
+    };
+} // namespace
+
 namespace openspace {
 
 SyncEngine::SyncEngine(unsigned int syncBufferSize)
-    : _syncBuffer(syncBufferSize)
+    : properties::PropertyOwner({ "SyncEngine" })
+    , _onlySyncChanges(OnlySyncChangesInfo, true)
+    , _compressFrames(CompressFramesInfo, false)
+    , _fullFrameInterval(FullFrameIntervalInfo, 600, 1, 10000)
+    , _syncBuffer(syncBufferSize)
 {
     ghoul_assert(syncBufferSize > 0, "syncBufferSize must be bigger than 0");
+
+    addProperty(_onlySyncChanges);
+    _compressFrames.onChange([this]() {
+        _syncBuffer.setCompressionEnabled(_compressFrames);
+    });
+    addProperty(_compressFrames);
+    addProperty(_fullFrameInterval);
 }
 
 // should be called on sgct master
 void SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
-        syncable->encode(&_syncBuffer);
+    const bool isFullFrame = !_onlySyncChanges ||
+                             _nFramesSinceFullFrame >= _fullFrameInterval;
+    _nFramesSinceFullFrame = isFullFrame ? 0 : _nFramesSinceFullFrame + 1;
+    _syncBuffer.setOnlyEncodeChanges(!isFullFrame);
+
+    for (SyncableInfo& info : _syncables) {
+        const size_t before = _syncBuffer.currentOffset();
+        info.syncable->encode(&_syncBuffer);
+        info.nBytes = _syncBuffer.currentOffset() - before;
     }
     _syncBuffer.write();
 }
 
 //should be called on sgct slaves
 void SyncEngine::decodeSyncables() {
-    _syncBuffer.read();
-    for (Syncable* syncable : _syncables) {
-        syncable->decode(&_syncBuffer);
+    if (!_syncBuffer.read()) {
+        // Decoding an empty or corrupt frame would read garbage into the syncables, so
+        // they keep their previous values until a valid frame is received
+        LWARNING("Skipping the synchronization of a frame that could not be read");
+        return;
+    }
+    for (SyncableInfo& info : _syncables) {
+        const size_t before = _syncBuffer.currentOffset();
+        info.syncable->decode(&_syncBuffer);
+        info.nBytes = _syncBuffer.currentOffset() - before;
     }
 }
 
 void SyncEngine::preSynchronization(IsMaster isMaster) {
-    for (Syncable* syncable : _syncables) {
-        syncable->preSync(isMaster);
+    for (const SyncableInfo& info : _syncables) {
+        info.syncable->preSync(isMaster);
     }
 }
 
 void SyncEngine::postSynchronization(IsMaster isMaster) {
-    for (Syncable* syncable : _syncables) {
-        syncable->postSync(isMaster);
+    for (const SyncableInfo& info : _syncables) {
+        info.syncable->postSync(isMaster);
     }
 }
 
-void SyncEngine::addSyncable(Syncable* syncable) {
+void SyncEngine::addSyncable(Syncable* syncable, std::string name) {
     ghoul_assert(syncable, "synable must not be nullptr");
 
-    _syncables.push_back(syncable);
+    _syncables.push_back({ syncable, std::move(name), 0 });
 }
 
-void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
-    for (Syncable* syncable : syncables) {
-        ghoul_assert(syncable, "syncables must not contain any nullptr");
-        addSyncable(syncable);
+void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables,
+                              const std::string& name)
+{
+    for (size_t i = 0; i < syncables.size(); ++i) {
+        ghoul_assert(syncables[i], "syncables must not contain any nullptr");
+        addSyncable(
+            syncables[i],
+            syncables.size() == 1 ? name : name + " " + std::to_string(i)
+        );
     }
 }
 
 void SyncEngine::removeSyncable(Syncable* syncable) {
     _syncables.erase(
-        std::remove(_syncables.begin(), _syncables.end(), syncable),
+        std::remove_if(
+            _syncables.begin(),
+            _syncables.end(),
+            [syncable](const SyncableInfo& info) { return info.syncable == syncable; }
+        ),
         _syncables.end()
     );
 }
@@ -90,4 +151,16 @@ void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
     }
 }
 
+const std::vector<SyncEngine::SyncableInfo>& SyncEngine::syncables() const {
+    return _syncables;
+}
+
+size_t SyncEngine::payloadSize() const {
+    return _syncBuffer.payloadSize();
+}
+
+size_t SyncEngine::transmittedSize() const {
+    return _syncBuffer.transmittedSize();
+}
+
 } // namespace openspace
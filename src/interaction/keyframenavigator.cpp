@@ -34,48 +34,37 @@
 
 namespace openspace::interaction {
 
-void KeyframeNavigator::updateCamera(Camera& camera) {
-    double now = OsEng.windowWrapper().applicationTime();
-
-    if (_cameraPoseTimeline.nKeyframes() == 0) {
-        return;
-    }
-
+bool KeyframeNavigator::interpolatePose(double timestamp, const Scene& scene,
+                                        glm::dvec3& position, glm::dquat& rotation,
+                                        float& scale) const
+{
     const Keyframe<CameraPose>* nextKeyframe =
-                                              _cameraPoseTimeline.firstKeyframeAfter(now);
+                                        _cameraPoseTimeline.firstKeyframeAfter(timestamp);
     const Keyframe<CameraPose>* prevKeyframe =
-                                              _cameraPoseTimeline.lastKeyframeBefore(now);
+                                        _cameraPoseTimeline.lastKeyframeBefore(timestamp);
 
-    double nextTime = 0.0;
-    if (nextKeyframe) {
-        nextTime = nextKeyframe->timestamp;
-    } else {
-        return;
+    if (!nextKeyframe) {
+        // The camera is no longer controlled by the keyframes after the last one
+        return false;
     }
 
-    double prevTime = 0.0;
-    double t = 0.0;
+    double t = 1.0;
     if (prevKeyframe) {
-        prevTime = prevKeyframe->timestamp;
-        t = (now - prevTime) / (nextTime - prevTime);
-    } else {
+        t = (timestamp - prevKeyframe->timestamp) /
+            (nextKeyframe->timestamp - prevKeyframe->timestamp);
+    }
+    else {
         // If there is no keyframe before: Only use the next keyframe.
-        prevTime = nextTime;
         prevKeyframe = nextKeyframe;
-        t = 1;
     }
 
-    _cameraPoseTimeline.removeKeyframesBefore(prevTime);
-
     const CameraPose& prevPose = prevKeyframe->data;
     const CameraPose& nextPose = nextKeyframe->data;
 
-    Scene* scene = camera.parent()->scene();
-    SceneGraphNode* prevFocusNode = scene->sceneGraphNode(prevPose.focusNode);
-    SceneGraphNode* nextFocusNode = scene->sceneGraphNode(nextPose.focusNode);
-
+    const SceneGraphNode* prevFocusNode = scene.sceneGraphNode(prevPose.focusNode);
+    const SceneGraphNode* nextFocusNode = scene.sceneGraphNode(nextPose.focusNode);
     if (!prevFocusNode || !nextFocusNode) {
-        return;
+        return false;
     }
 
     glm::dvec3 prevKeyframeCameraPosition = prevPose.position;
@@ -107,12 +96,8 @@ void KeyframeNavigator::updateCamera(Camera& camera) {
     nextKeyframeCameraPosition += nextFocusNode->worldPosition();
 
     // Linear interpolation
-    camera.setPositionVec3(
-        prevKeyframeCameraPosition * (1 - t) + nextKeyframeCameraPosition * t
-    );
-    camera.setRotation(
-        glm::slerp(prevKeyframeCameraRotation, nextKeyframeCameraRotation, t)
-    );
+    position = prevKeyframeCameraPosition * (1 - t) + nextKeyframeCameraPosition * t;
+    rotation = glm::slerp(prevKeyframeCameraRotation, nextKeyframeCameraRotation, t);
 
     // We want to affect view scaling, such that we achieve
     // logarithmic interpolation of distance to an imagined focus node.
@@ -120,7 +105,53 @@ void KeyframeNavigator::updateCamera(Camera& camera) {
     const float prevInvScaleExp = glm::log(1.0 / prevPose.scale);
     const float nextInvScaleExp = glm::log(1.0 / nextPose.scale);
     const float interpolatedInvScaleExp = prevInvScaleExp * (1 - t) + nextInvScaleExp * t;
-    camera.setScaling(1.0 / glm::exp(interpolatedInvScaleExp));
+    scale = 1.f / glm::exp(interpolatedInvScaleExp);
+    return true;
+}
+
+bool KeyframeNavigator::cameraPositionAt(double timestamp, const Scene& scene,
+                                         glm::dvec3& position) const
+{
+    glm::dquat rotation;
+    float scale;
+    return interpolatePose(timestamp, scene, position, rotation, scale);
+}
+
+void KeyframeNavigator::updateCamera(Camera& camera) {
+    double now = OsEng.windowWrapper().applicationTime();
+
+    if (_cameraPoseTimeline.nKeyframes() == 0) {
+        return;
+    }
+
+    const Keyframe<CameraPose>* nextKeyframe =
+                                              _cameraPoseTimeline.firstKeyframeAfter(now);
+    const Keyframe<CameraPose>* prevKeyframe =
+                                              _cameraPoseTimeline.lastKeyframeBefore(now);
+    if (!nextKeyframe) {
+        return;
+    }
+    if (prevKeyframe) {
+        _cameraPoseTimeline.removeKeyframesBefore(prevKeyframe->timestamp);
+    }
+
+    glm::dvec3 position;
+    glm::dquat rotation;
+    float scale;
+    const bool success = interpolatePose(
+        now,
+        *camera.parent()->scene(),
+        position,
+        rotation,
+        scale
+    );
+    if (!success) {
+        return;
+    }
+
+    camera.setPositionVec3(position);
+    camera.setRotation(rotation);
+    camera.setScaling(scale);
 }
 
 Timeline<KeyframeNavigator::CameraPose>& KeyframeNavigator::timeline() {
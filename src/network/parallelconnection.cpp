@@ -27,9 +27,10 @@
 #include <ghoul/fmt.h>
 #include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/logging/logmanager.h>
+#include <array>
+#include <cstring>
 
 namespace {
-    constexpr const uint32_t ProtocolVersion = 4;
     constexpr const char* _loggerCat = "ParallelConnection";
 } // namespace
 
@@ -61,53 +62,47 @@ bool ParallelConnection::isConnectedOrConnecting() const {
 void ParallelConnection::sendDataMessage(const DataMessage& dataMessage) {
     const uint32_t dataMessageTypeOut = static_cast<uint32_t>(dataMessage.type);
 
-    std::vector<char> messageContent;
-    messageContent.insert(
-        messageContent.end(),
-        reinterpret_cast<const char*>(&dataMessageTypeOut),
-        reinterpret_cast<const char*>(&dataMessageTypeOut) + sizeof(uint32_t)
-    );
-
-    messageContent.insert(messageContent.end(),
-        dataMessage.content.begin(),
-        dataMessage.content.end()
-    );
-
-    sendMessage(Message(MessageType::Data, messageContent));
+    // The data message type is the first part of the content of the message
+    const size_t contentSize = sizeof(uint32_t) + dataMessage.content.size();
+    if (!sendHeader(MessageType::Data, contentSize)) {
+        return;
+    }
+    if (!_socket->put<char>(
+            reinterpret_cast<const char*>(&dataMessageTypeOut),
+            sizeof(uint32_t)
+        ))
+    {
+        return;
+    }
+    _socket->put<char>(dataMessage.content.data(), dataMessage.content.size());
 }
 
 bool ParallelConnection::sendMessage(const Message& message) {
-    const uint32_t messageTypeOut = static_cast<uint32_t>(message.type);
-    const uint32_t messageSizeOut = static_cast<uint32_t>(message.content.size());
-
-    std::vector<char> header;
-
-    //insert header into buffer
-    header.push_back('O');
-    header.push_back('S');
-
-    header.insert(header.end(),
-        reinterpret_cast<const char*>(&ProtocolVersion),
-        reinterpret_cast<const char*>(&ProtocolVersion) + sizeof(uint32_t)
-    );
-
-    header.insert(header.end(),
-        reinterpret_cast<const char*>(&messageTypeOut),
-        reinterpret_cast<const char*>(&messageTypeOut) + sizeof(uint32_t)
-    );
-
-    header.insert(header.end(),
-        reinterpret_cast<const char*>(&messageSizeOut),
-        reinterpret_cast<const char*>(&messageSizeOut) + sizeof(uint32_t)
-    );
+    return sendMessage(message.type, message.content.data(), message.content.size());
+}
 
-    if (!_socket->put<char>(header.data(), header.size())) {
-        return false;
-    }
-    if (!_socket->put<char>(message.content.data(), message.content.size())) {
+bool ParallelConnection::sendMessage(MessageType type, const char* data, size_t size) {
+    if (!sendHeader(type, size)) {
         return false;
     }
-    return true;
+    return size == 0 || _socket->put<char>(data, size);
+}
+
+bool ParallelConnection::sendHeader(MessageType type, size_t contentSize) {
+    const uint32_t messageTypeOut = static_cast<uint32_t>(type);
+    const uint32_t messageSizeOut = static_cast<uint32_t>(contentSize);
+
+    std::array<char, HeaderSize> header;
+    header[0] = 'O';
+    header[1] = 'S';
+    size_t offset = 2;
+    memcpy(header.data() + offset, &ProtocolVersion, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    memcpy(header.data() + offset, &messageTypeOut, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    memcpy(header.data() + offset, &messageSizeOut, sizeof(uint32_t));
+
+    return _socket->put<char>(header.data(), header.size());
 }
 
 void ParallelConnection::disconnect() {
@@ -121,11 +116,8 @@ ghoul::io::TcpSocket* ParallelConnection::socket() {
 }
 
 ParallelConnection::Message ParallelConnection::receiveMessage() {
-    // Header consists of 'OS' + majorVersion + minorVersion + messageSize
-    constexpr size_t HeaderSize = 2 * sizeof(char) + 3 * sizeof(uint32_t);
-
-    // Create basic buffer for receiving first part of messages
-    std::vector<char> headerBuffer(HeaderSize);
+    // The header is small enough to be received on the stack
+    std::array<char, HeaderSize> headerBuffer;
     std::vector<char> messageBuffer;
 
     // Receive the header data
@@ -135,16 +127,17 @@ ParallelConnection::Message ParallelConnection::receiveMessage() {
     }
 
     // Make sure that header matches this version of OpenSpace
-    if (!(headerBuffer[0] == 'O' && headerBuffer[1] && 'S')) {
+    if (!(headerBuffer[0] == 'O' && headerBuffer[1] == 'S')) {
         LERROR("Expected to read message header 'OS' from socket.");
         throw ConnectionLostError();
     }
 
-    uint32_t* ptr = reinterpret_cast<uint32_t*>(&headerBuffer[2]);
-
-    const uint32_t protocolVersionIn = *(ptr++);
-    const uint32_t messageTypeIn = *(ptr++);
-    const uint32_t messageSizeIn = *(ptr++);
+    uint32_t protocolVersionIn;
+    uint32_t messageTypeIn;
+    uint32_t messageSizeIn;
+    memcpy(&protocolVersionIn, &headerBuffer[2], sizeof(uint32_t));
+    memcpy(&messageTypeIn, &headerBuffer[2 + sizeof(uint32_t)], sizeof(uint32_t));
+    memcpy(&messageSizeIn, &headerBuffer[2 + 2 * sizeof(uint32_t)], sizeof(uint32_t));
 
     if (protocolVersionIn != ProtocolVersion) {
         LERROR(fmt::format(
@@ -165,7 +158,7 @@ ParallelConnection::Message ParallelConnection::receiveMessage() {
     }
 
     // And delegate decoding depending on type
-    return Message(static_cast<MessageType>(messageTypeIn), messageBuffer);
+    return Message(static_cast<MessageType>(messageTypeIn), std::move(messageBuffer));
 }
 
 } // namespace openspace
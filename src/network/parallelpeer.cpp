@@ -42,6 +42,8 @@
 namespace {
     constexpr const uint32_t ProtocolVersion = 3;
     constexpr const size_t MaxLatencyDiffs = 64;
+    // Initial capacity of the buffer in which the outgoing data messages are batched
+    constexpr const size_t InitialSendBufferSize = 4096;
     constexpr const char* _loggerCat = "ParallelPeer";
 
     const openspace::properties::Property::PropertyInfo PasswordInfo = {
@@ -130,6 +132,12 @@ ParallelPeer::ParallelPeer()
     addProperty(_timeKeyframeInterval);
     addProperty(_cameraKeyframeInterval);
     addProperty(_timeTolerance);
+
+    // The batch is sent as a single data message, so it starts with the message type
+    _sendBuffer.reserve(InitialSendBufferSize);
+    const uint32_t batchType = static_cast<uint32_t>(datamessagestructures::Type::Batch);
+    _sendBuffer.resize(sizeof(uint32_t));
+    memcpy(_sendBuffer.data(), &batchType, sizeof(uint32_t));
 }
 
 ParallelPeer::~ParallelPeer() {
@@ -202,9 +210,9 @@ void ParallelPeer::sendAuthentication() {
     ));
 }
 
-void ParallelPeer::queueInMessage(const ParallelConnection::Message& message) {
+void ParallelPeer::queueInMessage(ParallelConnection::Message message) {
     std::lock_guard<std::mutex> unqlock(_receiveBufferMutex);
-    _receiveBuffer.push_back(message);
+    _receiveBuffer.push_back(std::move(message));
 }
 
 void ParallelPeer::handleMessage(const  ParallelConnection::Message& message) {
@@ -264,13 +272,43 @@ double ParallelPeer::timeTolerance() const {
 }
 
 void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
+    if (message.size() < sizeof(uint32_t)) {
+        LERROR("Malformed data message.");
+        return;
+    }
+
     // The type of data message received
-    const uint32_t type = *(reinterpret_cast<const uint32_t*>(message.data()));
-    std::vector<char> buffer(message.begin() + sizeof(uint32_t), message.end());
+    uint32_t type;
+    memcpy(&type, message.data(), sizeof(uint32_t));
+    const char* data = message.data() + sizeof(uint32_t);
+    const size_t size = message.size() - sizeof(uint32_t);
+
+    using datamessagestructures::Type;
+    if (static_cast<Type>(type) == Type::Batch) {
+        const bool success = datamessagestructures::forEachInBatch(
+            data,
+            size,
+            [this](Type t, const char* d, size_t s) { handleDataMessage(t, d, s); }
+        );
+        if (!success) {
+            LERROR("Malformed batch of data messages.");
+        }
+    }
+    else {
+        handleDataMessage(static_cast<Type>(type), data, size);
+    }
+}
 
-    switch (static_cast<datamessagestructures::Type>(type)) {
+void ParallelPeer::handleDataMessage(datamessagestructures::Type type, const char* data,
+                                     size_t size)
+{
+    switch (type) {
         case datamessagestructures::Type::CameraData: {
-            datamessagestructures::CameraKeyframe kf(buffer);
+            datamessagestructures::CameraKeyframe& kf = _receivedCameraKeyframe;
+            if (!kf.deserialize(data, size)) {
+                LERROR("Malformed camera keyframe.");
+                break;
+            }
             kf._timestamp = calculateBufferedKeyframeTime(kf._timestamp);
 
             OsEng.navigationHandler().keyframeNavigator().removeKeyframesAfter(
@@ -289,7 +327,11 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
             break;
         }
         case datamessagestructures::Type::TimeData: {
-            datamessagestructures::TimeKeyframe kf(buffer);
+            datamessagestructures::TimeKeyframe kf;
+            if (!kf.deserialize(data, size)) {
+                LERROR("Malformed time keyframe.");
+                break;
+            }
             kf._timestamp = calculateBufferedKeyframeTime(kf._timestamp);
 
             OsEng.timeManager().removeKeyframesAfter(kf._timestamp);
@@ -303,7 +345,7 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
         }
         case datamessagestructures::Type::ScriptData: {
             datamessagestructures::ScriptMessage sm;
-            sm.deserialize(buffer);
+            sm.deserialize(data, size);
 
             OsEng.scriptEngine().queueScript(
                 sm._script,
@@ -314,7 +356,7 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
         default: {
             LERROR(fmt::format(
                 "Unidentified message with identifier {} received in parallel connection",
-                type
+                static_cast<uint32_t>(type)
             ));
             break;
         }
@@ -380,8 +422,7 @@ void ParallelPeer::nConnectionsMessageReceived(const std::vector<char>& message)
 void ParallelPeer::handleCommunication() {
     while (!_shouldDisconnect && _connection.isConnectedOrConnecting()) {
         try {
-            ParallelConnection::Message m = _connection.receiveMessage();
-            queueInMessage(m);
+            queueInMessage(_connection.receiveMessage());
         } catch (const ParallelConnection::ConnectionLostError&) {
             LERROR("Parallel connection lost");
         }
@@ -439,14 +480,9 @@ void ParallelPeer::sendScript(std::string script) {
     datamessagestructures::ScriptMessage sm;
     sm._script = std::move(script);
 
-    std::vector<char> buffer;
-    sm.serialize(buffer);
-
-    ParallelConnection::DataMessage message(
-        datamessagestructures::Type::ScriptData,
-        buffer
-    );
-    _connection.sendDataMessage(message);
+    // The script is sent together with the keyframes at the end of this network tick
+    datamessagestructures::appendToBatch(_sendBuffer, sm);
+    ++_nBatchedMessages;
 }
 
 void ParallelPeer::resetTimeOffset() {
@@ -457,11 +493,15 @@ void ParallelPeer::resetTimeOffset() {
 }
 
 void ParallelPeer::preSynchronization() {
-    std::unique_lock<std::mutex> unqlock(_receiveBufferMutex);
-    while (!_receiveBuffer.empty()) {
-        ParallelConnection::Message& message = _receiveBuffer.front();
+    // Take all received messages at once so that the receiving thread is not blocked
+    // while they are handled
+    std::deque<ParallelConnection::Message> messages;
+    {
+        std::lock_guard<std::mutex> unqlock(_receiveBufferMutex);
+        messages.swap(_receiveBuffer);
+    }
+    for (const ParallelConnection::Message& message : messages) {
         handleMessage(message);
-        _receiveBuffer.pop_front();
     }
 
     if (status() == ParallelConnection::Status::Host) {
@@ -479,6 +519,7 @@ void ParallelPeer::preSynchronization() {
             _lastTimeKeyframeTimestamp = now;
         }
     }
+    sendBatch();
     if (_shouldDisconnect) {
         disconnect();
     }
@@ -548,17 +589,9 @@ void ParallelPeer::sendCameraKeyframe() {
     // Timestamp as current runtime of OpenSpace instance
     kf._timestamp = OsEng.windowWrapper().applicationTime();
 
-    // Create a buffer for the keyframe
-    std::vector<char> buffer;
-
-    // Fill the keyframe buffer
-    kf.serialize(buffer);
-
-    // Send message
-    _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::CameraData,
-        buffer
-    ));
+    // Add the keyframe to the batch for this network tick
+    datamessagestructures::appendToBatch(_sendBuffer, kf);
+    ++_nBatchedMessages;
 }
 
 void ParallelPeer::sendTimeKeyframe() {
@@ -575,18 +608,24 @@ void ParallelPeer::sendTimeKeyframe() {
     // Timestamp as current runtime of OpenSpace instance
     kf._timestamp = OsEng.windowWrapper().applicationTime();
 
-    // Create a buffer for the keyframe
-    std::vector<char> buffer;
+    // Add the keyframe to the batch for this network tick
+    datamessagestructures::appendToBatch(_sendBuffer, kf);
+    ++_nBatchedMessages;
+    _timeJumped = false;
+}
 
-    // Fill the keyframe buffer
-    kf.serialize(buffer);
+void ParallelPeer::sendBatch() {
+    if (_nBatchedMessages > 0 && isHost()) {
+        _connection.sendMessage(
+            ParallelConnection::MessageType::Data,
+            _sendBuffer.data(),
+            _sendBuffer.size()
+        );
+    }
 
-    // Send message
-    _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::TimeData,
-        buffer
-    ));
-    _timeJumped = false;
+    // Only keep the type of the batch, the capacity is reused for the next tick
+    _sendBuffer.resize(sizeof(uint32_t));
+    _nBatchedMessages = 0;
 }
 
 ghoul::Event<>& ParallelPeer::connectionEvent() {
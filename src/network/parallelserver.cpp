@@ -25,27 +25,266 @@
 #include <openspace/network/parallelserver.h>
 
 #include <ghoul/fmt.h>
-#include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <array>
+#include <cstring>
 #include <functional>
 
-// @TODO(abock): In the entire class remove std::shared_ptr<Peer> by const Peer& where
-//               possible to simplify the interface
+#ifdef WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else // WIN32
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif // __linux__
+#endif // WIN32
 
 namespace {
     constexpr const char* _loggerCat = "ParallelServer";
+
+#ifdef WIN32
+    using NativeSocket = SOCKET;
+#else // WIN32
+    using NativeSocket = int;
+#endif // WIN32
+
+    constexpr const intptr_t InvalidSocket = -1;
+
+    NativeSocket native(intptr_t socket) {
+        return static_cast<NativeSocket>(socket);
+    }
+
+    // The identifier that is used for the listening sockets in the I/O loop. Peer
+    // identifiers start at 1
+    constexpr const size_t ListenSocketId = 0;
+
+    // Time after which the I/O loop checks whether it should stop, in milliseconds
+    constexpr const int PollTimeout = 100;
+
+    // Maximum number of events that are handled in one iteration of the I/O loop
+    constexpr const int MaxEvents = 64;
+
+    // Number of bytes that the input buffer of a peer grows by for each read
+    constexpr const size_t ReadChunkSize = 64 * 1024;
+
+    // Peers sending larger messages than this are considered misbehaving
+    constexpr const uint32_t MaxMessageSize = 64 * 1024 * 1024;
+
+#ifdef __linux__
+    constexpr const int SendFlags = MSG_NOSIGNAL;
+#else // __linux__
+    constexpr const int SendFlags = 0;
+#endif // __linux__
+
+    bool wouldBlock() {
+#ifdef WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+#else // WIN32
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif // WIN32
+    }
+
+    void closeSocket(intptr_t socket) {
+#ifdef WIN32
+        closesocket(native(socket));
+#else // WIN32
+        close(native(socket));
+#endif // WIN32
+    }
+
+    bool configureSocket(intptr_t socket) {
+#ifdef WIN32
+        u_long nonBlocking = 1;
+        if (ioctlsocket(native(socket), FIONBIO, &nonBlocking) != 0) {
+            return false;
+        }
+#else // WIN32
+        const int fd = native(socket);
+        const int flags = fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            return false;
+        }
+#ifdef __APPLE__
+        // There is no MSG_NOSIGNAL on macOS, so a closed peer must not raise SIGPIPE
+        int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif // __APPLE__
+#endif // WIN32
+
+        // Keyframes are small and latency sensitive, so they should not be delayed
+        int noDelay = 1;
+        setsockopt(
+            native(socket),
+            IPPROTO_TCP,
+            TCP_NODELAY,
+            reinterpret_cast<const char*>(&noDelay),
+            sizeof(noDelay)
+        );
+        return true;
+    }
 } // namespace
 
 namespace openspace {
 
+ParallelServer::RingBuffer::RingBuffer(size_t capacity)
+    : _data(capacity)
+{}
+
+bool ParallelServer::RingBuffer::push(const char* data, size_t size) {
+    if (_size + size > _data.size()) {
+        return false;
+    }
+
+    const size_t end = (_begin + _size) % _data.size();
+    const size_t first = std::min(size, _data.size() - end);
+    memcpy(_data.data() + end, data, first);
+    memcpy(_data.data(), data + first, size - first);
+    _size += size;
+    return true;
+}
+
+std::pair<const char*, size_t> ParallelServer::RingBuffer::front() const {
+    return { _data.data() + _begin, std::min(_size, _data.size() - _begin) };
+}
+
+void ParallelServer::RingBuffer::pop(size_t size) {
+    _begin = (_begin + size) % _data.size();
+    _size -= size;
+    if (_size == 0) {
+        // Start from the beginning to keep the data in one contiguous block
+        _begin = 0;
+    }
+}
+
+size_t ParallelServer::RingBuffer::size() const {
+    return _size;
+}
+
+size_t ParallelServer::RingBuffer::capacity() const {
+    return _data.size();
+}
+
+bool ParallelServer::RingBuffer::empty() const {
+    return _size == 0;
+}
+
+ParallelServer::ParallelServer(size_t outgoingBufferSize)
+    : _outgoingBufferSize(outgoingBufferSize)
+{}
+
+ParallelServer::~ParallelServer() {
+    stop();
+}
+
 void ParallelServer::start(int port, const std::string& password,
-                           const std::string& changeHostPassword)
+                           const std::string& changeHostPassword,
+                           const std::string& address)
 {
-    _socketServer.listen("localhost", port);
+#ifdef WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif // WIN32
+
     _passwordHash = std::hash<std::string>{}(password);
     _changeHostPasswordHash = std::hash<std::string>{}(changeHostPassword);
 
-    _serverThread = std::thread([this](){ handleNewPeers(); });
+    // A host name such as localhost can resolve to both an IPv4 and an IPv6 address,
+    // and the clients might use either of them, so we listen on all of them. Without
+    // an address, the passive lookup yields the IPv4 and IPv6 wildcard addresses
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* result = nullptr;
+    const int res = getaddrinfo(
+        address.empty() ? nullptr : address.c_str(),
+        std::to_string(port).c_str(),
+        &hints,
+        &result
+    );
+    if (res != 0) {
+#ifdef WIN32
+        WSACleanup();
+#endif // WIN32
+        throw ghoul::RuntimeError(
+            fmt::format("Could not resolve address {}:{}", address, port),
+            "ParallelServer"
+        );
+    }
+
+    for (addrinfo* info = result; info; info = info->ai_next) {
+        const NativeSocket s = ::socket(
+            info->ai_family,
+            info->ai_socktype,
+            info->ai_protocol
+        );
+        const intptr_t socket = static_cast<intptr_t>(s);
+        if (socket == InvalidSocket) {
+            continue;
+        }
+
+        int enabled = 1;
+        setsockopt(
+            s,
+            SOL_SOCKET,
+            SO_REUSEADDR,
+            reinterpret_cast<const char*>(&enabled),
+            sizeof(enabled)
+        );
+        if (info->ai_family == AF_INET6) {
+            // Otherwise the IPv6 socket might also claim the IPv4 port
+            setsockopt(
+                s,
+                IPPROTO_IPV6,
+                IPV6_V6ONLY,
+                reinterpret_cast<const char*>(&enabled),
+                sizeof(enabled)
+            );
+        }
+
+        const bool success =
+            bind(s, info->ai_addr, static_cast<int>(info->ai_addrlen)) == 0 &&
+            listen(s, SOMAXCONN) == 0 &&
+            configureSocket(socket);
+        if (success) {
+            _listenSockets.push_back(socket);
+        }
+        else {
+            closeSocket(socket);
+        }
+    }
+    freeaddrinfo(result);
+
+    if (_listenSockets.empty()) {
+#ifdef WIN32
+        WSACleanup();
+#endif // WIN32
+        throw ghoul::RuntimeError(
+            fmt::format("Could not listen on {}:{}", address, port),
+            "ParallelServer"
+        );
+    }
+
+#ifdef __linux__
+    _pollHandle = epoll_create1(0);
+#endif // __linux__
+    for (intptr_t socket : _listenSockets) {
+        watchSocket(socket, ListenSocketId, true, false);
+    }
+
+    _shouldStop = false;
+    _isRunning = true;
     _eventLoopThread = std::thread([this]() { eventLoop(); });
 }
 
@@ -60,97 +299,352 @@ std::string ParallelServer::defaultHostAddress() const {
 }
 
 void ParallelServer::stop() {
+    if (!_isRunning) {
+        return;
+    }
     _shouldStop = true;
-    _socketServer.close();
+    if (_eventLoopThread.joinable()) {
+        _eventLoopThread.join();
+    }
+
+    // The I/O thread has finished, so the peers can be accessed from this thread
+    for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
+        if (it.second->socket != InvalidSocket) {
+            closeSocket(it.second->socket);
+        }
+    }
+    _peers.clear();
+    _nConnections = 0;
+    _hostPeerId = 0;
+
+    for (intptr_t socket : _listenSockets) {
+        closeSocket(socket);
+    }
+    _listenSockets.clear();
+#ifdef __linux__
+    close(_pollHandle);
+    _pollHandle = -1;
+#endif // __linux__
+#ifdef WIN32
+    WSACleanup();
+#endif // WIN32
+    _isRunning = false;
+}
+
+void ParallelServer::watchSocket(intptr_t socket, size_t id, bool isNew,
+                                 bool waitForWrite)
+{
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    if (waitForWrite) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u64 = id;
+    epoll_ctl(
+        _pollHandle,
+        isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+        native(socket),
+        &event
+    );
+#else // __linux__
+    // The poll set is rebuilt from the peers in every iteration of the I/O loop
+    (void)socket;
+    (void)id;
+    (void)isNew;
+    (void)waitForWrite;
+#endif // __linux__
 }
 
-void ParallelServer::handleNewPeers() {
+void ParallelServer::eventLoop() {
+#ifdef __linux__
+    std::array<epoll_event, MaxEvents> events;
+#else // __linux__
+    std::vector<pollfd> pollSet;
+    std::vector<size_t> pollIds;
+#endif // __linux__
+
     while (!_shouldStop) {
-        std::unique_ptr<ghoul::io::TcpSocket> socket =
-            _socketServer.awaitPendingTcpSocket();
+#ifdef __linux__
+        const int nEvents = epoll_wait(
+            _pollHandle,
+            events.data(),
+            MaxEvents,
+            PollTimeout
+        );
+        for (int i = 0; i < nEvents; ++i) {
+            const size_t id = static_cast<size_t>(events[i].data.u64);
+            const uint32_t flags = events[i].events;
+            const bool canRead = (flags & EPOLLIN) != 0;
+            const bool canWrite = (flags & EPOLLOUT) != 0;
+            const bool hasError = (flags & (EPOLLERR | EPOLLHUP)) != 0;
+#else // __linux__
+        pollSet.clear();
+        pollIds.clear();
+        for (intptr_t socket : _listenSockets) {
+            pollSet.push_back({ native(socket), POLLIN, 0 });
+            pollIds.push_back(ListenSocketId);
+        }
+        for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
+            const short events = POLLIN | (it.second->isWaitingForWrite ? POLLOUT : 0);
+            pollSet.push_back({ native(it.second->socket), events, 0 });
+            pollIds.push_back(it.first);
+        }
+#ifdef WIN32
+        const int nEvents = WSAPoll(
+            pollSet.data(),
+            static_cast<ULONG>(pollSet.size()),
+            PollTimeout
+        );
+#else // WIN32
+        const int nEvents = poll(
+            pollSet.data(),
+            static_cast<nfds_t>(pollSet.size()),
+            PollTimeout
+        );
+#endif // WIN32
+        for (size_t i = 0; i < pollSet.size() && nEvents > 0; ++i) {
+            const size_t id = pollIds[i];
+            const short flags = pollSet[i].revents;
+            const bool canRead = (flags & POLLIN) != 0;
+            const bool canWrite = (flags & POLLOUT) != 0;
+            const bool hasError = (flags & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+#endif // __linux__
+
+            if (id == ListenSocketId) {
+                if (canRead) {
+                    acceptPeers();
+                }
+                continue;
+            }
+
+            Peer* p = peer(id);
+            if (!p || p->isDisconnecting) {
+                continue;
+            }
+            // Read first so that any last message before a hangup is still handled
+            if (canRead) {
+                readFromPeer(*p);
+            }
+            if (canWrite && !p->isDisconnecting) {
+                writeToPeer(*p);
+            }
+            if (hasError && !p->isDisconnecting) {
+                LERROR(fmt::format("Connection lost to {}", p->id));
+                disconnect(*p);
+            }
+        }
 
-        socket->startStreams();
+        removeDisconnectedPeers();
+    }
+}
+
+void ParallelServer::acceptPeers() {
+    for (intptr_t listenSocket : _listenSockets) {
+        acceptPeers(listenSocket);
+    }
+}
+
+void ParallelServer::acceptPeers(intptr_t listenSocket) {
+    while (true) {
+        sockaddr_storage address = {};
+        socklen_t addressLength = sizeof(address);
+        const NativeSocket s = accept(
+            native(listenSocket),
+            reinterpret_cast<sockaddr*>(&address),
+            &addressLength
+        );
+        const intptr_t socket = static_cast<intptr_t>(s);
+        if (socket == InvalidSocket) {
+            if (!wouldBlock()) {
+                LERROR("Failed to accept a new connection");
+            }
+            return;
+        }
+        if (!configureSocket(socket)) {
+            LERROR("Failed to configure the socket of a new connection");
+            closeSocket(socket);
+            continue;
+        }
+
+        std::array<char, INET6_ADDRSTRLEN> addressString = {};
+        if (address.ss_family == AF_INET) {
+            inet_ntop(
+                AF_INET,
+                &reinterpret_cast<sockaddr_in*>(&address)->sin_addr,
+                addressString.data(),
+                addressString.size()
+            );
+        }
+        else if (address.ss_family == AF_INET6) {
+            inet_ntop(
+                AF_INET6,
+                &reinterpret_cast<sockaddr_in6*>(&address)->sin6_addr,
+                addressString.data(),
+                addressString.size()
+            );
+        }
 
         const size_t id = _nextConnectionId++;
-        std::shared_ptr<Peer> p = std::make_shared<Peer>(Peer{
+        _peers[id] = std::unique_ptr<Peer>(new Peer{
             id,
             "",
-            ParallelConnection(std::move(socket)),
+            addressString.data(),
             ParallelConnection::Status::Connecting,
-            std::thread()
-        });
-        auto it = _peers.emplace(p->id, p);
-        it.first->second->thread = std::thread([this, id]() {
-            handlePeer(id);
+            socket,
+            std::vector<char>(),
+            0,
+            RingBuffer(_outgoingBufferSize)
         });
+        watchSocket(socket, id, true, false);
     }
 }
 
-std::shared_ptr<ParallelServer::Peer> ParallelServer::peer(size_t id) {
-    std::lock_guard<std::mutex> lock(_peerListMutex);
-    auto it = _peers.find(id);
-    if (it == _peers.end()) {
-        return nullptr;
+void ParallelServer::readFromPeer(Peer& peer) {
+    // Read everything that is available; the socket is non-blocking
+    while (!peer.isDisconnecting) {
+        if (peer.inBuffer.size() < peer.nReceivedBytes + ReadChunkSize) {
+            peer.inBuffer.resize(peer.nReceivedBytes + ReadChunkSize);
+        }
+        const auto n = recv(
+            native(peer.socket),
+            peer.inBuffer.data() + peer.nReceivedBytes,
+            static_cast<int>(ReadChunkSize),
+            0
+        );
+        if (n == 0) {
+            LINFO(fmt::format("Connection {} closed", peer.id));
+            disconnect(peer);
+            return;
+        }
+        if (n < 0) {
+            if (!wouldBlock()) {
+                LERROR(fmt::format("Connection lost to {}", peer.id));
+                disconnect(peer);
+            }
+            break;
+        }
+        peer.nReceivedBytes += static_cast<size_t>(n);
     }
-    return it->second;
-}
 
-void ParallelServer::handlePeer(size_t id) {
-    while (!_shouldStop) {
-        std::shared_ptr<Peer> p = peer(id);
-        if (!p) {
+    // Handle all complete messages directly from the input buffer
+    constexpr const size_t HeaderSize = ParallelConnection::HeaderSize;
+    size_t offset = 0;
+    while (!peer.isDisconnecting && peer.nReceivedBytes - offset >= HeaderSize) {
+        const char* header = peer.inBuffer.data() + offset;
+        if (header[0] != 'O' || header[1] != 'S') {
+            LERROR("Expected to read message header 'OS' from socket.");
+            disconnect(peer);
             return;
         }
-
-        if (!p->parallelConnection.isConnectedOrConnecting()) {
+        uint32_t protocolVersion;
+        uint32_t messageType;
+        uint32_t messageSize;
+        memcpy(&protocolVersion, header + 2, sizeof(uint32_t));
+        memcpy(&messageType, header + 2 + sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&messageSize, header + 2 + 2 * sizeof(uint32_t), sizeof(uint32_t));
+
+        if (protocolVersion != ParallelConnection::ProtocolVersion) {
+            LERROR(fmt::format(
+                "Protocol versions do not match. Remote version: {}, Local version: {}",
+                protocolVersion,
+                ParallelConnection::ProtocolVersion
+            ));
+            disconnect(peer);
             return;
         }
-        try {
-            ParallelConnection::Message m = p->parallelConnection.receiveMessage();
-            _incomingMessages.push({id, m});
-        } catch (const ParallelConnection::ConnectionLostError&) {
-            LERROR(fmt::format("Connection lost to {}", p->id));
-            _incomingMessages.push({
-                id,
-                ParallelConnection::Message(
-                    ParallelConnection::MessageType::Disconnection, std::vector<char>()
-                )
-            });
+        if (messageSize > MaxMessageSize) {
+            LERROR(fmt::format(
+                "Connection {} sent a message of {} bytes", peer.id, messageSize
+            ));
+            disconnect(peer);
             return;
         }
+        if (peer.nReceivedBytes - offset < HeaderSize + messageSize) {
+            // The rest of the message has not been received yet
+            break;
+        }
+
+        handlePeerMessage(
+            peer,
+            static_cast<ParallelConnection::MessageType>(messageType),
+            header + HeaderSize,
+            messageSize
+        );
+        offset += HeaderSize + messageSize;
+    }
+
+    // Keep the partial message at the front of the buffer for the next read
+    if (offset > 0 && !peer.isDisconnecting) {
+        memmove(
+            peer.inBuffer.data(),
+            peer.inBuffer.data() + offset,
+            peer.nReceivedBytes - offset
+        );
+        peer.nReceivedBytes -= offset;
     }
 }
 
-void ParallelServer::eventLoop() {
-    while (!_shouldStop) {
-        PeerMessage pm = _incomingMessages.pop();
-        handlePeerMessage(std::move(pm));
+void ParallelServer::writeToPeer(Peer& peer) {
+    while (!peer.outBuffer.empty()) {
+        const std::pair<const char*, size_t> block = peer.outBuffer.front();
+        const auto n = send(
+            native(peer.socket),
+            block.first,
+            static_cast<int>(block.second),
+            SendFlags
+        );
+        if (n < 0) {
+            if (wouldBlock()) {
+                break;
+            }
+            LERROR(fmt::format("Connection lost to {}", peer.id));
+            disconnect(peer);
+            return;
+        }
+        peer.outBuffer.pop(static_cast<size_t>(n));
+    }
+
+    // Only wait for the socket to become writable if there is something left to write
+    const bool shouldWait = !peer.outBuffer.empty();
+    if (shouldWait != peer.isWaitingForWrite) {
+        peer.isWaitingForWrite = shouldWait;
+        watchSocket(peer.socket, peer.id, false, shouldWait);
     }
 }
 
-void ParallelServer::handlePeerMessage(PeerMessage peerMessage) {
-    const size_t peerId = peerMessage.peerId;
-    auto it = _peers.find(peerId);
-    if (it == _peers.end()) {
-        return;
+void ParallelServer::removeDisconnectedPeers() {
+    for (auto it = _peers.begin(); it != _peers.end();) {
+        if (it->second->isDisconnecting) {
+            it = _peers.erase(it);
+        }
+        else {
+            ++it;
+        }
     }
+}
 
-    std::shared_ptr<Peer>& peer = it->second;
+ParallelServer::Peer* ParallelServer::peer(size_t id) {
+    auto it = _peers.find(id);
+    return it != _peers.end() ? it->second.get() : nullptr;
+}
 
-    const ParallelConnection::MessageType messageType = peerMessage.message.type;
-    std::vector<char>& data = peerMessage.message.content;
+void ParallelServer::handlePeerMessage(Peer& peer,
+                                       ParallelConnection::MessageType messageType,
+                                       const char* data, size_t size)
+{
     switch (messageType) {
         case ParallelConnection::MessageType::Authentication:
-            handleAuthentication(peer, std::move(data));
+            handleAuthentication(peer, data, size);
             break;
         case ParallelConnection::MessageType::Data:
-            handleData(peer, std::move(data));
+            handleData(peer, data, size);
             break;
         case ParallelConnection::MessageType::HostshipRequest:
-            handleHostshipRequest(peer, std::move(data));
+            handleHostshipRequest(peer, data, size);
             break;
         case ParallelConnection::MessageType::HostshipResignation:
-            handleHostshipResignation(peer, std::move(data));
+            handleHostshipResignation(peer);
             break;
         case ParallelConnection::MessageType::Disconnection:
             disconnect(peer);
@@ -163,53 +657,50 @@ void ParallelServer::handlePeerMessage(PeerMessage peerMessage) {
     }
 }
 
-void ParallelServer::handleAuthentication(std::shared_ptr<Peer> peer,
-                                          std::vector<char> message)
-{
-    std::stringstream input(std::string(message.begin(), message.end()));
-
+void ParallelServer::handleAuthentication(Peer& peer, const char* data, size_t size) {
     // 8 bytes passcode
     uint64_t passwordHash = 0;
-    input.read(reinterpret_cast<char*>(&passwordHash), sizeof(uint64_t));
+    if (size >= sizeof(uint64_t)) {
+        memcpy(&passwordHash, data, sizeof(uint64_t));
+    }
 
     if (passwordHash != _passwordHash) {
-        LERROR(fmt::format("Connection {} provided incorrect passcode.", peer->id));
+        LERROR(fmt::format("Connection {} provided incorrect passcode.", peer.id));
         disconnect(peer);
         return;
     }
 
     // 4 bytes name size
     uint32_t nameSize = 0;
-    input.read(reinterpret_cast<char*>(&nameSize), sizeof(uint32_t));
+    if (size >= sizeof(uint64_t) + sizeof(uint32_t)) {
+        memcpy(&nameSize, data + sizeof(uint64_t), sizeof(uint32_t));
+    }
+    const size_t nameOffset = sizeof(uint64_t) + sizeof(uint32_t);
+    if (nameSize > size - std::min(size, nameOffset)) {
+        LERROR(fmt::format("Connection {} sent a malformed name.", peer.id));
+        disconnect(peer);
+        return;
+    }
 
     // <nameSize> bytes name
-    std::string name(nameSize, static_cast<char>(0));
-    input.read(&name[0], nameSize);
-
-    if (nameSize == 0) {
-        name = "Anonymous";
-    }
+    std::string name = nameSize > 0 ?
+        std::string(data + nameOffset, nameSize) :
+        "Anonymous";
 
     setName(peer, name);
 
-    LINFO(fmt::format("Connection established with {} \"{}\"", peer->id, name));
+    LINFO(fmt::format("Connection established with {} \"{}\"", peer.id, name));
 
     std::string defaultHostAddress;
     {
         std::lock_guard<std::mutex> _hostMutex(_hostInfoMutex);
         defaultHostAddress = _defaultHostAddress;
     }
-    if (_hostPeerId == 0 &&
-        peer->parallelConnection.socket()->address() == defaultHostAddress)
-    {
+    if (_hostPeerId == 0 && peer.address == defaultHostAddress) {
         // Directly promote the conenction to host (initialize)
         // if there is no host, and ip matches default host ip.
-        LINFO(fmt::format("Connection {} directly promoted to host.", peer->id));
+        LINFO(fmt::format("Connection {} directly promoted to host.", peer.id));
         assignHost(peer);
-        for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
-            // sendConnectionStatus(it->second) ?
-            sendConnectionStatus(peer);
-        }
     }
     else {
         setToClient(peer);
@@ -218,161 +709,173 @@ void ParallelServer::handleAuthentication(std::shared_ptr<Peer> peer,
     setNConnections(nConnections() + 1);
 }
 
-void ParallelServer::handleData(std::shared_ptr<Peer> peer, std::vector<char> data) {
-    if (peer->id != _hostPeerId) {
+void ParallelServer::handleData(Peer& peer, const char* data, size_t size) {
+    if (peer.id != _hostPeerId) {
         LINFO(fmt::format(
-            "Connection {} tried to send data without being the host. Ignoring", peer->id
+            "Connection {} tried to send data without being the host. Ignoring", peer.id
         ));
+        return;
     }
-    sendMessageToClients(ParallelConnection::MessageType::Data, data);
-
+    sendMessageToClients(ParallelConnection::MessageType::Data, data, size);
 }
 
-void ParallelServer::handleHostshipRequest(std::shared_ptr<Peer> peer,
-                                           std::vector<char> message)
-{
-    std::stringstream input(std::string(message.begin(), message.end()));
-
-    LINFO(fmt::format("Connection {} requested hostship.", peer->id));
+void ParallelServer::handleHostshipRequest(Peer& peer, const char* data, size_t size) {
+    LINFO(fmt::format("Connection {} requested hostship.", peer.id));
 
     uint64_t passwordHash = 0;
-    input.read(reinterpret_cast<char*>(&passwordHash), sizeof(uint64_t));
+    if (size >= sizeof(uint64_t)) {
+        memcpy(&passwordHash, data, sizeof(uint64_t));
+    }
 
     if (passwordHash != _changeHostPasswordHash) {
-        LERROR(fmt::format("Connection {} provided incorrect host password.", peer->id));
+        LERROR(fmt::format("Connection {} provided incorrect host password.", peer.id));
         return;
     }
 
-    size_t oldHostPeerId = 0;
-    {
-        std::lock_guard<std::mutex> lock(_hostInfoMutex);
-        oldHostPeerId = _hostPeerId;
-    }
-
-    if (oldHostPeerId == peer->id) {
-        LINFO(fmt::format("Connection {} is already the host.", peer->id));
+    const size_t oldHostPeerId = _hostPeerId;
+    if (oldHostPeerId == peer.id) {
+        LINFO(fmt::format("Connection {} is already the host.", peer.id));
         return;
     }
 
     assignHost(peer);
-    LINFO(fmt::format("Switched host from {} to {}.", oldHostPeerId, peer->id));
+    LINFO(fmt::format("Switched host from {} to {}.", oldHostPeerId, peer.id));
 }
 
-void ParallelServer::handleHostshipResignation(std::shared_ptr<Peer> peer,
-                                               std::vector<char>)
-{
-    LINFO(fmt::format("Connection {} wants to resign its hostship.", peer->id));
-
-    size_t oldHostPeerId = 0;
-    {
-        std::lock_guard<std::mutex> lock(_hostInfoMutex);
-        oldHostPeerId = _hostPeerId;
-    }
+void ParallelServer::handleHostshipResignation(Peer& peer) {
+    LINFO(fmt::format("Connection {} wants to resign its hostship.", peer.id));
 
     setToClient(peer);
 
-    LINFO(fmt::format("Connection {} resigned as host.", peer->id));
+    LINFO(fmt::format("Connection {} resigned as host.", peer.id));
 }
 
-bool ParallelServer::isConnected(std::shared_ptr<Peer> peer) const {
-    return peer->status != ParallelConnection::Status::Connecting &&
-           peer->status != ParallelConnection::Status::Disconnected;
+bool ParallelServer::isConnected(const Peer& peer) const {
+    return !peer.isDisconnecting &&
+           peer.status != ParallelConnection::Status::Connecting &&
+           peer.status != ParallelConnection::Status::Disconnected;
 }
 
-void ParallelServer::sendMessage(std::shared_ptr<Peer> peer,
-                                 ParallelConnection::MessageType messageType,
-                                 const std::vector<char>& message)
+void ParallelServer::sendMessage(Peer& peer, ParallelConnection::MessageType messageType,
+                                 const char* data, size_t size)
 {
-    peer->parallelConnection.sendMessage({ messageType, message });
+    if (peer.isDisconnecting) {
+        return;
+    }
+
+    constexpr const size_t HeaderSize = ParallelConnection::HeaderSize;
+    if (peer.outBuffer.size() + HeaderSize + size > peer.outBuffer.capacity()) {
+        // The peer does not keep up with the messages, so instead of letting it slow
+        // down the server, it is disconnected
+        LWARNING(fmt::format(
+            "Connection {} fell behind by more than {} bytes. Disconnecting",
+            peer.id, peer.outBuffer.capacity()
+        ));
+        disconnect(peer);
+        return;
+    }
+
+    const uint32_t protocolVersion = ParallelConnection::ProtocolVersion;
+    const uint32_t messageTypeOut = static_cast<uint32_t>(messageType);
+    const uint32_t messageSizeOut = static_cast<uint32_t>(size);
+    std::array<char, HeaderSize> header;
+    header[0] = 'O';
+    header[1] = 'S';
+    memcpy(header.data() + 2, &protocolVersion, sizeof(uint32_t));
+    memcpy(header.data() + 2 + sizeof(uint32_t), &messageTypeOut, sizeof(uint32_t));
+    memcpy(header.data() + 2 + 2 * sizeof(uint32_t), &messageSizeOut, sizeof(uint32_t));
+
+    peer.outBuffer.push(header.data(), header.size());
+    peer.outBuffer.push(data, size);
+
+    // Try to send right away; whatever the socket does not accept is sent as soon as
+    // the I/O loop reports the socket as writable
+    if (!peer.isWaitingForWrite) {
+        writeToPeer(peer);
+    }
 }
 
 void ParallelServer::sendMessageToAll(ParallelConnection::MessageType messageType,
-                                      const std::vector<char>& message)
+                                      const char* data, size_t size)
 {
-    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
-        if (isConnected(it.second)) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
+    for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
+        if (isConnected(*it.second)) {
+            sendMessage(*it.second, messageType, data, size);
         }
     }
 }
 
 void ParallelServer::sendMessageToClients(ParallelConnection::MessageType messageType,
-                                          const std::vector<char>& message)
+                                          const char* data, size_t size)
 {
-    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
+    for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
         if (it.second->status == ParallelConnection::Status::ClientWithHost) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
+            sendMessage(*it.second, messageType, data, size);
         }
     }
 }
 
-void ParallelServer::disconnect(std::shared_ptr<Peer> peer) {
-    if (isConnected(peer)) {
-        setNConnections(nConnections() - 1);
-    }
-
-    size_t hostPeerId = 0;
-    {
-        std::lock_guard<std::mutex> lock(_hostInfoMutex);
-        hostPeerId = _hostPeerId;
+void ParallelServer::disconnect(Peer& peer) {
+    if (peer.isDisconnecting) {
+        return;
     }
+    const bool wasConnected = isConnected(peer);
 
     // Make sure any disconnecting host is first degraded to client,
     // in order to notify other clients about host disconnection.
-    if (peer->id == hostPeerId) {
+    if (peer.id == _hostPeerId) {
         setToClient(peer);
     }
 
-    peer->parallelConnection.disconnect();
-    peer->thread.join();
-    _peers.erase(peer->id);
-}
+    // The peer is removed from the list at the end of the current I/O loop iteration
+    peer.isDisconnecting = true;
+    closeSocket(peer.socket);
+    peer.socket = InvalidSocket;
 
-void ParallelServer::setName(std::shared_ptr<Peer> peer, std::string name) {
-    peer->name = name;
-    size_t hostPeerId = 0;
-    {
-        std::lock_guard<std::mutex> lock(_hostInfoMutex);
-        hostPeerId = _hostPeerId;
+    if (wasConnected) {
+        setNConnections(nConnections() - 1);
     }
+}
+
+void ParallelServer::setName(Peer& peer, std::string name) {
+    peer.name = name;
 
     // Make sure everyone gets the new host name.
-    if (peer->id == hostPeerId) {
+    if (peer.id == _hostPeerId) {
         {
             std::lock_guard<std::mutex> lock(_hostInfoMutex);
             _hostName = name;
         }
 
-        for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
-            // sendConnectionStatus(it->second) ?
-            sendConnectionStatus(peer);
+        for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
+            sendConnectionStatus(*it.second);
         }
     }
 }
 
-void ParallelServer::assignHost(std::shared_ptr<Peer> newHost) {
+void ParallelServer::assignHost(Peer& newHost) {
     {
         std::lock_guard<std::mutex> lock(_hostInfoMutex);
-        std::shared_ptr<ParallelServer::Peer> oldHost = peer(_hostPeerId);
+        Peer* oldHost = peer(_hostPeerId);
 
         if (oldHost) {
             oldHost->status = ParallelConnection::Status::ClientWithHost;
         }
-        _hostPeerId = newHost->id;
-        _hostName = newHost->name;
+        _hostPeerId = newHost.id;
+        _hostName = newHost.name;
     }
-    newHost->status = ParallelConnection::Status::Host;
+    newHost.status = ParallelConnection::Status::Host;
 
-    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
-        if (it.second != newHost) {
+    for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
+        if (it.second.get() != &newHost) {
             it.second->status = ParallelConnection::Status::ClientWithHost;
         }
-        sendConnectionStatus(it.second);
+        sendConnectionStatus(*it.second);
     }
 }
 
-void ParallelServer::setToClient(std::shared_ptr<Peer> peer) {
-    if (peer->status == ParallelConnection::Status::Host) {
+void ParallelServer::setToClient(Peer& peer) {
+    if (peer.status == ParallelConnection::Status::Host) {
         {
             std::lock_guard<std::mutex> lock(_hostInfoMutex);
             _hostPeerId = 0;
@@ -380,12 +883,12 @@ void ParallelServer::setToClient(std::shared_ptr<Peer> peer) {
         }
 
         // If host becomes client, make all clients hostless.
-        for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
+        for (std::pair<const size_t, std::unique_ptr<Peer>>& it : _peers) {
             it.second->status = ParallelConnection::Status::ClientWithoutHost;
-            sendConnectionStatus(it.second);
+            sendConnectionStatus(*it.second);
         }
     } else {
-        peer->status = (_hostPeerId > 0) ?
+        peer.status = (_hostPeerId > 0) ?
             ParallelConnection::Status::ClientWithHost :
             ParallelConnection::Status::ClientWithoutHost;
         sendConnectionStatus(peer);
@@ -394,19 +897,17 @@ void ParallelServer::setToClient(std::shared_ptr<Peer> peer) {
 
 void ParallelServer::setNConnections(size_t nConnections) {
     _nConnections = nConnections;
-    std::vector<char> data;
     const uint32_t n = static_cast<uint32_t>(_nConnections);
-    data.insert(
-        data.end(),
+    sendMessageToAll(
+        ParallelConnection::MessageType::NConnections,
         reinterpret_cast<const char*>(&n),
-        reinterpret_cast<const char*>(&n) + sizeof(uint32_t)
+        sizeof(uint32_t)
     );
-    sendMessageToAll(ParallelConnection::MessageType::NConnections, data);
 }
 
-void ParallelServer::sendConnectionStatus(std::shared_ptr<Peer> peer) {
+void ParallelServer::sendConnectionStatus(Peer& peer) {
     std::vector<char> data;
-    const uint32_t outStatus = static_cast<uint32_t>(peer->status);
+    const uint32_t outStatus = static_cast<uint32_t>(peer.status);
     data.insert(
         data.end(),
         reinterpret_cast<const char*>(&outStatus),
@@ -426,7 +927,12 @@ void ParallelServer::sendConnectionStatus(std::shared_ptr<Peer> peer) {
         reinterpret_cast<const char*>(_hostName.data() + outHostNameSize)
     );
 
-    sendMessage(peer, ParallelConnection::MessageType::ConnectionStatus, data);
+    sendMessage(
+        peer,
+        ParallelConnection::MessageType::ConnectionStatus,
+        data.data(),
+        data.size()
+    );
 }
 
 size_t ParallelServer::nConnections() const {
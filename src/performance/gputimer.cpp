@@ -0,0 +1,91 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/performance/gputimer.h>
+
+namespace openspace::performance {
+
+void GpuTimer::begin() {
+    if (_queries[0] == 0) {
+        glGenQueries(2, _queries);
+    }
+
+    collectResults();
+
+    if (_isPending[_current]) {
+        // The GPU is lagging behind by more than two measurements, so we would have to
+        // wait for the query to finish before we can reuse it
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, _queries[_current]);
+    _isRunning = true;
+}
+
+void GpuTimer::end() {
+    if (!_isRunning) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    _isPending[_current] = true;
+    _current = 1 - _current;
+    _isRunning = false;
+}
+
+long long GpuTimer::latestResult() const {
+    return _latestResult;
+}
+
+void GpuTimer::deinitialize() {
+    if (_queries[0] != 0) {
+        glDeleteQueries(2, _queries);
+        _queries[0] = 0;
+        _queries[1] = 0;
+    }
+    _isPending[0] = false;
+    _isPending[1] = false;
+    _isRunning = false;
+}
+
+void GpuTimer::collectResults() {
+    // The query at _current was issued before the other one, so it is read first to
+    // leave the newest result in _latestResult
+    for (int i : { _current, 1 - _current }) {
+        if (!_isPending[i]) {
+            continue;
+        }
+
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(_queries[i], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_FALSE) {
+            continue;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(_queries[i], GL_QUERY_RESULT, &elapsed);
+        _latestResult = static_cast<long long>(elapsed);
+        _isPending[i] = false;
+    }
+}
+
+} // namespace openspace::performance
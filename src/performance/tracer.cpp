@@ -0,0 +1,358 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/performance/tracer.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tracer_lua.inl"
+
+namespace {
+    constexpr const char* _loggerCat = "Tracer";
+
+    // A single zone in a thread's ring buffer. The owning thread is the only writer and
+    // the exporting thread the only reader, so the slot is guarded by a sequence counter
+    // instead of a lock: the counter is odd while the slot is being written and the
+    // reader discards everything that changed while it was copying the slot
+    struct Event {
+        std::atomic<uint64_t> sequence = { 0 };
+        std::atomic<const char*> name = { nullptr };
+        std::atomic<int64_t> begin = { 0 };
+        std::atomic<int64_t> end = { 0 };
+    };
+
+    struct ThreadBuffer {
+        std::atomic<const char*> name = { nullptr };
+        // The number of zones that have ever been written to this buffer
+        std::atomic<uint64_t> head = { 0 };
+        // Zones before this index have been removed by Tracer::clear
+        std::atomic<uint64_t> start = { 0 };
+        std::unique_ptr<Event[]> events = std::make_unique<Event[]>(
+            openspace::performance::Tracer::BufferSize
+        );
+    };
+
+    // The buffers are never destroyed while the application is running. When a thread
+    // exits, its buffer is put on the free list, but keeps its zones so that they can
+    // still be exported until a new thread takes over the buffer. This bounds the number
+    // of buffers by the number of threads that are tracing at the same time
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::vector<ThreadBuffer*> freeBuffers;
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    // Returns the buffer of the thread to the free list when the thread exits. It is
+    // separate from LocalBuffer so that recording a zone does not pay for the
+    // initialization check of a thread_local object with a destructor
+    struct BufferReleaser {
+        ThreadBuffer* buffer = nullptr;
+
+        ~BufferReleaser() {
+            if (buffer) {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.freeBuffers.push_back(buffer);
+            }
+        }
+    };
+
+    std::atomic_bool IsEnabled = { false };
+    thread_local ThreadBuffer* LocalBuffer = nullptr;
+    thread_local BufferReleaser LocalBufferReleaser;
+    thread_local const char* LocalThreadName = nullptr;
+
+    int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    ThreadBuffer& localBuffer() {
+        if (!LocalBuffer) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            if (r.freeBuffers.empty()) {
+                r.buffers.push_back(std::make_unique<ThreadBuffer>());
+                LocalBuffer = r.buffers.back().get();
+            }
+            else {
+                // The zones of the thread that used this buffer before are discarded
+                LocalBuffer = r.freeBuffers.back();
+                r.freeBuffers.pop_back();
+                LocalBuffer->start = LocalBuffer->head.load(std::memory_order_relaxed);
+            }
+            LocalBuffer->name = LocalThreadName;
+            LocalBufferReleaser.buffer = LocalBuffer;
+        }
+        return *LocalBuffer;
+    }
+
+    void record(const char* name, int64_t begin, int64_t end) {
+        using openspace::performance::Tracer;
+
+        ThreadBuffer& buffer = localBuffer();
+        const uint64_t n = buffer.head.load(std::memory_order_relaxed);
+        Event& e = buffer.events[n % Tracer::BufferSize];
+
+        e.sequence.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.name.store(name, std::memory_order_relaxed);
+        e.begin.store(begin, std::memory_order_relaxed);
+        e.end.store(end, std::memory_order_relaxed);
+        e.sequence.store(2 * n + 2, std::memory_order_release);
+
+        buffer.head.store(n + 1, std::memory_order_release);
+    }
+
+    struct RecordedZone {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+    };
+
+    // Returns a consistent copy of all zones that are currently stored in the buffer
+    std::vector<RecordedZone> readZones(const ThreadBuffer& buffer) {
+        using openspace::performance::Tracer;
+
+        const uint64_t head = buffer.head.load(std::memory_order_acquire);
+        const uint64_t start = std::max(
+            buffer.start.load(std::memory_order_relaxed),
+            head > Tracer::BufferSize ? head - Tracer::BufferSize : 0
+        );
+
+        std::vector<RecordedZone> zones;
+        zones.reserve(head - std::min(start, head));
+        for (uint64_t n = start; n < head; ++n) {
+            const Event& e = buffer.events[n % Tracer::BufferSize];
+
+            const uint64_t before = e.sequence.load(std::memory_order_acquire);
+            if (before != 2 * n + 2) {
+                // The slot has been overwritten by a newer zone in the meantime
+                continue;
+            }
+            const RecordedZone zone = {
+                e.name.load(std::memory_order_relaxed),
+                e.begin.load(std::memory_order_relaxed),
+                e.end.load(std::memory_order_relaxed)
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            zones.push_back(zone);
+        }
+        return zones;
+    }
+
+    void writeEscaped(std::ostream& out, const char* s) {
+        out << '"';
+        for (; *s != '\0'; ++s) {
+            const unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\') {
+                out << '\\' << *s;
+            }
+            else if (c < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << static_cast<int>(c) << std::dec;
+            }
+            else {
+                out << *s;
+            }
+        }
+        out << '"';
+    }
+
+    // Chrome traces expect timestamps in microseconds
+    void writeMicroseconds(std::ostream& out, int64_t ns) {
+        out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+    }
+} // namespace
+
+namespace openspace::performance {
+
+Tracer::Zone::Zone(const char* name)
+    : _name(IsEnabled.load(std::memory_order_relaxed) ? name : nullptr)
+{
+    if (_name) {
+        _begin = now();
+    }
+}
+
+Tracer::Zone::~Zone() {
+    if (_name) {
+        record(_name, _begin, now());
+    }
+}
+
+void Tracer::setEnabled(bool enabled) {
+    IsEnabled = enabled;
+}
+
+bool Tracer::isEnabled() {
+    return IsEnabled;
+}
+
+void Tracer::setThreadName(const char* name) {
+    LocalThreadName = name;
+    if (LocalBuffer) {
+        LocalBuffer->name.store(name, std::memory_order_relaxed);
+    }
+}
+
+bool Tracer::writeChromeTrace(const std::string& filename) {
+    struct ThreadZones {
+        const char* name;
+        std::vector<RecordedZone> zones;
+    };
+    std::vector<ThreadZones> threads;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        threads.reserve(r.buffers.size());
+        for (const std::unique_ptr<ThreadBuffer>& b : r.buffers) {
+            threads.push_back({ b->name.load(std::memory_order_relaxed), readZones(*b) });
+        }
+    }
+
+    int64_t origin = std::numeric_limits<int64_t>::max();
+    for (ThreadZones& t : threads) {
+        // Sort parents before their children so that viewers nest them correctly
+        std::sort(
+            t.zones.begin(),
+            t.zones.end(),
+            [](const RecordedZone& lhs, const RecordedZone& rhs) {
+                return lhs.begin < rhs.begin ||
+                       (lhs.begin == rhs.begin && lhs.end > rhs.end);
+            }
+        );
+        if (!t.zones.empty()) {
+            origin = std::min(origin, t.zones.front().begin);
+        }
+    }
+
+    std::ofstream file(filename);
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open file '{}' for writing", filename));
+        return false;
+    }
+
+    file << "{\"traceEvents\":[";
+    bool isFirst = true;
+    for (size_t i = 0; i < threads.size(); ++i) {
+        const ThreadZones& t = threads[i];
+        const size_t tid = i + 1;
+
+        if (t.name) {
+            file << (isFirst ? "\n" : ",\n");
+            file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid
+                 << R"(,"args":{"name":)";
+            writeEscaped(file, t.name);
+            file << "}}";
+            isFirst = false;
+        }
+
+        for (const RecordedZone& z : t.zones) {
+            file << (isFirst ? "\n" : ",\n");
+            file << R"({"name":)";
+            writeEscaped(file, z.name);
+            file << R"(,"ph":"X","pid":1,"tid":)" << tid << R"(,"ts":)";
+            writeMicroseconds(file, z.begin - origin);
+            file << R"(,"dur":)";
+            writeMicroseconds(file, z.end - z.begin);
+            file << '}';
+            isFirst = false;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return file.good();
+}
+
+void Tracer::clear() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const std::unique_ptr<ThreadBuffer>& b : r.buffers) {
+        b->start = b->head.load(std::memory_order_acquire);
+    }
+}
+
+scripting::LuaLibrary Tracer::luaLibrary() {
+    return {
+        "tracing",
+        {
+            {
+                "setEnabled",
+                &luascriptfunctions::tracing::setEnabled,
+                {},
+                "bool",
+                "Enables or disables the recording of trace zones"
+            },
+            {
+                "isEnabled",
+                &luascriptfunctions::tracing::isEnabled,
+                {},
+                "",
+                "Returns whether trace zones are currently being recorded"
+            },
+            {
+                "exportChromeTrace",
+                &luascriptfunctions::tracing::exportChromeTrace,
+                {},
+                "string",
+                "Writes the recorded trace zones of all threads to the provided file in "
+                "the Chrome trace event format, which can be opened in chrome://tracing "
+                "or in the Perfetto UI"
+            },
+            {
+                "clear",
+                &luascriptfunctions::tracing::clear,
+                {},
+                "",
+                "Removes all trace zones that have been recorded so far"
+            }
+        }
+    };
+}
+
+} // namespace openspace::performance
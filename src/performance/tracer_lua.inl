@@ -0,0 +1,76 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+namespace openspace::luascriptfunctions::tracing {
+
+int setEnabled(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::setEnabled");
+
+    const bool enabled = ghoul::lua::value<bool>(L, 1, ghoul::lua::PopValue::Yes);
+    performance::Tracer::setEnabled(enabled);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+int isEnabled(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::isEnabled");
+
+    ghoul::lua::push(L, performance::Tracer::isEnabled());
+
+    ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
+    return 1;
+}
+
+int exportChromeTrace(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::exportChromeTrace");
+
+    const std::string& fileName = ghoul::lua::value<std::string>(
+        L,
+        1,
+        ghoul::lua::PopValue::Yes
+    );
+    if (fileName.empty()) {
+        return ghoul::lua::luaError(L, "Filepath is empty");
+    }
+
+    const bool success = performance::Tracer::writeChromeTrace(absPath(fileName));
+    if (!success) {
+        return ghoul::lua::luaError(L, "Could not write trace to '" + fileName + "'");
+    }
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+int clear(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::clear");
+
+    performance::Tracer::clear();
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+} // namespace openspace::luascriptfunctions::tracing
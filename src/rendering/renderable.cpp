@@ -140,6 +140,10 @@ void Renderable::deinitializeGL() {}
 
 void Renderable::update(const UpdateData&) {}
 
+bool Renderable::supportsParallelUpdate() const {
+    return false;
+}
+
 void Renderable::render(const RenderData&, RendererTasks&) {}
 
 void Renderable::setBoundingSphere(float boundingSphere) {
@@ -84,6 +84,10 @@ bool Rotation::initialize() {
     return true;
 }
 
+bool Rotation::supportsParallelUpdate() const {
+    return true;
+}
+
 const glm::dmat3& Rotation::matrix() const {
     return _cachedMatrix;
 }
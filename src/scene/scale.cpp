@@ -79,6 +79,10 @@ bool Scale::initialize() {
     return true;
 }
 
+bool Scale::supportsParallelUpdate() const {
+    return true;
+}
+
 double Scale::scaleValue() const {
     return _cachedScale;
 }
@@ -26,6 +26,7 @@
 
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
+#include <openspace/performance/tracer.h>
 #include <openspace/query/query.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scripting/lualibrary.h>
@@ -33,7 +34,12 @@
 #include <openspace/util/camera.h>
 #include <openspace/scene/scenelicensewriter.h>
 #include <openspace/scene/sceneinitializer.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/opengl/programobject.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <string>
 #include <stack>
 
@@ -43,6 +49,77 @@ namespace {
     constexpr const char* _loggerCat = "Scene";
     constexpr const char* KeyIdentifier = "Identifier";
     constexpr const char* KeyParent = "Parent";
+
+    // Smaller groups of nodes are updated on the calling thread, as waking up the
+    // workers would take longer than the update itself
+    constexpr const size_t MinimumParallelUpdateNodes = 32;
+
+    // Calls \p function for each of the \p nodes. If a \p pool is provided, its
+    // \p nThreads threads and the calling thread take the nodes one after another
+    template <typename Function>
+    void updateNodes(const std::vector<openspace::SceneGraphNode*>& nodes,
+                     openspace::ThreadPool* pool, unsigned int nThreads,
+                     Function function)
+    {
+        auto update = [&function](openspace::SceneGraphNode& node) {
+            try {
+                function(node);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.what());
+            }
+        };
+
+        if (!pool || nThreads == 0 || nodes.size() < MinimumParallelUpdateNodes) {
+            for (openspace::SceneGraphNode* node : nodes) {
+                update(*node);
+            }
+            return;
+        }
+
+        std::atomic<size_t> nextNode(0);
+        std::atomic_bool hasFailed(false);
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable finished;
+        unsigned int nRunningThreads = nThreads;
+
+        auto work = [&]() {
+            try {
+                size_t i = nextNode++;
+                while (i < nodes.size() && !hasFailed) {
+                    update(*nodes[i]);
+                    i = nextNode++;
+                }
+            }
+            catch (...) {
+                // Only the first exception is kept and rethrown on the calling thread
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!hasFailed.exchange(true)) {
+                    exception = std::current_exception();
+                }
+            }
+        };
+
+        for (unsigned int i = 0; i < nThreads; ++i) {
+            pool->enqueue([&]() {
+                work();
+                // Notifying under the lock keeps the condition variable alive until
+                // the calling thread has been woken up
+                std::lock_guard<std::mutex> lock(mutex);
+                --nRunningThreads;
+                finished.notify_one();
+            });
+        }
+
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&nRunningThreads]() { return nRunningThreads == 0; });
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
 } // namespace
 
 namespace openspace {
@@ -52,10 +129,14 @@ Scene::InvalidSceneError::InvalidSceneError(const std::string& msg,
     : ghoul::RuntimeError(msg, comp)
 {}
 
-Scene::Scene(std::unique_ptr<SceneInitializer> initializer)
+Scene::Scene(std::unique_ptr<SceneInitializer> initializer, unsigned int nUpdateThreads)
     : properties::PropertyOwner({"Scene", "Scene"})
     , _initializer(std::move(initializer))
+    , _nUpdateThreads(nUpdateThreads)
 {
+    if (_nUpdateThreads > 0) {
+        _updatePool = std::make_unique<ThreadPool>(_nUpdateThreads);
+    }
     _rootDummy.setIdentifier(SceneGraphNode::RootNodeIdentifier);
     _rootDummy.setScene(this);
 }
@@ -119,6 +200,7 @@ void Scene::markNodeRegistryDirty() {
 
 void Scene::updateNodeRegistry() {
     sortTopologically();
+    groupNodesIntoUpdateLevels();
     _dirtyNodeRegistry = false;
 }
 
@@ -199,6 +281,51 @@ void Scene::sortTopologically() {
     _topologicallySortedNodes = nodes;
 }
 
+void Scene::groupNodesIntoUpdateLevels() {
+    _updateLevels.clear();
+    _parallelRenderableNodes.clear();
+    _serialRenderableNodes.clear();
+
+    // As the nodes are sorted topologically, the levels of a node's parent and
+    // dependencies are known by the time the node itself is visited
+    std::unordered_map<const SceneGraphNode*, size_t> levels;
+    for (SceneGraphNode* node : _topologicallySortedNodes) {
+        size_t level = 0;
+        auto placeAfter = [&levels, &level](const SceneGraphNode* n) {
+            const auto it = levels.find(n);
+            if (it != levels.end()) {
+                level = std::max(level, it->second + 1);
+            }
+        };
+        if (node->parent()) {
+            placeAfter(node->parent());
+        }
+        for (const SceneGraphNode* dependency : node->dependencies()) {
+            placeAfter(dependency);
+        }
+        levels[node] = level;
+
+        if (_updateLevels.size() <= level) {
+            _updateLevels.resize(level + 1);
+        }
+        if (node->supportsParallelTransformUpdate()) {
+            _updateLevels[level].parallelNodes.push_back(node);
+        }
+        else {
+            _updateLevels[level].serialNodes.push_back(node);
+        }
+
+        if (node->renderable()) {
+            if (node->supportsParallelRenderableUpdate()) {
+                _parallelRenderableNodes.push_back(node);
+            }
+            else {
+                _serialRenderableNodes.push_back(node);
+            }
+        }
+    }
+}
+
 void Scene::initializeNode(SceneGraphNode* node) {
     _initializer->initializeNode(node);
 }
@@ -277,6 +404,8 @@ void Scene::initializeGL() {
 */
 
 void Scene::update(const UpdateData& data) {
+    TraceZone("Scene::update");
+
     std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
 
     for (SceneGraphNode* node : initializedNodes) {
@@ -289,6 +418,10 @@ void Scene::update(const UpdateData& data) {
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
     }
+    if (_updatePool) {
+        updateNodesInParallel(data);
+        return;
+    }
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
             LTRACE("Scene::update(begin '" + node->identifier() + "')");
@@ -301,6 +434,33 @@ void Scene::update(const UpdateData& data) {
     }
 }
 
+void Scene::updateNodesInParallel(const UpdateData& data) {
+    ThreadPool* pool = _updatePool.get();
+    const unsigned int nThreads = _nUpdateThreads;
+    auto updateTransforms = [&data](SceneGraphNode& node) {
+        node.updateTransforms(data);
+    };
+    auto updateRenderable = [&data](SceneGraphNode& node) {
+        node.updateRenderable(data);
+    };
+
+    {
+        TraceZone("Scene::updateTransforms");
+        for (const UpdateLevel& level : _updateLevels) {
+            updateNodes(level.parallelNodes, pool, nThreads, updateTransforms);
+            updateNodes(level.serialNodes, nullptr, 0, updateTransforms);
+        }
+    }
+
+    // Renderables can depend on the transforms of any node, so they are only updated
+    // once all transforms are up to date
+    {
+        TraceZone("Scene::updateRenderables");
+        updateNodes(_parallelRenderableNodes, pool, nThreads, updateRenderable);
+        updateNodes(_serialRenderableNodes, nullptr, 0, updateRenderable);
+    }
+}
+
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
@@ -343,6 +503,10 @@ const std::vector<SceneGraphNode*>& Scene::allSceneGraphNodes() const {
     return _topologicallySortedNodes;
 }
 
+const std::vector<Scene::UpdateLevel>& Scene::updateLevels() const {
+    return _updateLevels;
+}
+
 SceneGraphNode* Scene::loadNode(const ghoul::Dictionary& nodeDictionary) {
     // First interpret the dictionary
     std::vector<std::string> dependencyNames;
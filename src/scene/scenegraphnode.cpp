@@ -31,7 +31,6 @@
 #include <openspace/scene/scene.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
-#include <ghoul/opengl/ghoul_gl.h>
 
 #include "scenegraphnode_doc.inl"
 
@@ -219,6 +218,7 @@ void SceneGraphNode::deinitializeGL() {
     if (_renderable) {
         _renderable->deinitializeGL();
     }
+    _renderTimer.deinitialize();
 }
 
 void SceneGraphNode::traversePreOrder(const std::function<void(SceneGraphNode*)>& fn) {
@@ -236,18 +236,21 @@ void SceneGraphNode::traversePostOrder(const std::function<void(SceneGraphNode*)
 }
 
 void SceneGraphNode::update(const UpdateData& data) {
+    updateTransforms(data);
+    updateRenderable(data);
+}
+
+void SceneGraphNode::updateTransforms(const UpdateData& data) {
     State s = _state;
     if (s != State::Initialized && _state != State::GLInitialized) {
         return;
     }
     if (_transform.translation) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.translation->update(data.time);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeTranslation = (end - start).count();
         }
@@ -258,12 +261,10 @@ void SceneGraphNode::update(const UpdateData& data) {
 
     if (_transform.rotation) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.rotation->update(data.time);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeRotation = (end - start).count();
         }
@@ -274,12 +275,10 @@ void SceneGraphNode::update(const UpdateData& data) {
 
     if (_transform.scale) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.scale->update(data.time);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeScaling = (end - start).count();
         }
@@ -287,42 +286,41 @@ void SceneGraphNode::update(const UpdateData& data) {
             _transform.scale->update(data.time);
         }
     }
-    UpdateData newUpdateData = data;
 
     _worldRotationCached = calculateWorldRotation();
     _worldScaleCached = calculateWorldScale();
     // Assumes _worldRotationCached and _worldScaleCached have been calculated for parent
     _worldPositionCached = calculateWorldPosition();
 
-    newUpdateData.modelTransform.translation = worldPosition();
-    newUpdateData.modelTransform.rotation = worldRotationMatrix();
-    newUpdateData.modelTransform.scale = worldScale();
-
-    glm::dmat4 translation = glm::translate(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.translation
-    );
-    glm::dmat4 rotation = glm::dmat4(newUpdateData.modelTransform.rotation);
+    glm::dmat4 translation = glm::translate(glm::dmat4(1.0), _worldPositionCached);
+    glm::dmat4 rotation = glm::dmat4(_worldRotationCached);
     glm::dmat4 scaling = glm::scale(
         glm::dmat4(1.0),
-        glm::dvec3(
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale
-        )
+        glm::dvec3(_worldScaleCached, _worldScaleCached, _worldScaleCached)
     );
 
     _modelTransformCached = translation * rotation * scaling;
     _inverseModelTransformCached = glm::inverse(_modelTransformCached);
+    _hasCachedTransforms = true;
+}
+
+void SceneGraphNode::updateRenderable(const UpdateData& data) {
+    // The node might have finished its initialization after its transforms were updated
+    if (!_hasCachedTransforms) {
+        return;
+    }
 
     if (_renderable && _renderable->isReady()) {
+        UpdateData newUpdateData = data;
+        newUpdateData.modelTransform.translation = worldPosition();
+        newUpdateData.modelTransform.rotation = worldRotationMatrix();
+        newUpdateData.modelTransform.scale = worldScale();
+
         if (data.doPerformanceMeasurement) {
-            glFinish();
             auto start = std::chrono::high_resolution_clock::now();
 
             _renderable->update(newUpdateData);
 
-            glFinish();
             auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeRenderable = (end - start).count();
         }
@@ -332,6 +330,16 @@ void SceneGraphNode::update(const UpdateData& data) {
     }
 }
 
+bool SceneGraphNode::supportsParallelTransformUpdate() const {
+    return (!_transform.translation || _transform.translation->supportsParallelUpdate())
+        && (!_transform.rotation || _transform.rotation->supportsParallelUpdate())
+        && (!_transform.scale || _transform.scale->supportsParallelUpdate());
+}
+
+bool SceneGraphNode::supportsParallelRenderableUpdate() const {
+    return !_renderable || _renderable->supportsParallelUpdate();
+}
+
 void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
     if (_state != State::GLInitialized) {
         return;
@@ -361,14 +369,10 @@ void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
 
     if (visible) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
-            auto start = std::chrono::high_resolution_clock::now();
-
+            _renderTimer.begin();
             _renderable->render(newData, tasks);
-
-            glFinish();
-            auto end = std::chrono::high_resolution_clock::now();
-            _performanceRecord.renderTime = (end - start).count();
+            _renderTimer.end();
+            _performanceRecord.renderTime = _renderTimer.latestResult();
         }
         else {
             _renderable->render(newData, tasks);
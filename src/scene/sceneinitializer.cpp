@@ -25,6 +25,7 @@
 #include <openspace/scene/sceneinitializer.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/performance/tracer.h>
 #include <openspace/rendering/loadingscreen.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <ghoul/logging/logmanager.h>
@@ -32,6 +33,7 @@
 namespace openspace {
 
 void SingleThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
+    TraceZone("SceneInitializer::initializeNode");
     node->initialize();
     _initializedNodes.push_back(node);
 }
@@ -51,6 +53,9 @@ MultiThreadedSceneInitializer::MultiThreadedSceneInitializer(unsigned int nThrea
 
 void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
     auto initFunction = [this, node]() {
+        performance::Tracer::setThreadName("SceneInitializer");
+        TraceZone("SceneInitializer::initializeNode");
+
         LoadingScreen& loadingScreen = OsEng.loadingScreen();
 
         loadingScreen.updateItem(
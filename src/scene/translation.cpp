@@ -91,6 +91,28 @@ void Translation::update(const Time& time) {
     }
 }
 
+bool Translation::supportsParallelUpdate() const {
+    return true;
+}
+
+std::vector<glm::dvec3> Translation::positions(const std::vector<double>& times) const {
+    const BatchSampler sampler = batchSampler();
+    if (sampler) {
+        return sampler(times);
+    }
+
+    std::vector<glm::dvec3> result;
+    result.reserve(times.size());
+    for (double t : times) {
+        result.push_back(position(t));
+    }
+    return result;
+}
+
+Translation::BatchSampler Translation::batchSampler() const {
+    return BatchSampler();
+}
+
 glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
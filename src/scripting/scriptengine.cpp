@@ -641,12 +641,27 @@ void ScriptEngine::preSync(bool isMaster) {
 }
 
 void ScriptEngine::encode(SyncBuffer* syncBuffer) {
-    syncBuffer->encode(_currentSyncedScript);
+    if (syncBuffer->onlyEncodeChanges()) {
+        // Most frames do not carry a script, so we only pay for a flag in that case
+        const bool hasScript = !_currentSyncedScript.empty();
+        syncBuffer->encode(hasScript);
+        if (hasScript) {
+            syncBuffer->encode(_currentSyncedScript);
+        }
+    }
+    else {
+        syncBuffer->encode(_currentSyncedScript);
+    }
     _currentSyncedScript.clear();
 }
 
 void ScriptEngine::decode(SyncBuffer* syncBuffer) {
-    syncBuffer->decode(_currentSyncedScript);
+    if (!syncBuffer->onlyEncodeChanges() || syncBuffer->decode<bool>()) {
+        syncBuffer->decode(_currentSyncedScript);
+    }
+    else {
+        _currentSyncedScript.clear();
+    }
 
     if (!_currentSyncedScript.empty()) {
         _mutex.lock();
@@ -0,0 +1,166 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <utility>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename) {
+#ifdef WIN32
+    HANDLE file = CreateFileA(
+        filename.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    _fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        unmap();
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        unmap();
+        return;
+    }
+    _mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        unmap();
+        return;
+    }
+    _data = static_cast<const char*>(view);
+    _size = static_cast<size_t>(size.QuadPart);
+#else // WIN32
+    _fileDescriptor = open(filename.c_str(), O_RDONLY);
+    if (_fileDescriptor == -1) {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(_fileDescriptor, &status) == -1 || status.st_size == 0) {
+        unmap();
+        return;
+    }
+
+    void* view = mmap(
+        nullptr,
+        static_cast<size_t>(status.st_size),
+        PROT_READ,
+        MAP_PRIVATE,
+        _fileDescriptor,
+        0
+    );
+    if (view == MAP_FAILED) {
+        unmap();
+        return;
+    }
+    _data = static_cast<const char*>(view);
+    _size = static_cast<size_t>(status.st_size);
+#endif // WIN32
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    unmap();
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+#ifdef WIN32
+        std::swap(_fileHandle, other._fileHandle);
+        std::swap(_mappingHandle, other._mappingHandle);
+#else // WIN32
+        std::swap(_fileDescriptor, other._fileDescriptor);
+#endif // WIN32
+    }
+    return *this;
+}
+
+bool MemoryMappedFile::isValid() const {
+    return _data != nullptr;
+}
+
+const char* MemoryMappedFile::data() const {
+    return _data;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+void MemoryMappedFile::unmap() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+    }
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else // WIN32
+    if (_data) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+    if (_fileDescriptor != -1) {
+        close(_fileDescriptor);
+    }
+    _fileDescriptor = -1;
+#endif // WIN32
+    _data = nullptr;
+    _size = 0;
+}
+
+} // namespace openspace
@@ -31,6 +31,8 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
 
@@ -82,12 +84,123 @@ namespace {
             default:                            throw ghoul::MissingCaseException();
         }
     }
+
+    // The number of results that are kept in each generation of a MemoCache
+    constexpr const size_t MemoCacheSize = 4096;
+
+    template <typename T>
+    void hashCombine(size_t& seed, const T& value) {
+        seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    // Keeps the results of recent queries in two generations. Once the current
+    // generation is full, it replaces the previous one, which drops the results that
+    // have not been used since. Results that are found in the previous generation are
+    // moved to the current one, so queries that are repeated every frame are kept
+    template <typename Key, typename Value, typename Hash>
+    class MemoCache {
+    public:
+        const Value* find(const Key& key) {
+            const auto it = _current.find(key);
+            if (it != _current.end()) {
+                return &it->second;
+            }
+            const auto previous = _previous.find(key);
+            if (previous != _previous.end()) {
+                Value value = std::move(previous->second);
+                _previous.erase(previous);
+                return &insert(key, std::move(value));
+            }
+            return nullptr;
+        }
+
+        const Value& insert(const Key& key, Value value) {
+            if (_current.size() >= MemoCacheSize) {
+                _previous = std::move(_current);
+                _current.clear();
+            }
+            return _current.insert_or_assign(key, std::move(value)).first->second;
+        }
+
+        void clear() {
+            _current.clear();
+            _previous.clear();
+        }
+
+    private:
+        std::unordered_map<Key, Value, Hash> _current;
+        std::unordered_map<Key, Value, Hash> _previous;
+    };
+
+    int aberrationKey(openspace::SpiceManager::AberrationCorrection correction) {
+        return static_cast<int>(correction.type) * 2 +
+               static_cast<int>(correction.direction);
+    }
 }
 
 #include "spicemanager_lua.inl"
 
 namespace openspace {
 
+struct SpiceManager::QueryCache {
+    struct PositionQuery {
+        std::string target;
+        std::string observer;
+        std::string frame;
+        int aberration;
+        double time;
+
+        bool operator==(const PositionQuery& rhs) const {
+            return time == rhs.time && aberration == rhs.aberration &&
+                   target == rhs.target && observer == rhs.observer &&
+                   frame == rhs.frame;
+        }
+    };
+    struct PositionQueryHash {
+        size_t operator()(const PositionQuery& q) const {
+            size_t seed = std::hash<double>()(q.time);
+            hashCombine(seed, q.target);
+            hashCombine(seed, q.observer);
+            hashCombine(seed, q.frame);
+            hashCombine(seed, q.aberration);
+            return seed;
+        }
+    };
+    struct Position {
+        glm::dvec3 position;
+        double lightTime;
+    };
+
+    struct TransformQuery {
+        std::string source;
+        std::string destination;
+        double time;
+
+        bool operator==(const TransformQuery& rhs) const {
+            return time == rhs.time && source == rhs.source &&
+                   destination == rhs.destination;
+        }
+    };
+    struct TransformQueryHash {
+        size_t operator()(const TransformQuery& q) const {
+            size_t seed = std::hash<double>()(q.time);
+            hashCombine(seed, q.source);
+            hashCombine(seed, q.destination);
+            return seed;
+        }
+    };
+
+    MemoCache<PositionQuery, Position, PositionQueryHash> positions;
+    MemoCache<TransformQuery, glm::dmat3, TransformQueryHash> transforms;
+    std::map<int, FieldOfViewResult> fieldsOfView;
+
+    void clear() {
+        positions.clear();
+        transforms.clear();
+        fieldsOfView.clear();
+    }
+};
+
 SpiceManager::SpiceException::SpiceException(const std::string& msg)
     : ghoul::RuntimeError(msg, "Spice")
 {
@@ -167,7 +280,7 @@ SpiceManager::TerminatorType SpiceManager::terminatorTypeFromString(
     return Mapping.at(type);
 }
 
-SpiceManager::SpiceManager() {
+SpiceManager::SpiceManager() : _cache(std::make_unique<QueryCache>()) {
     // Set the SPICE library to not exit the program if an error occurs
     erract_c("SET", 0, const_cast<char*>("REPORT")); // NOLINT
     // But we do not want SPICE to print the errors, we will fetch them ourselves
@@ -198,6 +311,8 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
         )
     );
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     std::string path = absPath(std::move(filePath));
     const auto it = std::find_if(
         _loadedKernels.begin(),
@@ -250,6 +365,8 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
     KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
     _loadedKernels.push_back({std::move(path), kernelId, 1});
+    // The new kernel might provide better data for previously answered queries
+    _cache->clear();
     return kernelId;
 }
 
@@ -257,6 +374,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     const auto it = std::find_if(
         _loadedKernels.begin(),
         _loadedKernels.end(),
@@ -270,6 +389,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            _cache->clear();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -282,6 +402,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 void SpiceManager::unloadKernel(std::string filePath) {
     ghoul_assert(!filePath.empty(), "Empty filename");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     std::string path = absPath(std::move(filePath));
 
     const auto it = std::find_if(
@@ -291,7 +413,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
     );
 
     if (it == _loadedKernels.end()) {
-        if (_useExceptions) {
+        if (exceptionHandling()) {
             throw SpiceException(
                 fmt::format("'{}' did not correspond to a loaded kernel", path)
             );
@@ -306,6 +428,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
             _loadedKernels.erase(it);
+            _cache->clear();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -318,7 +441,12 @@ void SpiceManager::unloadKernel(std::string filePath) {
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
     ghoul_assert(!target.empty(), "Empty target");
 
-    const int id = naifId(target);
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    return hasSpkCoverage(naifId(target), et);
+}
+
+bool SpiceManager::hasSpkCoverage(int id, double et) const {
     const auto it = _spkIntervals.find(id);
     if (it != _spkIntervals.end()) {
         const std::vector<std::pair<double, double>>& intervalVector = it->second;
@@ -334,6 +462,8 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
     ghoul_assert(!frame.empty(), "Empty target");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     const int id = frameId(frame);
     const auto it = _ckIntervals.find(id);
     if (it != _ckIntervals.end()) {
@@ -348,6 +478,8 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     return bodfnd_c(naifId, item.c_str());
 }
 
@@ -362,10 +494,12 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 int SpiceManager::naifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
-    if (!success && _useExceptions) {
+    if (!success && exceptionHandling()) {
         throw SpiceException(fmt::format("Could not find NAIF ID of body '{}'", body));
     }
     return id;
@@ -374,6 +508,8 @@ int SpiceManager::naifId(const std::string& body) const {
 bool SpiceManager::hasNaifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
@@ -384,9 +520,11 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 int SpiceManager::frameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
-    if (id == 0 && _useExceptions) {
+    if (id == 0 && exceptionHandling()) {
         throw SpiceException(fmt::format("Could not find NAIF ID of frame '{}'", frame));
     }
     return id;
@@ -395,6 +533,8 @@ int SpiceManager::frameId(const std::string& frame) const {
 bool SpiceManager::hasFrameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     return id != 0;
@@ -416,24 +556,32 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
@@ -442,12 +590,16 @@ void SpiceManager::getValue(const std::string& body, const std::string& value,
 {
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
 }
 
 double SpiceManager::spacecraftClockToET(const std::string& craft, double craftTicks) {
     ghoul_assert(!craft.empty(), "Empty craft");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     int craftId = naifId(craft);
     double et;
     sct2e_c(craftId, craftTicks, &et);
@@ -460,6 +612,8 @@ double SpiceManager::spacecraftClockToET(const std::string& craft, double craftT
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     double et;
     str2et_c(timeString.c_str(), &et);
     throwOnSpiceError(fmt::format("Error converting date '{}'", timeString));
@@ -471,6 +625,8 @@ std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime,
 {
     ghoul_assert(!formatString.empty(), "Format is empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     constexpr const int BufferSize = 256;
     SpiceChar buffer[BufferSize];
     timout_c(ephemerisTime, formatString.c_str(), BufferSize - 1, buffer);
@@ -483,6 +639,16 @@ std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime,
     return std::string(buffer);
 }
 
+glm::dvec3 SpiceManager::rectangularFromRaDec(double range, double rightAscension,
+                                              double declination) const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    glm::dvec3 result;
+    radrec_c(range, rightAscension, declination, glm::value_ptr(result));
+    return result;
+}
+
 glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         const std::string& observer,
                                         const std::string& referenceFrame,
@@ -493,10 +659,104 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    const QueryCache::PositionQuery query = {
+        target,
+        observer,
+        referenceFrame,
+        aberrationKey(aberrationCorrection),
+        ephemerisTime
+    };
+    if (const QueryCache::Position* cached = _cache->positions.find(query)) {
+        lightTime = cached->lightTime;
+        return cached->position;
+    }
+
+    bool isValid = true;
+    const glm::dvec3 position = computeTargetPosition(
+        target,
+        observer,
+        referenceFrame,
+        aberrationCorrection,
+        ephemerisTime,
+        lightTime,
+        isValid
+    );
+    // Without exceptions, a failed query returns a default value that is not kept
+    if (isValid) {
+        _cache->positions.insert(query, { position, lightTime });
+    }
+    return position;
+}
+
+std::vector<glm::dvec3> SpiceManager::targetPositions(const std::string& target,
+                                                      const std::string& observer,
+                                                      const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                        const std::vector<double>& ephemerisTimes) const
+{
+    ghoul_assert(!target.empty(), "Target is not empty");
+    ghoul_assert(!observer.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
+
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    const int targetId = naifId(target);
+    const int observerId = naifId(observer);
+
+    std::vector<glm::dvec3> positions;
+    positions.reserve(ephemerisTimes.size());
+    for (double et : ephemerisTimes) {
+        double lightTime = 0.0;
+        if (hasSpkCoverage(targetId, et) && hasSpkCoverage(observerId, et)) {
+            // spkezp_c is the equivalent of spkpos_c that takes NAIF IDs instead of
+            // names, which saves the name lookup for every sample
+            glm::dvec3 position;
+            spkezp_c(
+                targetId,
+                et,
+                referenceFrame.c_str(),
+                aberrationCorrection,
+                observerId,
+                glm::value_ptr(position),
+                &lightTime
+            );
+            throwOnSpiceError(fmt::format(
+                "Error getting position from '{}' to '{}' in reference frame '{}' at "
+                "time {}",
+                target, observer, referenceFrame, et
+            ));
+            positions.push_back(position);
+        }
+        else {
+            bool isValid = true;
+            positions.push_back(computeTargetPosition(
+                target,
+                observer,
+                referenceFrame,
+                aberrationCorrection,
+                et,
+                lightTime,
+                isValid
+            ));
+        }
+    }
+    return positions;
+}
+
+glm::dvec3 SpiceManager::computeTargetPosition(const std::string& target,
+                                               const std::string& observer,
+                                               const std::string& referenceFrame,
+                                               AberrationCorrection aberrationCorrection,
+                                               double ephemerisTime,
+                                               double& lightTime, bool& isValid) const
+{
+    isValid = true;
     bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
     bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
-        if (_useExceptions) {
+        if (exceptionHandling()) {
             throw SpiceException(
                 fmt::format(
                     "Neither target '{}' nor observer '{}' has SPK coverage at time {}",
@@ -505,6 +765,8 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
             );
         }
         else {
+            // No SPICE function has failed, so the failure is only known here
+            isValid = false;
             return glm::dvec3();
         }
     }
@@ -519,7 +781,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
             glm::value_ptr(position),
             &lightTime
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error getting position from '{}' to '{}' in reference frame '{}' at time {}",
             target, observer, referenceFrame, ephemerisTime
         ));
@@ -533,7 +795,8 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
             referenceFrame,
             aberrationCorrection,
             ephemerisTime,
-            lightTime
+            lightTime,
+            isValid
         ) * -1.0;
     }
     else {
@@ -544,7 +807,8 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
             referenceFrame,
             aberrationCorrection,
             ephemerisTime,
-            lightTime
+            lightTime,
+            isValid
         );
     }
 }
@@ -573,6 +837,8 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     // get rotation matrix from frame A - frame B
     glm::dmat3 transform;
     pxform_c(
@@ -609,6 +875,8 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(directionVector != glm::dvec3(0.0), "Direction vector must not be zero");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     const std::string ComputationMethod = "ELLIPSOID";
 
     SurfaceInterceptResult result;
@@ -652,6 +920,8 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(!instrument.empty(), "Instrument must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     int visible;
     fovtrg_c(instrument.c_str(),
         target.c_str(),
@@ -699,6 +969,8 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     TargetStateResult result;
     result.lightTime = 0.0;
 
@@ -733,6 +1005,8 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     TransformMatrix m;
     sxform_c(
         sourceFrame.c_str(),
@@ -755,6 +1029,37 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    const QueryCache::TransformQuery query = {
+        sourceFrame,
+        destinationFrame,
+        ephemerisTime
+    };
+    if (const glm::dmat3* cached = _cache->transforms.find(query)) {
+        return *cached;
+    }
+
+    bool isValid = true;
+    const glm::dmat3 result = computePositionTransformMatrix(
+        sourceFrame,
+        destinationFrame,
+        ephemerisTime,
+        isValid
+    );
+    // Without exceptions, a failed query returns a default value that is not kept
+    if (isValid) {
+        _cache->transforms.insert(query, result);
+    }
+    return result;
+}
+
+glm::dmat3 SpiceManager::computePositionTransformMatrix(const std::string& sourceFrame,
+                                                   const std::string& destinationFrame,
+                                                        double ephemerisTime,
+                                                        bool& isValid) const
+{
+    isValid = true;
     glm::dmat3 result;
     pxform_c(
         sourceFrame.c_str(),
@@ -770,7 +1075,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
         result = getEstimatedTransformMatrix(
             sourceFrame,
             destinationFrame,
-            ephemerisTime
+            ephemerisTime,
+            isValid
         );
     }
 
@@ -785,6 +1091,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     glm::dmat3 result;
 
     pxfrm2_c(
@@ -810,6 +1118,13 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    const auto cached = _cache->fieldsOfView.find(instrument);
+    if (cached != _cache->fieldsOfView.end()) {
+        return cached->second;
+    }
+
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -852,6 +1167,7 @@ SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const
     res.shape = Map.at(shape);
     res.frameName = std::string(frameNameBuffer);
 
+    _cache->fieldsOfView[instrument] = res;
     return res;
 }
 
@@ -871,6 +1187,8 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
     ghoul_assert(!lightSource.empty(), "Light source must not be empty");
     ghoul_assert(numberOfTerminatorPoints >= 1, "Terminator points must be >= 1");
 
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     TerminatorEllipseResult res;
 
     // Warning: This assumes std::vector<glm::dvec3> to have all values memory contiguous
@@ -898,6 +1216,8 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
 }
 
 bool SpiceManager::addFrame(std::string body, std::string frame) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     if (body.empty() || frame.empty()) {
         return false;
     }
@@ -908,6 +1228,8 @@ bool SpiceManager::addFrame(std::string body, std::string frame) {
 }
 
 std::string SpiceManager::frameFromBody(const std::string& body) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     for (const std::pair<std::string, std::string>& pair : _frameByBody) {
         if (pair.first == body) {
             return pair.second;
@@ -1030,13 +1352,14 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
                                               const std::string& referenceFrame,
                                               AberrationCorrection aberrationCorrection,
                                               double ephemerisTime,
-                                              double& lightTime) const
+                                              double& lightTime, bool& isValid) const
 {
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
 
+    isValid = true;
     int targetId = naifId(target);
 
     if (targetId == 0) {
@@ -1045,11 +1368,12 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
     }
 
     if (_spkCoverageTimes.find(targetId) == _spkCoverageTimes.end()) {
-        if (_useExceptions) {
+        if (exceptionHandling()) {
             // no coverage
             throw SpiceException(fmt::format("No position for '{}' at any time", target));
         }
         else {
+            isValid = false;
             return glm::dvec3();
         }
     }
@@ -1068,7 +1392,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
             glm::value_ptr(pos),
             &lightTime
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating position for target '{}' with observer '{}' in frame '{}'",
             target, observer, referenceFrame
         ));
@@ -1084,7 +1408,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
             glm::value_ptr(pos),
             &lightTime
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating position for target '{}' with observer '{}' in frame '{}'",
             target, observer, referenceFrame
         ));
@@ -1117,7 +1441,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
             &ltLater
         );
 
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating position for target '{}' with observer '{}' in frame '{}'",
             target, observer, referenceFrame
         ));
@@ -1133,13 +1457,15 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
 
 glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFrame,
                                                      const std::string& toFrame,
-                                                     double time) const
+                                                     double time,
+                                                     bool& isValid) const
 {
+    isValid = true;
     glm::dmat3 result;
     const int idFrame = frameId(fromFrame);
 
     if (_ckCoverageTimes.find(idFrame) == _ckCoverageTimes.end()) {
-        if (_useExceptions) {
+        if (exceptionHandling()) {
             // no coverage
             throw SpiceException(fmt::format(
                 "No data available for transform matrix from '{}' to '{}' at any time",
@@ -1147,6 +1473,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             ));
         }
         else {
+            isValid = false;
             return glm::dmat3();
         }
     }
@@ -1161,7 +1488,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             *(coveredTimes.begin()),
             reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating transform matrix from frame '{}' to from '{}' at time '{}'",
             fromFrame, toFrame, time
         ));
@@ -1174,7 +1501,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             *(coveredTimes.rbegin()),
             reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating transform matrix from frame '{}' to from '{}' at time '{}'",
             fromFrame, toFrame, time
         ));
@@ -1191,7 +1518,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             earlier,
             reinterpret_cast<double(*)[3]>(glm::value_ptr(earlierTransform))
         );
-        throwOnSpiceError(fmt::format(
+        isValid = !throwOnSpiceError(fmt::format(
             "Error estimating transform matrix from frame '{}' to from '{}' at time '{}'",
             fromFrame, toFrame, time
         ));
@@ -1203,10 +1530,11 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             later,
             reinterpret_cast<double(*)[3]>(glm::value_ptr(laterTransform))
         );
-        throwOnSpiceError(fmt::format(
+        const bool laterFailed = throwOnSpiceError(fmt::format(
             "Error estimating transform matrix from frame '{}' to from '{}' at time '{}'",
             fromFrame, toFrame, time
         ));
+        isValid = isValid && !laterFailed;
 
         const double t = (time - earlier) / (later - earlier);
         result = earlierTransform * (1.0 - t) + laterTransform * t;
@@ -1216,11 +1544,15 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
 }
 
 void SpiceManager::setExceptionHandling(UseException useException) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     _useExceptions = useException;
+    // Queries that failed silently might have been memoized
+    _cache->clear();
 }
 
 SpiceManager::UseException SpiceManager::exceptionHandling() const {
-    return _useExceptions;
+    return _useExceptions.load();
 }
 
 scripting::LuaLibrary SpiceManager::luaLibrary() {
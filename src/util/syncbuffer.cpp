@@ -24,7 +24,27 @@
 
 #include <openspace/util/syncbuffer.h>
 
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <lz4.h>
 #include <sgct/SharedData.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "SyncBuffer";
+
+    enum FrameFlags : uint8_t {
+        OnlyChanges = 1 << 0,
+        Compressed = 1 << 1
+    };
+
+    // Frames smaller than this are not worth the time it takes to compress them
+    constexpr const size_t MinimumCompressionSize = 256;
+
+    constexpr const size_t FlagsSize = sizeof(uint8_t);
+    constexpr const size_t CompressedHeaderSize = FlagsSize + sizeof(uint32_t);
+} // namespace
 
 namespace openspace {
 
@@ -37,8 +57,46 @@ SyncBuffer::SyncBuffer(size_t n)
 
 SyncBuffer::~SyncBuffer() {} // NOLINT
 
+void SyncBuffer::setOnlyEncodeChanges(bool onlyChanges) {
+    _onlyEncodeChanges = onlyChanges;
+}
+
+bool SyncBuffer::onlyEncodeChanges() const {
+    return _onlyEncodeChanges;
+}
+
+void SyncBuffer::setCompressionEnabled(bool enabled) {
+    _compressionEnabled = enabled;
+}
+
+size_t SyncBuffer::currentOffset() const {
+    return std::max(_encodeOffset, _decodeOffset);
+}
+
+size_t SyncBuffer::payloadSize() const {
+    return _payloadSize;
+}
+
+size_t SyncBuffer::transmittedSize() const {
+    return _frame.size();
+}
+
+int SyncBuffer::nReallocations() const {
+    return _nReallocations;
+}
+
+void SyncBuffer::ensureCapacity(size_t size) {
+    if (_encodeOffset + size <= _dataStream.size()) {
+        return;
+    }
+
+    // Grow geometrically so that a steadily growing frame does not reallocate every time
+    _dataStream.resize(std::max(_encodeOffset + size, 2 * _dataStream.size()));
+    ++_nReallocations;
+}
+
 void SyncBuffer::encode(const std::string& s) {
-    ghoul_assert(_encodeOffset + sizeof(char) * s.size() + sizeof(int32_t) < _n, "");
+    ensureCapacity(sizeof(char) * s.size() + sizeof(int32_t));
 
     int32_t length = static_cast<int32_t>(s.length());
     memcpy(
@@ -52,18 +110,23 @@ void SyncBuffer::encode(const std::string& s) {
 }
 
 std::string SyncBuffer::decode() {
+    ghoul_assert(
+        _decodeOffset + sizeof(int32_t) <= _payloadSize,
+        "Reading past the frame"
+    );
     int32_t length;
     memcpy(
         reinterpret_cast<char*>(&length),
         _dataStream.data() + _decodeOffset,
         sizeof(int32_t)
     );
-    std::vector<char> tmp(length + 1);
     _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
+    ghoul_assert(
+        _decodeOffset + length <= _payloadSize,
+        "Reading past the frame"
+    );
+    std::string ret(_dataStream.data() + _decodeOffset, length);
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
     return ret;
 }
 
@@ -72,19 +135,113 @@ void SyncBuffer::decode(std::string& s) {
 }
 
 void SyncBuffer::write() {
-    _dataStream.resize(_encodeOffset);
-    _synchronizationBuffer->setVal(_dataStream);
+    packFrame();
+    _synchronizationBuffer->setVal(_frame);
     sgct::SharedData::instance()->writeVector(_synchronizationBuffer.get());
-    _dataStream.resize(_n);
+}
+
+bool SyncBuffer::read() {
+    sgct::SharedData::instance()->readVector(_synchronizationBuffer.get());
+    return unpackFrame(_synchronizationBuffer->getVal());
+}
+
+void SyncBuffer::packFrame() {
+    _payloadSize = _encodeOffset;
+    uint8_t flags = _onlyEncodeChanges ? OnlyChanges : 0;
+
+    bool isCompressed = false;
+    if (_compressionEnabled && _payloadSize >= MinimumCompressionSize) {
+        const int bound = LZ4_compressBound(static_cast<int>(_payloadSize));
+        _frame.resize(CompressedHeaderSize + bound);
+        const int compressedSize = LZ4_compress_default(
+            _dataStream.data(),
+            _frame.data() + CompressedHeaderSize,
+            static_cast<int>(_payloadSize),
+            bound
+        );
+
+        // Only keep the compressed version if it actually saves bandwidth
+        if (compressedSize > 0 && static_cast<size_t>(compressedSize) < _payloadSize) {
+            flags |= Compressed;
+            const uint32_t size = static_cast<uint32_t>(_payloadSize);
+            memcpy(_frame.data() + FlagsSize, &size, sizeof(uint32_t));
+            _frame.resize(CompressedHeaderSize + compressedSize);
+            isCompressed = true;
+        }
+    }
+
+    if (!isCompressed) {
+        _frame.resize(FlagsSize + _payloadSize);
+        memcpy(_frame.data() + FlagsSize, _dataStream.data(), _payloadSize);
+    }
+    _frame[0] = static_cast<char>(flags);
+
     _encodeOffset = 0;
     _decodeOffset = 0;
 }
 
-void SyncBuffer::read() {
-    sgct::SharedData::instance()->readVector(_synchronizationBuffer.get());
-    _dataStream = _synchronizationBuffer->getVal();
+bool SyncBuffer::unpackFrame(std::vector<char> frame) {
+    _frame = std::move(frame);
     _encodeOffset = 0;
     _decodeOffset = 0;
+    _payloadSize = 0;
+
+    if (_frame.empty()) {
+        // Nothing has been transmitted yet
+        return false;
+    }
+
+    const uint8_t flags = static_cast<uint8_t>(_frame[0]);
+    _onlyEncodeChanges = (flags & OnlyChanges) != 0;
+
+    if (flags & Compressed) {
+        if (_frame.size() <= CompressedHeaderSize) {
+            LERROR("Received a compressed frame with a truncated header");
+            return false;
+        }
+        uint32_t size;
+        memcpy(&size, _frame.data() + FlagsSize, sizeof(uint32_t));
+
+        // LZ4 cannot expand the data by more than this factor, so a larger size can only
+        // come from a corrupt header and must not cause a huge allocation
+        constexpr const size_t MaximumCompressionRatio = 255;
+        const size_t compressedSize = _frame.size() - CompressedHeaderSize;
+        if (size == 0 || size > compressedSize * MaximumCompressionRatio) {
+            LERROR(fmt::format(
+                "Received a compressed frame with an invalid payload size of {}", size
+            ));
+            return false;
+        }
+
+        if (_dataStream.size() < size) {
+            _dataStream.resize(size);
+            ++_nReallocations;
+        }
+        const int res = LZ4_decompress_safe(
+            _frame.data() + CompressedHeaderSize,
+            _dataStream.data(),
+            static_cast<int>(compressedSize),
+            static_cast<int>(size)
+        );
+        if (res != static_cast<int>(size)) {
+            LERROR("Received a corrupt compressed frame");
+            return false;
+        }
+        _payloadSize = size;
+    }
+    else {
+        _payloadSize = _frame.size() - FlagsSize;
+        if (_dataStream.size() < _payloadSize) {
+            _dataStream.resize(_payloadSize);
+            ++_nReallocations;
+        }
+        memcpy(_dataStream.data(), _frame.data() + FlagsSize, _payloadSize);
+    }
+    return true;
+}
+
+const std::vector<char>& SyncBuffer::frame() const {
+    return _frame;
 }
 
 } // namespace openspace
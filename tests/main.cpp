@@ -64,13 +64,31 @@
 
 #include <test_common.inl>
 #include <test_assetloader.inl>
+#include <test_brickedtraversal.inl>
 #include <test_documentation.inl>
 #include <test_luaconversions.inl>
 #include <test_optionproperty.inl>
+#include <test_parallelfor.inl>
+#include <test_parallelconnection.inl>
 #include <test_powerscalecoordinates.inl>
+#include <test_scene.inl>
 #include <test_scriptscheduler.inl>
 #include <test_spicemanager.inl>
+#include <test_syncbuffer.inl>
 #include <test_timeline.inl>
+#include <test_tracer.inl>
+
+#ifdef OPENSPACE_MODULE_BASE_ENABLED
+#include <test_renderabletrailorbit.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_DIGITALUNIVERSE_ENABLED
+#include <test_speckfile.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+#include <test_fieldlinessequence.inl>
+#endif
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
 #include <test_aabb.inl>
@@ -79,13 +97,33 @@
 #include <test_concurrentqueue.inl>
 #include <test_lrucache.inl>
 #include <test_gdalwms.inl>
+#include <test_workstealingthreadpool.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <test_keplertranslation.inl>
+#include <test_staroctree.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_SYNC_ENABLED
+#include <test_httpdownloadscheduler.inl>
 #endif
 
 #ifdef OPENSPACE_MODULE_ISWA_ENABLED
 #include <test_screenspaceimage.inl>
 #endif
 
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+#include <test_kameleonwrapper.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED
+#include <test_brickstreamer.inl>
+#include <test_tsp.inl>
+#endif
+
 #ifdef OPENSPACE_MODULE_VOLUME_ENABLED
+#include <test_linearlrucache.inl>
 #include <test_rawvolumeio.inl>
 #endif
 
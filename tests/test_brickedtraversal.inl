@@ -0,0 +1,250 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/brickedtraversal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+class BrickedTraversalTest : public testing::Test {};
+
+TEST_F(BrickedTraversalTest, VisitsEveryCellOnce) {
+    using namespace openspace;
+
+    // Dimensions that are not multiples of the brick size
+    const glm::uvec3 dims(37, 21, 9);
+    const size_t nCells = static_cast<size_t>(dims.x) * dims.y * dims.z;
+    std::vector<std::atomic<int>> visits(nCells);
+    for (std::atomic<int>& v : visits) {
+        v = 0;
+    }
+
+    struct State {
+        size_t nVisited = 0;
+    };
+    std::vector<State> states(4);
+    traverseBricksParallel(
+        dims,
+        states,
+        [&](State& s, const glm::uvec3& c) {
+            ++visits[c.x + c.y * dims.x + c.z * dims.x * dims.y];
+            ++s.nVisited;
+        },
+        nullptr,
+        8
+    );
+
+    for (const std::atomic<int>& v : visits) {
+        ASSERT_EQ(v, 1);
+    }
+    size_t total = 0;
+    for (const State& s : states) {
+        total += s.nVisited;
+    }
+    EXPECT_EQ(total, nCells);
+}
+
+TEST_F(BrickedTraversalTest, ReportsMonotonicProgress) {
+    using namespace openspace;
+
+    std::vector<int> states(3);
+    std::vector<float> progress;
+    traverseBricksParallel(
+        glm::uvec3(32, 32, 32),
+        states,
+        [](int&, const glm::uvec3&) {},
+        [&progress](float p) { progress.push_back(p); },
+        8
+    );
+
+    ASSERT_FALSE(progress.empty());
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    EXPECT_FLOAT_EQ(progress.back(), 1.f);
+}
+
+TEST_F(BrickedTraversalTest, RethrowsExceptionOnCallingThread) {
+    using namespace openspace;
+
+    std::vector<int> states(4);
+    auto traverse = [&states]() {
+        traverseBricksParallel(
+            glm::uvec3(64, 64, 64),
+            states,
+            [](int&, const glm::uvec3& c) {
+                if (c == glm::uvec3(40, 50, 60)) {
+                    throw std::runtime_error("Sampling failed");
+                }
+            }
+        );
+    };
+    EXPECT_THROW(traverse(), std::runtime_error);
+}
+
+namespace {
+    // A spherical grid with a radial spacing that grows outwards, resembling the grids
+    // of the heliospheric models read through Kameleon
+    struct SyntheticSphericalGrid {
+        SyntheticSphericalGrid(int nR, int nTheta, int nPhi)
+            : radii(nR)
+            , nTheta(nTheta)
+            , nPhi(nPhi)
+            , values(static_cast<size_t>(nR) * nTheta * nPhi)
+        {
+            for (int i = 0; i < nR; ++i) {
+                radii[i] = 0.1f * std::pow(1.02f, static_cast<float>(i));
+            }
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = std::sin(static_cast<float>(i) * 0.001f);
+            }
+        }
+
+        std::vector<float> radii;
+        int nTheta;
+        int nPhi;
+        std::vector<float> values;
+    };
+
+    // Like the Kameleon interpolators, this keeps the last radial cell that was found
+    // to avoid the search when consecutive samples are close to each other. This is
+    // state that makes it unsafe to share one interpolator between threads
+    class SyntheticInterpolator {
+    public:
+        explicit SyntheticInterpolator(const SyntheticSphericalGrid* grid)
+            : _grid(grid)
+        {}
+
+        float interpolate(float x, float y, float z) {
+            const std::vector<float>& radii = _grid->radii;
+            const float r = std::sqrt(x * x + y * y + z * z);
+            if (r < radii.front() || r >= radii.back()) {
+                return 0.f;
+            }
+            if (r < radii[_lastR] || r >= radii[_lastR + 1]) {
+                _lastR = static_cast<int>(
+                    std::upper_bound(radii.begin(), radii.end(), r) - radii.begin()
+                ) - 1;
+            }
+
+            constexpr const float Pi = 3.14159265f;
+            const float theta = std::acos(z / r) / Pi * (_grid->nTheta - 1);
+            const float phi = (std::atan2(y, x) + Pi) / (2.f * Pi) * (_grid->nPhi - 1);
+            const int iT = std::min(static_cast<int>(theta), _grid->nTheta - 2);
+            const int iP = std::min(static_cast<int>(phi), _grid->nPhi - 2);
+            const float fR = (r - radii[_lastR]) / (radii[_lastR + 1] - radii[_lastR]);
+            const float fT = theta - iT;
+            const float fP = phi - iP;
+
+            auto value = [this](int i, int t, int p) {
+                return _grid->values[
+                    i + _grid->radii.size() * (t + static_cast<size_t>(_grid->nTheta) * p)
+                ];
+            };
+            float result = 0.f;
+            for (int c = 0; c < 8; ++c) {
+                const int dr = c & 1;
+                const int dt = (c >> 1) & 1;
+                const int dp = (c >> 2) & 1;
+                const float w = (dr ? fR : 1.f - fR) * (dt ? fT : 1.f - fT) *
+                                (dp ? fP : 1.f - fP);
+                result += w * value(_lastR + dr, iT + dt, iP + dp);
+            }
+            return result;
+        }
+
+    private:
+        const SyntheticSphericalGrid* _grid;
+        int _lastR = 0;
+    };
+
+    glm::vec3 samplePosition(const glm::uvec3& cell, const glm::uvec3& dims) {
+        return glm::vec3(
+            -2.f + 4.f * cell.x / dims.x,
+            -2.f + 4.f * cell.y / dims.y,
+            -2.f + 4.f * cell.z / dims.z
+        );
+    }
+} // namespace
+
+// Run with --gtest_also_run_disabled_tests to compare the serial resampling loop that
+// KameleonVolumeReader and KameleonWrapper used to have against the bricked traversal
+TEST_F(BrickedTraversalTest, DISABLED_Benchmark) {
+    using namespace openspace;
+
+    const SyntheticSphericalGrid grid(256, 90, 180);
+    const glm::uvec3 dims(192, 192, 192);
+    const size_t nCells = static_cast<size_t>(dims.x) * dims.y * dims.z;
+
+    std::vector<float> serial(nCells);
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        SyntheticInterpolator interpolator(&grid);
+        for (unsigned int x = 0; x < dims.x; ++x) {
+            for (unsigned int y = 0; y < dims.y; ++y) {
+                for (unsigned int z = 0; z < dims.z; ++z) {
+                    const glm::vec3 p = samplePosition(glm::uvec3(x, y, z), dims);
+                    serial[x + y * dims.x + z * dims.x * dims.y] =
+                        interpolator.interpolate(p.x, p.y, p.z);
+                }
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double serialTime = std::chrono::duration<double, std::milli>(
+        end - start
+    ).count();
+
+    std::vector<float> parallel(nCells);
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<SyntheticInterpolator> interpolators(
+            defaultParallelThreadCount(),
+            SyntheticInterpolator(&grid)
+        );
+        traverseBricksParallel(
+            dims,
+            interpolators,
+            [&](SyntheticInterpolator& interpolator, const glm::uvec3& c) {
+                const glm::vec3 p = samplePosition(c, dims);
+                parallel[c.x + c.y * dims.x + c.z * dims.x * dims.y] =
+                    interpolator.interpolate(p.x, p.y, p.z);
+            }
+        );
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const double parallelTime = std::chrono::duration<double, std::milli>(
+        end - start
+    ).count();
+
+    EXPECT_EQ(serial, parallel);
+    std::cout << "Serial resampling:  " << serialTime << " ms" << std::endl;
+    std::cout << "Bricked resampling: " << parallelTime << " ms ("
+              << defaultParallelThreadCount() << " threads)" << std::endl;
+}
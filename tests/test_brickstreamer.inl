@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <fstream>
+#include <vector>
+
+namespace {
+    constexpr const long long DataPosition = 36;
+    constexpr const size_t BrickValues = 27;
+
+    // Writes a file with a header followed by nBricks bricks, where every voxel of a
+    // brick contains the index of the brick
+    std::string writeBricks(const std::string& filename, unsigned int nBricks) {
+        std::string path = absPath("${TEMPORARY}/" + filename);
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        std::vector<char> header(DataPosition, 0);
+        file.write(header.data(), header.size());
+        for (unsigned int brick = 0; brick < nBricks; ++brick) {
+            std::vector<float> values(BrickValues, static_cast<float>(brick));
+            file.write(
+                reinterpret_cast<const char*>(values.data()),
+                values.size() * sizeof(float)
+            );
+        }
+        return path;
+    }
+} // namespace
+
+class BrickStreamerTest : public testing::Test {};
+
+TEST_F(BrickStreamerTest, MergesNearbyBricks) {
+    using namespace openspace;
+
+    const std::string path = writeBricks("brickstreamertest.tsp", 64);
+    BrickStreamer streamer(path, DataPosition, BrickValues, 2, 256);
+
+    // 3, 4, 6 and 9 are at most two bricks apart, 40 and 41 are read separately
+    streamer.request({ 41, 9, 3, 6, 4, 40 });
+    streamer.waitUntilIdle();
+
+    std::vector<BrickStreamer::Brick> bricks = streamer.takeFinishedBricks();
+    ASSERT_EQ(bricks.size(), 6u);
+    const std::vector<unsigned int> expected = { 3, 4, 6, 9, 40, 41 };
+    for (size_t i = 0; i < bricks.size(); ++i) {
+        EXPECT_EQ(bricks[i].index, expected[i]);
+        ASSERT_EQ(bricks[i].data.size(), BrickValues);
+        EXPECT_EQ(bricks[i].data.front(), static_cast<float>(expected[i]));
+        EXPECT_EQ(bricks[i].data.back(), static_cast<float>(expected[i]));
+        streamer.recycle(std::move(bricks[i].data));
+    }
+
+    BrickStreamer::Statistics statistics = streamer.takeStatistics();
+    EXPECT_EQ(statistics.nDiskReads, 2);
+    EXPECT_EQ(statistics.nBricksLoaded, 6);
+    EXPECT_EQ(statistics.nBytesRead, (7 + 2) * BrickValues * sizeof(float));
+
+    EXPECT_TRUE(streamer.takeFinishedBricks().empty());
+    EXPECT_EQ(streamer.takeStatistics().nDiskReads, 0);
+
+    FileSys.deleteFile(path);
+}
+
+TEST_F(BrickStreamerTest, NewRequestReplacesPendingBricks) {
+    using namespace openspace;
+
+    const std::string path = writeBricks("brickstreamertest2.tsp", 512);
+    BrickStreamer streamer(path, DataPosition, BrickValues, 0, 1);
+
+    std::vector<unsigned int> first;
+    for (unsigned int i = 0; i < 256; ++i) {
+        first.push_back(2 * i);
+    }
+    streamer.request(first);
+    streamer.request({ 1, 3 });
+    streamer.waitUntilIdle();
+
+    // Only the bricks that had been picked up before the second request may be read
+    // from the first request, but all bricks of the second request have to be read
+    std::vector<BrickStreamer::Brick> bricks = streamer.takeFinishedBricks();
+    bool hasOne = false;
+    bool hasThree = false;
+    for (const BrickStreamer::Brick& brick : bricks) {
+        hasOne |= brick.index == 1;
+        hasThree |= brick.index == 3;
+        EXPECT_EQ(brick.data.front(), static_cast<float>(brick.index));
+    }
+    EXPECT_TRUE(hasOne);
+    EXPECT_TRUE(hasThree);
+    EXPECT_LE(bricks.size(), first.size() + 2);
+
+    FileSys.deleteFile(path);
+}
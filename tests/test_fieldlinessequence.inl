@@ -0,0 +1,258 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Records the order in which the prefetcher decodes the states. The files are named
+    // after their index, and the states whose index is in failingIndices fail to load
+    struct LoadRecorder {
+        std::vector<int> loadedIndices;
+        std::vector<int> failingIndices;
+        std::mutex mutex;
+
+        std::shared_ptr<const openspace::FieldlinesState> load(const std::string& file)
+        {
+            const int index = std::stoi(file);
+            std::lock_guard<std::mutex> lock(mutex);
+            loadedIndices.push_back(index);
+            const bool fails = std::find(
+                failingIndices.begin(),
+                failingIndices.end(),
+                index
+            ) != failingIndices.end();
+            return fails ? nullptr : std::make_shared<openspace::FieldlinesState>();
+        }
+
+        std::vector<int> loaded() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return loadedIndices;
+        }
+    };
+
+    std::vector<std::string> indexFileNames(int nFiles) {
+        std::vector<std::string> files;
+        for (int i = 0; i < nFiles; ++i) {
+            files.push_back(std::to_string(i));
+        }
+        return files;
+    }
+
+    // Waits for the worker thread of the prefetcher to reach a state
+    bool waitFor(const std::function<bool()>& condition) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > timeout) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    template <typename T>
+    void writeValue(std::string& buffer, const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Creates the content of an .osfls file with two lines and one extra quantity
+    std::string osflsContent(uint64_t nPoints, uint64_t nExtras) {
+        const uint64_t nLines = 2;
+        const std::string names = "density";
+
+        std::string content;
+        writeValue(content, int32_t(0));                   // version
+        writeValue(content, 0.0);                          // trigger time
+        writeValue(content, int32_t(0));                   // model
+        writeValue(content, false);                        // is morphable
+        writeValue(content, nLines);
+        writeValue(content, nPoints);
+        writeValue(content, nExtras);
+        writeValue(content, uint64_t(names.size() + 1));
+        writeValue(content, int32_t(0));                   // line start
+        writeValue(content, int32_t(2));
+        writeValue(content, uint32_t(2));                  // line count
+        writeValue(content, uint32_t(2));
+        for (uint64_t i = 0; i < 3 * nPoints; ++i) {
+            writeValue(content, static_cast<float>(i));   // vertex positions
+        }
+        for (uint64_t i = 0; i < nPoints; ++i) {
+            writeValue(content, 1.f);                      // extra quantity
+        }
+        content.append(names.c_str(), names.size() + 1);
+        return content;
+    }
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+        file.write(content.data(), content.size());
+    }
+} // namespace
+
+class FieldlinesSequenceTest : public testing::Test {};
+
+TEST_F(FieldlinesSequenceTest, PrefetcherLoadsActiveStateFirst) {
+    LoadRecorder recorder;
+    openspace::FieldlinesStatePrefetcher prefetcher(
+        indexFileNames(10),
+        2,
+        1,
+        [&recorder](const std::string& file) { return recorder.load(file); }
+    );
+
+    prefetcher.setActiveState(5, 1);
+    ASSERT_TRUE(waitFor([&]() { return recorder.loaded().size() == 4; }));
+    EXPECT_EQ(recorder.loaded(), std::vector<int>({ 5, 6, 7, 4 }));
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(4) != nullptr; }));
+    for (int i = 4; i <= 7; ++i) {
+        EXPECT_NE(prefetcher.state(i), nullptr) << i;
+    }
+    EXPECT_EQ(prefetcher.state(3), nullptr);
+    EXPECT_EQ(prefetcher.state(8), nullptr);
+}
+
+TEST_F(FieldlinesSequenceTest, PrefetcherFollowsDirectionChange) {
+    LoadRecorder recorder;
+    openspace::FieldlinesStatePrefetcher prefetcher(
+        indexFileNames(10),
+        2,
+        1,
+        [&recorder](const std::string& file) { return recorder.load(file); }
+    );
+
+    prefetcher.setActiveState(5, 1);
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(4) != nullptr; }));
+
+    // Moving backwards, the ring covers the states 3 to 6. Only state 3 is missing and
+    // it takes the slot of state 7, which is now behind the playback position
+    prefetcher.setActiveState(5, -1);
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(3) != nullptr; }));
+    EXPECT_EQ(recorder.loaded(), std::vector<int>({ 5, 6, 7, 4, 3 }));
+    for (int i = 3; i <= 6; ++i) {
+        EXPECT_NE(prefetcher.state(i), nullptr) << i;
+    }
+    EXPECT_EQ(prefetcher.state(7), nullptr);
+}
+
+TEST_F(FieldlinesSequenceTest, PrefetcherEvictsStatesOutsideRing) {
+    LoadRecorder recorder;
+    openspace::FieldlinesStatePrefetcher prefetcher(
+        indexFileNames(20),
+        2,
+        1,
+        [&recorder](const std::string& file) { return recorder.load(file); }
+    );
+
+    prefetcher.setActiveState(5, 1);
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(4) != nullptr; }));
+
+    prefetcher.setActiveState(9, 1);
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(8) != nullptr; }));
+    EXPECT_EQ(recorder.loaded(), std::vector<int>({ 5, 6, 7, 4, 9, 10, 11, 8 }));
+    for (int i = 8; i <= 11; ++i) {
+        EXPECT_NE(prefetcher.state(i), nullptr) << i;
+    }
+    for (int i = 4; i <= 7; ++i) {
+        EXPECT_EQ(prefetcher.state(i), nullptr) << i;
+    }
+}
+
+TEST_F(FieldlinesSequenceTest, PrefetcherRetriesFailedStates) {
+    LoadRecorder recorder;
+    recorder.failingIndices = { 1 };
+    openspace::FieldlinesStatePrefetcher prefetcher(
+        indexFileNames(3),
+        2,
+        0,
+        [&recorder](const std::string& file) { return recorder.load(file); }
+    );
+
+    prefetcher.setActiveState(0, 1);
+    const std::vector<int> expected = { 0, 1, 2, 1, 1 };
+    ASSERT_TRUE(waitFor([&]() { return recorder.loaded().size() == expected.size(); }));
+    ASSERT_TRUE(waitFor([&]() { return prefetcher.state(2) != nullptr; }));
+
+    // No more attempts are made after MaxLoadAttempts failures
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(recorder.loaded(), expected);
+    EXPECT_EQ(prefetcher.state(1), nullptr);
+}
+
+TEST_F(FieldlinesSequenceTest, LoadsOsflsFile) {
+    const std::string path = absPath("${TEMPORARY}/fieldlinestest.osfls");
+    writeFile(path, osflsContent(4, 1));
+
+    openspace::FieldlinesState state;
+    ASSERT_TRUE(state.loadStateFromOsfls(path));
+    EXPECT_EQ(state.lineStart().size(), 2u);
+    EXPECT_EQ(state.vertexPositions().size(), 4u);
+    ASSERT_EQ(state.extraQuantityNames().size(), 1u);
+    EXPECT_EQ(state.extraQuantityNames()[0], "density");
+
+    std::remove(path.c_str());
+}
+
+TEST_F(FieldlinesSequenceTest, RejectsTruncatedOsflsFile) {
+    const std::string path = absPath("${TEMPORARY}/fieldlinestest-truncated.osfls");
+    const std::string content = osflsContent(4, 1);
+
+    // Every truncation, including one in the middle of the header, has to be detected
+    for (size_t size = 0; size < content.size(); ++size) {
+        writeFile(path, content.substr(0, size));
+        openspace::FieldlinesState state;
+        EXPECT_FALSE(state.loadStateFromOsfls(path)) << size;
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(FieldlinesSequenceTest, RejectsCorruptExtraQuantityCount) {
+    const std::string path = absPath("${TEMPORARY}/fieldlinestest-corrupt.osfls");
+
+    // Without any points, the number of extra quantities is only bounded by the names
+    writeFile(path, osflsContent(0, 1'000'000'000'000));
+    openspace::FieldlinesState state;
+    EXPECT_FALSE(state.loadStateFromOsfls(path));
+
+    writeFile(path, osflsContent(4, 1'000'000'000'000));
+    EXPECT_FALSE(state.loadStateFromOsfls(path));
+
+    std::remove(path.c_str());
+}
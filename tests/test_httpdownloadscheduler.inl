@@ -0,0 +1,421 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/sync/httpdownloadscheduler.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/io/socket/tcpsocketserver.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace {
+    constexpr const int HttpServerPort = 25098;
+
+    std::string httpFileContent(const std::string& name) {
+        std::string content;
+        while (content.size() < 50000) {
+            content += name;
+        }
+        return content;
+    }
+
+    uint32_t crc32(const std::string& data) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (char c : data) {
+            crc ^= static_cast<uint8_t>(c);
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : (crc >> 1);
+            }
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        std::stringstream s;
+        s << file.rdbuf();
+        return s.str();
+    }
+
+    // A minimal HTTP server that serves every path with content derived from its name
+    // and that honors Range requests if rangeSupport is enabled. It answers one request
+    // per connection and records the Range headers it received
+    class LocalHttpServer {
+    public:
+        LocalHttpServer(bool rangeSupport) : _rangeSupport(rangeSupport) {
+            _server.listen("localhost", HttpServerPort);
+            _thread = std::thread([this]() {
+                while (std::unique_ptr<ghoul::io::TcpSocket> s =
+                       _server.awaitPendingTcpSocket())
+                {
+                    s->startStreams();
+                    serve(*s);
+                    s->disconnect();
+                }
+            });
+        }
+
+        ~LocalHttpServer() {
+            _server.close();
+            _thread.join();
+        }
+
+        std::vector<std::string> ranges() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _ranges;
+        }
+
+        int nRequests() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _nRequests;
+        }
+
+    private:
+        void serve(ghoul::io::TcpSocket& socket) {
+            std::string request;
+            char c;
+            while (request.find("\r\n\r\n") == std::string::npos && socket.get(&c)) {
+                request.push_back(c);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_nRequests;
+            }
+
+            const size_t pathBegin = request.find(' ') + 2;
+            const size_t pathEnd = request.find(' ', pathBegin);
+            const std::string content = httpFileContent(
+                request.substr(pathBegin, pathEnd - pathBegin)
+            );
+
+            size_t offset = 0;
+            const size_t range = request.find("Range: bytes=");
+            if (_rangeSupport && range != std::string::npos) {
+                offset = std::stoul(request.substr(range + strlen("Range: bytes=")));
+                std::lock_guard<std::mutex> lock(_mutex);
+                _ranges.push_back(std::to_string(offset));
+            }
+
+            std::string response;
+            if (offset > 0) {
+                response = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " +
+                    std::to_string(offset) + "-" + std::to_string(content.size() - 1) +
+                    "/" + std::to_string(content.size()) + "\r\n";
+            }
+            else {
+                response = "HTTP/1.1 200 OK\r\n";
+            }
+            response += "Content-Length: " + std::to_string(content.size() - offset) +
+                        "\r\nConnection: close\r\n\r\n" + content.substr(offset);
+            socket.put(response.data(), response.size());
+        }
+
+        bool _rangeSupport;
+        ghoul::io::TcpSocketServer _server;
+        std::thread _thread;
+        std::mutex _mutex;
+        std::vector<std::string> _ranges;
+        int _nRequests = 0;
+    };
+
+    // Downloads all files with the scheduler and returns the number of successful ones.
+    // If checksums are provided, the downloads are verified against them
+    int downloadAll(openspace::HttpDownloadScheduler& scheduler,
+                    const std::vector<std::string>& names, const std::string& directory,
+                    const std::vector<uint32_t>& checksums = {},
+                    int port = HttpServerPort)
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t nRemaining = names.size();
+        int nSucceeded = 0;
+
+        for (size_t i = 0; i < names.size(); ++i) {
+            const std::string& name = names[i];
+            openspace::HttpDownloadScheduler::Download download;
+            download.url = "http://localhost:" + std::to_string(port) + "/" + name;
+            download.destination = directory + "/" + name;
+            if (!checksums.empty()) {
+                download.hasChecksum = true;
+                download.checksum = checksums[i];
+            }
+            download.onFinished = [&](bool success) {
+                std::lock_guard<std::mutex> lock(mutex);
+                nSucceeded += success ? 1 : 0;
+                --nRemaining;
+                condition.notify_one();
+            };
+            scheduler.enqueue(std::move(download));
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return nRemaining == 0; });
+        return nSucceeded;
+    }
+} // namespace
+
+class HttpDownloadSchedulerTest : public testing::Test {
+protected:
+    HttpDownloadSchedulerTest() {
+        _directory = absPath("${TEMPORARY}/httpdownloadschedulertest");
+        FileSys.createDirectory(
+            _directory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+
+    ~HttpDownloadSchedulerTest() {
+        FileSys.deleteDirectory(
+            _directory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+
+    std::string _directory;
+};
+
+TEST_F(HttpDownloadSchedulerTest, DownloadsAllFiles) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler(3);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 50; ++i) {
+        names.push_back("file" + std::to_string(i));
+    }
+    EXPECT_EQ(50, downloadAll(scheduler, names, _directory));
+    EXPECT_EQ(0, scheduler.nActiveDownloads());
+    EXPECT_EQ(0, scheduler.nQueuedDownloads());
+
+    for (const std::string& name : names) {
+        EXPECT_EQ(httpFileContent(name), readFile(_directory + "/" + name));
+    }
+}
+
+TEST_F(HttpDownloadSchedulerTest, ResumesPartialFile) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler;
+
+    const std::string content = httpFileContent("partial");
+    {
+        std::ofstream file(_directory + "/partial", std::ofstream::binary);
+        file << content.substr(0, 12345);
+    }
+
+    EXPECT_EQ(1, downloadAll(scheduler, { "partial" }, _directory));
+    EXPECT_EQ(content, readFile(_directory + "/partial"));
+    ASSERT_EQ(1, server.ranges().size());
+    EXPECT_EQ("12345", server.ranges()[0]);
+}
+
+TEST_F(HttpDownloadSchedulerTest, RestartsWithoutRangeSupport) {
+    LocalHttpServer server(false);
+    openspace::HttpDownloadScheduler scheduler;
+
+    const std::string content = httpFileContent("norange");
+    {
+        std::ofstream file(_directory + "/norange", std::ofstream::binary);
+        file << content.substr(0, 12345);
+    }
+
+    EXPECT_EQ(1, downloadAll(scheduler, { "norange" }, _directory));
+    EXPECT_EQ(content, readFile(_directory + "/norange"));
+}
+
+TEST_F(HttpDownloadSchedulerTest, CancelAndStop) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler;
+
+    std::atomic_int nFinished = 0;
+    openspace::HttpDownloadScheduler::Download download;
+    download.url = "http://localhost:" + std::to_string(HttpServerPort) + "/cancel";
+    download.destination = _directory + "/cancel";
+    download.onProgress = [](openspace::HttpRequest::Progress) { return false; };
+    download.onFinished = [&nFinished](bool success) {
+        EXPECT_FALSE(success);
+        ++nFinished;
+    };
+    scheduler.enqueue(download);
+    scheduler.stop();
+    // Downloads that are enqueued after the scheduler stopped fail immediately
+    scheduler.enqueue(download);
+
+    EXPECT_EQ(2, nFinished);
+}
+
+TEST_F(HttpDownloadSchedulerTest, LimitsConcurrentConnections) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler(3);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    int nRemaining = 30;
+    std::atomic_int maxActive = 0;
+    for (int i = 0; i < 30; ++i) {
+        const std::string name = "limit" + std::to_string(i);
+        openspace::HttpDownloadScheduler::Download download;
+        download.url = "http://localhost:" + std::to_string(HttpServerPort) + "/" + name;
+        download.destination = _directory + "/" + name;
+        download.onProgress = [&](openspace::HttpRequest::Progress) {
+            maxActive = std::max(maxActive.load(), scheduler.nActiveDownloads());
+            return true;
+        };
+        download.onFinished = [&](bool success) {
+            EXPECT_TRUE(success);
+            std::lock_guard<std::mutex> lock(mutex);
+            --nRemaining;
+            condition.notify_one();
+        };
+        scheduler.enqueue(std::move(download));
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return nRemaining == 0; });
+    }
+
+    EXPECT_GE(maxActive, 1);
+    EXPECT_LE(maxActive, 3);
+}
+
+TEST_F(HttpDownloadSchedulerTest, ChecksumOfFile) {
+    const std::string path = _directory + "/checksum";
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        file << "123456789";
+    }
+
+    // The check value of CRC-32
+    size_t fileSize = 0;
+    EXPECT_TRUE(openspace::HttpDownloadScheduler::fileHasChecksum(
+        path,
+        0xCBF43926,
+        fileSize
+    ));
+    EXPECT_EQ(9, fileSize);
+
+    // A mismatching file has to be downloaded again
+    EXPECT_FALSE(openspace::HttpDownloadScheduler::fileHasChecksum(
+        path,
+        0xCBF43927,
+        fileSize
+    ));
+    EXPECT_FALSE(openspace::HttpDownloadScheduler::fileHasChecksum(
+        _directory + "/missing",
+        0xCBF43926,
+        fileSize
+    ));
+}
+
+TEST_F(HttpDownloadSchedulerTest, RestartsDownloadWithChecksumMismatch) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler;
+    scheduler.setInitialRetryDelay(10);
+
+    // The partial file does not belong to the file on the server, so resuming it
+    // produces a corrupt file that has to be downloaded again from the beginning
+    const std::string content = httpFileContent("mismatch");
+    {
+        std::ofstream file(_directory + "/mismatch", std::ofstream::binary);
+        file << "garbage";
+    }
+
+    EXPECT_EQ(1, downloadAll(scheduler, { "mismatch" }, _directory, { crc32(content) }));
+    EXPECT_EQ(content, readFile(_directory + "/mismatch"));
+    EXPECT_EQ(2, server.nRequests());
+}
+
+TEST_F(HttpDownloadSchedulerTest, FailsWithPersistentChecksumMismatch) {
+    LocalHttpServer server(true);
+    openspace::HttpDownloadScheduler scheduler;
+    scheduler.setMaxRetries(2);
+    scheduler.setInitialRetryDelay(10);
+
+    const uint32_t wrongChecksum = crc32(httpFileContent("corrupt")) + 1;
+    EXPECT_EQ(0, downloadAll(scheduler, { "corrupt" }, _directory, { wrongChecksum }));
+    EXPECT_EQ(3, server.nRequests());
+    // The corrupt file must not be kept
+    EXPECT_FALSE(FileSys.fileExists(_directory + "/corrupt"));
+}
+
+TEST_F(HttpDownloadSchedulerTest, BacksOffExponentially) {
+    // Nothing is listening on this port, so every attempt fails immediately
+    constexpr const int UnusedPort = HttpServerPort + 1;
+    constexpr const int InitialDelay = 50;
+
+    openspace::HttpDownloadScheduler scheduler;
+    scheduler.setMaxRetries(3);
+    scheduler.setInitialRetryDelay(InitialDelay);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, downloadAll(scheduler, { "refused" }, _directory, {}, UnusedPort));
+    const auto end = std::chrono::steady_clock::now();
+
+    // 50 + 100 + 200 ms
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end - start
+    );
+    EXPECT_GE(elapsed.count(), 7 * InitialDelay);
+}
+
+TEST_F(HttpDownloadSchedulerTest, BackoffDoesNotBlockOtherDownloads) {
+    LocalHttpServer server(true);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool hasSucceeded = false;
+
+    openspace::HttpDownloadScheduler scheduler(1);
+    scheduler.setMaxRetries(1);
+    scheduler.setInitialRetryDelay(10000);
+
+    // The first download waits for its retry while the second one uses the connection
+    openspace::HttpDownloadScheduler::Download failing;
+    failing.url = "http://localhost:" + std::to_string(HttpServerPort + 1) + "/refused";
+    failing.destination = _directory + "/refused";
+    failing.onFinished = [](bool) {};
+    scheduler.enqueue(std::move(failing));
+
+    openspace::HttpDownloadScheduler::Download download;
+    download.url = "http://localhost:" + std::to_string(HttpServerPort) + "/other";
+    download.destination = _directory + "/other";
+    download.onFinished = [&](bool success) {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasSucceeded = success;
+        condition.notify_one();
+    };
+    scheduler.enqueue(std::move(download));
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return hasSucceeded; });
+    }
+    EXPECT_EQ(1, scheduler.nQueuedDownloads());
+    scheduler.stop();
+}
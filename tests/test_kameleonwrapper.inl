@@ -0,0 +1,113 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/kameleon/include/kameleonwrapper.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <cmath>
+#include <vector>
+
+class KameleonWrapperTest : public testing::Test {};
+
+namespace {
+    // Any BATSRUS magnetosphere model with the magnetic field variables bx, by, bz. The
+    // file is too large to be part of the repository, so the tests that trace through it
+    // do nothing if it has not been placed there
+    constexpr const char* BatsrusModel = "${TESTDIR}/kameleon/batsrus.cdf";
+
+    // Seed points in Earth radii around the Earth, in and just above the equatorial
+    // plane, which produce both closed and open field lines
+    std::vector<glm::vec3> magnetosphereSeedPoints() {
+        std::vector<glm::vec3> seeds;
+        for (int i = 0; i < 64; ++i) {
+            const float angle = static_cast<float>(i) * 0.0981748f;
+            const float r = 3.f + static_cast<float>(i % 8);
+            seeds.emplace_back(r * std::cos(angle), r * std::sin(angle), (i % 3) * 0.5f);
+        }
+        return seeds;
+    }
+
+    void expectEqualFieldlines(const openspace::KameleonWrapper::Fieldlines& expected,
+                               const openspace::KameleonWrapper::Fieldlines& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i].size(), actual[i].size()) << "Line " << i;
+            for (size_t j = 0; j < expected[i].size(); ++j) {
+                ASSERT_EQ(expected[i][j].position, actual[i][j].position);
+                ASSERT_EQ(expected[i][j].color, actual[i][j].color);
+            }
+        }
+    }
+} // namespace
+
+// Tracing the seed points in parallel has to produce exactly the lines, and colors, that
+// tracing them one at a time on a single thread does
+TEST_F(KameleonWrapperTest, ParallelClassifiedFieldLinesMatchSerial) {
+    using namespace openspace;
+
+    const std::string path = absPath(BatsrusModel);
+    if (!FileSys.fileExists(path)) {
+        return;
+    }
+
+    KameleonWrapper kw(path);
+    const std::vector<glm::vec3> seeds = magnetosphereSeedPoints();
+    const KameleonWrapper::Fieldlines serial = kw.classifiedFieldLines(
+        "bx", "by", "bz", seeds, 0.2f, 1
+    );
+    const KameleonWrapper::Fieldlines parallel = kw.classifiedFieldLines(
+        "bx", "by", "bz", seeds, 0.2f, 4
+    );
+
+    ASSERT_EQ(seeds.size(), serial.size());
+    for (const std::vector<LinePoint>& line : serial) {
+        EXPECT_GT(line.size(), 1u);
+    }
+    expectEqualFieldlines(serial, parallel);
+}
+
+TEST_F(KameleonWrapperTest, ParallelFieldLinesMatchSerial) {
+    using namespace openspace;
+
+    const std::string path = absPath(BatsrusModel);
+    if (!FileSys.fileExists(path)) {
+        return;
+    }
+
+    KameleonWrapper kw(path);
+    const std::vector<glm::vec3> seeds = magnetosphereSeedPoints();
+    const glm::vec4 color = glm::vec4(1.f, 0.5f, 0.25f, 1.f);
+    const KameleonWrapper::Fieldlines serial = kw.fieldLines(
+        "bx", "by", "bz", seeds, 0.2f, color, 1
+    );
+    const KameleonWrapper::Fieldlines parallel = kw.fieldLines(
+        "bx", "by", "bz", seeds, 0.2f, color, 3
+    );
+
+    ASSERT_EQ(seeds.size(), serial.size());
+    expectEqualFieldlines(serial, parallel);
+}
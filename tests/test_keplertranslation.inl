@@ -0,0 +1,82 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/space/translation/keplertranslation.h>
+
+#include <openspace/util/time.h>
+#include <ghoul/glm.h>
+#include <vector>
+
+class KeplerTranslationTest : public testing::Test {};
+
+namespace {
+    // Sets the elements directly, as the epoch string of the dictionary constructor would
+    // require a leap seconds kernel
+    class TestKeplerTranslation : public openspace::KeplerTranslation {
+    public:
+        explicit TestKeplerTranslation(double eccentricity) {
+            setKeplerElements(
+                eccentricity,
+                7000.0, // semi-major axis in km
+                30.0,   // inclination
+                45.0,   // ascending node
+                60.0,   // argument of periapsis
+                10.0,   // mean anomaly at epoch
+                6000.0, // period in seconds
+                1000.0  // epoch in seconds past J2000
+            );
+        }
+    };
+} // namespace
+
+TEST_F(KeplerTranslationTest, BatchSamplerMatchesPosition) {
+    // One orbit for each of the regimes in which the eccentric anomaly is solved
+    // differently
+    for (double eccentricity : { 0.0, 0.1, 0.5, 0.95 }) {
+        TestKeplerTranslation translation(eccentricity);
+
+        std::vector<double> times;
+        for (int i = -50; i < 150; ++i) {
+            times.push_back(i * 45.0);
+        }
+
+        const openspace::Translation::BatchSampler sampler = translation.batchSampler();
+        ASSERT_TRUE(static_cast<bool>(sampler));
+        const std::vector<glm::dvec3> positions = sampler(times);
+        ASSERT_EQ(positions.size(), times.size());
+
+        for (size_t i = 0; i < times.size(); ++i) {
+            const glm::dvec3 p = translation.position(openspace::Time(times[i]));
+            // The sampler combines the terms in a different order, so the results are
+            // only the same up to rounding; the orbit's radius is of the order of 1e7 m
+            EXPECT_NEAR(p.x, positions[i].x, 1e-6) << "e = " << eccentricity;
+            EXPECT_NEAR(p.y, positions[i].y, 1e-6) << "e = " << eccentricity;
+            EXPECT_NEAR(p.z, positions[i].z, 1e-6) << "e = " << eccentricity;
+        }
+
+        EXPECT_EQ(translation.positions(times), positions);
+    }
+}
@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/volume/linearlrucache.h>
+
+#include <memory>
+
+class LinearLruCacheTest : public testing::Test {};
+
+TEST_F(LinearLruCacheTest, EvictsLeastRecentlyUsed) {
+    using namespace openspace::volume;
+
+    LinearLruCache<std::shared_ptr<int>> cache(2, 4);
+    cache.set(0, std::make_shared<int>(0));
+    cache.set(1, std::make_shared<int>(1));
+    cache.use(0);
+    cache.set(2, std::make_shared<int>(2));
+
+    ASSERT_TRUE(cache.has(0));
+    ASSERT_FALSE(cache.has(1));
+    ASSERT_TRUE(cache.has(2));
+    ASSERT_EQ(cache.size(), 2u);
+}
+
+TEST_F(LinearLruCacheTest, SetReplacesExistingValue) {
+    using namespace openspace::volume;
+
+    LinearLruCache<std::shared_ptr<int>> cache(2, 4);
+    cache.set(0, std::make_shared<int>(0));
+    cache.set(1, std::make_shared<int>(1));
+    cache.set(0, std::make_shared<int>(5));
+    cache.set(2, std::make_shared<int>(2));
+
+    // Setting key 0 again both replaced its value and marked it as recently used
+    ASSERT_TRUE(cache.has(0));
+    ASSERT_EQ(*cache.get(0), 5);
+    ASSERT_FALSE(cache.has(1));
+    ASSERT_EQ(cache.size(), 2u);
+}
+
+TEST_F(LinearLruCacheTest, ShrinkingCapacityEvicts) {
+    using namespace openspace::volume;
+
+    LinearLruCache<std::shared_ptr<int>> cache(4, 4);
+    for (int i = 0; i < 4; ++i) {
+        cache.set(i, std::make_shared<int>(i));
+    }
+    cache.use(1);
+
+    cache.setCapacity(2);
+    ASSERT_EQ(cache.size(), 2u);
+    ASSERT_TRUE(cache.has(1));
+    ASSERT_TRUE(cache.has(3));
+    ASSERT_FALSE(cache.has(0));
+    ASSERT_FALSE(cache.has(2));
+}
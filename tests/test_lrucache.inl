@@ -27,6 +27,10 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <limits>
+#include <list>
+#include <unordered_map>
 
 class LRUCacheTest : public testing::Test {};
 
@@ -95,3 +99,134 @@ TEST_F(LRUCacheTest, StructKey) {
     ASSERT_EQ(lru.get(key1), val2);
     ASSERT_EQ(lru.get(key2), val2);
 }
+
+TEST_F(LRUCacheTest, GetReturnsReference) {
+    openspace::globebrowsing::cache::LRUCache<int, std::string, DefaultHasher> lru(4);
+    lru.put(1, "hej");
+    lru.get(1) += " san";
+    ASSERT_EQ(lru.get(1), "hej san") << "Value should be modified in place";
+}
+
+TEST_F(LRUCacheTest, PopOrder) {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(4);
+    lru.put(1, 10);
+    lru.put(2, 20);
+    lru.put(3, 30);
+    ASSERT_TRUE(lru.touch(1));
+
+    ASSERT_EQ(lru.popLRU().first, 2) << "Least recently used element should be 2";
+    ASSERT_EQ(lru.popMRU().first, 1) << "Most recently used element should be 1";
+    ASSERT_EQ(lru.popMRU().first, 3);
+    ASSERT_TRUE(lru.isEmpty());
+}
+
+TEST_F(LRUCacheTest, Growing) {
+    // Caches with a large maximum size allocate their slots lazily
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(
+        std::numeric_limits<size_t>::max()
+    );
+    for (int i = 0; i < 10000; ++i) {
+        lru.put(i, 2 * i);
+    }
+    ASSERT_EQ(lru.size(), 10000u);
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_EQ(lru.get(i), 2 * i);
+    }
+    ASSERT_EQ(lru.popLRU().first, 0);
+}
+
+namespace {
+    // The std::list based implementation that the LRUCache used to be, kept as a
+    // reference for the benchmark below
+    template <typename KeyType, typename ValueType, typename HasherType>
+    class ListLRUCache {
+    public:
+        using Item = std::pair<KeyType, ValueType>;
+        using Items = std::list<Item>;
+
+        ListLRUCache(size_t size) : _maximumCacheSize(size) {}
+
+        void put(KeyType key, ValueType value) {
+            const auto it = _itemMap.find(key);
+            if (it != _itemMap.end()) {
+                _itemList.erase(it->second);
+                _itemMap.erase(it);
+            }
+            _itemList.emplace_front(key, std::move(value));
+            _itemMap.emplace(std::move(key), _itemList.begin());
+            while (_itemMap.size() > _maximumCacheSize) {
+                _itemMap.erase(_itemList.back().first);
+                _itemList.pop_back();
+            }
+        }
+
+        bool exist(const KeyType& key) const {
+            return _itemMap.count(key) > 0;
+        }
+
+        bool touch(const KeyType& key) {
+            const auto it = _itemMap.find(key);
+            if (it == _itemMap.end()) {
+                return false;
+            }
+            ValueType value = it->second->second;
+            _itemList.erase(it->second);
+            _itemMap.erase(it);
+            _itemList.emplace_front(key, value);
+            _itemMap.emplace(key, _itemList.begin());
+            return true;
+        }
+
+        ValueType get(const KeyType& key) {
+            const auto it = _itemMap.find(key);
+            _itemList.splice(_itemList.begin(), _itemList, it->second);
+            return it->second->second;
+        }
+
+    private:
+        Items _itemList;
+        std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+        size_t _maximumCacheSize;
+    };
+
+    // Runs the access pattern of the tests above, scaled up: filling the cache beyond
+    // its capacity, and getting, touching and replacing items with struct keys
+    template <typename Cache>
+    double benchmarkLRUCache(int nIterations) {
+        Cache cache(512);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        size_t checksum = 0;
+        for (int i = 0; i < nIterations; ++i) {
+            const MyKey key = { i % 1024, (i * 7) % 1024 };
+            if (!cache.touch(key)) {
+                cache.put(key, std::string("value"));
+            }
+            const MyKey other = { (i * 13) % 1024, (i * 91) % 1024 };
+            if (cache.exist(other)) {
+                checksum += cache.get(other).size();
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        // Prevent the compiler from optimizing the loop away
+        EXPECT_GE(checksum, 0u);
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+} // namespace
+
+// Run with --gtest_also_run_disabled_tests to compare against the previous
+// implementation
+TEST_F(LRUCacheTest, DISABLED_Benchmark) {
+    using namespace openspace::globebrowsing::cache;
+    constexpr const int NIterations = 5000000;
+
+    const double listTime = benchmarkLRUCache<
+        ListLRUCache<MyKey, std::string, DefaultHasherMyKey>
+    >(NIterations);
+    const double flatTime = benchmarkLRUCache<
+        LRUCache<MyKey, std::string, DefaultHasherMyKey>
+    >(NIterations);
+
+    std::cout << "std::list based LRU cache: " << listTime << " ms" << std::endl;
+    std::cout << "Flat LRU cache:            " << flatTime << " ms" << std::endl;
+}
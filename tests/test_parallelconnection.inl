@@ -0,0 +1,680 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messagestructures.h>
+#include <openspace/network/parallelconnection.h>
+#include <openspace/network/parallelserver.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+#ifdef WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else // WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr const int LoopbackPort = 25099;
+    constexpr const int BackpressurePort = 25100;
+    constexpr const int SlowPeerPort = 25101;
+    constexpr const int BenchmarkPort = 25102;
+
+    std::vector<char> authenticationMessage(const std::string& password,
+                                            const std::string& name)
+    {
+        const uint64_t passCode = std::hash<std::string>{}(password);
+        const uint32_t nameLength = static_cast<uint32_t>(name.size());
+
+        std::vector<char> buffer(sizeof(uint64_t) + sizeof(uint32_t) + nameLength);
+        char* ptr = buffer.data();
+        memcpy(ptr, &passCode, sizeof(uint64_t));
+        ptr += sizeof(uint64_t);
+        memcpy(ptr, &nameLength, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+        memcpy(ptr, name.data(), nameLength);
+        return buffer;
+    }
+
+    // Receives messages until a connection status message with the status is received
+    void awaitStatus(openspace::ParallelConnection& connection,
+                     openspace::ParallelConnection::Status status)
+    {
+        using namespace openspace;
+        while (true) {
+            ParallelConnection::Message m = connection.receiveMessage();
+            if (m.type == ParallelConnection::MessageType::ConnectionStatus) {
+                uint32_t s;
+                memcpy(&s, m.content.data(), sizeof(uint32_t));
+                if (static_cast<ParallelConnection::Status>(s) == status) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // Connects to the server and waits until it has assigned the connection the status
+    openspace::ParallelConnection connectPeer(int port, const std::string& password,
+                                              const std::string& name,
+                                           openspace::ParallelConnection::Status status)
+    {
+        using namespace openspace;
+        // The host is recognized by its IPv4 address, so localhost must not resolve
+        // to the IPv6 loopback address
+        auto socket = std::make_unique<ghoul::io::TcpSocket>("127.0.0.1", port);
+        socket->connect();
+        ParallelConnection connection(std::move(socket));
+        connection.sendMessage(ParallelConnection::Message(
+            ParallelConnection::MessageType::Authentication,
+            authenticationMessage(password, name)
+        ));
+        awaitStatus(connection, status);
+        return connection;
+    }
+
+    // The following helpers talk to the server through plain sockets rather than a
+    // ParallelConnection, as the latter always drains its socket in the background and
+    // can thus not act as a peer that stops reading
+#ifdef WIN32
+    using RawSocket = SOCKET;
+    const RawSocket InvalidRawSocket = INVALID_SOCKET;
+#else // WIN32
+    using RawSocket = int;
+    const RawSocket InvalidRawSocket = -1;
+#endif // WIN32
+
+    void closeRawPeer(RawSocket s) {
+#ifdef WIN32
+        closesocket(s);
+#else // WIN32
+        close(s);
+#endif // WIN32
+    }
+
+    RawSocket connectRawPeer(int port, int receiveBufferSize = 0) {
+        const RawSocket s = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (receiveBufferSize > 0) {
+            // Has to be set before connecting to limit the advertised receive window
+            setsockopt(
+                s,
+                SOL_SOCKET,
+                SO_RCVBUF,
+                reinterpret_cast<const char*>(&receiveBufferSize),
+                sizeof(receiveBufferSize)
+            );
+        }
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            closeRawPeer(s);
+            return InvalidRawSocket;
+        }
+        return s;
+    }
+
+    bool sendRaw(RawSocket s, const char* data, size_t size) {
+        while (size > 0) {
+            const auto n = send(s, data, static_cast<int>(size), 0);
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool receiveRaw(RawSocket s, char* data, size_t size) {
+        while (size > 0) {
+            const auto n = recv(s, data, static_cast<int>(size), 0);
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool sendRawMessage(RawSocket s, openspace::ParallelConnection::MessageType type,
+                        const std::vector<char>& content)
+    {
+        using namespace openspace;
+        const uint32_t protocolVersion = ParallelConnection::ProtocolVersion;
+        const uint32_t messageType = static_cast<uint32_t>(type);
+        const uint32_t messageSize = static_cast<uint32_t>(content.size());
+        std::array<char, ParallelConnection::HeaderSize> header;
+        header[0] = 'O';
+        header[1] = 'S';
+        memcpy(header.data() + 2, &protocolVersion, sizeof(uint32_t));
+        memcpy(header.data() + 2 + sizeof(uint32_t), &messageType, sizeof(uint32_t));
+        memcpy(header.data() + 2 + 2 * sizeof(uint32_t), &messageSize, sizeof(uint32_t));
+        return sendRaw(s, header.data(), header.size()) &&
+               sendRaw(s, content.data(), content.size());
+    }
+
+    // Returns a Disconnection message if the server closed the connection
+    openspace::ParallelConnection::Message receiveRawMessage(RawSocket s) {
+        using namespace openspace;
+        std::array<char, ParallelConnection::HeaderSize> header;
+        if (!receiveRaw(s, header.data(), header.size())) {
+            return { ParallelConnection::MessageType::Disconnection, {} };
+        }
+        uint32_t messageType;
+        uint32_t messageSize;
+        memcpy(&messageType, header.data() + 2 + sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&messageSize, header.data() + 2 + 2 * sizeof(uint32_t), sizeof(uint32_t));
+        std::vector<char> content(messageSize);
+        if (!receiveRaw(s, content.data(), content.size())) {
+            return { ParallelConnection::MessageType::Disconnection, {} };
+        }
+        return { static_cast<ParallelConnection::MessageType>(messageType), content };
+    }
+
+    // Authenticates the peer and waits until the server has assigned it the status
+    bool authenticateRawPeer(RawSocket s, const std::string& password,
+                             const std::string& name,
+                             openspace::ParallelConnection::Status status)
+    {
+        using namespace openspace;
+        sendRawMessage(
+            s,
+            ParallelConnection::MessageType::Authentication,
+            authenticationMessage(password, name)
+        );
+        while (true) {
+            ParallelConnection::Message m = receiveRawMessage(s);
+            if (m.type == ParallelConnection::MessageType::Disconnection) {
+                return false;
+            }
+            if (m.type == ParallelConnection::MessageType::ConnectionStatus) {
+                uint32_t st;
+                memcpy(&st, m.content.data(), sizeof(uint32_t));
+                if (static_cast<ParallelConnection::Status>(st) == status) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Receives the next data message and returns the index that is stored in it
+    int receiveRawDataIndex(RawSocket s) {
+        using namespace openspace;
+        while (true) {
+            ParallelConnection::Message m = receiveRawMessage(s);
+            if (m.type == ParallelConnection::MessageType::Disconnection) {
+                return -1;
+            }
+            if (m.type == ParallelConnection::MessageType::Data) {
+                int index;
+                memcpy(&index, m.content.data(), sizeof(int));
+                return index;
+            }
+        }
+    }
+
+    // The server updates its connection count on its I/O thread, so it is polled
+    bool awaitNConnections(const openspace::ParallelServer& server, size_t n) {
+        for (int i = 0; i < 1000; ++i) {
+            if (server.nConnections() == n) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+} // namespace
+
+class ParallelConnectionTest : public testing::Test {};
+
+TEST_F(ParallelConnectionTest, CameraKeyframeRoundTrip) {
+    using namespace openspace::datamessagestructures;
+
+    CameraKeyframe kf;
+    kf._position = glm::dvec3(1.0, 2.0, 3.0);
+    kf._rotation = glm::dquat(0.5, 0.5, 0.5, 0.5);
+    kf._followNodeRotation = true;
+    kf._focusNode = "Earth";
+    kf._scale = 0.25f;
+    kf._timestamp = 42.0;
+
+    std::vector<char> buffer;
+    kf.serialize(buffer);
+    ASSERT_EQ(CameraKeyframe::FixedSize + kf._focusNode.size(), buffer.size());
+
+    CameraKeyframe res;
+    ASSERT_TRUE(res.deserialize(buffer.data(), buffer.size()));
+    EXPECT_EQ(kf._position, res._position);
+    EXPECT_EQ(kf._rotation, res._rotation);
+    EXPECT_EQ(kf._followNodeRotation, res._followNodeRotation);
+    EXPECT_EQ(kf._focusNode, res._focusNode);
+    EXPECT_EQ(kf._scale, res._scale);
+    EXPECT_EQ(kf._timestamp, res._timestamp);
+
+    // A truncated keyframe must be rejected
+    EXPECT_FALSE(res.deserialize(buffer.data(), buffer.size() - 1));
+}
+
+TEST_F(ParallelConnectionTest, CameraKeyframeTruncatesLongFocusNode) {
+    using namespace openspace::datamessagestructures;
+
+    constexpr const size_t MaxLength = std::numeric_limits<uint16_t>::max();
+
+    CameraKeyframe kf;
+    kf._position = glm::dvec3(1.0, 2.0, 3.0);
+    kf._rotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+    kf._followNodeRotation = false;
+    kf._focusNode = std::string(MaxLength, 'a') + "bcd";
+    kf._scale = 1.f;
+    kf._timestamp = 1.0;
+
+    std::vector<char> buffer;
+    kf.serialize(buffer);
+    ASSERT_EQ(CameraKeyframe::FixedSize + MaxLength, buffer.size());
+
+    CameraKeyframe res;
+    ASSERT_TRUE(res.deserialize(buffer.data(), buffer.size()));
+    EXPECT_EQ(std::string(MaxLength, 'a'), res._focusNode);
+    EXPECT_EQ(kf._timestamp, res._timestamp);
+}
+
+TEST_F(ParallelConnectionTest, Batch) {
+    using namespace openspace::datamessagestructures;
+
+    TimeKeyframe time;
+    time._time = 1.0;
+    time._dt = 2.0;
+    time._paused = false;
+    time._requiresTimeJump = true;
+    time._timestamp = 3.0;
+
+    ScriptMessage script;
+    script._script = "openspace.time.setPause(true)";
+
+    std::vector<char> batch;
+    appendToBatch(batch, time);
+    appendToBatch(batch, script);
+
+    std::vector<Type> types;
+    const bool success = forEachInBatch(
+        batch.data(),
+        batch.size(),
+        [&](Type type, const char* data, size_t size) {
+            types.push_back(type);
+            if (type == Type::TimeData) {
+                TimeKeyframe res;
+                ASSERT_TRUE(res.deserialize(data, size));
+                EXPECT_EQ(time._time, res._time);
+                EXPECT_EQ(time._dt, res._dt);
+                EXPECT_EQ(time._paused, res._paused);
+                EXPECT_EQ(time._requiresTimeJump, res._requiresTimeJump);
+                EXPECT_EQ(time._timestamp, res._timestamp);
+            }
+            else {
+                ScriptMessage res;
+                ASSERT_TRUE(res.deserialize(data, size));
+                EXPECT_EQ(script._script, res._script);
+            }
+        }
+    );
+    EXPECT_TRUE(success);
+    ASSERT_EQ(2, types.size());
+    EXPECT_EQ(Type::TimeData, types[0]);
+    EXPECT_EQ(Type::ScriptData, types[1]);
+
+    // Cutting the last message short has to be detected
+    EXPECT_FALSE(forEachInBatch(
+        batch.data(),
+        batch.size() - 1,
+        [](Type, const char*, size_t) {}
+    ));
+}
+
+TEST_F(ParallelConnectionTest, LoopbackDeliversBatches) {
+    using namespace openspace;
+    using namespace datamessagestructures;
+    constexpr const int NMessages = 10000;
+    const std::string Password = "password";
+
+    ParallelServer server;
+    server.setDefaultHostAddress("127.0.0.1");
+    server.start(LoopbackPort, Password, "hostpassword", "localhost");
+
+    ParallelConnection host = connectPeer(
+        LoopbackPort,
+        Password,
+        "Host",
+        ParallelConnection::Status::Host
+    );
+    ParallelConnection client = connectPeer(
+        LoopbackPort,
+        Password,
+        "Client",
+        ParallelConnection::Status::ClientWithHost
+    );
+
+    // Each message is a batch of one camera and one time keyframe, like a network tick
+    CameraKeyframe camera;
+    camera._position = glm::dvec3(1.0, 2.0, 3.0);
+    camera._rotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+    camera._followNodeRotation = false;
+    camera._focusNode = "Earth";
+    camera._scale = 1.f;
+    TimeKeyframe time;
+    time._time = 0.0;
+    time._dt = 1.0;
+    time._paused = false;
+    time._requiresTimeJump = false;
+
+    std::vector<char> batch;
+    for (int i = 0; i < NMessages; ++i) {
+        camera._timestamp = time._timestamp = static_cast<double>(i);
+        batch.resize(sizeof(uint32_t));
+        const uint32_t type = static_cast<uint32_t>(Type::Batch);
+        memcpy(batch.data(), &type, sizeof(uint32_t));
+        appendToBatch(batch, camera);
+        appendToBatch(batch, time);
+        ASSERT_TRUE(host.sendMessage(
+            ParallelConnection::MessageType::Data,
+            batch.data(),
+            batch.size()
+        ));
+    }
+
+    // All batches have to arrive intact and in order
+    int nReceived = 0;
+    while (nReceived < NMessages) {
+        ParallelConnection::Message m = client.receiveMessage();
+        if (m.type != ParallelConnection::MessageType::Data) {
+            continue;
+        }
+        ASSERT_EQ(batch.size(), m.content.size());
+        uint32_t type;
+        memcpy(&type, m.content.data(), sizeof(uint32_t));
+        ASSERT_EQ(static_cast<uint32_t>(Type::Batch), type);
+
+        int nKeyframes = 0;
+        const bool success = forEachInBatch(
+            m.content.data() + sizeof(uint32_t),
+            m.content.size() - sizeof(uint32_t),
+            [&](Type t, const char* data, size_t size) {
+                ++nKeyframes;
+                if (t == Type::CameraData) {
+                    CameraKeyframe res;
+                    ASSERT_TRUE(res.deserialize(data, size));
+                    EXPECT_EQ(static_cast<double>(nReceived), res._timestamp);
+                    EXPECT_EQ(camera._focusNode, res._focusNode);
+                }
+                else {
+                    ASSERT_EQ(Type::TimeData, t);
+                    TimeKeyframe res;
+                    ASSERT_TRUE(res.deserialize(data, size));
+                    EXPECT_EQ(static_cast<double>(nReceived), res._timestamp);
+                }
+            }
+        );
+        ASSERT_TRUE(success);
+        ASSERT_EQ(2, nKeyframes);
+        ++nReceived;
+    }
+
+    host.disconnect();
+    client.disconnect();
+    server.stop();
+}
+
+// Run with --gtest_also_run_disabled_tests to measure how many batches per second the
+// server relays from a host to a client over the loopback interface
+TEST_F(ParallelConnectionTest, DISABLED_LoopbackThroughput) {
+    using namespace openspace;
+    using namespace datamessagestructures;
+    constexpr const int NMessages = 10000;
+    const std::string Password = "password";
+
+    ParallelServer server;
+    server.setDefaultHostAddress("127.0.0.1");
+    server.start(BenchmarkPort, Password, "hostpassword", "localhost");
+
+    ParallelConnection host = connectPeer(
+        BenchmarkPort,
+        Password,
+        "Host",
+        ParallelConnection::Status::Host
+    );
+    ParallelConnection client = connectPeer(
+        BenchmarkPort,
+        Password,
+        "Client",
+        ParallelConnection::Status::ClientWithHost
+    );
+
+    // Each message is a batch of one camera and one time keyframe, like a network tick
+    CameraKeyframe camera;
+    camera._position = glm::dvec3(1.0, 2.0, 3.0);
+    camera._rotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+    camera._followNodeRotation = false;
+    camera._focusNode = "Earth";
+    camera._scale = 1.f;
+    TimeKeyframe time;
+    time._time = 0.0;
+    time._dt = 1.0;
+    time._paused = false;
+    time._requiresTimeJump = false;
+
+    std::vector<char> batch;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NMessages; ++i) {
+        camera._timestamp = time._timestamp = static_cast<double>(i);
+        batch.resize(sizeof(uint32_t));
+        const uint32_t type = static_cast<uint32_t>(Type::Batch);
+        memcpy(batch.data(), &type, sizeof(uint32_t));
+        appendToBatch(batch, camera);
+        appendToBatch(batch, time);
+        ASSERT_TRUE(host.sendMessage(
+            ParallelConnection::MessageType::Data,
+            batch.data(),
+            batch.size()
+        ));
+    }
+
+    int nReceived = 0;
+    while (nReceived < NMessages) {
+        ParallelConnection::Message m = client.receiveMessage();
+        if (m.type == ParallelConnection::MessageType::Data) {
+            ++nReceived;
+        }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "ParallelServer loopback: " << NMessages << " batches in " << seconds
+              << "s (" << NMessages / seconds << " batches/s, "
+              << NMessages * batch.size() / seconds / (1024 * 1024) << " MB/s)"
+              << std::endl;
+
+    host.disconnect();
+    client.disconnect();
+    server.stop();
+}
+
+TEST_F(ParallelConnectionTest, RingBufferWrapsAround) {
+    openspace::ParallelServer::RingBuffer buffer(8);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(8u, buffer.capacity());
+
+    ASSERT_TRUE(buffer.push("abcdef", 6));
+    // Data that does not fit completely is rejected without appending any of it
+    EXPECT_FALSE(buffer.push("ghi", 3));
+    EXPECT_EQ(6u, buffer.size());
+
+    buffer.pop(4);
+    EXPECT_EQ(2u, buffer.size());
+
+    // "ef" is at the end of the storage, so "ghijk" has to wrap around
+    ASSERT_TRUE(buffer.push("ghijk", 5));
+    EXPECT_EQ(7u, buffer.size());
+
+    std::pair<const char*, size_t> block = buffer.front();
+    ASSERT_EQ(4u, block.second);
+    EXPECT_EQ("efgh", std::string(block.first, block.second));
+    buffer.pop(block.second);
+
+    block = buffer.front();
+    ASSERT_EQ(3u, block.second);
+    EXPECT_EQ("ijk", std::string(block.first, block.second));
+    buffer.pop(block.second);
+    EXPECT_TRUE(buffer.empty());
+
+    // An empty buffer can be filled to its full capacity in one contiguous block
+    ASSERT_TRUE(buffer.push("01234567", 8));
+    EXPECT_FALSE(buffer.push("8", 1));
+    block = buffer.front();
+    ASSERT_EQ(8u, block.second);
+    EXPECT_EQ("01234567", std::string(block.first, block.second));
+}
+
+TEST_F(ParallelConnectionTest, StalledPeerDoesNotDelayOthers) {
+    using namespace openspace;
+    constexpr const int NMessages = 1000;
+    constexpr const size_t MessageSize = 1024;
+    const std::string Password = "password";
+
+    ParallelServer server;
+    server.setDefaultHostAddress("127.0.0.1");
+    server.start(BackpressurePort, Password, "hostpassword", "localhost");
+
+    const RawSocket host = connectRawPeer(BackpressurePort);
+    ASSERT_NE(InvalidRawSocket, host);
+    ASSERT_TRUE(
+        authenticateRawPeer(host, Password, "Host", ParallelConnection::Status::Host)
+    );
+    const RawSocket client = connectRawPeer(BackpressurePort);
+    ASSERT_NE(InvalidRawSocket, client);
+    ASSERT_TRUE(authenticateRawPeer(
+        client, Password, "Client", ParallelConnection::Status::ClientWithHost
+    ));
+    // A small receive window makes the messages for this peer pile up in the server
+    const RawSocket stalled = connectRawPeer(BackpressurePort, 4096);
+    ASSERT_NE(InvalidRawSocket, stalled);
+    ASSERT_TRUE(authenticateRawPeer(
+        stalled, Password, "Stalled", ParallelConnection::Status::ClientWithHost
+    ));
+
+    // In total, the messages fit into the outgoing buffer of the stalled peer
+    std::vector<char> message(MessageSize);
+    for (int i = 0; i < NMessages; ++i) {
+        memcpy(message.data(), &i, sizeof(int));
+        ASSERT_TRUE(sendRawMessage(host, ParallelConnection::MessageType::Data, message));
+    }
+
+    // The client receives all messages while the stalled peer is not reading
+    for (int i = 0; i < NMessages; ++i) {
+        ASSERT_EQ(i, receiveRawDataIndex(client));
+    }
+    EXPECT_EQ(3u, server.nConnections());
+
+    // Once it starts reading, the stalled peer receives everything that was queued
+    for (int i = 0; i < NMessages; ++i) {
+        ASSERT_EQ(i, receiveRawDataIndex(stalled));
+    }
+    EXPECT_EQ(3u, server.nConnections());
+
+    closeRawPeer(stalled);
+    closeRawPeer(client);
+    closeRawPeer(host);
+    server.stop();
+}
+
+TEST_F(ParallelConnectionTest, SlowPeerIsDisconnected) {
+    using namespace openspace;
+    constexpr const size_t OutgoingBufferSize = 64 * 1024;
+    constexpr const size_t MessageSize = 16 * 1024;
+    // Enough data to exceed the socket buffers and the outgoing buffer many times
+    constexpr const int MaxMessages = 16 * 1024;
+    const std::string Password = "password";
+
+    ParallelServer server(OutgoingBufferSize);
+    server.setDefaultHostAddress("127.0.0.1");
+    server.start(SlowPeerPort, Password, "hostpassword", "localhost");
+
+    const RawSocket host = connectRawPeer(SlowPeerPort);
+    ASSERT_NE(InvalidRawSocket, host);
+    ASSERT_TRUE(
+        authenticateRawPeer(host, Password, "Host", ParallelConnection::Status::Host)
+    );
+    const RawSocket slow = connectRawPeer(SlowPeerPort, 4096);
+    ASSERT_NE(InvalidRawSocket, slow);
+    ASSERT_TRUE(authenticateRawPeer(
+        slow, Password, "Slow", ParallelConnection::Status::ClientWithHost
+    ));
+    ASSERT_TRUE(awaitNConnections(server, 2));
+
+    std::vector<char> message(MessageSize);
+    for (int i = 0; i < MaxMessages && server.nConnections() == 2; ++i) {
+        memcpy(message.data(), &i, sizeof(int));
+        ASSERT_TRUE(sendRawMessage(host, ParallelConnection::MessageType::Data, message));
+    }
+
+    // The peer that never reads is dropped instead of the server buffering unboundedly
+    ASSERT_TRUE(awaitNConnections(server, 1));
+
+    // What the slow peer still receives is in order and ends with the disconnection
+    int expected = 0;
+    while (true) {
+        const int index = receiveRawDataIndex(slow);
+        if (index == -1) {
+            break;
+        }
+        ASSERT_EQ(expected, index);
+        ++expected;
+    }
+    EXPECT_LT(expected, MaxMessages);
+
+    // The host is unaffected and is still served
+    const RawSocket client = connectRawPeer(SlowPeerPort);
+    ASSERT_NE(InvalidRawSocket, client);
+    ASSERT_TRUE(authenticateRawPeer(
+        client, Password, "Client", ParallelConnection::Status::ClientWithHost
+    ));
+    const int index = 42;
+    memcpy(message.data(), &index, sizeof(int));
+    ASSERT_TRUE(sendRawMessage(host, ParallelConnection::MessageType::Data, message));
+    EXPECT_EQ(index, receiveRawDataIndex(client));
+
+    closeRawPeer(client);
+    closeRawPeer(slow);
+    closeRawPeer(host);
+    server.stop();
+}
@@ -0,0 +1,169 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/parallelfor.h>
+
+#include <ghoul/glm.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+class ParallelForTest : public testing::Test {};
+
+TEST_F(ParallelForTest, ResultsFollowItemOrder) {
+    using namespace openspace;
+
+    struct State {
+        std::vector<int> scratch;
+        size_t nItems = 0;
+    };
+    std::vector<State> states(4);
+    std::vector<std::vector<int>> results(1000);
+    parallelForEach(
+        results.size(),
+        states,
+        [&results](State& state, size_t i) {
+            // Items of different lengths, produced through a reused per-thread buffer
+            state.scratch.clear();
+            for (size_t j = 0; j < i % 17; ++j) {
+                state.scratch.push_back(static_cast<int>(i));
+            }
+            results[i] = state.scratch;
+            ++state.nItems;
+        }
+    );
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_EQ(results[i], std::vector<int>(i % 17, static_cast<int>(i)));
+    }
+    size_t total = 0;
+    for (const State& s : states) {
+        total += s.nItems;
+    }
+    EXPECT_EQ(total, results.size());
+}
+
+TEST_F(ParallelForTest, MoreThreadsThanItems) {
+    using namespace openspace;
+
+    std::vector<int> states(8, 0);
+    parallelForEach(3, states, [](int& count, size_t) { ++count; });
+    EXPECT_EQ(std::accumulate(states.begin(), states.end(), 0), 3);
+}
+
+namespace {
+    // Traces a field line through a dipole field with fourth order Runge-Kutta, in the
+    // way that KameleonWrapper traces through a model, until it leaves the domain or
+    // reaches the inner boundary
+    void traceDipoleFieldline(const glm::vec3& seed, float direction,
+                              std::vector<glm::vec3>& line)
+    {
+        auto field = [direction](const glm::vec3& p) {
+            const float r = glm::length(p);
+            const float r5 = r * r * r * r * r;
+            const glm::vec3 b = glm::vec3(3.f * p.x * p.z, 3.f * p.y * p.z,
+                                          3.f * p.z * p.z - r * r) / r5;
+            return b / glm::length(b) * direction;
+        };
+
+        constexpr const float StepSize = 0.01f;
+        line.clear();
+        glm::vec3 pos = seed;
+        for (int i = 0; i < 5000; ++i) {
+            const float r = glm::length(pos);
+            if (r < 1.f || r > 30.f) {
+                break;
+            }
+            line.push_back(pos);
+            const glm::vec3 k1 = field(pos);
+            const glm::vec3 k2 = field(pos + k1 * (StepSize / 2.f));
+            const glm::vec3 k3 = field(pos + k2 * (StepSize / 2.f));
+            const glm::vec3 k4 = field(pos + k3 * StepSize);
+            pos = pos + (k1 + k2 * 2.f + k3 * 2.f + k4) * (StepSize / 6.f);
+        }
+        line.push_back(pos);
+    }
+
+    void traceSeed(const glm::vec3& seed, std::vector<glm::vec3>& forward,
+                   std::vector<glm::vec3>& back, std::vector<glm::vec3>& result)
+    {
+        traceDipoleFieldline(seed, 1.f, forward);
+        traceDipoleFieldline(seed, -1.f, back);
+        result.assign(forward.rbegin(), forward.rend());
+        result.insert(result.end(), back.begin() + 1, back.end());
+    }
+} // namespace
+
+// Run with --gtest_also_run_disabled_tests to compare tracing one seed point at a time,
+// as KameleonWrapper and the fieldlines sequence used to do, against parallelForEach
+TEST_F(ParallelForTest, DISABLED_Benchmark) {
+    using namespace openspace;
+
+    std::vector<glm::vec3> seeds;
+    for (int i = 0; i < 2000; ++i) {
+        const float angle = static_cast<float>(i) * 0.0031415f;
+        const float r = 2.f + static_cast<float>(i % 40) * 0.1f;
+        seeds.emplace_back(r * std::cos(angle), r * std::sin(angle), 0.1f);
+    }
+
+    std::vector<std::vector<glm::vec3>> serial(seeds.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            std::vector<glm::vec3> forward;
+            std::vector<glm::vec3> back;
+            traceSeed(seeds[i], forward, back, serial[i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double serialTime = std::chrono::duration<double, std::milli>(
+        end - start
+    ).count();
+
+    struct Buffers {
+        std::vector<glm::vec3> forward;
+        std::vector<glm::vec3> back;
+    };
+    std::vector<std::vector<glm::vec3>> parallel(seeds.size());
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<Buffers> buffers(defaultParallelThreadCount());
+        parallelForEach(seeds.size(), buffers, [&](Buffers& b, size_t i) {
+            traceSeed(seeds[i], b.forward, b.back, parallel[i]);
+        });
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const double parallelTime = std::chrono::duration<double, std::milli>(
+        end - start
+    ).count();
+
+    EXPECT_EQ(serial, parallel);
+    std::cout << "Serial tracing:   " << serialTime << " ms" << std::endl;
+    std::cout << "Parallel tracing: " << parallelTime << " ms ("
+              << defaultParallelThreadCount() << " threads)" << std::endl;
+}
@@ -0,0 +1,223 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/base/rendering/renderabletrailorbit.h>
+
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/scene/translation.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/glm.h>
+#include <ghoul/misc/dictionary.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RenderableTrailOrbitTest : public testing::Test {};
+
+namespace {
+    constexpr const double SecondsPerDay = 24.0 * 60.0 * 60.0;
+
+    // Holds back the samplers of the GatedTranslation until it is opened
+    struct Gate {
+        void open() {
+            std::lock_guard<std::mutex> lock(mutex);
+            isOpen = true;
+            condition.notify_all();
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex);
+            isOpen = false;
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return isOpen; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool isOpen = true;
+    };
+
+    // Opens the gate when leaving a test, so that no sampler is left waiting on the
+    // trail sampling pool if an assertion fails
+    struct GateOpener {
+        ~GateOpener() { gate->open(); }
+        std::shared_ptr<Gate> gate;
+    };
+
+    // A translation along the x axis whose x coordinate is the time. Its sampler only
+    // finishes once the gate is open, which keeps a sweep pending for as long as needed
+    class GatedTranslation : public openspace::Translation {
+    public:
+        explicit GatedTranslation(std::shared_ptr<Gate> gate) : _gate(std::move(gate)) {}
+
+        glm::dvec3 position(const openspace::Time& time) const override {
+            return glm::dvec3(time.j2000Seconds(), 0.0, 0.0);
+        }
+
+        BatchSampler batchSampler() const override {
+            std::shared_ptr<Gate> gate = _gate;
+            return [gate](const std::vector<double>& times) {
+                gate->wait();
+                std::vector<glm::dvec3> result;
+                for (double t : times) {
+                    result.emplace_back(t, 0.0, 0.0);
+                }
+                return result;
+            };
+        }
+
+    private:
+        std::shared_ptr<Gate> _gate;
+    };
+
+    class TestTrailOrbit : public openspace::RenderableTrailOrbit {
+    public:
+        TestTrailOrbit(const ghoul::Dictionary& dictionary, std::shared_ptr<Gate> gate)
+            : RenderableTrailOrbit(dictionary)
+        {
+            removePropertySubOwner(_translation.get());
+            _translation = std::make_unique<GatedTranslation>(std::move(gate));
+            addPropertySubOwner(_translation.get());
+        }
+
+        // Performs the part of #update that does not require OpenGL
+        UpdateReport step(double time) {
+            return updateTrails({
+                { glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+                openspace::Time(time),
+                false
+            });
+        }
+
+        // Steps until the positions of a full sweep have been applied to the trail
+        bool waitForFullSweep(double time) {
+            for (int i = 0; i < 5000; ++i) {
+                const UpdateReport report = step(time);
+                const bool isFullSweep = report.nUpdated == UpdateReport::All;
+                if (report.permanentPointsNeedUpdate && isFullSweep) {
+                    return true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return false;
+        }
+
+        std::vector<float> xCoordinates() const {
+            std::vector<float> result;
+            for (const TrailVBOLayout& v : _vertexArray) {
+                result.push_back(v.x);
+            }
+            return result;
+        }
+    };
+
+    ghoul::Dictionary trailDictionary(int resolution) {
+        using namespace std::string_literals;
+
+        ghoul::Dictionary translation = {
+            { "Type", "StaticTranslation"s },
+            { "Position", glm::dvec3(0.0) }
+        };
+        return {
+            { "Type", "RenderableTrailOrbit"s },
+            { "Translation", translation },
+            { "Color", glm::dvec3(1.0) },
+            { "Period", 1.0 },
+            { "Resolution", static_cast<double>(resolution) }
+        };
+    }
+} // namespace
+
+TEST_F(RenderableTrailOrbitTest, KeepsPreviousTrailUntilSamplesAreCollected) {
+    auto gate = std::make_shared<Gate>();
+    GateOpener opener = { gate };
+    TestTrailOrbit trail(trailDictionary(10), gate);
+
+    const double start = 100.0 * SecondsPerDay;
+    ASSERT_TRUE(trail.waitForFullSweep(start));
+    const std::vector<float> previous = trail.xCoordinates();
+    ASSERT_EQ(previous.size(), 10u);
+    EXPECT_EQ(previous[1], static_cast<float>(start));
+
+    // A jump of more than a period requires a full sweep, which cannot finish while the
+    // gate is closed
+    gate->close();
+    const double jump = start + 10.0 * SecondsPerDay;
+    for (int i = 0; i < 3; ++i) {
+        const auto report = trail.step(jump + i);
+        // The old trail stays, but its floating point still follows the object
+        EXPECT_FALSE(report.permanentPointsNeedUpdate);
+        EXPECT_TRUE(report.floatingPointNeedsUpdate);
+        EXPECT_EQ(trail.xCoordinates(), previous);
+    }
+
+    gate->open();
+    ASSERT_TRUE(trail.waitForFullSweep(jump));
+    const std::vector<float> current = trail.xCoordinates();
+    ASSERT_EQ(current.size(), 10u);
+    EXPECT_EQ(current[1], static_cast<float>(jump));
+}
+
+TEST_F(RenderableTrailOrbitTest, ResolutionChangeDuringPendingSweep) {
+    auto gate = std::make_shared<Gate>();
+    GateOpener opener = { gate };
+    TestTrailOrbit trail(trailDictionary(10), gate);
+
+    const double start = 100.0 * SecondsPerDay;
+    ASSERT_TRUE(trail.waitForFullSweep(start));
+
+    gate->close();
+    const double jump = start + 10.0 * SecondsPerDay;
+    trail.step(jump);
+
+    openspace::properties::Property* resolution = trail.property("Resolution");
+    ASSERT_NE(resolution, nullptr);
+    *static_cast<openspace::properties::IntProperty*>(resolution) = 20;
+
+    const auto report = trail.step(jump);
+    EXPECT_FALSE(report.permanentPointsNeedUpdate);
+    EXPECT_EQ(trail.xCoordinates().size(), 10u);
+
+    // The pending sweep is applied with the resolution it was requested with, and the
+    // next update requests a sweep with the new resolution
+    gate->open();
+    ASSERT_TRUE(trail.waitForFullSweep(jump));
+    EXPECT_EQ(trail.xCoordinates().size(), 10u);
+
+    ASSERT_TRUE(trail.waitForFullSweep(jump));
+    const std::vector<float> current = trail.xCoordinates();
+    ASSERT_EQ(current.size(), 20u);
+    EXPECT_EQ(current[1], static_cast<float>(jump));
+    const double secondsPerPoint = SecondsPerDay / 19.0;
+    EXPECT_EQ(current[19], static_cast<float>(jump - 18 * secondsPerPoint));
+}
@@ -0,0 +1,203 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scene/scene.h>
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/scene/sceneinitializer.h>
+#include <openspace/util/updatestructures.h>
+
+#include <ghoul/glm.h>
+#include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SceneTest : public testing::Test {};
+
+namespace {
+    // Creates a node with a static transform that differs for every value of \p i
+    std::unique_ptr<openspace::SceneGraphNode> createNode(const std::string& identifier,
+                                                          int i)
+    {
+        using namespace std::string_literals;
+
+        const double v = static_cast<double>(i);
+        ghoul::Dictionary translation = {
+            { "Type", "StaticTranslation"s },
+            { "Position", glm::dvec3(v, 2.0 * v, -0.5 * v) }
+        };
+        ghoul::Dictionary rotation = {
+            { "Type", "StaticRotation"s },
+            { "Rotation", glm::dvec3(0.1 * v, 0.2, -0.05 * v) }
+        };
+        ghoul::Dictionary scale = {
+            { "Type", "StaticScale"s },
+            { "Scale", 1.0 + 0.25 * (i % 4) }
+        };
+        ghoul::Dictionary transform = {
+            { "Translation", translation },
+            { "Rotation", rotation },
+            { "Scale", scale }
+        };
+        return openspace::SceneGraphNode::createFromDictionary({
+            { "Identifier", identifier },
+            { "Transform", transform }
+        });
+    }
+
+    // Adds the same tree of nodes to \p scene: 40 children of the root with 2 children
+    // each, and every fifth grandchild depends on a child of another branch
+    void populateScene(openspace::Scene& scene) {
+        using namespace openspace;
+
+        std::vector<SceneGraphNode*> nodes;
+        for (int i = 0; i < 40; ++i) {
+            std::unique_ptr<SceneGraphNode> child = createNode(
+                "Child" + std::to_string(i),
+                i
+            );
+            for (int j = 0; j < 2; ++j) {
+                child->attachChild(createNode(
+                    "Grandchild" + std::to_string(i) + "_" + std::to_string(j),
+                    100 + 2 * i + j
+                ));
+            }
+            nodes.push_back(child.get());
+            scene.attachNode(std::move(child));
+        }
+        for (int i = 0; i < 40; i += 5) {
+            SceneGraphNode* grandchild = nodes[i]->children().front();
+            grandchild->addDependency(*nodes[(i + 7) % 40]);
+        }
+        for (SceneGraphNode* node : scene.allSceneGraphNodes()) {
+            if (node != scene.root()) {
+                scene.initializeNode(node);
+            }
+        }
+    }
+
+    void updateScene(openspace::Scene& scene) {
+        scene.update({
+            { glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+            openspace::Time(0.0),
+            false
+        });
+    }
+
+    size_t updateLevel(const openspace::Scene& scene,
+                       const openspace::SceneGraphNode* node)
+    {
+        const std::vector<openspace::Scene::UpdateLevel>& levels = scene.updateLevels();
+        for (size_t i = 0; i < levels.size(); ++i) {
+            for (const std::vector<openspace::SceneGraphNode*>* nodes :
+                 { &levels[i].parallelNodes, &levels[i].serialNodes })
+            {
+                if (std::find(nodes->begin(), nodes->end(), node) != nodes->end()) {
+                    return i;
+                }
+            }
+        }
+        return levels.size();
+    }
+} // namespace
+
+TEST_F(SceneTest, GroupsNodesIntoUpdateLevels) {
+    using namespace openspace;
+
+    Scene scene(std::make_unique<SingleThreadedSceneInitializer>());
+
+    std::unique_ptr<SceneGraphNode> parent = createNode("Parent", 1);
+    std::unique_ptr<SceneGraphNode> child = createNode("Child", 2);
+    std::unique_ptr<SceneGraphNode> sibling = createNode("Sibling", 3);
+    std::unique_ptr<SceneGraphNode> dependent = createNode("Dependent", 4);
+    SceneGraphNode* parentRaw = parent.get();
+    SceneGraphNode* childRaw = child.get();
+    SceneGraphNode* siblingRaw = sibling.get();
+    SceneGraphNode* dependentRaw = dependent.get();
+
+    parent->attachChild(std::move(child));
+    dependent->addDependency(*childRaw);
+    scene.attachNode(std::move(parent));
+    scene.attachNode(std::move(sibling));
+    scene.attachNode(std::move(dependent));
+    updateScene(scene);
+
+    const size_t rootLevel = updateLevel(scene, scene.root());
+    ASSERT_LT(rootLevel, scene.updateLevels().size());
+    // Children of the root are one level below it, regardless of their order
+    EXPECT_EQ(updateLevel(scene, parentRaw), rootLevel + 1);
+    EXPECT_EQ(updateLevel(scene, siblingRaw), rootLevel + 1);
+    EXPECT_EQ(updateLevel(scene, childRaw), rootLevel + 2);
+    // The dependency on the grandchild pushes the node below it
+    EXPECT_EQ(updateLevel(scene, dependentRaw), rootLevel + 3);
+    EXPECT_EQ(scene.updateLevels().size(), rootLevel + 4);
+
+    // Static transforms can be updated in parallel
+    for (const SceneGraphNode* node : { parentRaw, childRaw, siblingRaw, dependentRaw }) {
+        const std::vector<SceneGraphNode*>& parallel =
+            scene.updateLevels()[updateLevel(scene, node)].parallelNodes;
+        EXPECT_NE(std::find(parallel.begin(), parallel.end(), node), parallel.end());
+    }
+
+    // Removing the dependency moves the node back up to its siblings
+    dependentRaw->removeDependency(*childRaw);
+    updateScene(scene);
+    EXPECT_EQ(updateLevel(scene, dependentRaw), rootLevel + 1);
+}
+
+TEST_F(SceneTest, ParallelUpdateMatchesSerial) {
+    using namespace openspace;
+
+    Scene serialScene(std::make_unique<SingleThreadedSceneInitializer>());
+    Scene parallelScene(std::make_unique<SingleThreadedSceneInitializer>(), 4);
+    populateScene(serialScene);
+    populateScene(parallelScene);
+
+    for (int i = 0; i < 2; ++i) {
+        updateScene(serialScene);
+        updateScene(parallelScene);
+    }
+
+    // The second level of children is large enough to be updated in parallel
+    size_t maxLevelSize = 0;
+    for (const Scene::UpdateLevel& level : parallelScene.updateLevels()) {
+        maxLevelSize = std::max(maxLevelSize, level.parallelNodes.size());
+    }
+    EXPECT_GE(maxLevelSize, 32u);
+
+    const std::vector<SceneGraphNode*>& serialNodes = serialScene.allSceneGraphNodes();
+    ASSERT_EQ(serialNodes.size(), parallelScene.allSceneGraphNodes().size());
+    for (const SceneGraphNode* serial : serialNodes) {
+        const SceneGraphNode* parallel = parallelScene.sceneGraphNode(
+            serial->identifier()
+        );
+        ASSERT_NE(parallel, nullptr);
+        EXPECT_EQ(serial->worldPosition(), parallel->worldPosition());
+        EXPECT_EQ(serial->worldRotationMatrix(), parallel->worldRotationMatrix());
+        EXPECT_EQ(serial->worldScale(), parallel->worldScale());
+    }
+}
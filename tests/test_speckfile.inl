@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/digitaluniverse/speckfile.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+    openspace::speck::Dataset createDataset() {
+        using namespace openspace::speck;
+
+        Dataset dataset;
+        dataset.variables = { { 3, "lum" }, { 4, "absmag" } };
+        dataset.textures = { { 1, "star.png" }, { 2, "galaxy.png" } };
+        dataset.textureVariableIndex = 4;
+        dataset.valuesPerEntry = 5;
+        dataset.entries = { 1.f, 2.f, 3.f, 0.5f, 1.f, -1.f, -2.f, -3.f, 0.25f, 2.f };
+        dataset.labelPositions = { glm::vec3(1.f, 2.f, 3.f), glm::vec3(4.f, 5.f, 6.f) };
+        dataset.labelTexts = { "Sirius", "Alpha Centauri" };
+        dataset.colorMap = {
+            glm::vec4(1.f, 0.f, 0.f, 1.f),
+            glm::vec4(0.f, 1.f, 0.f, 0.5f)
+        };
+
+        Dataset::Mesh mesh;
+        mesh.textureIndex = 1;
+        mesh.colorIndex = 2;
+        mesh.style = Dataset::Mesh::Style::Solid;
+        mesh.numU = 2;
+        mesh.numV = 1;
+        mesh.vertices = { 0.f, 0.f, 0.f, 1.f, 1.f, 1.f };
+        dataset.meshes.push_back(mesh);
+
+        return dataset;
+    }
+
+    void createEmptyFile(const std::string& path) {
+        std::ofstream file(path, std::ofstream::trunc);
+    }
+} // namespace
+
+class SpeckFileTest : public testing::Test {};
+
+TEST_F(SpeckFileTest, BinaryWriteReadBack) {
+    using namespace openspace::speck;
+
+    const std::string path = absPath("${TEMPORARY}/speckfiletest.osspeck");
+    const Dataset dataset = createDataset();
+    ASSERT_TRUE(saveBinaryFile(dataset, path));
+
+    Dataset result;
+    ASSERT_TRUE(loadBinaryFile(path, result));
+
+    ASSERT_EQ(dataset.variables.size(), result.variables.size());
+    for (size_t i = 0; i < dataset.variables.size(); ++i) {
+        EXPECT_EQ(dataset.variables[i].index, result.variables[i].index);
+        EXPECT_EQ(dataset.variables[i].name, result.variables[i].name);
+    }
+    ASSERT_EQ(dataset.textures.size(), result.textures.size());
+    for (size_t i = 0; i < dataset.textures.size(); ++i) {
+        EXPECT_EQ(dataset.textures[i].index, result.textures[i].index);
+        EXPECT_EQ(dataset.textures[i].file, result.textures[i].file);
+    }
+    EXPECT_EQ(dataset.textureVariableIndex, result.textureVariableIndex);
+    EXPECT_EQ(dataset.orientationVariableIndex, result.orientationVariableIndex);
+    EXPECT_EQ(dataset.valuesPerEntry, result.valuesPerEntry);
+    EXPECT_EQ(dataset.entries, result.entries);
+    EXPECT_EQ(dataset.labelPositions, result.labelPositions);
+    EXPECT_EQ(dataset.labelTexts, result.labelTexts);
+    EXPECT_EQ(dataset.colorMap, result.colorMap);
+
+    ASSERT_EQ(dataset.meshes.size(), result.meshes.size());
+    EXPECT_EQ(dataset.meshes[0].textureIndex, result.meshes[0].textureIndex);
+    EXPECT_EQ(dataset.meshes[0].colorIndex, result.meshes[0].colorIndex);
+    EXPECT_EQ(dataset.meshes[0].style, result.meshes[0].style);
+    EXPECT_EQ(dataset.meshes[0].numU, result.meshes[0].numU);
+    EXPECT_EQ(dataset.meshes[0].numV, result.meshes[0].numV);
+    EXPECT_EQ(dataset.meshes[0].vertices, result.meshes[0].vertices);
+
+    // The binary file is detected by its content, not by its extension
+    Dataset loaded;
+    ASSERT_TRUE(loadFile(path, loaded));
+    EXPECT_EQ(dataset.entries, loaded.entries);
+
+    std::remove(path.c_str());
+}
+
+TEST_F(SpeckFileTest, EmptyDatasetWriteReadBack) {
+    using namespace openspace::speck;
+
+    const std::string path = absPath("${TEMPORARY}/speckfiletest-empty.osspeck");
+    ASSERT_TRUE(saveBinaryFile(Dataset(), path));
+
+    Dataset result;
+    ASSERT_TRUE(loadBinaryFile(path, result));
+    EXPECT_TRUE(result.variables.empty());
+    EXPECT_TRUE(result.textures.empty());
+    EXPECT_EQ(0, result.valuesPerEntry);
+    EXPECT_TRUE(result.entries.empty());
+    EXPECT_TRUE(result.labelTexts.empty());
+    EXPECT_TRUE(result.colorMap.empty());
+    EXPECT_TRUE(result.meshes.empty());
+
+    std::remove(path.c_str());
+}
+
+TEST_F(SpeckFileTest, TruncatedBinaryFile) {
+    using namespace openspace::speck;
+
+    const std::string path = absPath("${TEMPORARY}/speckfiletest-truncated.osspeck");
+    ASSERT_TRUE(saveBinaryFile(createDataset(), path));
+
+    std::string content;
+    {
+        std::ifstream file(path, std::ifstream::binary);
+        content.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    {
+        std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+        file.write(content.data(), content.size() / 2);
+    }
+
+    Dataset result;
+    EXPECT_FALSE(loadBinaryFile(path, result));
+
+    std::remove(path.c_str());
+}
+
+TEST_F(SpeckFileTest, EmptyTextFile) {
+    using namespace openspace::speck;
+
+    const std::string speck = absPath("${TEMPORARY}/speckfiletest-empty.speck");
+    createEmptyFile(speck);
+
+    Dataset speckDataset;
+    ASSERT_TRUE(loadFile(speck, speckDataset));
+    EXPECT_EQ(3, speckDataset.valuesPerEntry);
+    EXPECT_TRUE(speckDataset.entries.empty());
+
+    // The second load uses the binary file in the cache
+    Dataset cachedDataset;
+    ASSERT_TRUE(loadFile(speck, cachedDataset));
+    EXPECT_EQ(3, cachedDataset.valuesPerEntry);
+    EXPECT_TRUE(cachedDataset.entries.empty());
+
+    const std::string label = absPath("${TEMPORARY}/speckfiletest-empty.label");
+    createEmptyFile(label);
+
+    Dataset labelDataset;
+    ASSERT_TRUE(loadFile(label, labelDataset));
+    EXPECT_TRUE(labelDataset.labelTexts.empty());
+
+    // An empty file is not a binary file
+    Dataset binaryDataset;
+    EXPECT_FALSE(loadBinaryFile(speck, binaryDataset));
+
+    std::remove(speck.c_str());
+    std::remove(label.c_str());
+}
+
+TEST_F(SpeckFileTest, MissingFile) {
+    openspace::speck::Dataset dataset;
+    EXPECT_FALSE(openspace::speck::loadFile(
+        absPath("${TEMPORARY}/speckfiletest-missing.speck"),
+        dataset
+    ));
+}
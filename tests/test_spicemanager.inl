@@ -25,6 +25,7 @@
 #include <openspace/util/spicemanager.h>
 
 #include <ghoul/filesystem/filesystem.h>
+#include <thread>
 
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
@@ -325,6 +326,34 @@ TEST_F(SpiceManagerTest, getTargetPosition) {
     EXPECT_DOUBLE_EQ(pos[2], targetPosition[2]) << "Position not found or differs from expected return";
 }
 
+// Try getting positional vectors of target for multiple times at once
+TEST_F(SpiceManagerTest, getTargetPositions) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+    const std::vector<double> times = { et, et + 60.0, et + 3600.0 };
+
+    SpiceManager::AberrationCorrection corr = {
+        SpiceManager::AberrationCorrection::Type::LightTimeStellar,
+        SpiceManager::AberrationCorrection::Direction::Reception
+    };
+
+    std::vector<glm::dvec3> positions;
+    ASSERT_NO_THROW(positions = SpiceManager::ref().targetPositions(
+        "EARTH", "CASSINI", "J2000", corr, times)
+    );
+    ASSERT_EQ(times.size(), positions.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        const glm::dvec3 position = SpiceManager::ref().targetPosition(
+            "EARTH", "CASSINI", "J2000", corr, times[i]
+        );
+        EXPECT_DOUBLE_EQ(position[0], positions[i][0]) << "Positions differ at " << i;
+        EXPECT_DOUBLE_EQ(position[1], positions[i][1]) << "Positions differ at " << i;
+        EXPECT_DOUBLE_EQ(position[2], positions[i][2]) << "Positions differ at " << i;
+    }
+}
+
 // Try getting position & velocity vectors of target
 TEST_F(SpiceManagerTest, getTargetState) {
     using openspace::SpiceManager;
@@ -475,3 +504,214 @@ TEST_F(SpiceManagerTest, getFieldOfView) {
         }
     }
 }
+
+// Try converting right ascension and declination to rectangular coordinates
+TEST_F(SpiceManagerTest, rectangularFromRaDec) {
+    using openspace::SpiceManager;
+
+    double reference[3];
+    radrec_c(2.0, 1.2, -0.4, reference);
+
+    const glm::dvec3 rectangular = SpiceManager::ref().rectangularFromRaDec(
+        2.0,
+        1.2,
+        -0.4
+    );
+    EXPECT_DOUBLE_EQ(reference[0], rectangular.x);
+    EXPECT_DOUBLE_EQ(reference[1], rectangular.y);
+    EXPECT_DOUBLE_EQ(reference[2], rectangular.z);
+}
+
+// The cache tests change the loaded kernels behind the back of the SpiceManager. A
+// position that comes from the cache is still returned afterwards, while a position that
+// is computed again fails
+namespace spicemanager_constants {
+    // Expanded with absPath when used, as the FileSystem does not exist yet when the
+    // constants are initialized
+    const std::string CassiniSpk =
+        "${TESTDIR}/SpiceTest/spicekernels/030201AP_SK_SM546_T45.bsp";
+
+    const openspace::SpiceManager::AberrationCorrection LightTimeStellar = {
+        openspace::SpiceManager::AberrationCorrection::Type::LightTimeStellar,
+        openspace::SpiceManager::AberrationCorrection::Direction::Reception
+    };
+} // namespace spicemanager_constants
+
+glm::dvec3 earthFromCassini(double et) {
+    return openspace::SpiceManager::ref().targetPosition(
+        "EARTH", "CASSINI", "J2000", spicemanager_constants::LightTimeStellar, et
+    );
+}
+
+// Repeated queries are answered from the cache
+TEST_F(SpiceManagerTest, cachedTargetPosition) {
+    loadMetaKernel();
+    const double et = openspace::SpiceManager::ref().ephemerisTimeFromDate(
+        "2004 jun 11 19:32:00"
+    );
+
+    glm::dvec3 position;
+    ASSERT_NO_THROW(position = earthFromCassini(et));
+
+    unload_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    glm::dvec3 cached;
+    ASSERT_NO_THROW(cached = earthFromCassini(et)) << "Position was not cached";
+    EXPECT_EQ(position, cached);
+
+    // Other times are not in the cache and need the unloaded kernel
+    EXPECT_THROW(earthFromCassini(et + 1.0), openspace::SpiceManager::SpiceException);
+}
+
+// Loading a kernel discards the cached results
+TEST_F(SpiceManagerTest, loadKernelClearsCache) {
+    using openspace::SpiceManager;
+
+    // Everything but the planetary constants, which are loaded later on
+    SpiceManager::ref().loadKernel(LSK);
+    SpiceManager::ref().loadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/981005_PLTEPH-DE405S.bsp")
+    );
+    SpiceManager::ref().loadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/020514_SE_SAT105.bsp")
+    );
+    SpiceManager::ref().loadKernel(absPath(spicemanager_constants::CassiniSpk));
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    ASSERT_NO_THROW(earthFromCassini(et));
+    unload_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    ASSERT_NO_THROW(earthFromCassini(et)) << "Position was not cached";
+
+    SpiceManager::ref().loadKernel(PCK);
+    EXPECT_THROW(earthFromCassini(et), SpiceManager::SpiceException);
+}
+
+// Unloading a kernel discards the cached results
+TEST_F(SpiceManagerTest, unloadKernelClearsCache) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    ASSERT_NO_THROW(earthFromCassini(et));
+    SpiceManager::ref().unloadKernel(absPath(spicemanager_constants::CassiniSpk));
+    EXPECT_THROW(earthFromCassini(et), SpiceManager::SpiceException);
+}
+
+// Changing the exception handling discards the cached results
+TEST_F(SpiceManagerTest, setExceptionHandlingClearsCache) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    ASSERT_NO_THROW(earthFromCassini(et));
+    unload_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    ASSERT_NO_THROW(earthFromCassini(et)) << "Position was not cached";
+
+    SpiceManager::ref().setExceptionHandling(SpiceManager::UseException::Yes);
+    EXPECT_THROW(earthFromCassini(et), SpiceManager::SpiceException);
+}
+
+// Queries that fail are computed again the next time
+TEST_F(SpiceManagerTest, failedQueriesAreNotCached) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    double reference[3];
+    double lt;
+    spkpos_c("EARTH", et, "J2000", "LT+S", "CASSINI", reference, &lt);
+
+    unload_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    EXPECT_THROW(earthFromCassini(et), SpiceManager::SpiceException);
+
+    furnsh_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    glm::dvec3 position;
+    ASSERT_NO_THROW(position = earthFromCassini(et));
+    EXPECT_DOUBLE_EQ(reference[0], position.x);
+    EXPECT_DOUBLE_EQ(reference[1], position.y);
+    EXPECT_DOUBLE_EQ(reference[2], position.z);
+
+    // Without exceptions, the failed query returns a value that must not be kept either
+    spkpos_c("EARTH", et + 1.0, "J2000", "LT+S", "CASSINI", reference, &lt);
+    SpiceManager::ref().setExceptionHandling(SpiceManager::UseException::No);
+    unload_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    earthFromCassini(et + 1.0);
+    EXPECT_TRUE(failed_c() == SPICETRUE);
+    reset_c();
+
+    furnsh_c(absPath(spicemanager_constants::CassiniSpk).c_str());
+    position = earthFromCassini(et + 1.0);
+    EXPECT_FALSE(failed_c() == SPICETRUE);
+    EXPECT_DOUBLE_EQ(reference[0], position.x);
+    EXPECT_DOUBLE_EQ(reference[1], position.y);
+    EXPECT_DOUBLE_EQ(reference[2], position.z);
+    SpiceManager::ref().setExceptionHandling(SpiceManager::UseException::Yes);
+}
+
+// Queries from many threads at once return the same results as sequential queries
+TEST_F(SpiceManagerTest, concurrentQueries) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    constexpr const int nTimes = 64;
+    std::vector<glm::dvec3> referencePositions(nTimes);
+    std::vector<glm::dmat3> referenceTransforms(nTimes);
+    for (int i = 0; i < nTimes; ++i) {
+        double p[3];
+        double lt;
+        spkpos_c("EARTH", et + i * 60.0, "J2000", "LT+S", "CASSINI", p, &lt);
+        referencePositions[i] = glm::dvec3(p[0], p[1], p[2]);
+
+        double m[3][3];
+        pxform_c("IAU_EARTH", "J2000", et + i * 60.0, m);
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 3; ++k) {
+                referenceTransforms[i][k][j] = m[j][k];
+            }
+        }
+    }
+
+    // Every thread goes through all times in a different order, so that some of the
+    // queries are answered from the cache while others are computed concurrently
+    constexpr const int nThreads = 8;
+    std::vector<std::vector<glm::dvec3>> positions(nThreads);
+    std::vector<std::vector<glm::dmat3>> transforms(nThreads);
+    std::vector<int> nFailures(nThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            positions[t].resize(nTimes);
+            transforms[t].resize(nTimes);
+            for (int n = 0; n < nTimes; ++n) {
+                const int i = (n * 7 + t * 13) % nTimes;
+                try {
+                    positions[t][i] = earthFromCassini(et + i * 60.0);
+                    transforms[t][i] = SpiceManager::ref().positionTransformMatrix(
+                        "IAU_EARTH", "J2000", et + i * 60.0
+                    );
+                }
+                catch (const SpiceManager::SpiceException&) {
+                    ++nFailures[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < nThreads; ++t) {
+        EXPECT_EQ(nFailures[t], 0) << "Queries failed on thread " << t;
+        for (int i = 0; i < nTimes; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                EXPECT_DOUBLE_EQ(referencePositions[i][j], positions[t][i][j]);
+                for (int k = 0; k < 3; ++k) {
+                    EXPECT_DOUBLE_EQ(
+                        referenceTransforms[i][j][k],
+                        transforms[t][i][j][k]
+                    );
+                }
+            }
+        }
+    }
+}
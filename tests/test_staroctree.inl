@@ -0,0 +1,168 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/space/staroctree.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <random>
+
+class StarOctreeTest : public testing::Test {};
+
+namespace {
+    std::vector<float> createStars(size_t nStars) {
+        using namespace openspace::staroctree;
+
+        std::mt19937 random(1337);
+        std::normal_distribution<float> position(0.f, 100.f);
+        std::uniform_real_distribution<float> magnitude(-5.f, 15.f);
+
+        std::vector<float> stars(nStars * NValues);
+        for (size_t i = 0; i < nStars; ++i) {
+            float* star = stars.data() + i * NValues;
+            star[PositionX] = position(random);
+            star[PositionY] = position(random);
+            star[PositionZ] = position(random);
+            star[AbsoluteMagnitude] = magnitude(random);
+            // Makes every star identifiable after the octree has reordered them
+            star[Speed] = static_cast<float>(i);
+        }
+        return stars;
+    }
+} // namespace
+
+TEST_F(StarOctreeTest, BuildKeepsEveryStarOnce) {
+    using namespace openspace::staroctree;
+
+    const size_t nStars = 20000;
+    std::vector<float> stars = createStars(nStars);
+    const Octree octree = build(stars, 500);
+
+    ASSERT_EQ(stars.size(), nStars * NValues);
+    ASSERT_LE(octree.maxStarsPerNode, 500u);
+    ASSERT_GT(octree.nodes.size(), 1u);
+
+    std::vector<bool> found(nStars, false);
+    for (const Node& node : octree.nodes) {
+        for (uint32_t i = 0; i < node.nStars; ++i) {
+            const size_t star = static_cast<size_t>(node.firstStar) + i;
+            const size_t id = static_cast<size_t>(stars[star * NValues + Speed]);
+            ASSERT_FALSE(found[id]) << "Star " << id << " is stored more than once";
+            found[id] = true;
+        }
+    }
+    EXPECT_TRUE(std::all_of(found.begin(), found.end(), [](bool b) { return b; }));
+}
+
+TEST_F(StarOctreeTest, ParentsContainBrighterStars) {
+    using namespace openspace::staroctree;
+
+    std::vector<float> stars = createStars(20000);
+    const Octree octree = build(stars, 500);
+
+    for (const Node& node : octree.nodes) {
+        float faintest = -std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < node.nStars; ++i) {
+            const size_t star = static_cast<size_t>(node.firstStar) + i;
+            faintest = std::max(faintest, stars[star * NValues + AbsoluteMagnitude]);
+        }
+
+        for (uint32_t child : node.children) {
+            if (child == 0) {
+                continue;
+            }
+            const Node& c = octree.nodes[child];
+            EXPECT_GE(c.brightestMagnitude, faintest);
+            EXPECT_FLOAT_EQ(c.halfSize, node.halfSize / 2.f);
+            for (uint32_t i = 0; i < c.nStars; ++i) {
+                const size_t star = static_cast<size_t>(c.firstStar) + i;
+                for (int axis = PositionX; axis <= PositionZ; ++axis) {
+                    EXPECT_LE(
+                        std::abs(stars[star * NValues + axis] - c.center[axis]),
+                        c.halfSize
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST_F(StarOctreeTest, SaveAndLoad) {
+    using namespace openspace::staroctree;
+
+    std::vector<float> stars = createStars(5000);
+    const Octree octree = build(stars, 256);
+
+    const std::string path = absPath("${TESTDIR}/stars.octree");
+    ASSERT_TRUE(saveFile(octree, stars, path));
+    ASSERT_TRUE(isOctreeFile(path));
+
+    Octree loaded;
+    ASSERT_TRUE(loadStructure(path, loaded));
+    ASSERT_EQ(loaded.nodes.size(), octree.nodes.size());
+    EXPECT_EQ(loaded.maxStarsPerNode, octree.maxStarsPerNode);
+
+    std::ifstream file(path, std::ifstream::binary);
+    for (size_t i = 0; i < loaded.nodes.size(); ++i) {
+        const Node& node = loaded.nodes[i];
+        EXPECT_EQ(node.nStars, octree.nodes[i].nStars);
+        EXPECT_EQ(node.children, octree.nodes[i].children);
+
+        std::vector<float> values;
+        ASSERT_TRUE(readStars(file, loaded, node, values));
+        ASSERT_EQ(values.size(), static_cast<size_t>(node.nStars) * NValues);
+        EXPECT_TRUE(std::equal(
+            values.begin(),
+            values.end(),
+            stars.begin() + node.firstStar * NValues
+        ));
+    }
+}
+
+TEST_F(StarOctreeTest, RejectTruncatedFile) {
+    using namespace openspace::staroctree;
+
+    std::vector<float> stars = createStars(5000);
+    const Octree octree = build(stars, 256);
+
+    const std::string path = absPath("${TESTDIR}/truncatedstars.octree");
+    ASSERT_TRUE(saveFile(octree, stars, path));
+
+    std::vector<char> contents;
+    {
+        std::ifstream file(path, std::ifstream::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    {
+        std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+        file.write(contents.data(), contents.size() / 2);
+    }
+
+    Octree loaded;
+    EXPECT_FALSE(loadStructure(path, loaded));
+}
@@ -0,0 +1,239 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/syncbuffer.h>
+#include <openspace/util/syncdata.h>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class SyncBufferTest : public testing::Test {};
+
+namespace {
+    // Encodes enough repetitive data into the buffer for the frame to be compressed
+    std::vector<char> compressedFrame(openspace::SyncBuffer& buffer) {
+        buffer.setCompressionEnabled(true);
+        for (int i = 0; i < 256; ++i) {
+            buffer.encode(i % 4);
+        }
+        buffer.encode(std::string(512, 'a'));
+        buffer.packFrame();
+        return buffer.frame();
+    }
+
+    // Makes the synchronization methods, which are usually only called by the
+    // SyncEngine, accessible to the tests
+    template <typename T>
+    class TestSyncData : public openspace::SyncData<T> {
+    public:
+        using openspace::SyncData<T>::SyncData;
+        using openspace::SyncData<T>::operator=;
+        using openspace::SyncData<T>::encode;
+        using openspace::SyncData<T>::decode;
+        using openspace::SyncData<T>::postSync;
+    };
+
+    // Does not provide an operator==, so it is compared bytewise
+    struct SyncTestValue {
+        double value;
+        int counter;
+    };
+
+    // Transmits the value of the master to the slave in a single frame
+    template <typename T>
+    void synchronize(TestSyncData<T>& master, openspace::SyncBuffer& masterBuffer,
+                     TestSyncData<T>& slave, openspace::SyncBuffer& slaveBuffer)
+    {
+        master.encode(&masterBuffer);
+        masterBuffer.packFrame();
+        ASSERT_TRUE(slaveBuffer.unpackFrame(masterBuffer.frame()));
+        slave.decode(&slaveBuffer);
+        slave.postSync(false);
+    }
+} // namespace
+
+TEST_F(SyncBufferTest, UnpacksCompressedFrame) {
+    openspace::SyncBuffer master(64);
+    const std::vector<char> frame = compressedFrame(master);
+    ASSERT_LT(frame.size(), master.payloadSize()) << "Frame was not compressed";
+
+    openspace::SyncBuffer slave(64);
+    ASSERT_TRUE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), master.payloadSize());
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(slave.decode<int>(), i % 4);
+    }
+    EXPECT_EQ(slave.decode(), std::string(512, 'a'));
+}
+
+TEST_F(SyncBufferTest, RejectsEmptyFrame) {
+    openspace::SyncBuffer slave(64);
+    EXPECT_FALSE(slave.unpackFrame({}));
+    EXPECT_EQ(slave.payloadSize(), 0u);
+}
+
+TEST_F(SyncBufferTest, RejectsTruncatedFrame) {
+    openspace::SyncBuffer master(64);
+    std::vector<char> frame = compressedFrame(master);
+    frame.resize(frame.size() / 2);
+
+    openspace::SyncBuffer slave(64);
+    EXPECT_FALSE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), 0u);
+
+    // Only the flags and part of the payload size are left
+    frame.resize(3);
+    EXPECT_FALSE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), 0u);
+}
+
+TEST_F(SyncBufferTest, RejectsCorruptPayloadSize) {
+    openspace::SyncBuffer master(64);
+    std::vector<char> frame = compressedFrame(master);
+
+    openspace::SyncBuffer slave(64);
+
+    // A size that does not match the compressed data
+    uint32_t size = static_cast<uint32_t>(master.payloadSize() + 1);
+    std::memcpy(frame.data() + 1, &size, sizeof(uint32_t));
+    EXPECT_FALSE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), 0u);
+
+    // A size that LZ4 could never have produced from this frame
+    size = 0xFFFFFFFF;
+    std::memcpy(frame.data() + 1, &size, sizeof(uint32_t));
+    EXPECT_FALSE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), 0u);
+}
+
+TEST_F(SyncBufferTest, AcceptsValidFrameAfterCorruptFrame) {
+    openspace::SyncBuffer master(64);
+    const std::vector<char> frame = compressedFrame(master);
+    std::vector<char> truncated = frame;
+    truncated.resize(truncated.size() / 2);
+
+    openspace::SyncBuffer slave(64);
+    EXPECT_FALSE(slave.unpackFrame(truncated));
+    ASSERT_TRUE(slave.unpackFrame(frame));
+    EXPECT_EQ(slave.payloadSize(), master.payloadSize());
+    EXPECT_EQ(slave.decode<int>(), 0);
+}
+
+TEST_F(SyncBufferTest, UnchangedSyncDataEncodesNothing) {
+    openspace::SyncBuffer buffer(64);
+    buffer.setOnlyEncodeChanges(true);
+
+    TestSyncData<double> number(1.0);
+    number.encode(&buffer);
+    EXPECT_EQ(buffer.currentOffset(), sizeof(bool) + sizeof(double));
+    buffer.packFrame();
+
+    // Only the flag stating that the value has not changed is left
+    number.encode(&buffer);
+    EXPECT_EQ(buffer.currentOffset(), sizeof(bool));
+    buffer.packFrame();
+
+    TestSyncData<SyncTestValue> value(SyncTestValue{ 2.0, 3 });
+    value.encode(&buffer);
+    EXPECT_EQ(buffer.currentOffset(), sizeof(bool) + sizeof(SyncTestValue));
+    buffer.packFrame();
+
+    value.encode(&buffer);
+    EXPECT_EQ(buffer.currentOffset(), sizeof(bool));
+    buffer.packFrame();
+
+    TestSyncData<std::string> text(std::string("OpenSpace"));
+    text.encode(&buffer);
+    buffer.packFrame();
+
+    // The heap allocated characters have to be compared, not the string object itself
+    text = std::string("OpenSpace");
+    text.encode(&buffer);
+    EXPECT_EQ(buffer.currentOffset(), sizeof(bool));
+}
+
+TEST_F(SyncBufferTest, ChangedSyncDataRoundTrips) {
+    openspace::SyncBuffer masterBuffer(64);
+    masterBuffer.setOnlyEncodeChanges(true);
+    openspace::SyncBuffer slaveBuffer(64);
+
+    TestSyncData<SyncTestValue> master(SyncTestValue{ 1.0, 1 });
+    TestSyncData<SyncTestValue> slave(SyncTestValue{ 0.0, 0 });
+
+    synchronize(master, masterBuffer, slave, slaveBuffer);
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).value, 1.0);
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).counter, 1);
+
+    master = SyncTestValue{ 1.0, 2 };
+    synchronize(master, masterBuffer, slave, slaveBuffer);
+    EXPECT_EQ(slaveBuffer.payloadSize(), sizeof(bool) + sizeof(SyncTestValue));
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).value, 1.0);
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).counter, 2);
+
+    // A frame without the value keeps the last value that was received
+    synchronize(master, masterBuffer, slave, slaveBuffer);
+    EXPECT_EQ(slaveBuffer.payloadSize(), sizeof(bool));
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).value, 1.0);
+    EXPECT_EQ(static_cast<SyncTestValue&>(slave).counter, 2);
+
+    TestSyncData<std::string> masterText(std::string("Earth"));
+    TestSyncData<std::string> slaveText;
+    synchronize(masterText, masterBuffer, slaveText, slaveBuffer);
+    EXPECT_EQ(static_cast<std::string&>(slaveText), "Earth");
+
+    masterText = std::string("Mars");
+    synchronize(masterText, masterBuffer, slaveText, slaveBuffer);
+    EXPECT_EQ(static_cast<std::string&>(slaveText), "Mars");
+}
+
+TEST_F(SyncBufferTest, CompressedSyncDataRoundTrips) {
+    using Values = std::array<int, 128>;
+
+    openspace::SyncBuffer masterBuffer(64);
+    masterBuffer.setOnlyEncodeChanges(true);
+    masterBuffer.setCompressionEnabled(true);
+    openspace::SyncBuffer slaveBuffer(64);
+
+    Values values;
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i % 4);
+    }
+    TestSyncData<Values> master(values);
+    TestSyncData<Values> slave;
+
+    synchronize(master, masterBuffer, slave, slaveBuffer);
+    ASSERT_LT(masterBuffer.transmittedSize(), masterBuffer.payloadSize())
+        << "Frame was not compressed";
+    EXPECT_EQ(slaveBuffer.payloadSize(), sizeof(bool) + sizeof(Values));
+    EXPECT_EQ(static_cast<Values&>(slave), values);
+
+    values[17] = 42;
+    master = values;
+    synchronize(master, masterBuffer, slave, slaveBuffer);
+    EXPECT_EQ(static_cast<Values&>(slave), values);
+}
@@ -0,0 +1,149 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/performance/tracer.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+    std::string exportTrace(const std::string& filename) {
+        const std::string path = absPath("${TEMPORARY}/" + filename);
+        EXPECT_TRUE(openspace::performance::Tracer::writeChromeTrace(path));
+
+        std::stringstream buffer;
+        {
+            std::ifstream file(path);
+            buffer << file.rdbuf();
+        }
+        std::remove(path.c_str());
+        return buffer.str();
+    }
+
+    size_t countOccurrences(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t p = text.find(pattern); p != std::string::npos;
+             p = text.find(pattern, p + pattern.size()))
+        {
+            ++count;
+        }
+        return count;
+    }
+} // namespace
+
+class TracerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        openspace::performance::Tracer::clear();
+    }
+
+    void TearDown() override {
+        openspace::performance::Tracer::setEnabled(false);
+        openspace::performance::Tracer::clear();
+    }
+};
+
+TEST_F(TracerTest, DisabledTracerRecordsNothing) {
+    using namespace openspace::performance;
+
+    Tracer::setEnabled(false);
+    {
+        TraceZone("TracerTest::disabled");
+    }
+
+    const std::string trace = exportTrace("tracertest_disabled.json");
+    EXPECT_EQ(0, countOccurrences(trace, "TracerTest::disabled"));
+}
+
+TEST_F(TracerTest, ExportsNestedZonesWithThreadNames) {
+    using namespace openspace::performance;
+
+    Tracer::setEnabled(true);
+    std::thread worker([]() {
+        Tracer::setThreadName("TracerTest \"Worker\"");
+        TraceZone("TracerTest::outer");
+        {
+            TraceZone("TracerTest::inner");
+        }
+        {
+            TraceZone("TracerTest::inner");
+        }
+    });
+    worker.join();
+
+    const std::string trace = exportTrace("tracertest_nested.json");
+    EXPECT_EQ(1, countOccurrences(trace, R"("name":"TracerTest::outer","ph":"X")"));
+    EXPECT_EQ(2, countOccurrences(trace, R"("name":"TracerTest::inner","ph":"X")"));
+    EXPECT_EQ(1, countOccurrences(trace, R"("args":{"name":"TracerTest \"Worker\""})"));
+
+    // The parent has to be written before its children so that it starts first
+    EXPECT_LT(trace.find("TracerTest::outer"), trace.find("TracerTest::inner"));
+}
+
+TEST_F(TracerTest, KeepsMostRecentZones) {
+    using namespace openspace::performance;
+
+    Tracer::setEnabled(true);
+    std::thread worker([]() {
+        for (uint64_t i = 0; i < Tracer::BufferSize; ++i) {
+            TraceZone("TracerTest::old");
+        }
+        for (uint64_t i = 0; i < Tracer::BufferSize / 2; ++i) {
+            TraceZone("TracerTest::new");
+        }
+    });
+    worker.join();
+
+    const std::string trace = exportTrace("tracertest_overflow.json");
+    EXPECT_EQ(Tracer::BufferSize / 2, countOccurrences(trace, "TracerTest::old"));
+    EXPECT_EQ(Tracer::BufferSize / 2, countOccurrences(trace, "TracerTest::new"));
+}
+
+TEST_F(TracerTest, ReusesBuffersOfExitedThreads) {
+    using namespace openspace::performance;
+
+    Tracer::setEnabled(true);
+    std::thread first([]() {
+        TraceZone("TracerTest::first");
+    });
+    first.join();
+
+    // The zones of an exited thread are kept until its buffer is reused
+    std::string trace = exportTrace("tracertest_exited.json");
+    EXPECT_EQ(1, countOccurrences(trace, "TracerTest::first"));
+
+    std::thread second([]() {
+        TraceZone("TracerTest::second");
+    });
+    second.join();
+
+    trace = exportTrace("tracertest_reused.json");
+    EXPECT_EQ(0, countOccurrences(trace, "TracerTest::first"));
+    EXPECT_EQ(1, countOccurrences(trace, "TracerTest::second"));
+}
@@ -0,0 +1,190 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/multiresvolume/rendering/errorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/tsp.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+    // The number of nodes in the octree of every BST node of a TSP with nBricks^3 bricks
+    unsigned int numOctreeNodes(unsigned int nBricks) {
+        // The octree has one level per halving of nBricks
+        unsigned int nOctreeNodes = 0;
+        for (unsigned int n = nBricks, nNodes = 1; n >= 1; n /= 2, nNodes *= 8) {
+            nOctreeNodes += nNodes;
+        }
+        return nOctreeNodes;
+    }
+
+    // Writes a TSP file with nTimesteps timesteps and nBricks^3 bricks of brickDim^3
+    // voxels each. Every voxel of the brick with the index i has the value brickValue(i)
+    // or, if no function is provided, a random value
+    std::string writeTsp(const std::string& filename, unsigned int nTimesteps,
+                         unsigned int brickDim, unsigned int nBricks,
+                         std::function<float(unsigned int)> brickValue = nullptr)
+    {
+        const std::string path = absPath("${TESTDIR}/" + filename);
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+
+        const openspace::TSP::Header header = {
+            0,
+            nTimesteps,
+            nTimesteps,
+            brickDim, brickDim, brickDim,
+            nBricks, nBricks, nBricks
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const size_t paddedDim = brickDim + 2;
+        const size_t nBrickValues = paddedDim * paddedDim * paddedDim;
+        const size_t nValues = static_cast<size_t>(numOctreeNodes(nBricks)) *
+                               (2 * nTimesteps - 1) * nBrickValues;
+
+        std::mt19937 random(1337);
+        std::uniform_real_distribution<float> distribution(0.f, 1.f);
+        std::vector<float> values(nValues);
+        for (size_t i = 0; i < nValues; ++i) {
+            values[i] = brickValue ?
+                brickValue(static_cast<unsigned int>(i / nBrickValues)) :
+                distribution(random);
+        }
+        file.write(
+            reinterpret_cast<const char*>(values.data()),
+            values.size() * sizeof(float)
+        );
+        return path;
+    }
+
+    struct TspResult {
+        std::vector<float> spatialErrors;
+        std::vector<float> temporalErrors;
+        std::vector<unsigned int> octreeChildren;
+        std::vector<std::vector<float>> histograms;
+    };
+
+    TspResult computeTsp(const std::string& path, unsigned int nThreads) {
+        openspace::TSP tsp(path);
+        tsp.setNumThreads(nThreads);
+        EXPECT_TRUE(tsp.readHeader());
+        EXPECT_TRUE(tsp.construct());
+        EXPECT_TRUE(tsp.calculateSpatialError());
+        EXPECT_TRUE(tsp.calculateTemporalError());
+
+        TspResult result;
+        for (unsigned int i = 0; i < tsp.numTotalNodes(); ++i) {
+            result.spatialErrors.push_back(tsp.getSpatialError(i));
+            result.temporalErrors.push_back(tsp.getTemporalError(i));
+            result.octreeChildren.push_back(tsp.getFirstOctreeChild(i));
+        }
+
+        openspace::ErrorHistogramManager histograms(&tsp);
+        EXPECT_TRUE(histograms.buildHistograms(50));
+        for (unsigned int i = 0; i < tsp.numTotalNodes(); ++i) {
+            const openspace::Histogram* histogram = histograms.getHistogram(i);
+            if (histogram) {
+                result.histograms.emplace_back(
+                    histogram->data(),
+                    histogram->data() + histogram->numBins()
+                );
+            }
+        }
+        return result;
+    }
+} // namespace
+
+class TspTest : public testing::Test {};
+
+TEST_F(TspTest, ParallelMatchesSerial) {
+    const std::string path = writeTsp("tsptest.tsp", 8, 4, 4);
+
+    const TspResult serial = computeTsp(path, 1);
+    const TspResult parallel = computeTsp(path, 4);
+
+    ASSERT_FALSE(serial.spatialErrors.empty());
+    ASSERT_FALSE(serial.histograms.empty());
+
+    // The threads accumulate in the same order as a single thread does, so the results
+    // have to be identical and not just close
+    EXPECT_EQ(serial.spatialErrors, parallel.spatialErrors);
+    EXPECT_EQ(serial.temporalErrors, parallel.temporalErrors);
+    EXPECT_EQ(serial.octreeChildren, parallel.octreeChildren);
+    EXPECT_EQ(serial.histograms, parallel.histograms);
+
+    std::remove(path.c_str());
+}
+
+TEST_F(TspTest, ErrorsOfSmallTree) {
+    // Two timesteps and 2x2x2 bricks result in a BST with a root and two leaves, each
+    // containing an octree with a root and eight leaves. The bricks are stored BST node
+    // by BST node, so brick b is the octree node b % 9 of the BST node b / 9
+    const unsigned int nOctreeNodes = numOctreeNodes(2);
+    ASSERT_EQ(nOctreeNodes, 9u);
+
+    // Each BST leaf scales the octree node index by its own factor and the BST root is
+    // the average of both leaves
+    const float scales[] = { 1.5f, 1.f, 2.f };
+    auto brickValue = [&](unsigned int brick) {
+        return scales[brick / nOctreeNodes] * (brick % nOctreeNodes) + 1.f;
+    };
+    const std::string path = writeTsp("tsptest-small.tsp", 2, 2, 2, brickValue);
+    const TspResult result = computeTsp(path, 2);
+    ASSERT_EQ(result.spatialErrors.size(), 3 * nOctreeNodes);
+
+    for (unsigned int bstNode = 0; bstNode < 3; ++bstNode) {
+        // An octree root has the value 1, while its leaf k has the value scale * k + 1.
+        // The error is the square root of the standard deviation of the leaves from 1
+        double sumSquares = 0.0;
+        for (int k = 1; k <= 8; ++k) {
+            sumSquares += std::pow(scales[bstNode] * k, 2.0);
+        }
+        const double expected = std::sqrt(std::sqrt(sumSquares / 8.0));
+        EXPECT_NEAR(result.spatialErrors[bstNode * nOctreeNodes], expected, 1e-5);
+
+        for (unsigned int k = 1; k < nOctreeNodes; ++k) {
+            EXPECT_EQ(result.spatialErrors[bstNode * nOctreeNodes + k], -0.1f);
+        }
+    }
+
+    for (unsigned int k = 0; k < nOctreeNodes; ++k) {
+        // Both leaves differ by k / 2 from the root, so the standard deviation over time
+        // is k / 2, of which the error is the fourth root
+        const double expected = std::pow(0.5 * k, 0.25);
+        EXPECT_NEAR(result.temporalErrors[k], expected, 1e-5) << k;
+
+        // BST leaves do not have a temporal error
+        EXPECT_EQ(result.temporalErrors[nOctreeNodes + k], -0.1f);
+        EXPECT_EQ(result.temporalErrors[2 * nOctreeNodes + k], -0.1f);
+    }
+
+    std::remove(path.c_str());
+}
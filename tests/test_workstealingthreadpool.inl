@@ -0,0 +1,326 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/other/prioritizingconcurrentjobmanager.h>
+#include <modules/globebrowsing/other/workstealingthreadpool.h>
+#include <openspace/util/job.h>
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Records the order in which tasks are executed. It has to outlive the thread pool
+    class ExecutionRecorder {
+    public:
+        void record(int id) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _ids.push_back(id);
+                _threads.push_back(std::this_thread::get_id());
+            }
+            _condition.notify_all();
+        }
+
+        std::vector<int> waitFor(size_t n) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [&]() { return _ids.size() >= n; });
+            return _ids;
+        }
+
+        std::vector<std::thread::id> threads() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _threads;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::vector<int> _ids;
+        std::vector<std::thread::id> _threads;
+    };
+
+    // Occupies one worker of the pool until it is released, so that the tasks that are
+    // enqueued in the meantime stay queued
+    class WorkerBlocker {
+    public:
+        WorkerBlocker(openspace::globebrowsing::WorkStealingThreadPool& pool) {
+            std::shared_future<void> release = _release.get_future().share();
+            pool.enqueue(
+                [this, release]() {
+                    _threadId = std::this_thread::get_id();
+                    _started.set_value();
+                    release.wait();
+                },
+                std::numeric_limits<float>::max()
+            );
+            _started.get_future().wait();
+        }
+
+        ~WorkerBlocker() {
+            release();
+        }
+
+        void release() {
+            if (!_isReleased) {
+                _isReleased = true;
+                _release.set_value();
+            }
+        }
+
+        std::thread::id threadId() const {
+            return _threadId;
+        }
+
+    private:
+        std::promise<void> _started;
+        std::promise<void> _release;
+        std::thread::id _threadId;
+        bool _isReleased = false;
+    };
+
+    struct KeyRecordingJob : public openspace::Job<int> {
+        KeyRecordingJob(int k, ExecutionRecorder& r) : key(k), recorder(r) {}
+
+        void execute() override {
+            recorder.record(key);
+        }
+
+        std::shared_ptr<int> product() override {
+            return std::make_shared<int>(key);
+        }
+
+        int key;
+        ExecutionRecorder& recorder;
+    };
+
+    using TestJobManager =
+        openspace::globebrowsing::PrioritizingConcurrentJobManager<int, int>;
+} // namespace
+
+class WorkStealingThreadPoolTest : public testing::Test {};
+
+TEST_F(WorkStealingThreadPoolTest, ExecutesMostUrgentTaskFirst) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    WorkStealingThreadPool pool(1);
+    {
+        WorkerBlocker blocker(pool);
+        pool.enqueue([&]() { recorder.record(0); }, 1.f);
+        pool.enqueue([&]() { recorder.record(1); }, 3.f);
+        pool.enqueue([&]() { recorder.record(2); }, 2.f);
+        pool.enqueue([&]() { recorder.record(3); }, 3.f);
+    }
+
+    // Among tasks with the same priority, the latest one is executed first
+    EXPECT_EQ(std::vector<int>({ 3, 1, 2, 0 }), recorder.waitFor(4));
+}
+
+TEST_F(WorkStealingThreadPoolTest, SetPriorityReordersTasks) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    WorkStealingThreadPool pool(1);
+    {
+        WorkerBlocker blocker(pool);
+        std::vector<std::shared_ptr<WorkStealingThreadPool::Task>> tasks;
+        for (int i = 0; i < 4; ++i) {
+            tasks.push_back(pool.enqueue([&recorder, i]() { recorder.record(i); }, 0.f));
+        }
+        pool.setPriority(*tasks[0], 10.f);
+        // Updating a task with its current priority makes it the most recent one
+        pool.setPriority(*tasks[1], 0.f);
+    }
+
+    EXPECT_EQ(std::vector<int>({ 0, 1, 3, 2 }), recorder.waitFor(4));
+}
+
+TEST_F(WorkStealingThreadPoolTest, CancelledTasksAreNotExecuted) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    WorkStealingThreadPool pool(1);
+    std::vector<std::shared_ptr<WorkStealingThreadPool::Task>> tasks;
+    {
+        WorkerBlocker blocker(pool);
+        for (int i = 0; i < 4; ++i) {
+            const float priority = static_cast<float>(i);
+            tasks.push_back(
+                pool.enqueue([&recorder, i]() { recorder.record(i); }, priority)
+            );
+        }
+        EXPECT_TRUE(WorkStealingThreadPool::cancel(*tasks[1]));
+        EXPECT_TRUE(WorkStealingThreadPool::cancel(*tasks[3]));
+        // Cancelling a task twice has no further effect
+        EXPECT_FALSE(WorkStealingThreadPool::cancel(*tasks[3]));
+    }
+
+    // The sentinel has the lowest priority, so all other tasks are done before it
+    pool.enqueue([&]() { recorder.record(-1); }, -1.f);
+    EXPECT_EQ(std::vector<int>({ 2, 0, -1 }), recorder.waitFor(3));
+
+    // Tasks that have been started can not be cancelled anymore
+    EXPECT_FALSE(WorkStealingThreadPool::cancel(*tasks[0]));
+    EXPECT_EQ(WorkStealingThreadPool::TaskState::Running, tasks[0]->state);
+    EXPECT_EQ(WorkStealingThreadPool::TaskState::Cancelled, tasks[1]->state);
+}
+
+TEST_F(WorkStealingThreadPoolTest, IdleWorkersStealTasks) {
+    using namespace openspace::globebrowsing;
+    constexpr const int NTasks = 16;
+
+    ExecutionRecorder recorder;
+    WorkStealingThreadPool pool(2);
+    WorkerBlocker blocker(pool);
+
+    // The tasks are distributed over the queues of both workers, so the worker that is
+    // not blocked can only finish all of them by stealing from the blocked one
+    for (int i = 0; i < NTasks; ++i) {
+        pool.enqueue([&recorder, i]() { recorder.record(i); }, 0.f);
+    }
+    EXPECT_EQ(static_cast<size_t>(NTasks), recorder.waitFor(NTasks).size());
+
+    for (std::thread::id id : recorder.threads()) {
+        EXPECT_NE(blocker.threadId(), id);
+    }
+    blocker.release();
+}
+
+TEST_F(WorkStealingThreadPoolTest, JobManagerRunsLatestJobFirst) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    auto pool = std::make_shared<WorkStealingThreadPool>(1);
+    TestJobManager manager(pool, 10);
+    {
+        WorkerBlocker blocker(*pool);
+        for (int key = 0; key < 3; ++key) {
+            manager.enqueueJob(std::make_shared<KeyRecordingJob>(key, recorder), key);
+        }
+        // Touching a job bumps it to the front, like in the previous LRU thread pool
+        EXPECT_TRUE(manager.touch(0));
+        EXPECT_FALSE(manager.touch(42));
+    }
+
+    EXPECT_EQ(std::vector<int>({ 0, 2, 1 }), recorder.waitFor(3));
+
+    // The finished jobs are handed out in the order in which they finished
+    std::vector<int> products;
+    while (products.size() < 3) {
+        if (manager.numFinishedJobs() > 0) {
+            products.push_back(*manager.popFinishedJob()->product());
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(std::vector<int>({ 0, 2, 1 }), products);
+    EXPECT_EQ(0u, manager.numFinishedJobs());
+}
+
+TEST_F(WorkStealingThreadPoolTest, JobManagerRunsMostUrgentJobFirst) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    auto pool = std::make_shared<WorkStealingThreadPool>(1);
+    TestJobManager manager(pool, 10);
+    {
+        WorkerBlocker blocker(*pool);
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(0, recorder), 0, -3.f);
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(1, recorder), 1, -1.f);
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(2, recorder), 2, -2.f);
+        EXPECT_TRUE(manager.touch(0, 0.f));
+    }
+
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2 }), recorder.waitFor(3));
+}
+
+TEST_F(WorkStealingThreadPoolTest, JobManagerReplacesJobWithSameKey) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    auto pool = std::make_shared<WorkStealingThreadPool>(1);
+    TestJobManager manager(pool, 10);
+    {
+        WorkerBlocker blocker(*pool);
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(0, recorder), 7);
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(1, recorder), 7);
+    }
+
+    pool->enqueue([&]() { recorder.record(-1); }, -1.f);
+    EXPECT_EQ(std::vector<int>({ 1, -1 }), recorder.waitFor(2));
+}
+
+TEST_F(WorkStealingThreadPoolTest, JobManagerDropsLeastRecentJobs) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    auto pool = std::make_shared<WorkStealingThreadPool>(1);
+    TestJobManager manager(pool, 2);
+    {
+        WorkerBlocker blocker(*pool);
+        for (int key = 0; key < 4; ++key) {
+            manager.enqueueJob(std::make_shared<KeyRecordingJob>(key, recorder), key);
+        }
+        std::vector<int> unfinished = manager.keysToUnfinishedJobs();
+        std::sort(unfinished.begin(), unfinished.end());
+        EXPECT_EQ(std::vector<int>({ 0, 1 }), unfinished);
+        // The list of unfinished jobs is cleared when it is retrieved
+        EXPECT_TRUE(manager.keysToUnfinishedJobs().empty());
+    }
+
+    pool->enqueue([&]() { recorder.record(-1); }, -1.f);
+    EXPECT_EQ(std::vector<int>({ 3, 2, -1 }), recorder.waitFor(3));
+}
+
+TEST_F(WorkStealingThreadPoolTest, JobManagerCancelsEnqueuedJobs) {
+    using namespace openspace::globebrowsing;
+
+    ExecutionRecorder recorder;
+    auto pool = std::make_shared<WorkStealingThreadPool>(1);
+    TestJobManager manager(pool, 10);
+    {
+        WorkerBlocker blocker(*pool);
+        for (int key = 0; key < 3; ++key) {
+            manager.enqueueJob(std::make_shared<KeyRecordingJob>(key, recorder), key);
+        }
+        std::vector<int> enqueued = manager.keysToEnqueuedJobs();
+        std::sort(enqueued.begin(), enqueued.end());
+        EXPECT_EQ(std::vector<int>({ 0, 1, 2 }), enqueued);
+        EXPECT_FALSE(manager.touch(0));
+
+        manager.enqueueJob(std::make_shared<KeyRecordingJob>(3, recorder), 3);
+        manager.clearEnqueuedJobs();
+    }
+
+    pool->enqueue([&]() { recorder.record(-1); }, -1.f);
+    EXPECT_EQ(std::vector<int>({ -1 }), recorder.waitFor(1));
+    EXPECT_EQ(0u, manager.numFinishedJobs());
+}